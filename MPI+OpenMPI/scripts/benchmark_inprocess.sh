@@ -0,0 +1,48 @@
+#!/bin/bash
+# Benchmark avec le harnais intégré (--bench) - Version 2 (MPI + OpenMP)
+# Un seul lancement mpirun par configuration: les itérations de chauffe et
+# les répétitions sont faites dans le processus (médiane, p5/p95 par phase)
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BIN_DIR="$SCRIPT_DIR/../bin"
+RESULTS_DIR="$SCRIPT_DIR/../results"
+
+mkdir -p "$RESULTS_DIR"
+OUTPUT_FILE="$RESULTS_DIR/bench_results.csv"
+rm -f "$OUTPUT_FILE"
+
+# Configurations à tester
+SIZES=(100000 1000000 10000000)
+MPI_PROCS=(1 2 4 8)
+OMP_THREADS=(1 2 4)
+K=100
+WARMUP=2
+REPS=10
+
+echo "=== Benchmark intégré (--bench=$WARMUP,$REPS) ==="
+echo "Tailles: ${SIZES[*]}"
+echo "Processus MPI: ${MPI_PROCS[*]}"
+echo "Threads OpenMP: ${OMP_THREADS[*]}"
+echo ""
+
+for SIZE in "${SIZES[@]}"; do
+    for NP in "${MPI_PROCS[@]}"; do
+        for THREADS in "${OMP_THREADS[@]}"; do
+            echo -n "n=$SIZE, $NP processus x $THREADS threads: "
+            OMP_NUM_THREADS=$THREADS mpirun -np $NP --oversubscribe "$BIN_DIR/bucket_sort_hybrid" \
+                $SIZE $THREADS --bench=$WARMUP,$REPS --bench-csv="$OUTPUT_FILE" > /dev/null 2>&1 \
+                && echo -n "." || echo -n "x"
+            OMP_NUM_THREADS=$THREADS mpirun -np $NP --oversubscribe "$BIN_DIR/topk_hybrid" \
+                $SIZE $K $THREADS --bench=$WARMUP,$REPS --bench-csv="$OUTPUT_FILE" > /dev/null 2>&1 \
+                && echo -n "." || echo -n "x"
+            echo " OK"
+        done
+    done
+done
+
+echo ""
+echo "=== Temps médians (phase total) ==="
+grep ",total," "$OUTPUT_FILE" | cut -d',' -f1,2,3,4,8,9,10
+
+echo ""
+echo "Résultats sauvegardés dans $OUTPUT_FILE"
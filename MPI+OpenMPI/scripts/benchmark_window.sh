@@ -0,0 +1,46 @@
+#!/bin/bash
+# Benchmark du Top-K sur fenêtre glissante (--window) - Version 2
+# Débit de mise à jour et latence des requêtes quand W et K augmentent
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BIN_DIR="$SCRIPT_DIR/../bin"
+RESULTS_DIR="$SCRIPT_DIR/../results"
+
+mkdir -p "$RESULTS_DIR"
+OUTPUT_FILE="$RESULTS_DIR/topk_window.csv"
+
+# Configurations à tester
+STREAM_SIZE=20000000
+WINDOWS=(10000 100000 1000000 10000000)
+K_VALUES=(10 100 1000)
+NP=4
+THREADS=2
+PANES=8
+
+echo "=== Benchmark Top-K sur fenêtre glissante ==="
+echo "Flux: $STREAM_SIZE éléments, $NP processus x $THREADS threads, $PANES sous-fenêtres"
+echo "Fenêtres: ${WINDOWS[*]}"
+echo "Valeurs de K: ${K_VALUES[*]}"
+echo ""
+
+echo "mpi_procs,omp_threads,window,k,panes,update_meps,query_mean_us,query_max_us" > "$OUTPUT_FILE"
+
+for W in "${WINDOWS[@]}"; do
+    for K in "${K_VALUES[@]}"; do
+        OUTPUT=$(OMP_NUM_THREADS=$THREADS mpirun -np $NP --oversubscribe "$BIN_DIR/topk_hybrid" \
+            $STREAM_SIZE $K $THREADS --window=$W --panes=$PANES 2>&1)
+        CSV_LINE=$(echo "$OUTPUT" | grep "^CSV:" | sed 's/CSV: //')
+        
+        if [ -n "$CSV_LINE" ]; then
+            echo "$CSV_LINE" >> "$OUTPUT_FILE"
+            RATE=$(echo "$CSV_LINE" | cut -d',' -f6)
+            LATENCY=$(echo "$CSV_LINE" | cut -d',' -f7)
+            echo "W=$W, K=$K: $RATE M éléments/s, requête $LATENCY us"
+        else
+            echo "W=$W, K=$K: ERREUR"
+        fi
+    done
+done
+
+echo ""
+echo "Résultats sauvegardés dans $OUTPUT_FILE"
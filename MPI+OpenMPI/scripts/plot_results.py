@@ -237,6 +237,67 @@ def plot_topk_results():
     plt.savefig(os.path.join(RESULTS_DIR, 'topk_hybrid_performance.png'), dpi=150, bbox_inches='tight')
     print("Graphique sauvegardé: topk_hybrid_performance.png")
 
+def plot_bench_results():
+    """Graphiques du mode --bench: médiane avec intervalle p5-p95 et
+    décomposition par phase (results/bench_results.csv)"""
+    
+    df = load_data('bench_results.csv')
+    if df is None:
+        print("Fichier bench_results.csv non trouvé")
+        return
+    
+    for program in sorted(df['program'].unique()):
+        prog = df[df['program'] == program]
+        
+        fig, axes = plt.subplots(1, 2, figsize=(14, 5))
+        
+        # Temps total: médiane et intervalle p5-p95
+        total = prog[prog['phase'] == 'total']
+        sizes = sorted(total['array_size'].unique())
+        series = sorted(total.groupby(['array_size', 'num_threads']).groups.keys())
+        for idx, (size, threads) in enumerate(series):
+            subset = total[(total['array_size'] == size) &
+                           (total['num_threads'] == threads)].sort_values('num_procs')
+            errors = [subset['median'] - subset['p5'], subset['p95'] - subset['median']]
+            axes[0].errorbar(subset['num_procs'], subset['median'], yerr=errors,
+                             marker='o', linewidth=2, markersize=6, capsize=4,
+                             color=COLORS[idx % len(COLORS)],
+                             label=f'n = {size:,}, {threads} threads')
+        
+        axes[0].set_xlabel('Nombre de processus', fontsize=12)
+        axes[0].set_ylabel('Temps médian (s)', fontsize=12)
+        axes[0].set_title(f'{program} - médiane et p5/p95', fontsize=14, fontweight='bold')
+        axes[0].legend(loc='upper right')
+        axes[0].set_xscale('log', base=2)
+        axes[0].grid(True, alpha=0.3)
+        
+        # Décomposition par phase pour la plus grande taille et le plus de threads
+        threads = prog['num_threads'].max()
+        largest = prog[(prog['array_size'] == sizes[-1]) & (prog['num_threads'] == threads) &
+                       (prog['phase'] != 'total')]
+        phases = list(dict.fromkeys(largest['phase']))
+        procs = sorted(largest['num_procs'].unique())
+        bottom = np.zeros(len(procs))
+        phase_colors = plt.cm.tab10(np.linspace(0, 1, max(len(phases), 1)))
+        for idx, phase in enumerate(phases):
+            values = np.array([largest[(largest['num_procs'] == p) & (largest['phase'] == phase)]['median'].sum()
+                               for p in procs])
+            axes[1].bar([str(p) for p in procs], values, bottom=bottom,
+                        color=phase_colors[idx], label=phase)
+            bottom += values
+        
+        axes[1].set_xlabel('Nombre de processus', fontsize=12)
+        axes[1].set_ylabel('Temps médian (s)', fontsize=12)
+        axes[1].set_title(f'Phases (n = {sizes[-1]:,}, {threads} threads)', fontsize=14, fontweight='bold')
+        axes[1].legend(loc='upper right', fontsize=8)
+        axes[1].grid(True, alpha=0.3, axis='y')
+        
+        plt.tight_layout()
+        plt.savefig(os.path.join(RESULTS_DIR, f'bench_{program}.png'), dpi=150, bbox_inches='tight')
+        plt.close()
+        
+        print(f"Graphique sauvegardé: bench_{program}.png")
+
 def main():
     """Fonction principale"""
     print("=== Génération des graphiques - Version 2 ===")
@@ -251,6 +312,7 @@ def main():
     plot_mpi_vs_omp()
     plot_version_comparison()
     plot_topk_results()
+    plot_bench_results()
     
     print()
     print("=== Génération terminée ===")
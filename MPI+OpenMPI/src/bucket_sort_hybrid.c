@@ -23,143 +23,113 @@
 #include <omp.h>
 #endif
 
+#include "dedup.h"
+#include "instrument.h"
+#include "trace.h"
+#include "bench.h"
+#include "workload.h"
+#include "verify.h"
+#include "sort_kernels.h"
+#include "partition.h"
+#include "tuning.h"
+#include "quantile.h"
+#include "scatter.h"
+#include "exchange.h"
+#include "segsort.h"
+#include "kernels.h"
+#include "sortopt.h"
+
 // Configuration par défaut
 #define DEFAULT_SIZE 1000000
 #define MAX_VALUE 1000000
 #define DEFAULT_NUM_THREADS 4
 
-/**
- * Comparateur pour qsort - tri croissant
- */
-int compare_int(const void *a, const void *b) {
-    return (*(int*)a - *(int*)b);
-}
+// Type des clés (--keys=int|pair)
+#define KEYS_INT    0
+#define KEYS_PAIR   1
 
 /**
- * Génère un tableau d'entiers aléatoires (parallélisé avec OpenMP)
+ * Options de la ligne de commande
  */
-void generate_random_array(int *arr, int size, int max_value, unsigned int seed) {
-    #ifdef _OPENMP
-    #pragma omp parallel
-    {
-        // Chaque thread a sa propre seed pour éviter les conflits
-        unsigned int local_seed = seed + omp_get_thread_num();
-        #pragma omp for
-        for (int i = 0; i < size; i++) {
-            arr[i] = rand_r(&local_seed) % max_value;
-        }
-    }
-    #else
-    srand(seed);
-    for (int i = 0; i < size; i++) {
-        arr[i] = rand() % max_value;
-    }
-    #endif
-}
+typedef struct {
+    int total_size;     // Taille du tableau (1er argument positionnel)
+    int num_threads;    // Threads OpenMP (2e argument positionnel)
+    int output_mode;    // OUTPUT_SORT, OUTPUT_UNIQUE ou OUTPUT_COUNT
+    int stats_format;   // STATS_NONE, STATS_CSV ou STATS_JSON (--stats)
+    const char *trace_path; // Fichier de trace Chrome/Perfetto (--trace), NULL sinon
+    int profile;        // Compteurs matériels par phase (--profile)
+    int bench;          // Mode benchmark intégré (--bench[=W,M])
+    int bench_warmup;   // Itérations de chauffe
+    int bench_reps;     // Itérations mesurées
+    const char *bench_csv;  // Fichier CSV des résultats (--bench-csv=fichier)
+    int dist;           // Distribution des données (--dist=nom, DIST_*)
+    unsigned long long seed;    // Graine du générateur (--seed=n)
+    strategy_t strategy;        // Partitionnement, échange et tri local (--partition,
+                                // --exchange, --local-sort)
+    int strategy_auto;  // Seuils lus dans le cache (--strategy=auto)
+    int tune;           // Calibration et mise à jour du cache (--tune)
+    const char *tune_file;      // Cache de calibration (--tune-file=fichier)
+    long long quantile_ranks[MAX_QUANTILES];    // Rangs demandés (--quantiles, --kth)
+    int num_quantiles;  // 0 sans requête, -1 si la liste est invalide
+    int segment_min;    // Longueurs des segments (--segments[=min,max]),
+    int segment_max;    // segment_max = 0 sans tri segmenté
+    int key_type;       // KEYS_* (--keys=int|pair), -1 si inconnu
+    int order;          // SORT_ASC ou SORT_DESC (--order=asc|desc), -1 si inconnu
+    int stable;         // Égalités dans l'ordre d'origine (--stable)
+} options_t;
 
 /**
- * Vérifie si un tableau est trié (parallélisé avec OpenMP)
+ * Résultat d'une exécution du Bucket Sort: tableau rassemblé sur le
+ * processus 0 et parties locales conservées pour la vérification distribuée
  */
-int is_sorted(int *arr, int size) {
-    int sorted = 1;
-    
-    #ifdef _OPENMP
-    #pragma omp parallel for reduction(&&: sorted)
-    #endif
-    for (int i = 1; i < size; i++) {
-        if (arr[i] < arr[i-1]) {
-            sorted = 0;
-        }
-    }
-    return sorted;
-}
+typedef struct {
+    int *sorted_data;           // Tableau trié, ou clés distinctes (--unique)
+    key_count_t *histogram;     // Histogramme (--count)
+    int total_distinct;         // Nombre de clés distinctes (--unique, --count)
+    int *local_input;           // Données reçues par ce processus (avant tri)
+    int local_input_size;
+    int *local_sorted;          // Bucket trié de ce processus
+    key_count_t *local_pairs;   // Paires fusionnées de ce processus (--unique, --count)
+    int local_output_size;      // Taille de local_sorted ou de local_pairs
+    long long bytes_sent;       // Volume envoyé par ce processus
+    int partition;              // Partitionnement utilisé (PARTITION_*)
+    int exchange;               // Échange utilisé (EXCHANGE_*)
+    int *quantiles;             // Valeurs des rangs demandés (--quantiles, --kth)
+    int quantile_rounds;        // Tours de raffinement (MPI_Allreduce)
+    segment_layout_t segments;  // Segments de ce processus (--segments)
+    segsort_stats_t segment_stats;  // Segments par méthode (tous processus, sur 0)
+    double total_time;          // Temps d'exécution (barrière à barrière)
+    double comp_time;           // Temps de calcul
+    double comm_time;           // Temps de communication
+} sort_result_t;
 
 /**
- * Calcule la somme locale pour le comptage des buckets (parallélisé)
+ * Comptage des éléments par bucket (un histogramme par thread, voir
+ * kernels.h)
  */
 void count_bucket_elements(int *local_data, int local_size, int *bucket_counts, 
-                           int num_buckets, double range) {
-    // Initialisation à zéro
-    memset(bucket_counts, 0, num_buckets * sizeof(int));
-    
-    #ifdef _OPENMP
-    // Utilisation de reduction pour éviter les race conditions
-    #pragma omp parallel
-    {
-        int *local_counts = (int*)calloc(num_buckets, sizeof(int));
-        
-        #pragma omp for nowait
-        for (int i = 0; i < local_size; i++) {
-            int bucket_id = (int)(local_data[i] / range);
-            if (bucket_id >= num_buckets) bucket_id = num_buckets - 1;
-            local_counts[bucket_id]++;
-        }
-        
-        #pragma omp critical
-        {
-            for (int j = 0; j < num_buckets; j++) {
-                bucket_counts[j] += local_counts[j];
-            }
-        }
-        
-        free(local_counts);
-    }
-    #else
-    for (int i = 0; i < local_size; i++) {
-        int bucket_id = (int)(local_data[i] / range);
-        if (bucket_id >= num_buckets) bucket_id = num_buckets - 1;
-        bucket_counts[bucket_id]++;
-    }
-    #endif
+                           int num_buckets, double range, const int *splitters) {
+    double trace_t0 = trace_begin();
+    kernel_count_buckets(local_data, local_size, bucket_counts, num_buckets, range, splitters);
+    trace_end("count_buckets", trace_t0);
 }
 
 /**
- * Distribue les éléments dans les buckets (parallélisé avec OpenMP)
+ * Tri d'une section avec le noyau choisi par la stratégie
  */
-void distribute_to_buckets(int *local_data, int local_size, int **buckets, 
-                          int *bucket_indices, int num_buckets, double range) {
-    #ifdef _OPENMP
-    // Version séquentielle pour éviter les conflits d'écriture
-    // (la parallélisation nécessiterait des structures plus complexes)
-    #endif
-    
-    for (int i = 0; i < local_size; i++) {
-        int bucket_id = (int)(local_data[i] / range);
-        if (bucket_id >= num_buckets) bucket_id = num_buckets - 1;
-        buckets[bucket_id][bucket_indices[bucket_id]++] = local_data[i];
-    }
+static void sort_section(int *arr, int size, const void *context) {
+    double trace_t0 = trace_begin();
+    strategy_sort((const strategy_t*)context, arr, size);
+    trace_end("sort_section", trace_t0);
 }
 
 /**
- * Tri parallèle avec OpenMP (fusion sort ou quicksort selon la taille)
+ * Tri parallèle avec OpenMP: une section par thread triée avec le noyau
+ * choisi par la stratégie, puis fusions deux à deux des sections voisines
+ * (log2(threads) tours, les fusions d'un même tour en parallèle)
  */
-void parallel_sort(int *arr, int size) {
-    #ifdef _OPENMP
-    // Pour les grands tableaux, utiliser le tri parallèle
-    if (size > 10000) {
-        // Diviser le tableau en sections et trier en parallèle
-        int num_threads = omp_get_max_threads();
-        int chunk_size = size / num_threads;
-        
-        #pragma omp parallel
-        {
-            int tid = omp_get_thread_num();
-            int start = tid * chunk_size;
-            int end = (tid == num_threads - 1) ? size : start + chunk_size;
-            
-            // Tri local de chaque section
-            qsort(arr + start, end - start, sizeof(int), compare_int);
-        }
-        
-        // Fusion des sections triées (version simplifiée)
-        // Pour une vraie implémentation, utiliser un merge sort parallèle
-        qsort(arr, size, sizeof(int), compare_int);
-    } else {
-        qsort(arr, size, sizeof(int), compare_int);
-    }
-    #else
-    qsort(arr, size, sizeof(int), compare_int);
-    #endif
+void parallel_sort(int *arr, int size, const strategy_t *strategy) {
+    kernel_parallel_sort(arr, size, sort_section, strategy);
 }
 
 /**
@@ -186,67 +156,369 @@ void print_execution_info(int rank, int num_procs) {
 }
 
 /**
- * Fonction principale du Bucket Sort distribué hybride
+ * Lecture des arguments: <taille> [threads_omp] [--unique | --count]
+ *                        [--stats[=csv|json]]
+ *                        [--trace[=fichier.json]] [--profile]
+ *                        [--bench[=W,M]] [--bench-csv=fichier]
+ *                        [--dist=nom] [--seed=n]
+ *                        [--strategy=auto] [--tune] [--tune-file=fichier]
+ *                        [--partition=range|sample|auto] [--exchange=dense|sparse|auto]
+ *                        [--local-sort=qsort|radix|counting|natural|auto]
+ *                        [--quantiles=0.5,0.99,... | --kth=r1,r2,...]
+ *                        [--segments[=min,max]]
+ *                        [--keys=int|pair] [--order=asc|desc] [--stable]
  */
-int main(int argc, char *argv[]) {
-    int rank, num_procs;
-    int *data = NULL;
-    int *recv_bucket = NULL;
-    int *sorted_data = NULL;
-    int total_size;
-    int num_threads = DEFAULT_NUM_THREADS;
-    double start_time, end_time, total_time;
-    double comm_time = 0, comp_time = 0;
+void parse_arguments(int argc, char *argv[], options_t *opts) {
+    int positional = 0;
+    int partition = PARTITION_RANGE;
+    int local_sort = SORT_QSORT;
+    int exchange = STRATEGY_AUTO;
+    int explicit_partition = 0;
+    int explicit_sort = 0;
+    const char *quantile_spec = NULL;
+    int quantile_is_rank = 0;
     
-    // Initialisation MPI avec support des threads
-    int provided;
-    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    opts->total_size = DEFAULT_SIZE;
+    opts->num_threads = DEFAULT_NUM_THREADS;
+    opts->output_mode = OUTPUT_SORT;
+    opts->stats_format = STATS_NONE;
+    opts->trace_path = NULL;
+    opts->profile = 0;
+    opts->bench = 0;
+    opts->bench_csv = NULL;
+    opts->dist = DIST_UNIFORM;
+    opts->seed = WORKLOAD_DEFAULT_SEED;
+    opts->strategy_auto = 0;
+    opts->tune = 0;
+    opts->tune_file = TUNING_DEFAULT_FILE;
+    opts->segment_min = 0;
+    opts->segment_max = 0;
+    opts->key_type = KEYS_INT;
+    opts->order = SORT_ASC;
+    opts->stable = 0;
     
-    if (provided < MPI_THREAD_FUNNELED) {
-        fprintf(stderr, "Avertissement: Le niveau de thread MPI demandé n'est pas supporté\n");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unique") == 0) {
+            opts->output_mode = OUTPUT_UNIQUE;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            opts->output_mode = OUTPUT_COUNT;
+        } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=csv") == 0) {
+            opts->stats_format = STATS_CSV;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            opts->stats_format = STATS_JSON;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opts->trace_path = "trace.json";
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            opts->trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            opts->profile = 1;
+        } else if (bench_parse_option(argv[i], &opts->bench_warmup, &opts->bench_reps)) {
+            opts->bench = 1;
+        } else if (strncmp(argv[i], "--bench-csv=", 12) == 0) {
+            opts->bench_csv = argv[i] + 12;
+        } else if (strncmp(argv[i], "--dist=", 7) == 0) {
+            opts->dist = workload_parse_dist(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            opts->seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strcmp(argv[i], "--strategy=auto") == 0) {
+            opts->strategy_auto = 1;
+        } else if (strcmp(argv[i], "--tune") == 0) {
+            opts->tune = 1;
+        } else if (strncmp(argv[i], "--tune-file=", 12) == 0) {
+            opts->tune_file = argv[i] + 12;
+        } else if (strncmp(argv[i], "--partition=", 12) == 0) {
+            partition = strategy_parse_choice(argv[i] + 12, partition_parse);
+            explicit_partition = 1;
+        } else if (strncmp(argv[i], "--exchange=", 11) == 0) {
+            exchange = strategy_parse_choice(argv[i] + 11, exchange_parse);
+        } else if (strncmp(argv[i], "--local-sort=", 13) == 0) {
+            local_sort = strategy_parse_choice(argv[i] + 13, sort_kernel_parse);
+            explicit_sort = 1;
+        } else if (strncmp(argv[i], "--quantiles=", 12) == 0) {
+            quantile_spec = argv[i] + 12;
+            quantile_is_rank = 0;
+        } else if (strncmp(argv[i], "--kth=", 6) == 0) {
+            quantile_spec = argv[i] + 6;
+            quantile_is_rank = 1;
+        } else if (strcmp(argv[i], "--segments") == 0) {
+            opts->segment_min = SEGSORT_DEFAULT_MIN;
+            opts->segment_max = SEGSORT_DEFAULT_MAX;
+        } else if (strncmp(argv[i], "--segments=", 11) == 0) {
+            char *end;
+            opts->segment_min = (int)strtol(argv[i] + 11, &end, 10);
+            opts->segment_max = (*end == ',') ? atoi(end + 1) : opts->segment_min;
+            if (opts->segment_min < 1 || opts->segment_max < opts->segment_min) {
+                opts->segment_max = -1;
+            }
+        } else if (strcmp(argv[i], "--keys=int") == 0) {
+            opts->key_type = KEYS_INT;
+        } else if (strcmp(argv[i], "--keys=pair") == 0) {
+            opts->key_type = KEYS_PAIR;
+        } else if (strncmp(argv[i], "--keys=", 7) == 0) {
+            opts->key_type = -1;
+        } else if (strcmp(argv[i], "--order=asc") == 0) {
+            opts->order = SORT_ASC;
+        } else if (strcmp(argv[i], "--order=desc") == 0) {
+            opts->order = SORT_DESC;
+        } else if (strncmp(argv[i], "--order=", 8) == 0) {
+            opts->order = -1;
+        } else if (strcmp(argv[i], "--stable") == 0) {
+            opts->stable = 1;
+        } else if (positional == 0) {
+            opts->total_size = atoi(argv[i]);
+            positional++;
+        } else if (positional == 1) {
+            opts->num_threads = atoi(argv[i]);
+            positional++;
+        }
     }
     
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    // --strategy=auto et --tune: les choix non imposés deviennent automatiques
+    if (opts->strategy_auto || opts->tune) {
+        if (!explicit_partition) partition = STRATEGY_AUTO;
+        if (!explicit_sort) local_sort = STRATEGY_AUTO;
+    }
+    strategy_init(&opts->strategy, partition, local_sort, -1);
+    opts->strategy.exchange = exchange;
     
-    // Lecture des arguments
-    total_size = (argc > 1) ? atoi(argv[1]) : DEFAULT_SIZE;
-    if (argc > 2) {
-        num_threads = atoi(argv[2]);
+    // Rangs des quantiles (la taille du tableau est alors connue)
+    opts->num_quantiles = 0;
+    if (quantile_spec != NULL) {
+        opts->num_quantiles = quantile_parse(quantile_spec, quantile_is_rank, opts->total_size,
+                                             opts->quantile_ranks);
     }
+}
+
+/**
+ * Étapes 2 à 4: création des buckets locaux (OpenMP), échange (All-to-All
+ * ou creux) et tri local (OpenMP) selon la stratégie. Retourne le bucket
+ * trié de ce processus (à libérer), le partitionnement et l'échange
+ * utilisés dans *partition et *exchange, et cumule les temps de calcul et
+ * de communication.
+ */
+int *bucket_sort_exchange(int *local_data, int local_size, int num_procs,
+                          const strategy_t *strategy, int *out_size, int *partition,
+                          int *exchange, double *comp_time, double *comm_time) {
+    // ============================================
+    // ÉTAPE 2: Création des buckets locaux (parallélisé avec OpenMP)
+    // ============================================
+    double comp_start = MPI_Wtime();
     
-    // Configuration OpenMP
-    #ifdef _OPENMP
-    omp_set_num_threads(num_threads);
-    #endif
+    double range = (double)MAX_VALUE / num_procs;
     
-    // Affichage des informations d'exécution
-    print_execution_info(rank, num_procs);
+    // Comptage parallèle des éléments par bucket
+    double t0 = instr_start();
+    int *bucket_counts = (int*)calloc(num_procs, sizeof(int));
+    count_bucket_elements(local_data, local_size, bucket_counts, num_procs, range, NULL);
     
-    if (rank == 0) {
-        printf("Taille du tableau: %d\n", total_size);
-        printf("Valeur maximale: %d\n", MAX_VALUE);
-        printf("\n");
+    // Intervalles trop déséquilibrés (stratégie automatique) ou
+    // --partition=sample: séparateurs tirés d'un échantillon des données
+    int *splitters = NULL;
+    *partition = strategy->partition;
+    if (*partition == STRATEGY_AUTO) {
+        double imbalance = partition_imbalance(bucket_counts, num_procs, MPI_COMM_WORLD);
+        *partition = strategy_choose_partition(strategy, imbalance);
     }
+    if (*partition == PARTITION_SAMPLE) {
+        splitters = partition_select_splitters(local_data, local_size, num_procs, MPI_COMM_WORLD);
+        count_bucket_elements(local_data, local_size, bucket_counts, num_procs, range, splitters);
+    }
+    instr_stop(PHASE_CLASSIFY, t0);
     
-    // Allocation et génération des données sur le processus 0
-    if (rank == 0) {
-        data = (int*)malloc(total_size * sizeof(int));
-        if (data == NULL) {
-            fprintf(stderr, "Erreur d'allocation mémoire\n");
-            MPI_Abort(MPI_COMM_WORLD, 1);
+    // Remplissage des buckets directement dans le buffer d'envoi contigu
+    // (séquentiel, tampons d'une ligne de cache par bucket, voir scatter.h)
+    t0 = instr_start();
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    send_displs[0] = 0;
+    int total_send = bucket_counts[0];
+    for (int i = 1; i < num_procs; i++) {
+        send_displs[i] = send_displs[i-1] + bucket_counts[i-1];
+        total_send += bucket_counts[i];
+    }
+    int *send_buffer = scatter_alloc(total_send);
+    scatter_buckets(local_data, local_size, send_buffer, send_displs, num_procs, range, splitters);
+    instr_stop(PHASE_PACK, t0);
+    
+    *comp_time += MPI_Wtime() - comp_start;
+    
+    // ============================================
+    // ÉTAPE 3: Échange All-to-All (MPI_Alltoallv), ou creux si peu de
+    // paires de processus ont des données à échanger
+    // ============================================
+    double comm_start = MPI_Wtime();
+    
+    *exchange = strategy->exchange;
+    if (*exchange == STRATEGY_AUTO) {
+        t0 = instr_start();
+        double density = exchange_density(bucket_counts, num_procs, MPI_COMM_WORLD);
+        *exchange = strategy_choose_exchange(strategy, density);
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    }
+    
+    int total_recv;
+    int *recv_bucket;
+    if (*exchange == EXCHANGE_SPARSE) {
+        t0 = instr_start();
+        recv_bucket = exchange_sparse(send_buffer, bucket_counts, send_displs, &total_recv,
+                                      MPI_COMM_WORLD);
+        instr_stop(PHASE_DATA_EXCHANGE, t0);
+    } else {
+        t0 = instr_start();
+        int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+        TRACED("MPI_Alltoall",
+               MPI_Alltoall(bucket_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD));
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+        
+        int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+        
+        recv_displs[0] = 0;
+        total_recv = recv_counts[0];
+        
+        for (int i = 1; i < num_procs; i++) {
+            recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+            total_recv += recv_counts[i];
         }
         
-        double gen_start = MPI_Wtime();
-        generate_random_array(data, total_size, MAX_VALUE, 42);
-        double gen_end = MPI_Wtime();
+        recv_bucket = (int*)malloc((total_recv + 1) * sizeof(int));
         
-        printf("Temps de génération des données: %.6f s\n", gen_end - gen_start);
+        t0 = instr_start();
+        TRACED("MPI_Alltoallv",
+               MPI_Alltoallv(send_buffer, bucket_counts, send_displs, MPI_INT,
+                             recv_bucket, recv_counts, recv_displs, MPI_INT,
+                             MPI_COMM_WORLD));
+        instr_stop(PHASE_DATA_EXCHANGE, t0);
+        free(recv_counts);
+        free(recv_displs);
+    }
+    instr_add_bytes((long long)total_send * sizeof(int), (long long)total_recv * sizeof(int));
+    instr_set_bucket_size(total_recv);
+    
+    *comm_time += MPI_Wtime() - comm_start;
+    
+    // ============================================
+    // ÉTAPE 4: Tri local du bucket (parallélisé avec OpenMP)
+    // ============================================
+    comp_start = MPI_Wtime();
+    
+    t0 = instr_start();
+    parallel_sort(recv_bucket, total_recv, strategy);
+    instr_stop(PHASE_LOCAL_SORT, t0);
+    
+    *comp_time += MPI_Wtime() - comp_start;
+    
+    free(splitters);
+    free(bucket_counts);
+    free(send_displs);
+    free(send_buffer);
+    
+    *out_size = total_recv;
+    return recv_bucket;
+}
+
+/**
+ * Variante --unique / --count des étapes 2 à 5: les doublons sont regroupés
+ * (histogramme OpenMP) avant l'échange puis le résultat est rassemblé sur le
+ * processus 0, soit sous forme de clés distinctes (*keys), soit de paires
+ * (clé, nombre) (*histogram). Retourne le nombre de clés distinctes.
+ */
+int bucket_sort_distinct(int *local_data, int local_size, int num_procs, int rank,
+                         int mode, int **keys, key_count_t **histogram,
+                         key_count_t **local_pairs, int *num_local_pairs,
+                         long long *bytes_sent, double *comp_time, double *comm_time) {
+    double comp_start = MPI_Wtime();
+    double range = (double)MAX_VALUE / num_procs;
+    int *bucket_counts = (int*)malloc(num_procs * sizeof(int));
+    
+    // Regroupement local des doublons
+    key_count_t *pairs = NULL;
+    key_count_t *merged = NULL;
+    dedup_collapse_local(local_data, local_size, MAX_VALUE, num_procs, range,
+                         &pairs, bucket_counts);
+    instr_stop(PHASE_CLASSIFY, comp_start);
+    *comp_time += MPI_Wtime() - comp_start;
+    
+    // Échange des paires et fusion des occurrences
+    double comm_start = MPI_Wtime();
+    int num_merged = dedup_exchange_merge(pairs, bucket_counts, mode, &merged,
+                                          bytes_sent, MPI_COMM_WORLD);
+    instr_set_bucket_size(num_merged);
+    
+    // Rassemblement du résultat trié sur le processus 0
+    double t0 = instr_start();
+    int *final_counts = NULL;
+    int *final_displs = NULL;
+    int total_distinct = 0;
+    
+    if (rank == 0) {
+        final_counts = (int*)malloc(num_procs * sizeof(int));
+        final_displs = (int*)malloc(num_procs * sizeof(int));
+    }
+    
+    TRACED("MPI_Gather",
+           MPI_Gather(&num_merged, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    
+    if (rank == 0) {
+        for (int i = 0; i < num_procs; i++) {
+            final_displs[i] = total_distinct;
+            total_distinct += final_counts[i];
+        }
+    }
+    
+    if (mode == OUTPUT_UNIQUE) {
+        // Clés seules: la moitié du volume des paires
+        int *local_keys = (int*)malloc((num_merged + 1) * sizeof(int));
+        for (int i = 0; i < num_merged; i++) {
+            local_keys[i] = merged[i].key;
+        }
+        if (rank == 0) {
+            *keys = (int*)malloc((total_distinct + 1) * sizeof(int));
+        }
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(local_keys, num_merged, MPI_INT,
+                           rank == 0 ? *keys : NULL, final_counts, final_displs, MPI_INT,
+                           0, MPI_COMM_WORLD));
+        free(local_keys);
+    } else {
+        MPI_Datatype pair_type = dedup_pair_type();
+        if (rank == 0) {
+            *histogram = (key_count_t*)malloc((total_distinct + 1) * sizeof(key_count_t));
+        }
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(merged, num_merged, pair_type,
+                           rank == 0 ? *histogram : NULL, final_counts, final_displs, pair_type,
+                           0, MPI_COMM_WORLD));
+        MPI_Type_free(&pair_type);
     }
+    instr_stop(PHASE_GATHER, t0);
+    
+    *comm_time += MPI_Wtime() - comm_start;
+    
+    free(bucket_counts);
+    free(pairs);
+    free(final_counts);
+    free(final_displs);
+    
+    *local_pairs = merged;
+    *num_local_pairs = num_merged;
+    return total_distinct;
+}
+
+/**
+ * Exécution chronométrée du Bucket Sort (étapes 1 à 5) à partir des données
+ * du processus 0. Les données d'entrée ne sont pas modifiées.
+ */
+void run_bucket_sort(int *data, const options_t *opts, int rank, int num_procs,
+                     sort_result_t *result) {
+    int total_size = opts->total_size;
+    int *recv_bucket = NULL;
+    int total_recv = 0;
+    
+    memset(result, 0, sizeof(*result));
     
     // Synchronisation avant le chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    start_time = MPI_Wtime();
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
     
     // ============================================
     // ÉTAPE 1: Distribution des données (MPI_Scatterv)
@@ -269,171 +541,681 @@ int main(int argc, char *argv[]) {
     
     int *local_data = (int*)malloc(local_size * sizeof(int));
     
-    MPI_Scatterv(data, sendcounts, displs, MPI_INT,
-                 local_data, local_size, MPI_INT,
-                 0, MPI_COMM_WORLD);
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
     
-    comm_time += MPI_Wtime() - comm_start;
+    instr_stop(PHASE_SCATTER, comm_start);
+    result->comm_time += MPI_Wtime() - comm_start;
     
-    // ============================================
-    // ÉTAPE 2: Création des buckets locaux (parallélisé avec OpenMP)
-    // ============================================
+    if (opts->num_quantiles > 0) {
+        // ============================================
+        // ÉTAPE 2 (--quantiles, --kth): raffinement d'histogramme global,
+        // sans échange des données ni tri (MPI_Allreduce compris)
+        // ============================================
+        double comp_start = MPI_Wtime();
+        result->quantiles = (int*)malloc(opts->num_quantiles * sizeof(int));
+        result->quantile_rounds = quantile_select(local_data, local_size, opts->quantile_ranks,
+                                                  opts->num_quantiles, result->quantiles,
+                                                  MPI_COMM_WORLD);
+        instr_set_bucket_size(local_size);
+        result->comp_time += MPI_Wtime() - comp_start;
+    } else if (opts->output_mode != OUTPUT_SORT) {
+        // ============================================
+        // ÉTAPES 2 à 5 (--unique / --count): échange des paires (clé, nombre)
+        // ============================================
+        result->total_distinct = bucket_sort_distinct(local_data, local_size, num_procs, rank,
+                                                      opts->output_mode, &result->sorted_data,
+                                                      &result->histogram, &result->local_pairs,
+                                                      &result->local_output_size, &result->bytes_sent,
+                                                      &result->comp_time, &result->comm_time);
+    } else {
+        // ============================================
+        // ÉTAPES 2 à 4: buckets locaux, échange All-to-All et tri local
+        // ============================================
+        recv_bucket = bucket_sort_exchange(local_data, local_size, num_procs, &opts->strategy,
+                                           &total_recv, &result->partition, &result->exchange,
+                                           &result->comp_time, &result->comm_time);
+        result->bytes_sent = (long long)local_size * sizeof(int);
+        result->local_sorted = recv_bucket;
+        result->local_output_size = total_recv;
+        
+        // ============================================
+        // ÉTAPE 5: Rassemblement des résultats (MPI_Gatherv)
+        // ============================================
+        comm_start = MPI_Wtime();
+        
+        int *final_counts = NULL;
+        int *final_displs = NULL;
+        
+        if (rank == 0) {
+            final_counts = (int*)malloc(num_procs * sizeof(int));
+            final_displs = (int*)malloc(num_procs * sizeof(int));
+            result->sorted_data = (int*)malloc(total_size * sizeof(int));
+        }
+        
+        TRACED("MPI_Gather",
+               MPI_Gather(&total_recv, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD));
+        
+        if (rank == 0) {
+            final_displs[0] = 0;
+            for (int i = 1; i < num_procs; i++) {
+                final_displs[i] = final_displs[i-1] + final_counts[i-1];
+            }
+        }
+        
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(recv_bucket, total_recv, MPI_INT,
+                           result->sorted_data, final_counts, final_displs, MPI_INT,
+                           0, MPI_COMM_WORLD));
+        
+        instr_stop(PHASE_GATHER, comm_start);
+        result->comm_time += MPI_Wtime() - comm_start;
+        
+        free(final_counts);
+        free(final_displs);
+    }
+    
+    // Fin du chronométrage
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    result->total_time = MPI_Wtime() - start_time;
+    
+    result->local_input = local_data;
+    result->local_input_size = local_size;
+    
+    free(sendcounts);
+    free(displs);
+}
+
+/**
+ * Exécution chronométrée du tri segmenté (--segments): distribution des
+ * segments entiers par taille cumulée, tri de chaque segment selon sa
+ * taille (segsort.h) et rassemblement sur le processus 0 dans la
+ * disposition d'origine. offsets: bornes des num_segments segments de data
+ * (processus 0).
+ */
+void run_segmented_sort(int *data, const int *offsets, int num_segments, const options_t *opts,
+                        int rank, sort_result_t *result) {
+    memset(result, 0, sizeof(*result));
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    // Distribution des segments (longueurs puis valeurs)
+    double comm_start = MPI_Wtime();
+    int *local_data = segsort_scatter(data, offsets, num_segments, &result->segments, 0,
+                                      MPI_COMM_WORLD);
+    int local_size = result->segments.size;
+    instr_stop(PHASE_SCATTER, comm_start);
+    result->comm_time += MPI_Wtime() - comm_start;
+    
+    // Tri de chaque segment (l'entrée locale est conservée pour la vérification)
     double comp_start = MPI_Wtime();
+    result->local_sorted = (int*)malloc((local_size + 1) * sizeof(int));
+    memcpy(result->local_sorted, local_data, local_size * sizeof(int));
+    segsort_stats_t stats = { 0, 0, 0 };
+    segsort_sort(result->local_sorted, result->segments.offsets, result->segments.num_segments,
+                 &opts->strategy, &stats);
+    result->local_output_size = local_size;
+    instr_set_bucket_size(local_size);
+    instr_stop(PHASE_LOCAL_SORT, comp_start);
+    result->comp_time += MPI_Wtime() - comp_start;
     
-    double range = (double)MAX_VALUE / num_procs;
+    // Rassemblement dans la disposition d'origine
+    comm_start = MPI_Wtime();
+    if (rank == 0) {
+        result->sorted_data = (int*)malloc((opts->total_size + 1) * sizeof(int));
+    }
+    segsort_gather(result->local_sorted, &result->segments, result->sorted_data, 0,
+                   MPI_COMM_WORLD);
+    instr_stop(PHASE_GATHER, comm_start);
+    result->comm_time += MPI_Wtime() - comm_start;
     
-    // Comptage parallèle des éléments par bucket
-    int *bucket_counts = (int*)calloc(num_procs, sizeof(int));
-    count_bucket_elements(local_data, local_size, bucket_counts, num_procs, range);
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    result->total_time = MPI_Wtime() - start_time;
     
-    // Allocation et remplissage des buckets
-    int **local_buckets = (int**)malloc(num_procs * sizeof(int*));
-    int *bucket_indices = (int*)calloc(num_procs, sizeof(int));
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&stats, &result->segment_stats, 3, MPI_LONG_LONG, MPI_SUM, 0,
+                      MPI_COMM_WORLD));
+    result->local_input = local_data;
+    result->local_input_size = local_size;
+    result->bytes_sent = (long long)local_size * sizeof(int);
+}
+
+/**
+ * Affiche un enregistrement du mode --order/--stable/--keys=pair
+ */
+static void print_record(const char *label, const sortopt_ops_t *ops, const int *record) {
+    printf("%s: %d", label, record[0]);
+    if (ops->pair) printf(", %d", record[1]);
+    if (ops->stable) printf(" (indice %d)", record[ops->fields - 1]);
+    printf("\n");
+}
+
+/**
+ * Modes --order=desc, --stable et --keys=pair: Bucket Sort
+ * d'enregistrements (clé, [clé2], [indice d'origine]) par le pipeline de
+ * sortopt.h, comme bucket_sort_mpi: distribution, séparateurs
+ * échantillonnés, échange, tri local avec les noyaux spécialisés de la
+ * combinaison d'options (un thread par processus), rassemblement, puis
+ * vérification distribuée. La seconde clé est uniforme (graine + 1). Le
+ * temps de communication compte la distribution et le rassemblement;
+ * l'échange et le tri local, indissociables, sont comptés en calcul.
+ */
+void run_ordered_sort(const options_t *opts, int rank, int num_procs, int num_threads,
+                      bench_t *bench) {
+    int total_size = opts->total_size;
+    sort_options_t sort_opts = { opts->order, opts->stable, opts->key_type == KEYS_PAIR };
+    const sortopt_ops_t *ops = sortopt_select(&sort_opts);
     
-    for (int i = 0; i < num_procs; i++) {
-        local_buckets[i] = (int*)malloc((bucket_counts[i] + 1) * sizeof(int));
+    int *records = NULL;
+    if (rank == 0) {
+        int *keys = (int*)malloc((total_size + 1) * sizeof(int));
+        int *keys2 = NULL;
+        workload_generate(keys, 0, total_size, total_size, MAX_VALUE, opts->dist, opts->seed);
+        if (ops->pair) {
+            keys2 = (int*)malloc((total_size + 1) * sizeof(int));
+            workload_generate(keys2, 0, total_size, total_size, MAX_VALUE, DIST_UNIFORM,
+                              opts->seed + 1);
+        }
+        records = sortopt_build(ops, keys, keys2, total_size, 0);
+        free(keys);
+        free(keys2);
+        printf("Enregistrements: %s (%d entiers chacun)\n", ops->name, ops->fields);
     }
     
-    distribute_to_buckets(local_data, local_size, local_buckets, 
-                         bucket_indices, num_procs, range);
+    int *local = NULL, *sorted = NULL, *gathered = NULL;
+    int local_count = 0, sorted_count = 0, gathered_count = 0;
+    long long bytes_sent = 0;
+    double total_time = 0.0, comm_time = 0.0;
+    for (int iter = 0; iter < bench_iterations(bench); iter++) {
+        free(local);
+        free(sorted);
+        free(gathered);
+        instr_reset();
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        double start_time = MPI_Wtime();
+        
+        double t0 = instr_start();
+        double comm_start = MPI_Wtime();
+        sortopt_scatter(ops, records, total_size, &local, &local_count, 0, MPI_COMM_WORLD);
+        comm_time = MPI_Wtime() - comm_start;
+        instr_stop(PHASE_SCATTER, t0);
+        
+        bytes_sent = sortopt_exchange(ops, local, local_count, &sorted, &sorted_count,
+                                      MPI_COMM_WORLD);
+        
+        t0 = instr_start();
+        comm_start = MPI_Wtime();
+        sortopt_gather(ops, sorted, sorted_count, &gathered, &gathered_count, 0,
+                       MPI_COMM_WORLD);
+        comm_time += MPI_Wtime() - comm_start;
+        instr_stop(PHASE_GATHER, t0);
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        total_time = MPI_Wtime() - start_time;
+        bench_record(bench, iter, total_time, MPI_COMM_WORLD);
+    }
     
-    comp_time += MPI_Wtime() - comp_start;
+    // Vérification: ordre global et mêmes enregistrements avant et après
+    double t0 = instr_start();
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    sortopt_checksum(&before, ops, local, local_count);
+    sortopt_checksum(&after, ops, sorted, sorted_count);
+    int ok = sortopt_verify_distributed(ops, sorted, sorted_count, MPI_COMM_WORLD);
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        ok = 0;
+    }
+    instr_stop(PHASE_VERIFY, t0);
     
-    // ============================================
-    // ÉTAPE 3: Échange All-to-All (MPI_Alltoallv)
-    // ============================================
-    comm_start = MPI_Wtime();
+    long long total_bytes = 0;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
     
-    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
-    MPI_Alltoall(bucket_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD);
+    if (rank == 0) {
+        double comp_time = total_time - comm_time;
+        printf("\n=== Résultats ===\n");
+        printf("Tri correct: %s\n", ok ? "OUI" : "NON");
+        if (gathered_count > 0) {
+            print_record("Premier", ops, gathered);
+            print_record("Dernier", ops, gathered + (size_t)(gathered_count - 1) * ops->fields);
+        }
+        printf("Volume échangé: %lld octets\n", total_bytes);
+        printf("Temps total: %.6f secondes\n", total_time);
+        printf("Temps de calcul (échange et tri local): %.6f secondes (%.1f%%)\n",
+               comp_time, (comp_time/total_time)*100);
+        printf("Temps de communication (distribution, rassemblement): %.6f secondes (%.1f%%)\n",
+               comm_time, (comm_time/total_time)*100);
+        printf("Éléments triés par seconde: %.2f millions\n",
+               (total_size / total_time) / 1000000.0);
+        
+        // Format CSV pour les benchmarks
+        printf("\nCSV: %d,%d,%d,%.6f,%.6f,%.6f\n", num_procs, num_threads, total_size,
+               total_time, comp_time, comm_time);
+    }
     
-    int *send_displs = (int*)malloc(num_procs * sizeof(int));
-    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    if (opts->bench) {
+        bench_report(bench, "bucket_sort_hybrid", num_procs, num_threads, total_size, 0,
+                     opts->bench_csv, MPI_COMM_WORLD);
+    }
     
-    send_displs[0] = 0;
-    recv_displs[0] = 0;
-    int total_send = bucket_counts[0];
-    int total_recv = recv_counts[0];
+    free(records);
+    free(local);
+    free(sorted);
+    free(gathered);
+}
+
+/**
+ * Libère le résultat d'une exécution
+ */
+void free_sort_result(sort_result_t *result) {
+    free(result->sorted_data);
+    free(result->histogram);
+    free(result->local_input);
+    free(result->local_sorted);
+    free(result->local_pairs);
+    free(result->quantiles);
+    segsort_layout_free(&result->segments);
+    memset(result, 0, sizeof(*result));
+}
+
+/**
+ * Calibration (--tune): seuils du tri local par balayage, puis seuil de
+ * déséquilibre à partir des meilleurs temps de chaque partitionnement sur
+ * les données courantes. Le résultat est enregistré dans le cache.
+ */
+void tune_bucket_sort(int *data, options_t *opts, int rank, int num_procs, int num_threads) {
+    strategy_t *strategy = &opts->strategy;
+    tuning_calibrate_local_sort(strategy, opts->total_size / num_procs, MPI_COMM_WORLD);
     
-    for (int i = 1; i < num_procs; i++) {
-        send_displs[i] = send_displs[i-1] + bucket_counts[i-1];
-        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
-        total_send += bucket_counts[i];
-        total_recv += recv_counts[i];
+    if (opts->output_mode == OUTPUT_SORT) {
+        options_t trial = *opts;
+        sort_result_t result;
+        double local_times[NUM_PARTITIONS];
+        double times[NUM_PARTITIONS];
+        int largest = 0, total = 0;
+        
+        for (int p = 0; p < NUM_PARTITIONS; p++) {
+            trial.strategy.partition = p;
+            local_times[p] = 1e30;
+            for (int rep = 0; rep < 3; rep++) {
+                run_bucket_sort(data, &trial, rank, num_procs, &result);
+                if (result.total_time < local_times[p]) local_times[p] = result.total_time;
+                if (p == PARTITION_RANGE && rep == 0) {
+                    MPI_Allreduce(&result.local_output_size, &largest, 1, MPI_INT, MPI_MAX,
+                                  MPI_COMM_WORLD);
+                    MPI_Allreduce(&result.local_output_size, &total, 1, MPI_INT, MPI_SUM,
+                                  MPI_COMM_WORLD);
+                }
+                free_sort_result(&result);
+            }
+        }
+        MPI_Allreduce(local_times, times, NUM_PARTITIONS, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        
+        double imbalance = total > 0 ? (double)largest * num_procs / total : 1.0;
+        strategy->sample_imbalance = tuning_fit_imbalance(times[PARTITION_RANGE], imbalance,
+                                                          times[PARTITION_SAMPLE]);
+        if (rank == 0) {
+            printf("Calibration: intervalles %.6f s (déséquilibre %.2f), échantillonnage %.6f s\n",
+                   times[PARTITION_RANGE], imbalance, times[PARTITION_SAMPLE]);
+        }
     }
     
-    // Préparation du buffer d'envoi contigu
-    int *send_buffer = (int*)malloc(total_send * sizeof(int));
-    int pos = 0;
-    for (int i = 0; i < num_procs; i++) {
-        memcpy(send_buffer + pos, local_buckets[i], bucket_counts[i] * sizeof(int));
-        pos += bucket_counts[i];
+    tuning_store(opts->tune_file, "bucket_sort_hybrid", num_procs, num_threads, opts->total_size,
+                 0, strategy, MPI_COMM_WORLD);
+}
+
+/**
+ * Fonction principale du Bucket Sort distribué hybride
+ */
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    int *data = NULL;
+    int *offsets = NULL;
+    int num_segments = 0;
+    int total_size;
+    double total_time;
+    double comm_time, comp_time;
+    options_t opts;
+    sort_result_t result;
+    bench_t bench;
+    int num_threads = 1;
+    
+    // Initialisation MPI avec support des threads
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    
+    if (provided < MPI_THREAD_FUNNELED) {
+        fprintf(stderr, "Avertissement: Le niveau de thread MPI demandé n'est pas supporté\n");
     }
     
-    recv_bucket = (int*)malloc((total_recv + 1) * sizeof(int));
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     
-    MPI_Alltoallv(send_buffer, bucket_counts, send_displs, MPI_INT,
-                  recv_bucket, recv_counts, recv_displs, MPI_INT,
-                  MPI_COMM_WORLD);
+    // Lecture des arguments
+    parse_arguments(argc, argv, &opts);
+    total_size = opts.total_size;
+    instr_init(opts.stats_format, opts.trace_path != NULL || opts.bench);
     
-    comm_time += MPI_Wtime() - comm_start;
+    // Vérification de la distribution
+    if (opts.dist < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: distribution inconnue (uniform, zipf, gaussian, sorted, "
+                    "reverse, nearly-sorted, all-equal, few-unique)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
     
-    // ============================================
-    // ÉTAPE 4: Tri local du bucket (parallélisé avec OpenMP)
-    // ============================================
-    comp_start = MPI_Wtime();
+    // Configuration OpenMP
+    #ifdef _OPENMP
+    omp_set_num_threads(opts.num_threads);
+    num_threads = omp_get_max_threads();
+    #endif
+    
+    // Compteurs matériels de chaque thread (--profile)
+    if (opts.profile) {
+        instr_profile_init();
+    }
     
-    parallel_sort(recv_bucket, total_recv);
+    if (opts.strategy.partition == -1 || opts.strategy.local_sort == -1
+        || opts.strategy.exchange == -1) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: stratégie inconnue (--partition=range|sample|auto, "
+                    "--local-sort=qsort|radix|counting|natural|auto, --exchange=dense|sparse|auto)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.num_quantiles < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: liste invalide (--quantiles=q1,q2,... dans [0, 1], "
+                    "--kth=r1,r2,... dans [0, taille - 1])\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.segment_max < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: longueurs invalides (--segments=min,max avec "
+                    "1 <= min <= max)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.segment_max > 0 && (opts.output_mode != OUTPUT_SORT || opts.num_quantiles > 0
+                                 || opts.tune)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --segments ne s'applique qu'au tri (sans --tune)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.key_type < 0 || opts.order < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: option inconnue (--keys=int|pair, --order=asc|desc)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    int ordered = opts.order == SORT_DESC || opts.stable || opts.key_type == KEYS_PAIR;
+    if (ordered && (opts.output_mode != OUTPUT_SORT || opts.num_quantiles > 0
+                    || opts.segment_max > 0 || opts.tune)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --order=desc, --stable et --keys=pair ne s'appliquent "
+                    "qu'au tri (sans --segments ni --tune)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
     
-    comp_time += MPI_Wtime() - comp_start;
+    // --strategy=auto: seuils du cache de calibration (sinon seuils par défaut)
+    int cached = 0;
+    if (opts.strategy_auto && !opts.tune) {
+        cached = tuning_load(opts.tune_file, "bucket_sort_hybrid", num_procs, num_threads,
+                             total_size, 0, &opts.strategy, MPI_COMM_WORLD);
+    }
     
-    // ============================================
-    // ÉTAPE 5: Rassemblement des résultats (MPI_Gatherv)
-    // ============================================
-    comm_start = MPI_Wtime();
+    // Trace chronologique (après la configuration OpenMP: un tampon par thread)
+    if (opts.trace_path != NULL) {
+        trace_init(opts.trace_path, MPI_COMM_WORLD);
+    }
     
-    int *final_counts = NULL;
-    int *final_displs = NULL;
+    // Sans --bench: une seule itération mesurée, sans chauffe
+    bench_init(&bench, opts.bench ? opts.bench_warmup : 0, opts.bench ? opts.bench_reps : 1);
+    
+    // Affichage des informations d'exécution
+    print_execution_info(rank, num_procs);
     
     if (rank == 0) {
-        final_counts = (int*)malloc(num_procs * sizeof(int));
-        final_displs = (int*)malloc(num_procs * sizeof(int));
-        sorted_data = (int*)malloc(total_size * sizeof(int));
+        printf("Taille du tableau: %d\n", total_size);
+        printf("Valeur maximale: %d\n", MAX_VALUE);
+        printf("Distribution: %s (graine %llu)\n", workload_dist_name(opts.dist), opts.seed);
+        if (opts.output_mode == OUTPUT_UNIQUE) {
+            printf("Mode: clés distinctes (--unique)\n");
+        } else if (opts.output_mode == OUTPUT_COUNT) {
+            printf("Mode: histogramme (--count)\n");
+        }
+        if (opts.num_quantiles > 0) {
+            printf("Mode: statistiques d'ordre (%d rangs, sans tri)\n", opts.num_quantiles);
+        }
+        if (opts.segment_max > 0) {
+            printf("Mode: tri segmenté (segments de %d à %d éléments)\n", opts.segment_min,
+                   opts.segment_max);
+        }
+        if (ordered) {
+            printf("Mode: ordre %s%s%s (partition échantillonnée, noyaux spécialisés)\n",
+                   opts.order == SORT_DESC ? "décroissant" : "croissant",
+                   opts.key_type == KEYS_PAIR ? ", clés (clé, clé2)" : "",
+                   opts.stable ? ", stable" : "");
+        }
+        printf("\n");
     }
     
-    MPI_Gather(&total_recv, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Ordre décroissant, stable ou multiclé: pipeline d'enregistrements (sortopt.h)
+    if (ordered) {
+        run_ordered_sort(&opts, rank, num_procs, num_threads, &bench);
+        instr_report("bucket_sort_hybrid", total_size, num_threads, MPI_COMM_WORLD);
+        trace_write(MPI_COMM_WORLD);
+        bench_free(&bench);
+        MPI_Finalize();
+        return 0;
+    }
     
+    // Allocation et génération des données sur le processus 0
     if (rank == 0) {
-        final_displs[0] = 0;
-        for (int i = 1; i < num_procs; i++) {
-            final_displs[i] = final_displs[i-1] + final_counts[i-1];
+        data = (int*)malloc(total_size * sizeof(int));
+        if (data == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
         }
+        
+        double gen_start = MPI_Wtime();
+        workload_generate(data, 0, total_size, total_size, MAX_VALUE, opts.dist, opts.seed);
+        if (opts.segment_max > 0) {
+            num_segments = segsort_make_offsets(total_size, opts.segment_min, opts.segment_max,
+                                                opts.seed + 1, &offsets);
+        }
+        double gen_end = MPI_Wtime();
+        
+        printf("Temps de génération des données: %.6f s\n", gen_end - gen_start);
+    }
+    
+    // Calibration sur la machine courante (--tune)
+    if (opts.tune) {
+        tune_bucket_sort(data, &opts, rank, num_procs, num_threads);
     }
     
-    MPI_Gatherv(recv_bucket, total_recv, MPI_INT,
-                sorted_data, final_counts, final_displs, MPI_INT,
-                0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        printf("Stratégie: partition=%s, échange=%s, tri local=%s",
+               strategy_choice_name(opts.strategy.partition, partition_name),
+               strategy_choice_name(opts.strategy.exchange, exchange_name),
+               strategy_choice_name(opts.strategy.local_sort, sort_kernel_name));
+        if (opts.strategy_auto || opts.tune) {
+            printf(" (seuils %s: déséquilibre %.2f, base >= %d, comptage <= %.2f x taille)",
+                   opts.tune ? "calibrés" : (cached ? "du cache" : "par défaut"),
+                   opts.strategy.sample_imbalance, opts.strategy.radix_min_size,
+                   opts.strategy.counting_max_ratio);
+        }
+        printf("\n");
+    }
     
-    comm_time += MPI_Wtime() - comm_start;
+    // ============================================
+    // ÉTAPES 1 à 5 (répétées en mode --bench; l'entrée n'est jamais modifiée)
+    // ============================================
+    for (int iter = 0; iter < bench_iterations(&bench); iter++) {
+        if (iter > 0) {
+            free_sort_result(&result);
+        }
+        instr_reset();
+        if (opts.segment_max > 0) {
+            run_segmented_sort(data, offsets, num_segments, &opts, rank, &result);
+        } else {
+            run_bucket_sort(data, &opts, rank, num_procs, &result);
+        }
+        bench_record(&bench, iter, result.total_time, MPI_COMM_WORLD);
+    }
+    total_time = result.total_time;
+    comp_time = result.comp_time;
+    comm_time = result.comm_time;
     
-    // Fin du chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    end_time = MPI_Wtime();
-    total_time = end_time - start_time;
+    // Volume total envoyé lors de l'échange All-to-All
+    long long total_bytes = 0;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&result.bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
     
     // ============================================
     // ÉTAPE 6: Vérification et affichage des résultats
     // ============================================
     
+    // Vérification distribuée: ordre local, frontières entre processus et
+    // empreinte du multi-ensemble des clés avant/après (O(n/p) par processus)
+    int sorted;
+    double t0 = instr_start();
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    
+    if (opts.num_quantiles > 0) {
+        // Rang global de chaque valeur encadré par comptage distribué
+        sorted = verify_quantiles_distributed(result.local_input, result.local_input_size,
+                                              opts.quantile_ranks, result.quantiles,
+                                              opts.num_quantiles, MPI_COMM_WORLD);
+    } else if (opts.segment_max > 0) {
+        // Chaque segment croissant, mêmes clés qu'avant le tri
+        checksum_add_array(&before, result.local_input, result.local_input_size);
+        checksum_add_array(&after, result.local_sorted, result.local_output_size);
+        sorted = verify_segments_distributed(result.local_sorted, result.segments.offsets,
+                                             result.segments.num_segments, MPI_COMM_WORLD);
+    } else if (opts.output_mode == OUTPUT_SORT) {
+        checksum_add_array(&before, result.local_input, result.local_input_size);
+        checksum_add_array(&after, result.local_sorted, result.local_output_size);
+        sorted = verify_sorted_distributed(result.local_sorted, result.local_output_size,
+                                           0, MPI_COMM_WORLD);
+    } else {
+        // Clés strictement croissantes; en mode --count, les occurrences
+        // reconstituent exactement les données d'entrée
+        sorted = verify_pairs_distributed(result.local_pairs, result.local_output_size,
+                                          MPI_COMM_WORLD);
+        if (opts.output_mode == OUTPUT_COUNT) {
+            checksum_add_array(&before, result.local_input, result.local_input_size);
+            checksum_add_pairs(&after, result.local_pairs, result.local_output_size);
+        }
+    }
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        sorted = 0;
+    }
+    instr_stop(PHASE_VERIFY, t0);
+    
     if (rank == 0) {
-        int sorted = is_sorted(sorted_data, total_size);
+        key_count_t *histogram = result.histogram;
+        int total_distinct = result.total_distinct;
+        
         
         printf("\n=== Résultats ===\n");
-        printf("Tri correct: %s\n", sorted ? "OUI" : "NON");
+        if (opts.num_quantiles > 0) {
+            printf("Statistiques d'ordre (%d tours de MPI_Allreduce):\n", result.quantile_rounds);
+            for (int q = 0; q < opts.num_quantiles; q++) {
+                printf("  rang %lld (%.4f%%): %d\n", opts.quantile_ranks[q],
+                       quantile_percent(opts.quantile_ranks[q], total_size), result.quantiles[q]);
+            }
+            printf("Valeurs correctes: %s\n", sorted ? "OUI" : "NON");
+        } else {
+            printf("Tri correct: %s\n", sorted ? "OUI" : "NON");
+        }
+        if (opts.segment_max > 0) {
+            printf("Segments: %d (%lld par réseau de tri, %lld un par thread, "
+                   "%lld découpés entre threads)\n", num_segments, result.segment_stats.small,
+                   result.segment_stats.medium, result.segment_stats.split);
+        } else if (opts.output_mode == OUTPUT_SORT && opts.num_quantiles == 0) {
+            printf("Partitionnement utilisé: %s, échange: %s\n", partition_name(result.partition),
+                   exchange_name(result.exchange));
+        }
+        if (opts.output_mode != OUTPUT_SORT) {
+            printf("Clés distinctes: %d (facteur de duplication: %.2f)\n",
+                   total_distinct, total_distinct > 0 ? (double)total_size / total_distinct : 0.0);
+            printf("Volume échangé: %lld octets (%.1f%% du tri complet)\n",
+                   total_bytes, total_size > 0 ? 100.0 * total_bytes / ((double)total_size * sizeof(int)) : 0.0);
+            if (opts.output_mode == OUTPUT_COUNT && total_distinct > 0) {
+                printf("Premières entrées: ");
+                for (int i = 0; i < total_distinct && i < 5; i++) {
+                    printf("(%d, %d) ", histogram[i].key, histogram[i].count);
+                }
+                printf("...\n");
+            }
+        }
         printf("Temps total: %.6f secondes\n", total_time);
         printf("Temps de calcul: %.6f secondes (%.1f%%)\n", 
                comp_time, (comp_time/total_time)*100);
         printf("Temps de communication: %.6f secondes (%.1f%%)\n", 
                comm_time, (comm_time/total_time)*100);
-        printf("Éléments triés par seconde: %.2f millions\n", 
-               (total_size / total_time) / 1000000.0);
-        
-        // Format CSV pour les benchmarks
-        #ifdef _OPENMP
-        printf("\nCSV: %d,%d,%d,%.6f,%.6f,%.6f\n", 
-               num_procs, omp_get_max_threads(), total_size, 
-               total_time, comp_time, comm_time);
-        #else
-        printf("\nCSV: %d,1,%d,%.6f,%.6f,%.6f\n", 
-               num_procs, total_size, total_time, comp_time, comm_time);
-        #endif
+        if (opts.num_quantiles > 0) {
+            // Rien n'est trié: ligne propre, pour ne pas se mêler aux temps de tri
+            printf("\nCSV_QUANTILES: %d,%d,%d,%d,%.6f,%.6f,%.6f\n", num_procs, num_threads,
+                   total_size, opts.num_quantiles, total_time, comp_time, comm_time);
+        } else {
+            printf("Éléments triés par seconde: %.2f millions\n", 
+                   (total_size / total_time) / 1000000.0);
+            if (opts.segment_max > 0) {
+                printf("Segments triés par seconde: %.0f\n", num_segments / total_time);
+            }
+            
+            // Format CSV pour les benchmarks
+            printf("\nCSV: %d,%d,%d,%.6f,%.6f,%.6f\n", 
+                   num_procs, num_threads, total_size, 
+                   total_time, comp_time, comm_time);
+        }
+    }
+    
+    // Statistiques du mode --bench (toutes les itérations mesurées)
+    if (opts.bench) {
+        bench_report(&bench, "bucket_sort_hybrid", num_procs, num_threads, total_size, 0,
+                     opts.bench_csv, MPI_COMM_WORLD);
     }
     
+    // Statistiques par phase et par processus (--stats, dernière itération)
+    instr_report("bucket_sort_hybrid", total_size, num_threads, MPI_COMM_WORLD);
+    trace_write(MPI_COMM_WORLD);
+    
     // ============================================
     // Libération de la mémoire
     // ============================================
     
-    free(local_data);
-    free(sendcounts);
-    free(displs);
-    free(bucket_counts);
-    free(bucket_indices);
-    free(recv_counts);
-    free(send_displs);
-    free(recv_displs);
-    free(send_buffer);
-    free(recv_bucket);
-    
-    for (int i = 0; i < num_procs; i++) {
-        free(local_buckets[i]);
-    }
-    free(local_buckets);
+    free_sort_result(&result);
+    bench_free(&bench);
     
     if (rank == 0) {
         free(data);
-        free(sorted_data);
-        free(final_counts);
-        free(final_displs);
+        free(offsets);
     }
     
     MPI_Finalize();
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
 #include <mpi.h>
 
@@ -21,139 +22,1113 @@
 #include <omp.h>
 #endif
 
+#include "instrument.h"
+#include "trace.h"
+#include "bench.h"
+#include "workload.h"
+#include "verify.h"
+#include "partition.h"
+#include "tuning.h"
+#include "argtopk.h"
+#include "stream.h"
+#include "window.h"
+#include "kernels.h"
+#include "sort_kernels.h"
+
 // Configuration par défaut
 #define DEFAULT_SIZE 1000000
 #define MAX_VALUE 1000000
 #define DEFAULT_K 100
 #define DEFAULT_NUM_THREADS 4
 
+// Segment de flux en dessous duquel un seul thread insère (région OpenMP évitée)
+#define PARALLEL_PUSH_MIN 16384
+
+/**
+ * Options de la ligne de commande
+ */
+typedef struct {
+    int total_size;     // Taille du tableau (1er argument positionnel)
+    int k;              // Nombre de valeurs à extraire (2e argument positionnel)
+    int num_threads;    // Threads OpenMP (3e argument positionnel)
+    int stats_format;   // STATS_NONE, STATS_CSV ou STATS_JSON (--stats)
+    const char *trace_path; // Fichier de trace Chrome/Perfetto (--trace), NULL sinon
+    int profile;        // Compteurs matériels par phase (--profile)
+    int bench;          // Mode benchmark intégré (--bench[=W,M])
+    int bench_warmup;   // Itérations de chauffe
+    int bench_reps;     // Itérations mesurées
+    const char *bench_csv;  // Fichier CSV des résultats (--bench-csv=fichier)
+    int dist;           // Distribution des données (--dist=nom, DIST_*)
+    unsigned long long seed;    // Graine du générateur (--seed=n)
+    strategy_t strategy;        // Méthode de fusion (--topk-method=nom)
+    int strategy_auto;  // Méthode lue dans le cache (--strategy=auto)
+    int tune;           // Calibration et mise à jour du cache (--tune)
+    const char *tune_file;      // Cache de calibration (--tune-file=fichier)
+    int argtopk;        // Indices globaux des K plus grands (--argtopk)
+    int payload;        // Colonne de charge utile transportée (--payload)
+    const char *stream_source;  // Source du mode flux (--stream[=source]), NULL sinon
+    int chunk_size;     // Taille des blocs lus (--chunk=n)
+    int snapshot_every; // Instantané global tous les n blocs (--snapshot=n), 0: à la fin
+                        // (fenêtre: requête tous les n blocs, 0: à chaque bloc)
+    long long window_size;      // Fenêtre des W derniers éléments (--window=W), 0 sinon
+    double window_seconds;      // Fenêtre des T dernières secondes (--window=Ts), 0 sinon
+    int num_panes;      // Sous-fenêtres de la fenêtre glissante (--panes=n)
+} options_t;
+
 /**
- * Comparateur pour tri décroissant
+ * Résultat d'une exécution du Top-K
  */
-int compare_int_desc(const void *a, const void *b) {
-    return (*(int*)b - *(int*)a);
+typedef struct {
+    int *topk;                  // K plus grandes valeurs (processus 0)
+    topk_entry_t *entries;      // K entrées (valeur, indice) en mode --argtopk
+    int *local_data;            // Partie locale des données (vérification)
+    int *local_payload;         // Partie locale de la charge utile (--payload)
+    int local_size;
+    double total_time;          // Temps d'exécution (barrière à barrière)
+    double comp_time;           // Temps de calcul
+    double comm_time;           // Temps de communication
+} topk_result_t;
+
+/**
+ * Fusion en tournoi de num_lists listes décroissantes (la liste t commence
+ * à lists + t * stride et compte counts[t] éléments): log2(listes) tours,
+ * les fusions d'un même tour en parallèle, chacune limitée aux K premiers.
+ * buffer: num_lists * stride éléments; lists et counts sont modifiés. Le
+ * résultat est copié dans out; retourne sa taille (au plus K).
+ */
+int tournament_merge(int *lists, int stride, int *counts, int num_lists, int k, int *buffer,
+                     int *out) {
+    int *src = lists;
+    int *dst = buffer;
+    for (int width = 1; width < num_lists; width *= 2) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int s = 0; s < num_lists; s += 2 * width) {
+            double trace_t0 = trace_begin();
+            if (s + width < num_lists) {
+                counts[s] = kernel_merge_topk(src + (size_t)s * stride, counts[s],
+                                              src + (size_t)(s + width) * stride,
+                                              counts[s + width], dst + (size_t)s * stride, k);
+            } else {
+                memcpy(dst + (size_t)s * stride, src + (size_t)s * stride,
+                       counts[s] * sizeof(int));
+            }
+            trace_end("tournament_merge", trace_t0);
+        }
+        int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    int count = (counts[0] < k) ? counts[0] : k;
+    memcpy(out, src, count * sizeof(int));
+    return count;
 }
 
 /**
- * Génère un tableau d'entiers aléatoires (parallélisé avec OpenMP)
+ * Top-K local parallèle: chaque thread sélectionne sur sa tranche les K
+ * plus grands éléments supérieurs ou égaux à threshold (sélection rapide
+ * puis tri des seuls candidats retenus), puis les listes des threads sont
+ * fusionnées en tournoi. local_topk reçoit les candidats en ordre
+ * décroissant, sans bourrage; retourne leur nombre (au plus K).
  */
-void generate_random_array(int *arr, int size, int max_value, unsigned int seed) {
+int select_local_topk(const int *local_data, int local_size, int threshold, int k,
+                      int *local_topk) {
+    int num_threads = 1;
     #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    
+    // Une liste d'au plus min(K, taille locale) candidats par thread
+    int stride = (k < local_size) ? k : local_size;
+    if (stride < 1) stride = 1;
+    int *work = (int*)malloc((local_size + 1) * sizeof(int));
+    int *lists = (int*)malloc((size_t)num_threads * stride * sizeof(int));
+    int *buffer = (int*)malloc((size_t)num_threads * stride * sizeof(int));
+    int *counts = (int*)calloc(num_threads, sizeof(int));
+    
     #pragma omp parallel
     {
-        unsigned int local_seed = seed + omp_get_thread_num();
-        #pragma omp for
-        for (int i = 0; i < size; i++) {
-            arr[i] = rand_r(&local_seed) % max_value;
+        int tid = 0, nt = 1;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        nt = omp_get_num_threads();
+        #endif
+        int start = (int)((long long)tid * local_size / nt);
+        int end = (int)((long long)(tid + 1) * local_size / nt);
+        
+        double trace_t0 = trace_begin();
+        int num_candidates = 0;
+        for (int i = start; i < end; i++) {
+            if (local_data[i] >= threshold) {
+                work[start + num_candidates++] = local_data[i];
+            }
         }
+        counts[tid] = sort_top_desc(work + start, num_candidates, k);
+        memcpy(lists + (size_t)tid * stride, work + start, counts[tid] * sizeof(int));
+        trace_end("select_thread_topk", trace_t0);
     }
-    #else
-    srand(seed);
-    for (int i = 0; i < size; i++) {
-        arr[i] = rand() % max_value;
+    
+    int count = tournament_merge(lists, stride, counts, num_threads, k, buffer, local_topk);
+    
+    free(work);
+    free(lists);
+    free(buffer);
+    free(counts);
+    return count;
+}
+
+/**
+ * Affiche les informations sur l'environnement d'exécution
+ */
+void print_execution_info(int rank, int num_procs, int k) {
+    if (rank == 0) {
+        printf("=== Top-K Hybride (MPI + OpenMP) - Version 2 ===\n");
+        printf("Nombre de processus MPI: %d\n", num_procs);
+        printf("Valeur de K: %d\n", k);
+        
+        #ifdef _OPENMP
+        printf("OpenMP activé: OUI\n");
+        printf("Nombre de threads OpenMP par processus: %d\n", omp_get_max_threads());
+        printf("Nombre total de threads: %d\n", num_procs * omp_get_max_threads());
+        #else
+        printf("OpenMP activé: NON\n");
+        #endif
     }
-    #endif
 }
 
 /**
- * Tri parallèle avec OpenMP
+ * Lecture des arguments: <taille> <K> [threads_omp] [--stats[=csv|json]]
+ *                        [--trace[=fichier.json]] [--profile]
+ *                        [--bench[=W,M]] [--bench-csv=fichier]
+ *                        [--dist=nom] [--seed=n]
+ *                        [--strategy=auto] [--tune] [--tune-file=fichier]
+ *                        [--topk-method=gather|tree|histogram|auto]
+ *                        [--argtopk [--payload]]
+ *                        [--stream[=gen[:N]|-|fichier] [--chunk=n] [--snapshot=n]]
+ *                        [--window=W|Ts [--panes=n]]
  */
-void parallel_sort_desc(int *arr, int size) {
-    #ifdef _OPENMP
-    if (size > 10000) {
-        int num_threads = omp_get_max_threads();
-        int chunk_size = size / num_threads;
+void parse_arguments(int argc, char *argv[], options_t *opts) {
+    int positional = 0;
+    int method = TOPK_TREE;
+    int explicit_method = 0;
+    
+    opts->total_size = DEFAULT_SIZE;
+    opts->k = DEFAULT_K;
+    opts->num_threads = DEFAULT_NUM_THREADS;
+    opts->stats_format = STATS_NONE;
+    opts->trace_path = NULL;
+    opts->profile = 0;
+    opts->bench = 0;
+    opts->bench_csv = NULL;
+    opts->dist = DIST_UNIFORM;
+    opts->seed = WORKLOAD_DEFAULT_SEED;
+    opts->strategy_auto = 0;
+    opts->tune = 0;
+    opts->tune_file = TUNING_DEFAULT_FILE;
+    opts->argtopk = 0;
+    opts->payload = 0;
+    opts->stream_source = NULL;
+    opts->chunk_size = STREAM_DEFAULT_CHUNK;
+    opts->snapshot_every = 0;
+    opts->window_size = 0;
+    opts->window_seconds = 0.0;
+    opts->num_panes = WINDOW_DEFAULT_PANES;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=csv") == 0) {
+            opts->stats_format = STATS_CSV;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            opts->stats_format = STATS_JSON;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opts->trace_path = "trace.json";
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            opts->trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            opts->profile = 1;
+        } else if (bench_parse_option(argv[i], &opts->bench_warmup, &opts->bench_reps)) {
+            opts->bench = 1;
+        } else if (strncmp(argv[i], "--bench-csv=", 12) == 0) {
+            opts->bench_csv = argv[i] + 12;
+        } else if (strncmp(argv[i], "--dist=", 7) == 0) {
+            opts->dist = workload_parse_dist(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            opts->seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strcmp(argv[i], "--strategy=auto") == 0) {
+            opts->strategy_auto = 1;
+        } else if (strcmp(argv[i], "--tune") == 0) {
+            opts->tune = 1;
+        } else if (strncmp(argv[i], "--tune-file=", 12) == 0) {
+            opts->tune_file = argv[i] + 12;
+        } else if (strncmp(argv[i], "--topk-method=", 14) == 0) {
+            method = strategy_parse_choice(argv[i] + 14, topk_method_parse);
+            explicit_method = 1;
+        } else if (strcmp(argv[i], "--argtopk") == 0) {
+            opts->argtopk = 1;
+        } else if (strcmp(argv[i], "--payload") == 0) {
+            opts->argtopk = 1;
+            opts->payload = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            opts->stream_source = "gen";
+        } else if (strncmp(argv[i], "--stream=", 9) == 0) {
+            opts->stream_source = argv[i] + 9;
+        } else if (strncmp(argv[i], "--chunk=", 8) == 0) {
+            opts->chunk_size = atoi(argv[i] + 8);
+            if (opts->chunk_size < 1) opts->chunk_size = STREAM_DEFAULT_CHUNK;
+        } else if (strncmp(argv[i], "--snapshot=", 11) == 0) {
+            opts->snapshot_every = atoi(argv[i] + 11);
+            if (opts->snapshot_every < 0) opts->snapshot_every = 0;
+        } else if (strncmp(argv[i], "--window=", 9) == 0) {
+            // "W": nombre d'éléments, "Ts": durée en secondes
+            const char *spec = argv[i] + 9;
+            if (spec[0] != '\0' && spec[strlen(spec) - 1] == 's') {
+                opts->window_seconds = atof(spec);
+            } else {
+                opts->window_size = atoll(spec);
+            }
+        } else if (strncmp(argv[i], "--panes=", 8) == 0) {
+            opts->num_panes = atoi(argv[i] + 8);
+            if (opts->num_panes < 1) opts->num_panes = WINDOW_DEFAULT_PANES;
+        } else if (positional == 0) {
+            opts->total_size = atoi(argv[i]);
+            positional++;
+        } else if (positional == 1) {
+            opts->k = atoi(argv[i]);
+            positional++;
+        } else if (positional == 2) {
+            opts->num_threads = atoi(argv[i]);
+            positional++;
+        }
+    }
+    
+    // La fenêtre glissante porte sur un flux (générateur par défaut)
+    if ((opts->window_size > 0 || opts->window_seconds > 0) && opts->stream_source == NULL) {
+        opts->stream_source = "gen";
+    }
+    
+    // --strategy=auto: méthode lue dans le cache si elle n'est pas imposée
+    if (opts->strategy_auto && !explicit_method) {
+        method = STRATEGY_AUTO;
+    }
+    strategy_init(&opts->strategy, -1, -1, method);
+}
+
+/**
+ * Exécution chronométrée du Top-K (étapes 1 à 3) à partir des données du
+ * processus 0, qui ne sont pas modifiées, avec la méthode de fusion donnée
+ * (TOPK_*)
+ */
+void run_topk(int *data, int total_size, int k, int method, int rank, int num_procs,
+              topk_result_t *result) {
+    result->comp_time = 0;
+    result->comm_time = 0;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    // ============================================
+    // ÉTAPE 1: Distribution des données (MPI_Scatterv)
+    // ============================================
+    double comm_start = MPI_Wtime();
+    
+    int base_size = total_size / num_procs;
+    int remainder = total_size % num_procs;
+    int local_size = base_size + (rank < remainder ? 1 : 0);
+    
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
+    }
+    
+    int *local_data = (int*)malloc(local_size * sizeof(int));
+    
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    
+    instr_stop(PHASE_SCATTER, comm_start);
+    result->comm_time += MPI_Wtime() - comm_start;
+    
+    // ============================================
+    // ÉTAPE 2: Extraction locale des K max (parallélisé avec OpenMP)
+    // ============================================
+    double comp_start = MPI_Wtime();
+    
+    int *local_topk = (int*)malloc((k + 1) * sizeof(int));
+    int threshold = INT_MIN;
+    if (method == TOPK_HISTOGRAM) {
+        // Seuil global par histogramme (MPI_Allreduce): seuls les éléments
+        // au-dessus du seuil sont candidats
+        threshold = topk_histogram_threshold(local_data, local_size, k, MAX_VALUE,
+                                             MPI_COMM_WORLD);
+    }
+    int local_count = select_local_topk(local_data, local_size, threshold, k, local_topk);
+    instr_set_bucket_size(local_size);
+    
+    instr_stop(PHASE_SELECT, comp_start);
+    result->comp_time += MPI_Wtime() - comp_start;
+    
+    // ============================================
+    // ÉTAPE 3: Fusion des Top-K locaux
+    // ============================================
+    
+    // Seuls les candidats effectifs circulent (au plus K par processus,
+    // moins si la partie locale est plus petite): pas de valeurs de bourrage
+    if (method == TOPK_GATHER) {
+        // Rassemblement direct: le processus 0 reçoit les p listes
+        // (MPI_Gather des tailles, MPI_Gatherv des candidats, liste r à
+        // r * K) et les fusionne en tournoi
+        int *counts = NULL;
+        int *displs_topk = NULL;
+        int *all_topk = NULL;
+        if (rank == 0) {
+            counts = (int*)malloc(num_procs * sizeof(int));
+            displs_topk = (int*)malloc(num_procs * sizeof(int));
+            all_topk = (int*)malloc((size_t)k * num_procs * sizeof(int));
+            for (int r = 0; r < num_procs; r++) {
+                displs_topk[r] = r * k;
+            }
+        }
         
-        #pragma omp parallel
-        {
-            int tid = omp_get_thread_num();
-            int start = tid * chunk_size;
-            int end = (tid == num_threads - 1) ? size : start + chunk_size;
-            
-            qsort(arr + start, end - start, sizeof(int), compare_int_desc);
+        comm_start = MPI_Wtime();
+        TRACED("MPI_Gather",
+               MPI_Gather(&local_count, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD));
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(local_topk, local_count, MPI_INT, all_topk, counts, displs_topk,
+                           MPI_INT, 0, MPI_COMM_WORLD));
+        instr_stop(PHASE_GATHER, comm_start);
+        long long received = 0;
+        if (rank == 0) {
+            for (int r = 0; r < num_procs; r++) received += counts[r];
         }
+        instr_add_bytes((long long)local_count * sizeof(int), received * sizeof(int));
+        result->comm_time += MPI_Wtime() - comm_start;
         
-        // Fusion finale
-        qsort(arr, size, sizeof(int), compare_int_desc);
+        if (rank == 0) {
+            comp_start = MPI_Wtime();
+            int *buffer = (int*)malloc((size_t)k * num_procs * sizeof(int));
+            local_count = tournament_merge(all_topk, k, counts, num_procs, k, buffer,
+                                           local_topk);
+            free(buffer);
+            instr_stop(PHASE_MERGE, comp_start);
+            result->comp_time += MPI_Wtime() - comp_start;
+        }
+        free(counts);
+        free(displs_topk);
+        free(all_topk);
     } else {
-        qsort(arr, size, sizeof(int), compare_int_desc);
+        // Arbre binomial: les enfants de rank sont rank + 1, rank + 2,
+        // rank + 4... tant que rank est multiple du double du pas; son
+        // parent est rank moins son bit de poids faible. Les réceptions de
+        // tous les enfants sont postées d'avance (au plus K éléments
+        // chacune, taille effective par MPI_Get_count) et chaque liste est
+        // fusionnée dès son arrivée, pendant que les autres transitent.
+        int step = 1;
+        int num_children = 0;
+        while (step < num_procs && rank % (2 * step) == 0) {
+            if (rank + step < num_procs) num_children++;
+            step *= 2;
+        }
+        
+        int *recv_topk = (int*)malloc(((size_t)num_children * k + 1) * sizeof(int));
+        int *merged_topk = (int*)malloc((k + 1) * sizeof(int));
+        MPI_Request *requests = (MPI_Request*)malloc((num_children + 1) * sizeof(MPI_Request));
+        
+        comm_start = MPI_Wtime();
+        for (int c = 0; c < num_children; c++) {
+            MPI_Irecv(recv_topk + (size_t)c * k, k, MPI_INT, rank + (1 << c), 0,
+                      MPI_COMM_WORLD, &requests[c]);
+        }
+        result->comm_time += MPI_Wtime() - comm_start;
+        
+        for (int received = 0; received < num_children; received++) {
+            int c, count;
+            MPI_Status status;
+            comm_start = MPI_Wtime();
+            TRACED("MPI_Waitany",
+                   MPI_Waitany(num_children, requests, &c, &status));
+            MPI_Get_count(&status, MPI_INT, &count);
+            instr_stop(PHASE_DATA_EXCHANGE, comm_start);
+            instr_add_bytes(0, (long long)count * sizeof(int));
+            result->comm_time += MPI_Wtime() - comm_start;
+            
+            comp_start = MPI_Wtime();
+            local_count = kernel_merge_topk(local_topk, local_count, recv_topk + (size_t)c * k,
+                                            count, merged_topk, k);
+            int *tmp = local_topk;
+            local_topk = merged_topk;
+            merged_topk = tmp;
+            instr_stop(PHASE_MERGE, comp_start);
+            result->comp_time += MPI_Wtime() - comp_start;
+        }
+        
+        if (rank != 0) {
+            comm_start = MPI_Wtime();
+            TRACED("MPI_Send",
+                   MPI_Send(local_topk, local_count, MPI_INT, rank - step, 0, MPI_COMM_WORLD));
+            instr_stop(PHASE_DATA_EXCHANGE, comm_start);
+            instr_add_bytes((long long)local_count * sizeof(int), 0);
+            result->comm_time += MPI_Wtime() - comm_start;
+        }
+        
+        free(recv_topk);
+        free(merged_topk);
+        free(requests);
     }
-    #else
-    qsort(arr, size, sizeof(int), compare_int_desc);
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    result->total_time = MPI_Wtime() - start_time;
+    
+    result->topk = local_topk;
+    result->local_data = local_data;
+    result->local_size = local_size;
+    
+    free(sendcounts);
+    free(displs);
+}
+
+/**
+ * Arg-top-K (--argtopk): comme run_topk, mais chaque candidat porte son
+ * indice global (et sa charge utile). Chaque thread sélectionne ses K
+ * premiers sur sa tranche, les listes des threads sont fusionnées, puis
+ * les processus fusionnent leurs candidats (départage par indice).
+ */
+void run_argtopk(int *data, int *payload, int with_payload, int total_size, int k, int method,
+                 int rank, int num_procs, topk_result_t *result) {
+    result->comp_time = 0;
+    result->comm_time = 0;
+    result->topk = NULL;
+    result->local_payload = NULL;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    // ============================================
+    // ÉTAPE 1: Distribution des données (et de la charge utile)
+    // ============================================
+    double comm_start = MPI_Wtime();
+    
+    int base_size = total_size / num_procs;
+    int remainder = total_size % num_procs;
+    int local_size = base_size + (rank < remainder ? 1 : 0);
+    
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
+    }
+    
+    int *local_data = (int*)malloc((local_size + 1) * sizeof(int));
+    int *local_payload = NULL;
+    
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    if (with_payload) {
+        local_payload = (int*)malloc((local_size + 1) * sizeof(int));
+        TRACED("MPI_Scatterv",
+               MPI_Scatterv(payload, sendcounts, displs, MPI_INT,
+                            local_payload, local_size, MPI_INT,
+                            0, MPI_COMM_WORLD));
+    }
+    
+    instr_stop(PHASE_SCATTER, comm_start);
+    result->comm_time += MPI_Wtime() - comm_start;
+    
+    // ============================================
+    // ÉTAPE 2: Sélection locale (un Top-K par thread, puis fusion)
+    // ============================================
+    int min_value = INT_MIN;
+    if (method == TOPK_HISTOGRAM) {
+        comm_start = MPI_Wtime();
+        min_value = topk_histogram_threshold(local_data, local_size, k, MAX_VALUE,
+                                             MPI_COMM_WORLD);
+        result->comm_time += MPI_Wtime() - comm_start;
+    }
+    
+    double comp_start = MPI_Wtime();
+    
+    int num_threads = 1;
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
     #endif
+    
+    topk_entry_t *thread_topk = (topk_entry_t*)malloc((size_t)num_threads * k * sizeof(topk_entry_t));
+    int *thread_count = (int*)calloc(num_threads, sizeof(int));
+    
+    #pragma omp parallel
+    {
+        int tid = 0, nt = 1;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        nt = omp_get_num_threads();
+        #endif
+        int chunk = local_size / nt;
+        int start = tid * chunk;
+        int end = (tid == nt - 1) ? local_size : start + chunk;
+        
+        thread_count[tid] = argtopk_select(local_data + start,
+                                           local_payload ? local_payload + start : NULL,
+                                           end - start, (long long)displs[rank] + start, k,
+                                           min_value, thread_topk + (size_t)tid * k);
+    }
+    
+    // Fusion séquentielle des listes des threads (au plus K entrées chacune)
+    topk_entry_t *local_topk = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    topk_entry_t *merged = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    int local_k = thread_count[0];
+    memcpy(local_topk, thread_topk, local_k * sizeof(topk_entry_t));
+    for (int t = 1; t < num_threads; t++) {
+        local_k = argtopk_merge(local_topk, local_k, thread_topk + (size_t)t * k,
+                                thread_count[t], k, merged);
+        topk_entry_t *swap = local_topk;
+        local_topk = merged;
+        merged = swap;
+    }
+    instr_set_bucket_size(local_size);
+    
+    instr_stop(PHASE_SELECT, comp_start);
+    result->comp_time += MPI_Wtime() - comp_start;
+    
+    // ============================================
+    // ÉTAPE 3: Fusion des candidats des processus
+    // ============================================
+    comm_start = MPI_Wtime();
+    result->entries = argtopk_reduce(local_topk, local_k, k, method, MPI_COMM_WORLD);
+    result->comm_time += MPI_Wtime() - comm_start;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    result->total_time = MPI_Wtime() - start_time;
+    
+    result->local_data = local_data;
+    result->local_payload = local_payload;
+    result->local_size = local_size;
+    
+    free(sendcounts);
+    free(displs);
+    free(thread_topk);
+    free(thread_count);
+    free(local_topk);
+    free(merged);
+}
+
+/**
+ * Fusionne les tas des threads en une liste décroissante d'au plus K
+ * éléments (out; tmp et merged sont des tampons de K + 1 éléments).
+ * Retourne le nombre d'éléments.
+ */
+int merge_thread_heaps(const topk_heap_t *heaps, int num_threads, int k, int *out, int *tmp,
+                       int *merged) {
+    int count = topk_heap_sorted(&heaps[0], out);
+    for (int t = 1; t < num_threads; t++) {
+        int thread_count = topk_heap_sorted(&heaps[t], tmp);
+        count = kernel_merge_topk(out, count, tmp, thread_count, merged, k);
+        memcpy(out, merged, count * sizeof(int));
+    }
+    return count;
 }
 
 /**
- * Extraction parallèle des K plus grandes valeurs locales
- * Utilise un heap ou tri partiel pour optimiser
+ * Insère un segment de flux dans les tas des threads (un tas par thread;
+ * le tas du thread 0 seul pour un segment court)
  */
-void extract_local_topk(int *local_data, int local_size, int *local_topk, int k) {
-    // Tri partiel: on ne trie que ce qui est nécessaire pour obtenir les K premiers
-    // Pour simplifier, on utilise qsort complet puis copie des K premiers
-    // Une optimisation serait d'utiliser un heap ou quickselect
+void push_thread_heaps(topk_heap_t *heaps, long long *thread_inserted, const int *values,
+                       int count) {
+    #pragma omp parallel if (count >= PARALLEL_PUSH_MIN)
+    {
+        int tid = 0, nt = 1;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        nt = omp_get_num_threads();
+        #endif
+        int part = count / nt;
+        int start = tid * part;
+        int end = (tid == nt - 1) ? count : start + part;
+        thread_inserted[tid] += topk_heap_push_chunk(&heaps[tid], values + start, end - start);
+    }
+}
+
+/**
+ * Mode --stream: chaque processus consomme sa source par blocs (lecture en
+ * double tampon par un thread dédié); chaque bloc est partagé entre les
+ * threads OpenMP, qui gardent chacun un tas de K éléments. Avant chaque
+ * instantané global (tous les snapshot_every blocs, ou à la fin du flux),
+ * les tas des threads sont fusionnés. La mémoire reste en
+ * O(threads x K + bloc). Retourne 0 si la source ne peut pas être ouverte.
+ */
+int run_stream(const options_t *opts, int k, int rank, int num_procs, int num_threads) {
+    stream_t stream;
     
-    int *temp = (int*)malloc(local_size * sizeof(int));
-    memcpy(temp, local_data, local_size * sizeof(int));
+    int status = stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                             rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+    int all_opened;
+    int opened = (status == 0);
+    MPI_Allreduce(&opened, &all_opened, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_opened) {
+        if (!opened) {
+            fprintf(stderr, "Erreur: processus %d: source %s illisible\n", rank,
+                    opts->stream_source);
+        } else {
+            stream_close(&stream);
+        }
+        return 0;
+    }
     
-    parallel_sort_desc(temp, local_size);
+    topk_heap_t *heaps = (topk_heap_t*)malloc(num_threads * sizeof(topk_heap_t));
+    long long *thread_inserted = (long long*)calloc(num_threads, sizeof(long long));
+    for (int t = 0; t < num_threads; t++) {
+        topk_heap_init(&heaps[t], k);
+    }
+    int *local_topk = (int*)malloc((k + 1) * sizeof(int));
+    int *thread_topk = (int*)malloc((k + 1) * sizeof(int));
+    int *merged = (int*)malloc((k + 1) * sizeof(int));
+    int *global_topk = (int*)malloc((k + 1) * sizeof(int));
+    int global_count = 0;
+    long long consumed = 0;
+    long long totals[2] = { 0, 0 };
+    int snapshots = 0;
     
-    int copy_size = (k < local_size) ? k : local_size;
-    memcpy(local_topk, temp, copy_size * sizeof(int));
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
     
-    // Si local_size < k, remplir avec des valeurs minimales
-    for (int i = copy_size; i < k; i++) {
-        local_topk[i] = -1;
+    int active = 1;
+    for (;;) {
+        for (int c = 0; active && (opts->snapshot_every == 0 || c < opts->snapshot_every); c++) {
+            const int *chunk;
+            // Attente du thread de lecture
+            double t0 = instr_start();
+            int count = stream_next(&stream, &chunk);
+            instr_stop(PHASE_SCATTER, t0);
+            if (count == 0) {
+                active = 0;
+                break;
+            }
+            
+            t0 = instr_start();
+            push_thread_heaps(heaps, thread_inserted, chunk, count);
+            instr_stop(PHASE_SELECT, t0);
+            consumed += count;
+        }
+        
+        // Fusion des tas des threads puis instantané global
+        double t0 = instr_start();
+        int local_count = merge_thread_heaps(heaps, num_threads, k, local_topk, thread_topk,
+                                             merged);
+        int any_active = topk_snapshot(local_topk, local_count, k, active, global_topk,
+                                       &global_count, MPI_COMM_WORLD);
+        long long local_totals[2] = { consumed, 0 };
+        for (int t = 0; t < num_threads; t++) {
+            local_totals[1] += thread_inserted[t];
+        }
+        TRACED("MPI_Reduce",
+               MPI_Reduce(local_totals, totals, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+        instr_stop(PHASE_MERGE, t0);
+        snapshots++;
+        
+        if (rank == 0 && opts->snapshot_every > 0 && global_count > 0) {
+            printf("Instantané %d: %lld éléments lus, max %d, %d-ième %d (%.3f s)\n",
+                   snapshots, totals[0], global_topk[0], global_count,
+                   global_topk[global_count - 1], MPI_Wtime() - start_time);
+        }
+        if (!any_active) break;
     }
     
-    free(temp);
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double total_time = MPI_Wtime() - start_time;
+    stream_close(&stream);
+    instr_set_bucket_size(consumed);
+    
+    // Vérification: seconde lecture de la source (sauf entrée standard)
+    int correct = -1;
+    if (stream_rereadable(opts->stream_source)) {
+        topk_tally_t tally;
+        double t0 = instr_start();
+        topk_tally_init(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                    rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+        const int *chunk;
+        int count;
+        while ((count = stream_next(&stream, &chunk)) > 0) {
+            topk_tally_add(&tally, chunk, count);
+        }
+        stream_close(&stream);
+        correct = topk_tally_check(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_VERIFY, t0);
+    }
+    
+    if (rank == 0) {
+        printf("\n=== Résultats (flux) ===\n");
+        printf("Top-K (%d premières valeurs): ", global_count < 10 ? global_count : 10);
+        for (int i = 0; i < global_count && i < 10; i++) {
+            printf("%d ", global_topk[i]);
+        }
+        printf("\n");
+        if (global_count < k) {
+            printf("Flux plus court que K: %d éléments retenus\n", global_count);
+        }
+        printf("Éléments lus: %lld (%d instantanés)\n", totals[0], snapshots);
+        printf("Rejetés en une comparaison: %.2f%%\n",
+               totals[0] > 0 ? 100.0 * (totals[0] - totals[1]) / totals[0] : 0.0);
+        printf("Mémoire par processus: %.1f Ko (%d tas de K + 2 blocs de %d)\n",
+               ((double)num_threads * k + 2.0 * opts->chunk_size) * sizeof(int) / 1024.0,
+               num_threads, opts->chunk_size);
+        if (correct < 0) {
+            printf("Valeurs correctes: non vérifiées (entrée standard)\n");
+        } else {
+            printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
+        }
+        printf("Temps total: %.6f secondes (%.2f millions d'éléments/s)\n", total_time,
+               total_time > 0 ? totals[0] / total_time / 1e6 : 0.0);
+        printf("\nCSV: %d,%d,%lld,%d,%.6f\n", num_procs, num_threads, totals[0], k, total_time);
+    }
+    
+    for (int t = 0; t < num_threads; t++) {
+        topk_heap_free(&heaps[t]);
+    }
+    free(heaps);
+    free(thread_inserted);
+    free(local_topk);
+    free(thread_topk);
+    free(merged);
+    free(global_topk);
+    return 1;
 }
 
 /**
- * Fusion parallèle de deux tableaux triés en décroissant
- * Garde seulement les K plus grandes valeurs
+ * Bloc suivant du flux de --window et sa place dans l'ordre global. Les
+ * processus avancent d'un bloc à la fois (un processus sans données compte
+ * un bloc vide) et s'échangent la taille de leur bloc (MPI_Allgather):
+ * l'ordre global est celui des pas, puis des rangs dans un pas, soit
+ * l'ordre des blocs du générateur (bloc b pour le processus b % p) ou de
+ * lecture d'une source lue par le processus 0 seul. cut est la décision
+ * du processus 0 de terminer la sous-fenêtre (fenêtre de T secondes),
+ * rendue à tous. Écrit la position globale du premier élément local dans
+ * *position et le nombre d'éléments du pas (tous processus) dans
+ * *step_total; retourne le nombre d'éléments locaux. Opération collective.
  */
-void merge_topk(int *arr1, int size1, int *arr2, int size2, int *result, int k) {
-    int i = 0, j = 0, r = 0;
-    
-    while (r < k && (i < size1 || j < size2)) {
-        if (i >= size1) {
-            result[r++] = arr2[j++];
-        } else if (j >= size2) {
-            result[r++] = arr1[i++];
-        } else if (arr1[i] >= arr2[j]) {
-            result[r++] = arr1[i++];
+static int next_global_chunk(stream_t *stream, int *active, const int **chunk,
+                             long long consumed, int *cut, int *exchange,
+                             long long *position, long long *step_total) {
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    int count = *active ? stream_next(stream, chunk) : 0;
+    if (count == 0) {
+        *active = 0;
+    }
+    
+    int local[2] = { count, *cut };
+    TRACED("MPI_Allgather",
+           MPI_Allgather(local, 2, MPI_INT, exchange, 2, MPI_INT, MPI_COMM_WORLD));
+    *cut = exchange[1];
+    *position = consumed;
+    *step_total = 0;
+    for (int r = 0; r < num_procs; r++) {
+        if (r < rank) {
+            *position += exchange[2 * r];
+        }
+        *step_total += exchange[2 * r];
+    }
+    return count;
+}
+
+/**
+ * Mode --window: Top-K des W derniers éléments (ou des T dernières
+ * secondes) du flux. Les éléments sont numérotés dans l'ordre global du
+ * flux (next_global_chunk) et les sous-fenêtres sont des intervalles de
+ * positions globales de W / panes éléments, communs à tous les processus
+ * (ou coupées au même pas sur l'horloge du processus 0). Chaque processus
+ * insère ses éléments dans les tas des threads (sous-fenêtre courante); à
+ * la fin d'une sous-fenêtre, son résumé entre dans l'anneau (window.h), le
+ * plus ancien expirant. Une requête (tous les snapshot_every blocs) fusionne
+ * l'anneau localement, sans les éléments de position inférieure à
+ * total - W, puis entre processus (topk_snapshot). Retourne 0 si la source
+ * ne peut pas être ouverte.
+ */
+int run_window(const options_t *opts, int k, int rank, int num_procs, int num_threads) {
+    stream_t stream;
+    
+    int status = stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                             rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+    int all_opened;
+    int opened = (status == 0);
+    MPI_Allreduce(&opened, &all_opened, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_opened) {
+        if (!opened) {
+            fprintf(stderr, "Erreur: processus %d: source %s illisible\n", rank,
+                    opts->stream_source);
+        } else {
+            stream_close(&stream);
+        }
+        return 0;
+    }
+    
+    // Sous-fenêtres de pane_size positions globales ou de pane_seconds secondes
+    int timed = (opts->window_size <= 0);
+    long long pane_size = (opts->window_size + opts->num_panes - 1) / opts->num_panes;
+    if (pane_size < 1) pane_size = 1;
+    double pane_seconds = opts->window_seconds / opts->num_panes;
+    int query_every = (opts->snapshot_every > 0) ? opts->snapshot_every : 1;
+    
+    topk_window_t window;
+    topk_window_init(&window, k, opts->num_panes, !timed);
+    topk_heap_t *heaps = (topk_heap_t*)malloc(num_threads * sizeof(topk_heap_t));
+    long long *thread_inserted = (long long*)calloc(num_threads, sizeof(long long));
+    for (int t = 0; t < num_threads; t++) {
+        topk_heap_init(&heaps[t], k);
+    }
+    int *exchange = (int*)malloc(2 * num_procs * sizeof(int));
+    int *current = (int*)malloc((k + 1) * sizeof(int));
+    int *local_topk = (int*)malloc((k + 1) * sizeof(int));
+    int *thread_topk = (int*)malloc((k + 1) * sizeof(int));
+    int *merged = (int*)malloc((k + 1) * sizeof(int));
+    int *global_topk = (int*)malloc((k + 1) * sizeof(int));
+    int global_count = 0;
+    long long consumed = 0;         // Éléments du flux (tous processus) traités
+    long long pane_start = 0;       // Position globale de la sous-fenêtre courante
+    long long window_start = 0;     // Plus ancienne position couverte
+    long long window_memory = 0;    // Pic de mémoire de l'anneau
+    double update_time = 0.0, query_time = 0.0, query_max = 0.0;
+    int num_queries = 0;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    double pane_time = start_time;
+    
+    int active = 1;
+    int finished = 0;
+    while (!finished) {
+        for (int c = 0; c < query_every; c++) {
+            const int *chunk = NULL;
+            long long position, step_total;
+            // Attente du thread de lecture et place du bloc dans le flux
+            double t0 = instr_start();
+            int cut = timed && rank == 0 && MPI_Wtime() - pane_time >= pane_seconds;
+            int count = next_global_chunk(&stream, &active, &chunk, consumed, &cut, exchange,
+                                          &position, &step_total);
+            instr_stop(PHASE_SCATTER, t0);
+            if (step_total == 0) {
+                finished = 1;
+                break;
+            }
+            
+            // Mise à jour: arrivée des éléments, expiration par sous-fenêtre
+            t0 = instr_start();
+            double update_start = MPI_Wtime();
+            if (timed) {
+                if (cut) {
+                    int pane_count = merge_thread_heaps(heaps, num_threads, k, current,
+                                                        thread_topk, merged);
+                    topk_window_push_pane(&window, current, pane_count, pane_start);
+                    for (int t = 0; t < num_threads; t++) heaps[t].size = 0;
+                    pane_start = consumed;
+                    pane_time = update_start;
+                }
+                push_thread_heaps(heaps, thread_inserted, chunk, count);
+            } else {
+                // Parcours du pas par sous-fenêtre: chaque processus y insère
+                // ses éléments, et tous terminent la sous-fenêtre ensemble
+                long long step_end = consumed + step_total;
+                long long pos = consumed;
+                while (pos < step_end) {
+                    long long pane_end = pane_start + pane_size;
+                    long long seg_end = (pane_end < step_end) ? pane_end : step_end;
+                    long long lo = (pos > position) ? pos : position;
+                    long long hi = (seg_end < position + count) ? seg_end : position + count;
+                    if (hi > lo) {
+                        push_thread_heaps(heaps, thread_inserted, chunk + (lo - position),
+                                          (int)(hi - lo));
+                        topk_window_append(&window, chunk + (lo - position), (int)(hi - lo), lo);
+                    }
+                    pos = seg_end;
+                    if (pos == pane_end) {
+                        topk_window_seal_pane(&window, pane_start);
+                        for (int t = 0; t < num_threads; t++) heaps[t].size = 0;
+                        pane_start = pane_end;
+                    }
+                }
+            }
+            consumed += step_total;
+            long long memory = topk_window_memory(&window);
+            if (memory > window_memory) window_memory = memory;
+            update_time += MPI_Wtime() - update_start;
+            instr_stop(PHASE_SELECT, t0);
+        }
+        
+        // Requête: fusion locale de l'anneau puis fusion entre processus
+        double t0 = instr_start();
+        double query_start = MPI_Wtime();
+        if (timed) {
+            window_start = topk_window_start(&window, pane_start);
+        } else {
+            window_start = (consumed > opts->window_size) ? consumed - opts->window_size : 0;
+        }
+        int current_count = merge_thread_heaps(heaps, num_threads, k, current, thread_topk,
+                                               merged);
+        int local_count = topk_window_query(&window, current, current_count, window_start,
+                                            local_topk);
+        topk_snapshot(local_topk, local_count, k, !finished, global_topk, &global_count,
+                      MPI_COMM_WORLD);
+        double latency = MPI_Wtime() - query_start;
+        instr_stop(PHASE_MERGE, t0);
+        query_time += latency;
+        if (latency > query_max) query_max = latency;
+        num_queries++;
+    }
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double total_time = MPI_Wtime() - start_time;
+    stream_close(&stream);
+    instr_set_bucket_size(consumed - window_start);
+    
+    // Vérification: seconde lecture de la source, limitée aux positions
+    // globales [window_start, consumed)
+    int correct = -1;
+    if (stream_rereadable(opts->stream_source)) {
+        topk_tally_t tally;
+        double t0 = instr_start();
+        topk_tally_init(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                    rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+        const int *chunk = NULL;
+        long long seen = 0, position, step_total;
+        active = 1;
+        for (;;) {
+            int cut = 0;
+            int count = next_global_chunk(&stream, &active, &chunk, seen, &cut, exchange,
+                                          &position, &step_total);
+            if (step_total == 0) break;
+            long long skip = window_start - position;
+            if (skip < count) {
+                int first = (skip > 0) ? (int)skip : 0;
+                topk_tally_add(&tally, chunk + first, count - first);
+            }
+            seen += step_total;
+        }
+        stream_close(&stream);
+        correct = topk_tally_check(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_VERIFY, t0);
+    }
+    
+    // Débit de mise à jour et mémoire (processus le plus lent, le plus
+    // chargé) et latence des requêtes
+    double local_stats[3] = { update_time, query_max,
+                              (double)window_memory + ((double)num_threads * k +
+                                                       2.0 * opts->chunk_size) * sizeof(int) };
+    double stats[3];
+    TRACED("MPI_Reduce",
+           MPI_Reduce(local_stats, stats, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD));
+    
+    if (rank == 0) {
+        long long covered = consumed - window_start;
+        double update_rate = (stats[0] > 0) ? consumed / stats[0] / 1e6 : 0.0;
+        double query_mean = (num_queries > 0) ? query_time / num_queries : 0.0;
+        printf("\n=== Résultats (fenêtre glissante) ===\n");
+        printf("Top-K (%d premières valeurs): ", global_count < 10 ? global_count : 10);
+        for (int i = 0; i < global_count && i < 10; i++) {
+            printf("%d ", global_topk[i]);
+        }
+        printf("\n");
+        printf("Éléments lus: %lld, fenêtre finale: %lld éléments, positions [%lld, %lld) "
+               "(%d sous-fenêtres)\n", consumed, covered, window_start, consumed,
+               opts->num_panes);
+        printf("Mémoire par processus (maximum): %.1f Ko (%s, %d tas de K, 2 blocs de %d)\n",
+               stats[2] / 1024.0, timed ? "résumés de K" : "K-skybands et sous-fenêtre courante",
+               num_threads, opts->chunk_size);
+        if (correct < 0) {
+            printf("Valeurs correctes: non vérifiées (entrée standard)\n");
         } else {
-            result[r++] = arr2[j++];
+            printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
         }
+        printf("Débit de mise à jour: %.2f millions d'éléments/s\n", update_rate);
+        printf("Requêtes: %d, latence moyenne %.1f us, maximale %.1f us\n", num_queries,
+               query_mean * 1e6, stats[1] * 1e6);
+        printf("Temps total: %.6f secondes\n", total_time);
+        printf("\nCSV: %d,%d,%lld,%d,%d,%.3f,%.3f,%.3f\n", num_procs, num_threads, covered, k,
+               opts->num_panes, update_rate, query_mean * 1e6, stats[1] * 1e6);
+    }
+    
+    topk_window_free(&window);
+    for (int t = 0; t < num_threads; t++) {
+        topk_heap_free(&heaps[t]);
     }
+    free(heaps);
+    free(thread_inserted);
+    free(exchange);
+    free(current);
+    free(local_topk);
+    free(thread_topk);
+    free(merged);
+    free(global_topk);
+    return 1;
 }
 
 /**
- * Affiche les informations sur l'environnement d'exécution
+ * Calibration (--tune): chaque méthode de fusion est exécutée sur les
+ * données courantes; la plus rapide (meilleur temps, processus le plus
+ * lent) est enregistrée dans le cache pour cette classe de taille et de K
  */
-void print_execution_info(int rank, int num_procs, int k) {
+int tune_topk(int *data, options_t *opts, int k, int rank, int num_procs, int num_threads) {
+    double local_times[NUM_TOPK_METHODS];
+    double times[NUM_TOPK_METHODS];
+    topk_result_t trial;
+    
+    for (int m = 0; m < NUM_TOPK_METHODS; m++) {
+        local_times[m] = 1e30;
+        for (int rep = 0; rep < 3; rep++) {
+            run_topk(data, opts->total_size, k, m, rank, num_procs, &trial);
+            if (trial.total_time < local_times[m]) local_times[m] = trial.total_time;
+            free(trial.topk);
+            free(trial.local_data);
+        }
+    }
+    MPI_Allreduce(local_times, times, NUM_TOPK_METHODS, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    
+    int best = 0;
+    for (int m = 1; m < NUM_TOPK_METHODS; m++) {
+        if (times[m] < times[best]) best = m;
+    }
     if (rank == 0) {
-        printf("=== Top-K Hybride (MPI + OpenMP) - Version 2 ===\n");
-        printf("Nombre de processus MPI: %d\n", num_procs);
-        printf("Valeur de K: %d\n", k);
-        
-        #ifdef _OPENMP
-        printf("OpenMP activé: OUI\n");
-        printf("Nombre de threads OpenMP par processus: %d\n", omp_get_max_threads());
-        printf("Nombre total de threads: %d\n", num_procs * omp_get_max_threads());
-        #else
-        printf("OpenMP activé: NON\n");
-        #endif
+        printf("Calibration:");
+        for (int m = 0; m < NUM_TOPK_METHODS; m++) {
+            printf(" %s %.6f s%s", topk_method_name(m), times[m],
+                   m < NUM_TOPK_METHODS - 1 ? "," : "\n");
+        }
     }
+    
+    opts->strategy.topk_method = best;
+    tuning_store(opts->tune_file, "topk_hybrid", num_procs, num_threads, opts->total_size, k,
+                 &opts->strategy, MPI_COMM_WORLD);
+    return best;
 }
 
 int main(int argc, char *argv[]) {
     int rank, num_procs;
     int *data = NULL;
+    int *payload = NULL;
     int total_size, k;
-    int num_threads = DEFAULT_NUM_THREADS;
-    double start_time, end_time, total_time;
-    double comm_time = 0, comp_time = 0;
+    int num_threads;
+    double total_time, comm_time, comp_time;
+    options_t opts;
+    topk_result_t result;
+    bench_t bench;
     
     // Initialisation MPI avec support des threads
     int provided;
@@ -163,27 +1138,97 @@ int main(int argc, char *argv[]) {
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     
     // Lecture des arguments
-    total_size = (argc > 1) ? atoi(argv[1]) : DEFAULT_SIZE;
-    k = (argc > 2) ? atoi(argv[2]) : DEFAULT_K;
-    if (argc > 3) {
-        num_threads = atoi(argv[3]);
+    parse_arguments(argc, argv, &opts);
+    total_size = opts.total_size;
+    k = opts.k;
+    num_threads = opts.num_threads;
+    instr_init(opts.stats_format, opts.trace_path != NULL || opts.bench);
+    
+    // Vérification de la distribution
+    if (opts.dist < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: distribution inconnue (uniform, zipf, gaussian, sorted, "
+                    "reverse, nearly-sorted, all-equal, few-unique)\n");
+        }
+        MPI_Finalize();
+        return 1;
     }
     
-    // Validation de K
-    if (k > total_size) {
+    // Validation de K (la longueur d'un flux n'est pas connue à l'avance)
+    if (k > total_size && opts.stream_source == NULL) {
         k = total_size;
     }
     
     // Configuration OpenMP
     #ifdef _OPENMP
     omp_set_num_threads(num_threads);
+    num_threads = omp_get_max_threads();
+    #else
+    num_threads = 1;
     #endif
     
+    // Compteurs matériels de chaque thread (--profile)
+    if (opts.profile) {
+        instr_profile_init();
+    }
+    
+    if (opts.strategy.topk_method == -1) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: méthode inconnue (--topk-method=gather|tree|histogram|auto)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // --strategy=auto: méthode du cache de calibration (sinon règle par défaut)
+    int cached = 0;
+    if (opts.strategy_auto && !opts.tune) {
+        cached = tuning_load(opts.tune_file, "topk_hybrid", num_procs, num_threads, total_size, k,
+                             &opts.strategy, MPI_COMM_WORLD);
+    }
+    
+    // Trace chronologique (après la configuration OpenMP: un tampon par thread)
+    if (opts.trace_path != NULL) {
+        trace_init(opts.trace_path, MPI_COMM_WORLD);
+    }
+    
+    // Mode --stream: aucune donnée n'est stockée, ni sur le processus 0 ni
+    // ailleurs (la taille n'est utilisée que par la source "gen")
+    if (opts.stream_source != NULL) {
+        int windowed = (opts.window_size > 0 || opts.window_seconds > 0);
+        print_execution_info(rank, num_procs, k);
+        if (rank == 0 && windowed) {
+            if (opts.window_size > 0) {
+                printf("Fenêtre glissante: %lld derniers éléments", opts.window_size);
+            } else {
+                printf("Fenêtre glissante: %.3f dernières secondes", opts.window_seconds);
+            }
+            printf(" (%d sous-fenêtres), source %s, blocs de %d\n\n", opts.num_panes,
+                   opts.stream_source, opts.chunk_size);
+        } else if (rank == 0) {
+            printf("Source: %s, blocs de %d, instantané %s\n\n", opts.stream_source,
+                   opts.chunk_size, opts.snapshot_every > 0 ? "périodique" : "final");
+        }
+        int ok = windowed ? run_window(&opts, k, rank, num_procs, num_threads)
+                          : run_stream(&opts, k, rank, num_procs, num_threads);
+        instr_report("topk_hybrid", 0, num_threads, MPI_COMM_WORLD);
+        trace_write(MPI_COMM_WORLD);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
+    
+    // Sans --bench: une seule itération mesurée, sans chauffe
+    bench_init(&bench, opts.bench ? opts.bench_warmup : 0, opts.bench ? opts.bench_reps : 1);
+    
     // Affichage des informations
     print_execution_info(rank, num_procs, k);
     
     if (rank == 0) {
         printf("Taille du tableau: %d\n", total_size);
+        printf("Distribution: %s (graine %llu)\n", workload_dist_name(opts.dist), opts.seed);
+        if (opts.argtopk) {
+            printf("Mode: indices globaux (--argtopk)%s\n", opts.payload ? " avec charge utile" : "");
+        }
         printf("\n");
     }
     
@@ -196,95 +1241,82 @@ int main(int argc, char *argv[]) {
         }
         
         double gen_start = MPI_Wtime();
-        generate_random_array(data, total_size, MAX_VALUE, 42);
+        workload_generate(data, 0, total_size, total_size, MAX_VALUE, opts.dist, opts.seed);
+        // Charge utile: seconde colonne uniforme (graine suivante)
+        if (opts.payload) {
+            payload = (int*)malloc(total_size * sizeof(int));
+            workload_generate(payload, 0, total_size, total_size, MAX_VALUE, DIST_UNIFORM,
+                              opts.seed + 1);
+        }
         double gen_end = MPI_Wtime();
         
         printf("Temps de génération: %.6f s\n", gen_end - gen_start);
     }
     
-    MPI_Barrier(MPI_COMM_WORLD);
-    start_time = MPI_Wtime();
-    
-    // ============================================
-    // ÉTAPE 1: Distribution des données (MPI_Scatterv)
-    // ============================================
-    double comm_start = MPI_Wtime();
-    
-    int base_size = total_size / num_procs;
-    int remainder = total_size % num_procs;
-    int local_size = base_size + (rank < remainder ? 1 : 0);
-    
-    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
-    int *displs = (int*)malloc(num_procs * sizeof(int));
-    
-    int offset = 0;
-    for (int i = 0; i < num_procs; i++) {
-        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
-        displs[i] = offset;
-        offset += sendcounts[i];
+    // Choix de la méthode de fusion (calibration sur la machine courante avec --tune)
+    int method;
+    if (opts.tune) {
+        method = tune_topk(data, &opts, k, rank, num_procs, num_threads);
+    } else {
+        method = strategy_choose_topk(&opts.strategy, total_size, k, num_procs);
+    }
+    if (rank == 0) {
+        printf("Méthode de fusion: %s%s\n", topk_method_name(method),
+               opts.tune ? " (calibrée)"
+               : cached ? " (cache)"
+               : opts.strategy.topk_method == STRATEGY_AUTO ? " (règle par défaut)" : "");
     }
-    
-    int *local_data = (int*)malloc(local_size * sizeof(int));
-    
-    MPI_Scatterv(data, sendcounts, displs, MPI_INT,
-                 local_data, local_size, MPI_INT,
-                 0, MPI_COMM_WORLD);
-    
-    comm_time += MPI_Wtime() - comm_start;
-    
-    // ============================================
-    // ÉTAPE 2: Extraction locale des K max (parallélisé avec OpenMP)
-    // ============================================
-    double comp_start = MPI_Wtime();
-    
-    int local_k = (k < local_size) ? k : local_size;
-    int *local_topk = (int*)malloc(k * sizeof(int));
-    
-    extract_local_topk(local_data, local_size, local_topk, k);
-    
-    comp_time += MPI_Wtime() - comp_start;
     
     // ============================================
-    // ÉTAPE 3: Réduction arborescente pour fusionner les Top-K
+    // ÉTAPES 1 à 3 (répétées en mode --bench; l'entrée n'est jamais modifiée)
     // ============================================
-    
-    // Approche: réduction binaire pour minimiser la communication
-    // Chaque étape, les processus pairs reçoivent et fusionnent
-    
-    int *recv_topk = (int*)malloc(k * sizeof(int));
-    int *merged_topk = (int*)malloc(k * sizeof(int));
-    
-    int step = 1;
-    while (step < num_procs) {
-        if (rank % (2 * step) == 0) {
-            int partner = rank + step;
-            if (partner < num_procs) {
-                comm_start = MPI_Wtime();
-                MPI_Recv(recv_topk, k, MPI_INT, partner, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                comm_time += MPI_Wtime() - comm_start;
-                
-                comp_start = MPI_Wtime();
-                merge_topk(local_topk, k, recv_topk, k, merged_topk, k);
-                memcpy(local_topk, merged_topk, k * sizeof(int));
-                comp_time += MPI_Wtime() - comp_start;
-            }
-        } else if (rank % (2 * step) == step) {
-            int partner = rank - step;
-            comm_start = MPI_Wtime();
-            MPI_Send(local_topk, k, MPI_INT, partner, 0, MPI_COMM_WORLD);
-            comm_time += MPI_Wtime() - comm_start;
+    memset(&result, 0, sizeof(result));
+    for (int iter = 0; iter < bench_iterations(&bench); iter++) {
+        free(result.topk);
+        free(result.entries);
+        free(result.local_data);
+        free(result.local_payload);
+        instr_reset();
+        if (opts.argtopk) {
+            run_argtopk(data, payload, opts.payload, total_size, k, method, rank, num_procs,
+                        &result);
+        } else {
+            result.entries = NULL;
+            result.local_payload = NULL;
+            run_topk(data, total_size, k, method, rank, num_procs, &result);
         }
-        step *= 2;
+        bench_record(&bench, iter, result.total_time, MPI_COMM_WORLD);
     }
     
-    MPI_Barrier(MPI_COMM_WORLD);
-    end_time = MPI_Wtime();
-    total_time = end_time - start_time;
+    // Valeurs seules de l'arg-top-K pour l'affichage
+    if (opts.argtopk && rank == 0) {
+        result.topk = (int*)malloc(k * sizeof(int));
+        for (int i = 0; i < k; i++) {
+            result.topk[i] = result.entries[i].value;
+        }
+    }
+    int *local_topk = result.topk;
+    total_time = result.total_time;
+    comp_time = result.comp_time;
+    comm_time = result.comm_time;
     
     // ============================================
-    // ÉTAPE 4: Affichage des résultats
+    // ÉTAPE 4: Vérification distribuée et affichage des résultats
     // ============================================
     
+    // Chaque processus compte ses éléments supérieurs à la K-ième valeur
+    double verify_start = instr_start();
+    int correct;
+    if (opts.argtopk) {
+        correct = verify_argtopk_distributed(result.local_data, result.local_payload,
+                                             result.local_size, result.entries, k, 0,
+                                             MPI_COMM_WORLD);
+    } else {
+        correct = verify_topk_distributed(result.local_data, result.local_size,
+                                          local_topk, k, 0, MPI_COMM_WORLD);
+    }
+    instr_stop(PHASE_VERIFY, verify_start);
+    
     if (rank == 0) {
         printf("\n=== Top-%d Résultats ===\n", k);
         
@@ -295,8 +1327,20 @@ int main(int argc, char *argv[]) {
             printf("%d ", local_topk[i]);
         }
         printf("...\n");
+        if (opts.argtopk) {
+            printf("Entrées (valeur, indice%s): ", opts.payload ? ", charge" : "");
+            for (int i = 0; i < display_count && i < 5; i++) {
+                if (opts.payload) {
+                    printf("(%d, %lld, %d) ", result.entries[i].value, result.entries[i].index,
+                           result.entries[i].payload);
+                } else {
+                    printf("(%d, %lld) ", result.entries[i].value, result.entries[i].index);
+                }
+            }
+            printf("...\n");
+        }
         
-        // Vérification: les valeurs doivent être en ordre décroissant
+        // Les valeurs doivent être en ordre décroissant
         int sorted = 1;
         for (int i = 1; i < k; i++) {
             if (local_topk[i] > local_topk[i-1]) {
@@ -306,6 +1350,7 @@ int main(int argc, char *argv[]) {
         }
         
         printf("Ordre correct (décroissant): %s\n", sorted ? "OUI" : "NON");
+        printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
         printf("Valeur maximale: %d\n", local_topk[0]);
         printf("Valeur minimale du Top-K: %d\n", local_topk[k-1]);
         
@@ -317,26 +1362,31 @@ int main(int argc, char *argv[]) {
                comm_time, (comm_time/total_time)*100);
         
         // Format CSV pour les benchmarks
-        #ifdef _OPENMP
         printf("\nCSV: %d,%d,%d,%d,%.6f,%.6f,%.6f\n", 
-               num_procs, omp_get_max_threads(), total_size, k,
+               num_procs, num_threads, total_size, k,
                total_time, comp_time, comm_time);
-        #else
-        printf("\nCSV: %d,1,%d,%d,%.6f,%.6f,%.6f\n", 
-               num_procs, total_size, k, total_time, comp_time, comm_time);
-        #endif
     }
     
+    // Statistiques du mode --bench (toutes les itérations mesurées)
+    if (opts.bench) {
+        bench_report(&bench, "topk_hybrid", num_procs, num_threads, total_size, k,
+                     opts.bench_csv, MPI_COMM_WORLD);
+    }
+    
+    // Statistiques par phase et par processus (--stats, dernière itération)
+    instr_report("topk_hybrid", total_size, num_threads, MPI_COMM_WORLD);
+    trace_write(MPI_COMM_WORLD);
+    
     // Libération mémoire
-    free(local_data);
-    free(sendcounts);
-    free(displs);
     free(local_topk);
-    free(recv_topk);
-    free(merged_topk);
+    free(result.entries);
+    free(result.local_data);
+    free(result.local_payload);
+    bench_free(&bench);
     
     if (rank == 0) {
         free(data);
+        free(payload);
     }
     
     MPI_Finalize();
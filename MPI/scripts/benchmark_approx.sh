@@ -0,0 +1,57 @@
+#!/bin/bash
+#
+# Benchmark du Top-K approché (--approx) contre le Top-K exact
+# Temps, volume du résumé fusionné (un MPI_Allreduce), erreur relative de la
+# K-ième valeur et nombre de candidats (non rassemblés)
+#
+
+# Configuration
+OUTPUT_FILE="results/topk_approx.csv"
+ARRAY_SIZE=10000000
+NUM_PROCS=(2 4 8)
+K_VALUES=(100 10000)
+BITS=(0 3 6 8)
+WARMUP=1
+REPS=5
+
+mkdir -p results
+
+if [ ! -f ./topk_mpi ]; then
+    echo "Erreur: L'exécutable ./topk_mpi n'existe pas."
+    echo "Veuillez d'abord compiler avec 'make'"
+    exit 1
+fi
+
+echo "mode,bits,procs,size,k,median_time,message_bytes,relative_error,candidates" > "$OUTPUT_FILE"
+
+# Temps médian (--bench) et ligne CSV d'une exécution
+run_topk() {
+    local np=$1
+    shift
+    mpirun -np $np --oversubscribe ./topk_mpi $ARRAY_SIZE "$@" --bench=$WARMUP,$REPS 2>&1
+}
+
+for NP in "${NUM_PROCS[@]}"; do
+    for K in "${K_VALUES[@]}"; do
+        # Chemin exact: p x K valeurs rassemblées sur le processus 0
+        OUTPUT=$(run_topk $NP $K)
+        MEDIAN=$(echo "$OUTPUT" | grep "^BENCH:.*,total," | cut -d',' -f8)
+        BYTES=$((NP * K * 4))
+        echo "exact,,$NP,$ARRAY_SIZE,$K,$MEDIAN,$BYTES,0,$K" >> "$OUTPUT_FILE"
+        echo "np=$NP, K=$K, exact: $MEDIAN s, $BYTES octets"
+        
+        for B in "${BITS[@]}"; do
+            OUTPUT=$(run_topk $NP $K --approx=$B)
+            MEDIAN=$(echo "$OUTPUT" | grep "^BENCH:.*,total," | cut -d',' -f8)
+            CSV_LINE=$(echo "$OUTPUT" | grep "^CSV:" | sed 's/CSV: //')
+            BYTES=$(echo "$CSV_LINE" | cut -d',' -f6)
+            ERROR=$(echo "$CSV_LINE" | cut -d',' -f7)
+            CANDIDATES=$(echo "$CSV_LINE" | cut -d',' -f8)
+            echo "approx,$B,$NP,$ARRAY_SIZE,$K,$MEDIAN,$BYTES,$ERROR,$CANDIDATES" >> "$OUTPUT_FILE"
+            echo "np=$NP, K=$K, approché (bits=$B): $MEDIAN s, $BYTES octets, erreur $ERROR, $CANDIDATES candidats (non rassemblés)"
+        done
+    done
+done
+
+echo ""
+echo "Résultats sauvegardés dans $OUTPUT_FILE"
@@ -0,0 +1,55 @@
+#!/bin/bash
+#
+# Benchmark avec le harnais intégré (--bench)
+# Un seul lancement mpirun par configuration: les itérations de chauffe et
+# les répétitions sont faites dans le processus (médiane, p5/p95 par phase)
+#
+
+# Configuration
+OUTPUT_FILE="results/bench_results.csv"
+ARRAY_SIZES=(100000 1000000 10000000)
+NUM_PROCS=(1 2 4 8 16 32 64 128)
+K=100
+WARMUP=2
+REPS=10
+
+mkdir -p results
+rm -f "$OUTPUT_FILE"
+
+for EXECUTABLE in ./bucket_sort_mpi ./topk_mpi; do
+    if [ ! -f "$EXECUTABLE" ]; then
+        echo "Erreur: L'exécutable $EXECUTABLE n'existe pas."
+        echo "Veuillez d'abord compiler avec 'make'"
+        exit 1
+    fi
+done
+
+MAX_CORES=$(nproc)
+echo "Benchmark intégré ($WARMUP itérations de chauffe, $REPS mesurées)"
+echo "Nombre de cœurs disponibles: $MAX_CORES"
+echo ""
+
+for SIZE in "${ARRAY_SIZES[@]}"; do
+    echo "=== Taille du tableau: $SIZE ==="
+    
+    for NP in "${NUM_PROCS[@]}"; do
+        if [ $NP -gt $MAX_CORES ]; then
+            echo "  Saut de $NP processus (> $MAX_CORES cœurs disponibles)"
+            continue
+        fi
+        
+        echo -n "  $NP processus: "
+        mpirun --oversubscribe -np $NP ./bucket_sort_mpi $SIZE \
+            --bench=$WARMUP,$REPS --bench-csv="$OUTPUT_FILE" > /dev/null 2>&1 && echo -n "." || echo -n "x"
+        mpirun --oversubscribe -np $NP ./topk_mpi $SIZE $K \
+            --bench=$WARMUP,$REPS --bench-csv="$OUTPUT_FILE" > /dev/null 2>&1 && echo -n "." || echo -n "x"
+        echo " OK"
+    done
+    echo ""
+done
+
+echo "=== Temps médians (phase total) ==="
+grep ",total," "$OUTPUT_FILE" | cut -d',' -f1,2,4,8,9,10
+
+echo ""
+echo "Résultats sauvegardés dans $OUTPUT_FILE"
@@ -0,0 +1,48 @@
+#!/bin/bash
+#
+# Benchmark des chemins rapides du préordre (--presort)
+# Temps médian avec et sans détection pour chaque classe d'entrée, et gain
+#
+
+# Configuration
+OUTPUT_FILE="results/presort.csv"
+ARRAY_SIZE=10000000
+NUM_PROCS=(2 4 8)
+DISTS=(sorted reverse nearly-sorted uniform)
+WARMUP=1
+REPS=5
+
+mkdir -p results
+
+if [ ! -f ./bucket_sort_mpi ]; then
+    echo "Erreur: L'exécutable ./bucket_sort_mpi n'existe pas."
+    echo "Veuillez d'abord compiler avec 'make'"
+    exit 1
+fi
+
+echo "dist,procs,size,detected,median_off,median_on,saved_percent" > "$OUTPUT_FILE"
+
+# Sortie d'une exécution mesurée (--bench)
+run_sort() {
+    local np=$1
+    shift
+    mpirun -np $np --oversubscribe ./bucket_sort_mpi $ARRAY_SIZE "$@" --bench=$WARMUP,$REPS 2>&1
+}
+
+for NP in "${NUM_PROCS[@]}"; do
+    for DIST in "${DISTS[@]}"; do
+        OUTPUT=$(run_sort $NP --dist=$DIST --presort=off)
+        OFF=$(echo "$OUTPUT" | grep "^BENCH:.*,total," | cut -d',' -f8)
+        
+        OUTPUT=$(run_sort $NP --dist=$DIST --presort=on)
+        ON=$(echo "$OUTPUT" | grep "^BENCH:.*,total," | cut -d',' -f8)
+        DETECTED=$(echo "$OUTPUT" | grep "^Préordre détecté:" | awk '{print $3}')
+        
+        SAVED=$(awk -v off="$OFF" -v on="$ON" 'BEGIN { if (off > 0) printf "%.1f", 100 * (off - on) / off }')
+        echo "$DIST,$NP,$ARRAY_SIZE,$DETECTED,$OFF,$ON,$SAVED" >> "$OUTPUT_FILE"
+        echo "np=$NP, $DIST ($DETECTED): $OFF s sans détection, $ON s avec ($SAVED% gagnés)"
+    done
+done
+
+echo ""
+echo "Résultats sauvegardés dans $OUTPUT_FILE"
@@ -250,6 +250,66 @@ def generate_efficiency_table():
         for _, row in subset.iterrows():
             print(f"{int(row['num_procs']):<12} {row['mean_time']:<12.4f} {row['speedup']:<12.2f} {row['efficiency']:<12.1f}%")
 
+def plot_bench_results():
+    """Graphiques du mode --bench: médiane avec intervalle p5-p95 et
+    décomposition par phase (results/bench_results.csv)"""
+    
+    bench_file = 'results/bench_results.csv'
+    df = load_and_process_data(bench_file)
+    
+    if df is None:
+        print("Impossible de générer les graphiques du mode --bench")
+        return
+    
+    for program in sorted(df['program'].unique()):
+        prog = df[df['program'] == program]
+        
+        fig, axes = plt.subplots(1, 2, figsize=(14, 5))
+        
+        # Temps total: médiane et intervalle p5-p95
+        total = prog[prog['phase'] == 'total']
+        sizes = sorted(total['array_size'].unique())
+        colors = plt.cm.viridis(np.linspace(0, 0.8, len(sizes)))
+        for idx, size in enumerate(sizes):
+            subset = total[total['array_size'] == size].sort_values('num_procs')
+            errors = [subset['median'] - subset['p5'], subset['p95'] - subset['median']]
+            axes[0].errorbar(subset['num_procs'], subset['median'], yerr=errors,
+                             marker='o', linewidth=2, markersize=6, capsize=4,
+                             color=colors[idx], label=f'n = {size:,}')
+        
+        axes[0].set_xlabel('Nombre de processus', fontsize=12)
+        axes[0].set_ylabel('Temps médian (s)', fontsize=12)
+        axes[0].set_title(f'{program} - médiane et p5/p95', fontsize=14, fontweight='bold')
+        axes[0].legend(loc='upper right')
+        axes[0].set_xscale('log', base=2)
+        axes[0].grid(True, alpha=0.3)
+        
+        # Décomposition par phase pour la plus grande taille
+        largest = prog[(prog['array_size'] == sizes[-1]) & (prog['phase'] != 'total')]
+        phases = list(dict.fromkeys(largest['phase']))
+        procs = sorted(largest['num_procs'].unique())
+        bottom = np.zeros(len(procs))
+        phase_colors = plt.cm.tab10(np.linspace(0, 1, max(len(phases), 1)))
+        for idx, phase in enumerate(phases):
+            values = np.array([largest[(largest['num_procs'] == p) & (largest['phase'] == phase)]['median'].sum()
+                               for p in procs])
+            axes[1].bar([str(p) for p in procs], values, bottom=bottom,
+                        color=phase_colors[idx], label=phase)
+            bottom += values
+        
+        axes[1].set_xlabel('Nombre de processus', fontsize=12)
+        axes[1].set_ylabel('Temps médian (s)', fontsize=12)
+        axes[1].set_title(f'Phases (n = {sizes[-1]:,})', fontsize=14, fontweight='bold')
+        axes[1].legend(loc='upper right', fontsize=8)
+        axes[1].grid(True, alpha=0.3, axis='y')
+        
+        plt.tight_layout()
+        output = f'results/bench_{program}.png'
+        plt.savefig(output, dpi=150, bbox_inches='tight')
+        plt.close()
+        
+        print(f"Graphique sauvegardé: {output}")
+
 def main():
     """Fonction principale"""
     
@@ -265,6 +325,7 @@ def main():
     plot_bucket_sort_results()
     plot_topk_results()
     plot_comparison()
+    plot_bench_results()
     
     # Afficher le tableau d'efficacité
     generate_efficiency_table()
@@ -0,0 +1,450 @@
+#!/usr/bin/env python3
+"""
+Modèle de coût et prédiction du passage à l'échelle
+
+Ajuste un modèle de type LogGP sur les mesures de cost_calibrate (make
+calibrate), puis prédit le temps du Bucket Sort et du Top-K pour une taille
+et un nombre de nœuds cibles, et le meilleur découpage processus x threads
+par nœud.
+
+Paramètres ajustés (moindres carrés):
+- ping-pong:         t = L + octets x G
+- MPI_Alltoallv:     t = (q - 1) x (o + octets par paire x g)
+- Scatterv/Gatherv:  t = a x log2(q) + (q - 1) x octets par processus x Gr
+- noyaux:            secondes par élément, interpolées en log2(taille); au-delà
+                     de la plus grande taille mesurée, le tri croît en log2(n)
+                     et les autres noyaux sont constants
+La calibration se fait sur une machine: entre nœuds, la latence et le débit
+du réseau sont des options (--net-latency-us, --net-bandwidth-gbs). Un
+nœud est supposé sans contention mémoire entre processus; quand processus
+x threads dépasse les cœurs disponibles, les calculs sont ralentis d'autant.
+
+Modèles des pipelines (m = n / p éléments par processus, t threads):
+- Bucket Sort: scatter + classement (comptage) + rangement + échange des
+  effectifs + échange des données (4m/p octets par paire) + tri local
+  (sections de m/t éléments et fusions) + gather
+- Top-K MPI (gather): scatter + tri complet de m + gather de k par processus
+  + tri de k x p sur la racine
+- Top-K hybride (tree): scatter + sélection sur m/t par thread + tournoi des
+  threads + arbre binomial de log2(p) tours (message de 4k octets et fusion
+  de deux listes de k)
+
+Usage: predict_scaling.py [--calibration=fichier] [--program=bucket|topk|all]
+                          [--size=n] [--k=n] [--nodes=1,2,4,...]
+                          [--cores-per-node=n] [--net-latency-us=x]
+                          [--net-bandwidth-gbs=x] [--thread-efficiency=x]
+                          [--validate] [--validate-size=n] [--max-procs=n]
+"""
+
+import argparse
+import bisect
+import csv
+import math
+import os
+import re
+import subprocess
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+MPI_DIR = os.path.dirname(SCRIPT_DIR)
+HYBRID_DIR = os.path.join(MPI_DIR, '..', 'MPI+OpenMPI', 'bin')
+
+
+def least_squares(rows):
+    """Moindres carrés sans constante: rows = [(x1, x2, y)], retourne (a, b)
+    avec y ~ a x1 + b x2, coefficients ramenés à 0 s'ils sont négatifs.
+    L'erreur minimisée est relative: sinon les grands messages fixeraient
+    seuls le modèle et la latence serait perdue."""
+    rows = [(x1 / y, x2 / y, 1.0) for x1, x2, y in rows if y > 0]
+    s11 = sum(x1 * x1 for x1, _, _ in rows)
+    s12 = sum(x1 * x2 for x1, x2, _ in rows)
+    s22 = sum(x2 * x2 for _, x2, _ in rows)
+    s1y = sum(x1 * y for x1, _, y in rows)
+    s2y = sum(x2 * y for _, x2, y in rows)
+    det = s11 * s22 - s12 * s12
+    if not rows or abs(det) < 1e-30:
+        return 0.0, 0.0
+    a = (s1y * s22 - s2y * s12) / det
+    b = (s2y * s11 - s1y * s12) / det
+    # Un coefficient négatif n'a pas de sens: ajustement à un seul terme
+    if a < 0:
+        return 0.0, max(s2y / s22, 0.0) if s22 > 0 else 0.0
+    if b < 0:
+        return max(s1y / s11, 0.0) if s11 > 0 else 0.0, 0.0
+    return a, b
+
+
+class CostModel:
+    """Paramètres ajustés sur la calibration et coûts des opérations"""
+
+    def __init__(self, rows, args):
+        self.args = args
+        by_kind = {}
+        for row in rows:
+            by_kind.setdefault(row['kind'], []).append(row)
+
+        # Ping-pong: y = L x 1 + G x octets
+        pingpong = by_kind.get('pingpong', [])
+        self.latency, self.byte_time = least_squares(
+            [(1.0, r['size'], r['seconds']) for r in pingpong])
+        # Alltoallv: y = o x (q - 1) + g x (q - 1) x octets
+        self.a2a_overhead, self.a2a_byte_time = least_squares(
+            [(r['procs'] - 1, (r['procs'] - 1) * r['size'], r['seconds'])
+             for r in by_kind.get('alltoallv', [])])
+        # Collectives à racine: y = a x log2(q) + Gr x (q - 1) x octets
+        self.rooted = {}
+        for kind in ('scatterv', 'gatherv'):
+            self.rooted[kind] = least_squares(
+                [(math.log2(r['procs']), (r['procs'] - 1) * r['size'], r['seconds'])
+                 for r in by_kind.get(kind, [])])
+        if not pingpong:
+            print("Attention: pas de mesure de communication (calibration sur 1 processus)")
+
+        # Noyaux: (nom, threads, paramètre) -> [(log2 taille, s/élément)] triés
+        self.kernels = {}
+        for row in rows:
+            if row['kind'].startswith('kernel_'):
+                key = (row['kind'], row['threads'], row['param'])
+                self.kernels.setdefault(key, []).append((math.log2(row['size']), row['seconds']))
+        for points in self.kernels.values():
+            points.sort()
+        self.thread_efficiency = args.thread_efficiency
+        if self.thread_efficiency is None:
+            self.thread_efficiency = self.fit_thread_efficiency()
+
+    def fit_thread_efficiency(self):
+        """Efficacité des cœurs supplémentaires, (accélération - 1) / (t - 1),
+        moyenne sur les mesures du comptage à plusieurs threads; les mesures
+        sans accélération (plus de threads que de cœurs) sont ignorées.
+        0.8 sans mesure utilisable."""
+        ratios = []
+        for (name, threads, param), points in self.kernels.items():
+            base = self.kernels.get((name, 1, param))
+            if name != 'kernel_count' or threads == 1 or base is None:
+                continue
+            size = points[-1][0]
+            speedup = self.interpolate(base, size) / self.interpolate(points, size)
+            if speedup > 1.05:
+                ratios.append((speedup - 1) / (threads - 1))
+        return min(sum(ratios) / len(ratios), 1.0) if ratios else 0.8
+
+    @staticmethod
+    def interpolate(points, log_size, log_growth=False):
+        """Secondes par élément à 2^log_size éléments"""
+        sizes = [p[0] for p in points]
+        i = bisect.bisect_left(sizes, log_size)
+        if i == 0:
+            return points[0][1]
+        if i == len(points):
+            last_size, last = points[-1]
+            return last * log_size / last_size if log_growth else last
+        (x0, y0), (x1, y1) = points[i - 1], points[i]
+        return y0 + (y1 - y0) * (log_size - x0) / (x1 - x0)
+
+    def kernel(self, name, size, param=0):
+        """Temps séquentiel d'un noyau sur size éléments"""
+        if size <= 0:
+            return 0.0
+        params = sorted({p for (n, t, p) in self.kernels if n == name and t == 1})
+        if not params:
+            raise SystemExit(f"Erreur: noyau {name} absent de la calibration")
+        # Paramètre mesuré le plus proche (en échelle logarithmique)
+        nearest = min(params, key=lambda p: abs(math.log2(max(p, 1)) - math.log2(max(param, 1))))
+        return size * self.interpolate(self.kernels[(name, 1, nearest)], math.log2(size),
+                                       name == 'kernel_sort')
+
+    def parallel(self, sequential, threads, cores_per_proc):
+        """Temps d'un travail réparti sur threads threads quand le processus
+        dispose de cores_per_proc cœurs (fractionnaire si les processus
+        sont plus nombreux que les cœurs): chaque cœur au-delà du premier
+        compte pour thread_efficiency"""
+        active = min(threads, cores_per_proc)
+        speed = active if active <= 1 else 1 + (active - 1) * self.thread_efficiency
+        return sequential / speed
+
+    def sort(self, size, threads, cores_per_proc):
+        """Tri de kernel_parallel_sort: sections de size/t éléments en
+        parallèle, puis fusions (la dernière, sur tout le tableau, domine)"""
+        if threads == 1:
+            return self.parallel(self.kernel('kernel_sort', size), 1, cores_per_proc)
+        sections = threads * self.kernel('kernel_sort', size // threads)
+        merges = 2 * (threads - 1) / threads * self.kernel('kernel_merge', size)
+        return self.parallel(sections, threads, cores_per_proc) + \
+            self.parallel(merges, 1, cores_per_proc)
+
+    def net_byte_time(self):
+        return 1.0 / (self.args.net_bandwidth_gbs * 1e9)
+
+    def alltoallv(self, procs, bytes_per_pair, procs_per_node):
+        """Échange tout-à-tout: dans un nœud, paramètres calibrés; entre
+        nœuds, le volume sortant du nœud passe par le réseau"""
+        if procs <= 1:
+            return 0.0
+        local = (procs - 1) * self.a2a_overhead
+        local_bytes = (min(procs, procs_per_node) - 1) * bytes_per_pair * self.a2a_byte_time
+        remote = 0.0
+        if procs > procs_per_node:
+            remote = (self.args.net_latency_us * 1e-6 +
+                      procs_per_node * (procs - procs_per_node) * bytes_per_pair *
+                      self.net_byte_time())
+        return local + max(local_bytes, remote)
+
+    def rooted_collective(self, kind, procs, bytes_per_proc, procs_per_node):
+        """Scatterv ou Gatherv depuis la racine"""
+        if procs <= 1:
+            return 0.0
+        a, root_byte_time = self.rooted[kind]
+        local = a * math.log2(procs) + (min(procs, procs_per_node) - 1) * bytes_per_proc * \
+            root_byte_time
+        remote = 0.0
+        if procs > procs_per_node:
+            remote = (math.ceil(math.log2(procs / procs_per_node)) *
+                      self.args.net_latency_us * 1e-6 +
+                      (procs - procs_per_node) * bytes_per_proc * self.net_byte_time())
+        return local + remote
+
+    def message(self, size_bytes, remote):
+        """Message point à point"""
+        if remote:
+            return self.args.net_latency_us * 1e-6 + size_bytes * self.net_byte_time()
+        return self.latency + size_bytes * self.byte_time
+
+    def bucket_sort(self, n, procs, threads, procs_per_node, cores_per_node):
+        """Temps par phase du Bucket Sort (noms des phases de --bench)"""
+        m = n // procs
+        cores = cores_per_node / procs_per_node
+        return {
+            'scatter': self.rooted_collective('scatterv', procs, 4 * m, procs_per_node),
+            'classify': self.parallel(self.kernel('kernel_count', m, procs), threads, cores),
+            'pack': self.parallel(self.kernel('kernel_scatter', m, procs), 1, cores),
+            'count_exchange': self.alltoallv(procs, 4, procs_per_node),
+            'data_exchange': self.alltoallv(procs, 4 * m // procs, procs_per_node),
+            'local_sort': self.sort(m, threads, cores),
+            'gather': self.rooted_collective('gatherv', procs, 4 * m, procs_per_node),
+        }
+
+    def topk_gather(self, n, k, procs, procs_per_node, cores_per_node):
+        """Temps par phase de topk_mpi (méthode gather, un thread)"""
+        m = n // procs
+        kept = min(k, m)
+        cores = cores_per_node / procs_per_node
+        return {
+            'scatter': self.rooted_collective('scatterv', procs, 4 * m, procs_per_node),
+            'local_sort': self.parallel(self.kernel('kernel_sort', m), 1, cores),
+            'gather': self.rooted_collective('gatherv', procs, 4 * kept, procs_per_node),
+            'merge': self.kernel('kernel_sort', kept * procs) if procs > 1 else 0.0,
+        }
+
+    def topk_tree(self, n, k, procs, threads, procs_per_node, cores_per_node):
+        """Temps par phase de topk_hybrid (méthode tree)"""
+        m = n // procs
+        kept = min(k, m)
+        cores = cores_per_node / procs_per_node
+        select = threads * self.kernel('kernel_select', max(m // threads, 1), kept)
+        tournament = math.ceil(math.log2(threads)) * self.kernel('kernel_merge_topk', kept) \
+            if threads > 1 else 0.0
+        rounds = math.ceil(math.log2(procs)) if procs > 1 else 0
+        # Tours de l'arbre: les derniers relient des nœuds différents
+        local_rounds = min(rounds, math.ceil(math.log2(procs_per_node)) if procs_per_node > 1
+                           else 0)
+        tree = 0.0
+        for r in range(rounds):
+            tree += self.message(4 * kept, r >= local_rounds) + \
+                self.kernel('kernel_merge_topk', kept)
+        return {
+            'scatter': self.rooted_collective('scatterv', procs, 4 * m, procs_per_node),
+            'select': self.parallel(select, threads, cores) + self.parallel(tournament, 1, cores),
+            'merge': tree,
+        }
+
+    def predict(self, program, n, k, procs, threads, procs_per_node, cores_per_node):
+        if program in ('bucket', 'bucket_sort_mpi', 'bucket_sort_hybrid'):
+            phases = self.bucket_sort(n, procs, threads, procs_per_node, cores_per_node)
+        elif program == 'topk_mpi':
+            phases = self.topk_gather(n, k, procs, procs_per_node, cores_per_node)
+        else:
+            phases = self.topk_tree(n, k, procs, threads, procs_per_node, cores_per_node)
+        phases['total'] = sum(phases.values())
+        return phases
+
+
+def load_calibration(path):
+    if not os.path.exists(path):
+        raise SystemExit(f"Erreur: calibration {path} absente (lancez d'abord 'make calibrate')")
+    rows = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            rows.append({'kind': row['kind'], 'procs': int(row['procs']),
+                         'threads': int(row['threads']), 'size': int(row['size']),
+                         'param': int(row['param']), 'seconds': float(row['seconds'])})
+    return rows
+
+
+def splits(cores_per_node):
+    """Découpages processus x threads d'un nœud (processus par nœud diviseur
+    du nombre de cœurs)"""
+    return [(ppn, cores_per_node // ppn) for ppn in range(1, cores_per_node + 1)
+            if cores_per_node % ppn == 0]
+
+
+def format_phases(phases):
+    top = sorted(((v, p) for p, v in phases.items() if p != 'total'), reverse=True)[:3]
+    return ', '.join(f"{p} {100 * v / phases['total']:.0f}%" for v, p in top if v > 0)
+
+
+def report(model, program, args):
+    label = 'Bucket Sort' if program == 'bucket' else f'Top-K (K = {args.k})'
+    print(f"\n=== {label}, n = {args.size} ===")
+    print(f"{'nœuds':>5} {'proc/nœud':>9} {'threads':>7} {'prédit (s)':>12}  phases principales")
+    best_single = None
+    plan = []
+    for nodes in args.nodes:
+        best = None
+        for ppn, threads in splits(args.cores_per_node):
+            procs = nodes * ppn
+            if procs > args.size:
+                continue
+            phases = model.predict(program, args.size, args.k, procs, threads, ppn,
+                                   args.cores_per_node)
+            print(f"{nodes:5d} {ppn:9d} {threads:7d} {phases['total']:12.6f}  "
+                  f"{format_phases(phases)}")
+            if best is None or phases['total'] < best[2]['total']:
+                best = (ppn, threads, phases)
+        if best is None:
+            continue
+        if best_single is None:
+            best_single = (nodes, best[2]['total'])
+        plan.append((nodes, best))
+        print(f"      -> meilleur découpage: {best[0]} processus x {best[1]} threads par nœud "
+              f"({best[2]['total']:.6f} s)")
+
+    print("\nPlanification (meilleur découpage par nombre de nœuds):")
+    print(f"{'nœuds':>5} {'découpage':>10} {'prédit (s)':>12} {'accél.':>8} {'efficacité':>10}")
+    for nodes, (ppn, threads, phases) in plan:
+        speedup = best_single[1] / phases['total']
+        efficiency = speedup * best_single[0] / nodes
+        print(f"{nodes:5d} {f'{ppn}x{threads}':>10} {phases['total']:12.6f} {speedup:8.2f} "
+              f"{100 * efficiency:9.0f}%")
+
+
+def run_bench(program, procs, threads, size, k):
+    """Médianes par phase de --bench, None en cas d'échec"""
+    if program.endswith('_hybrid'):
+        executable = os.path.join(HYBRID_DIR, program)
+        extra = [str(size), str(k), str(threads)] if program == 'topk_hybrid' else \
+            [str(size), str(threads)]
+    else:
+        executable = os.path.join(MPI_DIR, program)
+        extra = [str(size), str(k)] if program == 'topk_mpi' else [str(size)]
+    if not os.path.exists(executable):
+        return None
+    env = dict(os.environ, OMP_NUM_THREADS=str(threads))
+    command = ['mpirun', '-np', str(procs), '--oversubscribe', executable] + extra + \
+        ['--bench=1,5']
+    try:
+        output = subprocess.run(command, env=env, capture_output=True, text=True,
+                                timeout=600).stdout
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    phases = {}
+    for line in output.splitlines():
+        match = re.match(r'^BENCH: [^,]+,\d+,\d+,\d+,\d+,(\w+),\d+,([0-9.eE+-]+),', line)
+        if match:
+            phases[match.group(1)] = float(match.group(2))
+    return phases if 'total' in phases else None
+
+
+def validate(model, args):
+    """Compare les prédictions aux exécutions locales atteignables"""
+    cores = os.cpu_count() or 1
+    matrix = []
+    for procs in (1, 2, 4, 8):
+        if procs <= args.max_procs:
+            matrix.append(('bucket_sort_mpi', procs, 1, 0))
+            matrix.append(('topk_mpi', procs, 1, args.k))
+    for procs, threads in ((1, 2), (2, 2), (1, 4)):
+        if procs * threads <= args.max_procs:
+            matrix.append(('bucket_sort_hybrid', procs, threads, 0))
+            matrix.append(('topk_hybrid', procs, threads, args.k))
+
+    path = os.path.join('results', 'prediction_validation.csv')
+    os.makedirs('results', exist_ok=True)
+    print(f"\n=== Validation: n = {args.validate_size}, {cores} cœur(s) local(aux) ===")
+    print(f"{'programme':<20} {'np':>3} {'thr':>4} {'prédit (s)':>12} {'mesuré (s)':>12} "
+          f"{'erreur':>8}")
+    errors = []
+    with open(path, 'w') as f:
+        f.write("program,num_procs,num_threads,array_size,k,phase,predicted,measured,"
+                "error_percent\n")
+        for program, procs, threads, k in matrix:
+            measured = run_bench(program, procs, threads, args.validate_size, k)
+            if measured is None:
+                print(f"{program:<20} {procs:3d} {threads:4d}  (non exécuté)")
+                continue
+            # Tous les processus sur la machine locale
+            predicted = model.predict(program, args.validate_size, k, procs, threads, procs,
+                                      cores)
+            for phase, value in measured.items():
+                if phase not in predicted:
+                    continue
+                error = 100 * (predicted[phase] - value) / value if value > 0 else 0.0
+                f.write(f"{program},{procs},{threads},{args.validate_size},{k},{phase},"
+                        f"{predicted[phase]:.6f},{value:.6f},{error:.1f}\n")
+            error = 100 * (predicted['total'] - measured['total']) / measured['total']
+            errors.append(abs(error))
+            print(f"{program:<20} {procs:3d} {threads:4d} {predicted['total']:12.6f} "
+                  f"{measured['total']:12.6f} {error:+7.1f}%")
+    if errors:
+        print(f"\nErreur absolue moyenne: {sum(errors) / len(errors):.1f}% "
+              f"(médiane {sorted(errors)[len(errors) // 2]:.1f}%)")
+    print(f"Détail par phase dans {path}")
+
+
+def parse_nodes(text):
+    return [int(x) for x in text.split(',') if x]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Prédiction du passage à l'échelle")
+    parser.add_argument('--calibration', default=os.path.join('results', 'cost_calibration.csv'))
+    parser.add_argument('--program', choices=('bucket', 'topk', 'all'), default='all')
+    parser.add_argument('--size', type=lambda x: int(float(x)), default=100000000)
+    parser.add_argument('--k', type=int, default=100)
+    parser.add_argument('--nodes', type=parse_nodes, default=[1, 2, 4, 8, 16])
+    parser.add_argument('--cores-per-node', type=int, default=os.cpu_count() or 1)
+    parser.add_argument('--net-latency-us', type=float, default=2.0)
+    parser.add_argument('--net-bandwidth-gbs', type=float, default=10.0)
+    parser.add_argument('--thread-efficiency', type=float, default=None)
+    parser.add_argument('--validate', action='store_true')
+    parser.add_argument('--validate-size', type=lambda x: int(float(x)), default=1000000)
+    parser.add_argument('--max-procs', type=int,
+                        default=int(os.environ.get('PREDICT_MAX_PROCS', 4)))
+    args = parser.parse_args()
+
+    model = CostModel(load_calibration(args.calibration), args)
+    print("=== Paramètres du modèle ===")
+    print(f"Ping-pong:      L = {model.latency * 1e6:.2f} us, "
+          f"G = {model.byte_time * 1e9:.4f} ns/octet "
+          f"({1e-9 / model.byte_time if model.byte_time > 0 else 0:.2f} Go/s)")
+    print(f"Alltoallv:      o = {model.a2a_overhead * 1e6:.2f} us/pair, "
+          f"g = {model.a2a_byte_time * 1e9:.4f} ns/octet")
+    for kind, (a, root_byte_time) in model.rooted.items():
+        print(f"{kind.capitalize() + ':':<15} a = {a * 1e6:.2f} us x log2(q), "
+              f"Gr = {root_byte_time * 1e9:.4f} ns/octet")
+    print(f"Réseau:         L = {args.net_latency_us:.2f} us, {args.net_bandwidth_gbs:.2f} Go/s "
+          f"(options), efficacité des threads {model.thread_efficiency:.2f}")
+    for name in ('kernel_count', 'kernel_scatter', 'kernel_sort', 'kernel_merge',
+                 'kernel_select', 'kernel_merge_topk'):
+        print(f"{name + ':':<19} {1e9 * model.kernel(name, 1 << 20, 64) / (1 << 20):8.2f} "
+              f"ns/élément (2^20 éléments)")
+
+    programs = ('bucket', 'topk') if args.program == 'all' else (args.program,)
+    for program in programs:
+        report(model, program, args)
+    if args.validate:
+        validate(model, args)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
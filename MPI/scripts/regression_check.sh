@@ -0,0 +1,199 @@
+#!/bin/bash
+#
+# Contrôle de non-régression des performances
+#
+# Relance une matrice fixe de configurations (programme, processus, threads,
+# taille, K) avec le harnais intégré (--bench) et compare le temps total
+# médian de chaque case à celui d'un fichier de référence. Une case est en
+# régression si elle ralentit au-delà d'un seuil qui tient compte du bruit:
+#   seuil = max(TOLERANCE, Z x sqrt(bruit_ref^2 + bruit_courant^2))
+# où le bruit relatif d'une mesure est estimé par (p95 - p5) / (3.29 x médiane)
+# (écart-type d'une loi normale). Le résumé donne l'accélération ou le
+# ralentissement de chaque case; le code de sortie est 1 en cas de régression,
+# d'échec d'exécution (plantage, pas de ligne BENCH:) ou de case de la
+# référence absente de la mesure. Seules les cases sautées volontairement
+# (MAX_CORES, exécutable hybride non compilé) ne comptent pas comme échecs.
+#
+# Usage: regression_check.sh            comparaison à la référence
+#        regression_check.sh --update   enregistre la référence
+#
+
+# Configuration (surchargée par l'environnement)
+BASELINE_FILE=${REGRESSION_BASELINE:-results/regression_baseline.csv}
+REPORT_FILE=${REGRESSION_REPORT:-results/regression_report.csv}
+WARMUP=${REGRESSION_WARMUP:-2}
+REPS=${REGRESSION_REPS:-10}
+TOLERANCE=${REGRESSION_TOLERANCE:-5}    # Seuil minimal (%)
+Z=${REGRESSION_Z:-3}                    # Nombre d'écarts-types tolérés
+MAX_CORES=${REGRESSION_MAX_CORES:-$(nproc)}  # Cases plus grandes sautées
+
+HYBRID_DIR=../MPI+OpenMPI/bin
+
+# Matrice fixe: programme processus threads taille K (K = 0 pour le tri)
+MATRIX=(
+    "bucket_sort_mpi 1 1 1000000 0"
+    "bucket_sort_mpi 4 1 1000000 0"
+    "bucket_sort_mpi 4 1 10000000 0"
+    "bucket_sort_mpi 8 1 10000000 0"
+    "topk_mpi 1 1 10000000 100"
+    "topk_mpi 4 1 10000000 100"
+    "topk_mpi 4 1 10000000 10000"
+    "bucket_sort_hybrid 2 2 10000000 0"
+    "topk_hybrid 2 2 10000000 100"
+)
+
+UPDATE=0
+if [ "$1" == "--update" ]; then
+    UPDATE=1
+fi
+
+for EXECUTABLE in ./bucket_sort_mpi ./topk_mpi; do
+    if [ ! -f "$EXECUTABLE" ]; then
+        echo "Erreur: L'exécutable $EXECUTABLE n'existe pas."
+        echo "Veuillez d'abord compiler avec 'make'"
+        exit 1
+    fi
+done
+if [ $UPDATE -eq 0 ] && [ ! -f "$BASELINE_FILE" ]; then
+    echo "Erreur: pas de référence $BASELINE_FILE"
+    echo "Enregistrez-la d'abord avec 'make regression-baseline'"
+    exit 1
+fi
+
+mkdir -p results
+
+# Mesure d'une case: "médiane,p5,p95,répétitions" du temps total
+measure() {
+    local program=$1 np=$2 threads=$3 size=$4 k=$5
+    local command
+    case $program in
+        bucket_sort_mpi)    command="./bucket_sort_mpi $size" ;;
+        topk_mpi)           command="./topk_mpi $size $k" ;;
+        bucket_sort_hybrid) command="$HYBRID_DIR/bucket_sort_hybrid $size $threads" ;;
+        topk_hybrid)        command="$HYBRID_DIR/topk_hybrid $size $k $threads" ;;
+    esac
+    OMP_NUM_THREADS=$threads mpirun -np $np --oversubscribe $command \
+        --bench=$WARMUP,$REPS 2>&1 | grep "^BENCH:.*,total," | cut -d',' -f8,9,10,7 |
+        awk -F',' '{ print $2 "," $3 "," $4 "," $1 }'
+}
+
+CURRENT=$(mktemp)
+trap 'rm -f "$CURRENT"' EXIT
+echo "program,num_procs,num_threads,array_size,k,median,p5,p95,reps" > "$CURRENT"
+
+SKIPPED=""       # Cases sautées volontairement
+CRASHED=""       # Cases en échec d'exécution
+echo "=== Contrôle de non-régression ($WARMUP itérations de chauffe, $REPS mesurées) ==="
+for CELL in "${MATRIX[@]}"; do
+    read -r PROGRAM NP THREADS SIZE K <<< "$CELL"
+    KEY="$PROGRAM,$NP,$THREADS,$SIZE,$K"
+    if [ $((NP * THREADS)) -gt $MAX_CORES ]; then
+        echo "  $KEY: sautée ($((NP * THREADS)) cœurs > $MAX_CORES disponibles)"
+        SKIPPED="$SKIPPED $KEY"
+        continue
+    fi
+    if [[ $PROGRAM == *_hybrid ]] && [ ! -f "$HYBRID_DIR/$PROGRAM" ]; then
+        echo "  $KEY: sautée ($HYBRID_DIR/$PROGRAM non compilé)"
+        SKIPPED="$SKIPPED $KEY"
+        continue
+    fi
+    STATS=$(measure $PROGRAM $NP $THREADS $SIZE $K)
+    if [ -z "$STATS" ]; then
+        echo "  $KEY: échec de l'exécution"
+        CRASHED="$CRASHED $KEY"
+        continue
+    fi
+    echo "$KEY,$STATS" >> "$CURRENT"
+    echo "  $KEY: médiane $(echo "$STATS" | cut -d',' -f1) s"
+done
+
+if [ $UPDATE -eq 1 ]; then
+    if [ -n "$CRASHED" ]; then
+        echo ""
+        echo "Erreur: échec de l'exécution de$CRASHED; référence non enregistrée"
+        exit 1
+    fi
+    cp "$CURRENT" "$BASELINE_FILE"
+    echo ""
+    echo "Référence enregistrée dans $BASELINE_FILE"
+    exit 0
+fi
+
+# Comparaison case par case (les cases absentes d'un côté sont signalées;
+# échecs d'exécution et cases de la référence non mesurées sont des échecs)
+echo ""
+awk -F',' -v tolerance="$TOLERANCE" -v z="$Z" -v report="$REPORT_FILE" \
+    -v skipped="$SKIPPED" -v crashed="$CRASHED" '
+function noise(median, p5, p95) {
+    return (median > 0) ? (p95 - p5) / (3.29 * median) : 0
+}
+BEGIN {
+    n = split(skipped, list, " ")
+    for (i = 1; i <= n; i++) is_skipped[list[i]] = 1
+    n = split(crashed, list, " ")
+    for (i = 1; i <= n; i++) is_crashed[list[i]] = 1
+    print "program,num_procs,num_threads,array_size,k,baseline_median,median,speedup," \
+          "threshold_percent,status" > report
+    printf "%-42s %10s %10s %9s %7s  %s\n", "programme,np,threads,taille,K", "référence",
+           "actuel", "accél.", "seuil", "verdict"
+}
+FNR == 1 { next }
+NR == FNR {
+    key = $1 "," $2 "," $3 "," $4 "," $5
+    base_median[key] = $6
+    base_noise[key] = noise($6, $7, $8)
+    next
+}
+{
+    key = $1 "," $2 "," $3 "," $4 "," $5
+    if (!(key in base_median)) {
+        printf "%-42s %10s %10.6f %9s %7s  NOUVELLE\n", key, "-", $6, "-", "-"
+        print key ",," $6 ",,,new" > report
+        next
+    }
+    seen[key] = 1
+    ref = base_median[key]
+    cur_noise = noise($6, $7, $8)
+    threshold = z * sqrt(base_noise[key] ^ 2 + cur_noise ^ 2) * 100
+    if (threshold < tolerance) threshold = tolerance
+    change = (ref > 0) ? 100 * ($6 - ref) / ref : 0
+    speedup = ($6 > 0) ? ref / $6 : 0
+    status = "OK"
+    if (change > threshold) { status = "RÉGRESSION"; failed++ }
+    else if (change < -threshold) { status = "AMÉLIORATION" }
+    printf "%-42s %10.6f %10.6f %8.3fx %6.1f%%  %s\n", key, ref, $6, speedup, threshold, status
+    print key "," ref "," $6 "," speedup "," threshold "," status > report
+    total++
+}
+END {
+    for (key in base_median) {
+        if (key in seen) continue
+        if (key in is_skipped) {
+            printf "%-42s %10.6f %10s %9s %7s  SAUTÉE\n", key, base_median[key], "-", "-", "-"
+            print key "," base_median[key] ",,,,skipped" > report
+        } else if (key in is_crashed) {
+            printf "%-42s %10.6f %10s %9s %7s  ÉCHEC D\047EXÉCUTION\n", key, base_median[key],
+                   "-", "-", "-"
+            print key "," base_median[key] ",,,,failed_run" > report
+            missing++
+        } else {
+            printf "%-42s %10.6f %10s %9s %7s  ABSENTE\n", key, base_median[key], "-", "-", "-"
+            print key "," base_median[key] ",,,,missing" > report
+            missing++
+        }
+    }
+    # Cases en échec absentes de la référence
+    for (key in is_crashed) {
+        if (key in base_median) continue
+        printf "%-42s %10s %10s %9s %7s  ÉCHEC D\047EXÉCUTION\n", key, "-", "-", "-", "-"
+        print key ",,,,,failed_run" > report
+        missing++
+    }
+    printf "\n%d cases comparées, %d en régression, %d en échec ou absentes: %s\n", total,
+           failed, missing, (failed || missing) ? "ÉCHEC" : "SUCCÈS"
+    exit (failed || missing) ? 1 : 0
+}' "$BASELINE_FILE" "$CURRENT"
+STATUS=$?
+
+echo "Rapport sauvegardé dans $REPORT_FILE"
+exit $STATUS
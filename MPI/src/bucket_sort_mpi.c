@@ -10,38 +10,90 @@
 #include <time.h>
 #include <mpi.h>
 
+#include "dedup.h"
+#include "instrument.h"
+#include "trace.h"
+#include "bench.h"
+#include "workload.h"
+#include "verify.h"
+#include "sort_kernels.h"
+#include "partition.h"
+#include "tuning.h"
+#include "quantile.h"
+#include "sketch.h"
+#include "incremental.h"
+#include "scatter.h"
+#include "kernels.h"
+#include "exchange.h"
+#include "presort.h"
+#include "strsort.h"
+#include "sortopt.h"
+
 // Taille par défaut du tableau à trier
 #define DEFAULT_SIZE 1000000
 #define MAX_VALUE 1000000
 
-/**
- * Comparateur pour qsort - tri croissant
- */
-int compare_int(const void *a, const void *b) {
-    return (*(int*)a - *(int*)b);
-}
+// Type des clés (--keys=int|string|pair)
+#define KEYS_INT    0
+#define KEYS_STRING 1
+#define KEYS_PAIR   2
 
 /**
- * Génère un tableau d'entiers aléatoires
+ * Options de la ligne de commande
  */
-void generate_random_array(int *arr, int size, int max_value, unsigned int seed) {
-    srand(seed);
-    for (int i = 0; i < size; i++) {
-        arr[i] = rand() % max_value;
-    }
-}
+typedef struct {
+    int total_size;     // Taille du tableau (argument positionnel)
+    int output_mode;    // OUTPUT_SORT, OUTPUT_UNIQUE ou OUTPUT_COUNT
+    int stats_format;   // STATS_NONE, STATS_CSV ou STATS_JSON (--stats)
+    const char *trace_path; // Fichier de trace Chrome/Perfetto (--trace), NULL sinon
+    int profile;        // Compteurs matériels par phase (--profile)
+    int bench;          // Mode benchmark intégré (--bench[=W,M])
+    int bench_warmup;   // Itérations de chauffe
+    int bench_reps;     // Itérations mesurées
+    const char *bench_csv;  // Fichier CSV des résultats (--bench-csv=fichier)
+    int dist;           // Distribution des données (--dist=nom, DIST_*)
+    unsigned long long seed;    // Graine du générateur (--seed=n)
+    strategy_t strategy;        // Partitionnement, échange et tri local (--partition,
+                                // --exchange, --local-sort)
+    int strategy_auto;  // Seuils lus dans le cache (--strategy=auto)
+    int tune;           // Calibration et mise à jour du cache (--tune)
+    const char *tune_file;      // Cache de calibration (--tune-file=fichier)
+    long long quantile_ranks[MAX_QUANTILES];    // Rangs demandés (--quantiles, --kth)
+    int num_quantiles;  // 0 sans requête, -1 si la liste est invalide
+    int approx_bits;    // Quantiles approchés de précision 2^-bits (--approx[=bits]), -1 sinon
+    int presort;        // Détection du préordre et chemins rapides (--presort=on|off)
+    int incremental_rounds;     // Lots ajoutés après le tri initial (--incremental=U[,P])
+    double batch_percent;       // Taille d'un lot en % du tableau
+    double rebalance_threshold; // Déséquilibre déclenchant un rééquilibrage (--rebalance=x)
+    int key_type;       // KEYS_* (--keys=int|string|pair), -1 si inconnu
+    int order;          // SORT_ASC ou SORT_DESC (--order=asc|desc), -1 si inconnu
+    int stable;         // Égalités dans l'ordre d'origine (--stable)
+} options_t;
 
 /**
- * Vérifie si un tableau est trié
+ * Résultat d'une exécution du Bucket Sort: tableau rassemblé sur le
+ * processus 0 et parties locales conservées pour la vérification distribuée
  */
-int is_sorted(int *arr, int size) {
-    for (int i = 1; i < size; i++) {
-        if (arr[i] < arr[i-1]) {
-            return 0;
-        }
-    }
-    return 1;
-}
+typedef struct {
+    int *sorted_data;           // Tableau trié, ou clés distinctes (--unique)
+    key_count_t *histogram;     // Histogramme (--count)
+    int total_distinct;         // Nombre de clés distinctes (--unique, --count)
+    int *local_input;           // Données reçues par ce processus (avant tri)
+    int local_input_size;
+    int *local_sorted;          // Bucket trié de ce processus
+    key_count_t *local_pairs;   // Paires fusionnées de ce processus (--unique, --count)
+    int local_output_size;      // Taille de local_sorted ou de local_pairs
+    long long bytes_sent;       // Volume envoyé par ce processus
+    int partition;              // Partitionnement utilisé (PARTITION_*)
+    int exchange;               // Échange utilisé (EXCHANGE_*)
+    int presort;                // Préordre détecté (PRESORT_*, --presort)
+    int *quantiles;             // Valeurs des rangs demandés (--quantiles, --kth)
+    int quantile_rounds;        // Tours de raffinement (MPI_Allreduce)
+    long long *quantile_bounds; // Encadrement [lo, hi] de chaque valeur (--approx)
+    long long approx_bytes;     // Taille du résumé fusionné (--approx)
+    int *splitters;             // Séparateurs du partitionnement utilisé (num_procs - 1)
+    double total_time;          // Temps d'exécution (barrière à barrière)
+} sort_result_t;
 
 /**
  * Affiche un tableau (pour debug)
@@ -57,48 +109,370 @@ void print_array(int *arr, int size, const char *name) {
 }
 
 /**
- * Fonction principale du Bucket Sort distribué
+ * Lecture des arguments: <taille> [--unique | --count] [--stats[=csv|json]]
+ *                        [--trace[=fichier.json]] [--profile]
+ *                        [--bench[=W,M]] [--bench-csv=fichier]
+ *                        [--dist=nom] [--seed=n]
+ *                        [--strategy=auto] [--tune] [--tune-file=fichier]
+ *                        [--partition=range|sample|auto] [--exchange=dense|sparse|auto]
+ *                        [--local-sort=qsort|radix|counting|natural|auto]
+ *                        [--quantiles=0.5,0.99,... | --kth=r1,r2,...] [--approx[=bits]]
+ *                        [--incremental=lots[,pourcentage] [--rebalance=x]]
+ *                        [--presort=on|off] [--keys=int|string|pair]
+ *                        [--order=asc|desc] [--stable]
  */
-int main(int argc, char *argv[]) {
-    int rank, num_procs;
-    int *data = NULL;
-    int *recv_bucket = NULL;
-    int *sorted_data = NULL;
-    int total_size;
-    double start_time, end_time, total_time;
+void parse_arguments(int argc, char *argv[], options_t *opts) {
+    int positional = 0;
+    int partition = PARTITION_RANGE;
+    int local_sort = SORT_QSORT;
+    int exchange = STRATEGY_AUTO;
+    int explicit_partition = 0;
+    int explicit_sort = 0;
+    const char *quantile_spec = NULL;
+    int quantile_is_rank = 0;
     
-    // Initialisation MPI
-    MPI_Init(&argc, &argv);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    opts->total_size = DEFAULT_SIZE;
+    opts->output_mode = OUTPUT_SORT;
+    opts->stats_format = STATS_NONE;
+    opts->trace_path = NULL;
+    opts->profile = 0;
+    opts->bench = 0;
+    opts->bench_csv = NULL;
+    opts->dist = DIST_UNIFORM;
+    opts->seed = WORKLOAD_DEFAULT_SEED;
+    opts->strategy_auto = 0;
+    opts->tune = 0;
+    opts->tune_file = TUNING_DEFAULT_FILE;
+    opts->approx_bits = -1;
+    opts->presort = 1;
+    opts->incremental_rounds = 0;
+    opts->batch_percent = 1.0;
+    opts->rebalance_threshold = INCREMENTAL_DEFAULT_REBALANCE;
+    opts->key_type = KEYS_INT;
+    opts->order = SORT_ASC;
+    opts->stable = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unique") == 0) {
+            opts->output_mode = OUTPUT_UNIQUE;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            opts->output_mode = OUTPUT_COUNT;
+        } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=csv") == 0) {
+            opts->stats_format = STATS_CSV;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            opts->stats_format = STATS_JSON;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opts->trace_path = "trace.json";
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            opts->trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            opts->profile = 1;
+        } else if (bench_parse_option(argv[i], &opts->bench_warmup, &opts->bench_reps)) {
+            opts->bench = 1;
+        } else if (strncmp(argv[i], "--bench-csv=", 12) == 0) {
+            opts->bench_csv = argv[i] + 12;
+        } else if (strncmp(argv[i], "--dist=", 7) == 0) {
+            opts->dist = workload_parse_dist(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            opts->seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strcmp(argv[i], "--strategy=auto") == 0) {
+            opts->strategy_auto = 1;
+        } else if (strcmp(argv[i], "--tune") == 0) {
+            opts->tune = 1;
+        } else if (strncmp(argv[i], "--tune-file=", 12) == 0) {
+            opts->tune_file = argv[i] + 12;
+        } else if (strncmp(argv[i], "--partition=", 12) == 0) {
+            partition = strategy_parse_choice(argv[i] + 12, partition_parse);
+            explicit_partition = 1;
+        } else if (strncmp(argv[i], "--exchange=", 11) == 0) {
+            exchange = strategy_parse_choice(argv[i] + 11, exchange_parse);
+        } else if (strncmp(argv[i], "--local-sort=", 13) == 0) {
+            local_sort = strategy_parse_choice(argv[i] + 13, sort_kernel_parse);
+            explicit_sort = 1;
+        } else if (strncmp(argv[i], "--quantiles=", 12) == 0) {
+            quantile_spec = argv[i] + 12;
+            quantile_is_rank = 0;
+        } else if (strncmp(argv[i], "--kth=", 6) == 0) {
+            quantile_spec = argv[i] + 6;
+            quantile_is_rank = 1;
+        } else if (strcmp(argv[i], "--approx") == 0) {
+            opts->approx_bits = SKETCH_DEFAULT_BITS;
+        } else if (strncmp(argv[i], "--approx=", 9) == 0) {
+            opts->approx_bits = atoi(argv[i] + 9);
+            if (opts->approx_bits < 0 || opts->approx_bits > SKETCH_MAX_BITS) {
+                opts->approx_bits = SKETCH_DEFAULT_BITS;
+            }
+        } else if (strcmp(argv[i], "--presort=on") == 0) {
+            opts->presort = 1;
+        } else if (strcmp(argv[i], "--presort=off") == 0) {
+            opts->presort = 0;
+        } else if (strncmp(argv[i], "--incremental=", 14) == 0) {
+            char *end;
+            opts->incremental_rounds = (int)strtol(argv[i] + 14, &end, 10);
+            if (*end == ',') {
+                opts->batch_percent = atof(end + 1);
+            }
+            if (opts->incremental_rounds < 0) opts->incremental_rounds = 0;
+            if (opts->batch_percent <= 0.0) opts->batch_percent = 1.0;
+        } else if (strncmp(argv[i], "--rebalance=", 12) == 0) {
+            opts->rebalance_threshold = atof(argv[i] + 12);
+        } else if (strcmp(argv[i], "--keys=int") == 0) {
+            opts->key_type = KEYS_INT;
+        } else if (strcmp(argv[i], "--keys=string") == 0) {
+            opts->key_type = KEYS_STRING;
+        } else if (strcmp(argv[i], "--keys=pair") == 0) {
+            opts->key_type = KEYS_PAIR;
+        } else if (strncmp(argv[i], "--keys=", 7) == 0) {
+            opts->key_type = -1;
+        } else if (strcmp(argv[i], "--order=asc") == 0) {
+            opts->order = SORT_ASC;
+        } else if (strcmp(argv[i], "--order=desc") == 0) {
+            opts->order = SORT_DESC;
+        } else if (strncmp(argv[i], "--order=", 8) == 0) {
+            opts->order = -1;
+        } else if (strcmp(argv[i], "--stable") == 0) {
+            opts->stable = 1;
+        } else if (positional++ == 0) {
+            opts->total_size = atoi(argv[i]);
+        }
+    }
     
-    // Lecture de la taille du tableau depuis les arguments
-    total_size = (argc > 1) ? atoi(argv[1]) : DEFAULT_SIZE;
+    // --strategy=auto et --tune: les choix non imposés deviennent automatiques
+    if (opts->strategy_auto || opts->tune) {
+        if (!explicit_partition) partition = STRATEGY_AUTO;
+        if (!explicit_sort) local_sort = STRATEGY_AUTO;
+    }
+    strategy_init(&opts->strategy, partition, local_sort, -1);
+    opts->strategy.exchange = exchange;
+    
+    // Rangs des quantiles (la taille du tableau est alors connue)
+    opts->num_quantiles = 0;
+    if (quantile_spec != NULL) {
+        opts->num_quantiles = quantile_parse(quantile_spec, quantile_is_rank, opts->total_size,
+                                             opts->quantile_ranks);
+    }
+}
+
+/**
+ * Étapes 2 à 4: création des buckets locaux, échange (All-to-All ou
+ * creux) et tri local selon la stratégie. Retourne le bucket trié de ce
+ * processus (à libérer), le partitionnement et l'échange utilisés dans
+ * *partition et *exchange, et les séparateurs correspondants dans
+ * *splitters_out (à libérer).
+ */
+int *bucket_sort_exchange(int *local_data, int local_size, int num_procs,
+                          const strategy_t *strategy, int *out_size, int *partition,
+                          int *exchange, int **splitters_out) {
+    // ÉTAPE 2: Création des buckets locaux
+    
+    // Chaque processus est responsable d'une plage de valeurs
+    // Processus i: [i * range, (i+1) * range)
+    double range = (double)MAX_VALUE / num_procs;
+    
+    // Comptage des éléments pour chaque bucket
+    double t0 = instr_start();
+    int *bucket_counts = (int*)calloc(num_procs, sizeof(int));
+    kernel_count_buckets(local_data, local_size, bucket_counts, num_procs, range, NULL);
+    
+    // Intervalles trop déséquilibrés (stratégie automatique) ou
+    // --partition=sample: séparateurs tirés d'un échantillon des données
+    int *splitters = NULL;
+    *partition = strategy->partition;
+    if (*partition == STRATEGY_AUTO) {
+        double imbalance = partition_imbalance(bucket_counts, num_procs, MPI_COMM_WORLD);
+        *partition = strategy_choose_partition(strategy, imbalance);
+    }
+    if (*partition == PARTITION_SAMPLE) {
+        splitters = partition_select_splitters(local_data, local_size, num_procs, MPI_COMM_WORLD);
+        kernel_count_buckets(local_data, local_size, bucket_counts, num_procs, range, splitters);
+    }
+    instr_stop(PHASE_CLASSIFY, t0);
+    
+    // Remplissage des buckets directement dans le buffer d'envoi contigu
+    // (tampons d'une ligne de cache par bucket, voir scatter.h)
+    t0 = instr_start();
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    send_displs[0] = 0;
+    int total_send = bucket_counts[0];
+    for (int i = 1; i < num_procs; i++) {
+        send_displs[i] = send_displs[i-1] + bucket_counts[i-1];
+        total_send += bucket_counts[i];
+    }
+    int *send_buffer = scatter_alloc(total_send);
+    scatter_buckets(local_data, local_size, send_buffer, send_displs, num_procs, range, splitters);
+    instr_stop(PHASE_PACK, t0);
+    
+    // ÉTAPE 3: Échange des buckets (All-to-All, ou creux si peu de paires
+    // de processus ont des données à échanger)
+    *exchange = strategy->exchange;
+    if (*exchange == STRATEGY_AUTO) {
+        t0 = instr_start();
+        double density = exchange_density(bucket_counts, num_procs, MPI_COMM_WORLD);
+        *exchange = strategy_choose_exchange(strategy, density);
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    }
+    
+    int total_recv;
+    int *recv_bucket;
+    if (*exchange == EXCHANGE_SPARSE) {
+        t0 = instr_start();
+        recv_bucket = exchange_sparse(send_buffer, bucket_counts, send_displs, &total_recv,
+                                      MPI_COMM_WORLD);
+        instr_stop(PHASE_DATA_EXCHANGE, t0);
+    } else {
+        // Communication des tailles de buckets
+        t0 = instr_start();
+        int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+        TRACED("MPI_Alltoall",
+               MPI_Alltoall(bucket_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD));
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+        
+        // Calcul des déplacements pour la réception
+        int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+        
+        recv_displs[0] = 0;
+        total_recv = recv_counts[0];
+        
+        for (int i = 1; i < num_procs; i++) {
+            recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+            total_recv += recv_counts[i];
+        }
+        
+        // Allocation du buffer de réception
+        recv_bucket = (int*)malloc((total_recv + 1) * sizeof(int));
+        
+        // Échange All-to-All des données
+        t0 = instr_start();
+        TRACED("MPI_Alltoallv",
+               MPI_Alltoallv(send_buffer, bucket_counts, send_displs, MPI_INT,
+                             recv_bucket, recv_counts, recv_displs, MPI_INT,
+                             MPI_COMM_WORLD));
+        instr_stop(PHASE_DATA_EXCHANGE, t0);
+        free(recv_counts);
+        free(recv_displs);
+    }
+    instr_add_bytes((long long)total_send * sizeof(int), (long long)total_recv * sizeof(int));
+    instr_set_bucket_size(total_recv);
+    
+    // ÉTAPE 4: Tri local du bucket
+    
+    t0 = instr_start();
+    strategy_sort(strategy, recv_bucket, total_recv);
+    instr_stop(PHASE_LOCAL_SORT, t0);
+    
+    // Séparateurs conservés pour les mises à jour (--incremental)
+    *splitters_out = (splitters != NULL) ? splitters : incremental_range_splitters(range, num_procs);
+    free(bucket_counts);
+    free(send_displs);
+    free(send_buffer);
+    
+    *out_size = total_recv;
+    return recv_bucket;
+}
+
+/**
+ * Variante --unique / --count des étapes 2 à 5: les doublons sont regroupés
+ * avant l'échange puis le résultat est rassemblé sur le processus 0,
+ * soit sous forme de clés distinctes (*keys), soit de paires (clé, nombre)
+ * (*histogram). Les paires fusionnées de ce processus sont retournées dans
+ * *local_pairs (à libérer). Retourne le nombre de clés distinctes (sur le
+ * processus 0).
+ */
+int bucket_sort_distinct(int *local_data, int local_size, int num_procs, int rank,
+                         int mode, int **keys, key_count_t **histogram,
+                         key_count_t **local_pairs, int *num_local_pairs,
+                         long long *bytes_sent) {
+    double range = (double)MAX_VALUE / num_procs;
+    int *bucket_counts = (int*)malloc(num_procs * sizeof(int));
+    
+    // Regroupement local puis échange et fusion des occurrences
+    key_count_t *pairs = NULL;
+    key_count_t *merged = NULL;
+    double t0 = instr_start();
+    dedup_collapse_local(local_data, local_size, MAX_VALUE, num_procs, range,
+                         &pairs, bucket_counts);
+    instr_stop(PHASE_CLASSIFY, t0);
+    int num_merged = dedup_exchange_merge(pairs, bucket_counts, mode, &merged,
+                                          bytes_sent, MPI_COMM_WORLD);
+    instr_set_bucket_size(num_merged);
+    
+    // Rassemblement du résultat trié sur le processus 0
+    t0 = instr_start();
+    int *final_counts = NULL;
+    int *final_displs = NULL;
+    int total_distinct = 0;
     
     if (rank == 0) {
-        printf("=== Bucket Sort Distribué avec MPI ===\n");
-        printf("Nombre de processus: %d\n", num_procs);
-        printf("Taille du tableau: %d\n", total_size);
-        printf("Valeur maximale: %d\n", MAX_VALUE);
+        final_counts = (int*)malloc(num_procs * sizeof(int));
+        final_displs = (int*)malloc(num_procs * sizeof(int));
     }
     
-    // Allocation et génération des données sur le processus 0
+    TRACED("MPI_Gather",
+           MPI_Gather(&num_merged, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    
     if (rank == 0) {
-        data = (int*)malloc(total_size * sizeof(int));
-        if (data == NULL) {
-            fprintf(stderr, "Erreur d'allocation mémoire\n");
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        for (int i = 0; i < num_procs; i++) {
+            final_displs[i] = total_distinct;
+            total_distinct += final_counts[i];
         }
-        generate_random_array(data, total_size, MAX_VALUE, 42);
-        // print_array(data, total_size, "Données initiales");
     }
     
-    // Synchronisation avant le début du chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    start_time = MPI_Wtime();
+    if (mode == OUTPUT_UNIQUE) {
+        // Clés seules: la moitié du volume des paires
+        int *local_keys = (int*)malloc((num_merged + 1) * sizeof(int));
+        for (int i = 0; i < num_merged; i++) {
+            local_keys[i] = merged[i].key;
+        }
+        if (rank == 0) {
+            *keys = (int*)malloc((total_distinct + 1) * sizeof(int));
+        }
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(local_keys, num_merged, MPI_INT,
+                           rank == 0 ? *keys : NULL, final_counts, final_displs, MPI_INT,
+                           0, MPI_COMM_WORLD));
+        free(local_keys);
+    } else {
+        MPI_Datatype pair_type = dedup_pair_type();
+        if (rank == 0) {
+            *histogram = (key_count_t*)malloc((total_distinct + 1) * sizeof(key_count_t));
+        }
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(merged, num_merged, pair_type,
+                           rank == 0 ? *histogram : NULL, final_counts, final_displs, pair_type,
+                           0, MPI_COMM_WORLD));
+        MPI_Type_free(&pair_type);
+    }
+    instr_stop(PHASE_GATHER, t0);
+    
+    free(bucket_counts);
+    free(pairs);
+    free(final_counts);
+    free(final_displs);
+    
+    *local_pairs = merged;
+    *num_local_pairs = num_merged;
+    return total_distinct;
+}
 
+/**
+ * Exécution chronométrée du Bucket Sort (étapes 1 à 5) à partir des données
+ * du processus 0. Les données d'entrée ne sont pas modifiées.
+ */
+void run_bucket_sort(int *data, const options_t *opts, int rank, int num_procs,
+                     sort_result_t *result) {
+    int total_size = opts->total_size;
+    int *recv_bucket = NULL;
+    int total_recv = 0;
+    
+    memset(result, 0, sizeof(*result));
+    
+    // Synchronisation avant le début du chronométrage
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
     // ÉTAPE 1: Distribution des données
-
+    
     // Calcul de la taille locale pour chaque processus
     int base_size = total_size / num_procs;
     int remainder = total_size % num_procs;
@@ -119,152 +493,882 @@ int main(int argc, char *argv[]) {
     int *local_data = (int*)malloc(local_size * sizeof(int));
     
     // Distribution des données
-    MPI_Scatterv(data, sendcounts, displs, MPI_INT,
-                 local_data, local_size, MPI_INT,
-                 0, MPI_COMM_WORLD);
-
-    // ÉTAPE 2: Création des buckets locaux
- 
-    // Chaque processus est responsable d'une plage de valeurs
-    // Processus i: [i * range, (i+1) * range)
-    double range = (double)MAX_VALUE / num_procs;
-    
-    // Comptage des éléments pour chaque bucket
-    int *bucket_counts = (int*)calloc(num_procs, sizeof(int));
+    double t0 = instr_start();
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    instr_stop(PHASE_SCATTER, t0);
     
-    for (int i = 0; i < local_size; i++) {
-        int bucket_id = (int)(local_data[i] / range);
-        if (bucket_id >= num_procs) bucket_id = num_procs - 1;
-        bucket_counts[bucket_id]++;
+    if (opts->num_quantiles > 0 && opts->approx_bits >= 0) {
+        // ÉTAPE 2 (--approx): résumé log-linéaire fusionné par un seul
+        // MPI_Allreduce de taille fixe; chaque valeur est le centre de la
+        // classe qui contient son rang
+        sketch_t sketch;
+        t0 = instr_start();
+        sketch_init(&sketch, opts->approx_bits);
+        sketch_add(&sketch, local_data, local_size);
+        instr_stop(PHASE_CLASSIFY, t0);
+        
+        t0 = instr_start();
+        sketch_allreduce(&sketch, MPI_COMM_WORLD);
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+        instr_add_bytes(sketch_bytes(&sketch), sketch_bytes(&sketch));
+        
+        t0 = instr_start();
+        result->quantiles = (int*)malloc(opts->num_quantiles * sizeof(int));
+        result->quantile_bounds = (long long*)malloc(2 * opts->num_quantiles * sizeof(long long));
+        for (int q = 0; q < opts->num_quantiles; q++) {
+            long long below;
+            long long *bounds = result->quantile_bounds + 2 * q;
+            int bin = sketch_rank_bin(&sketch, opts->quantile_ranks[q], &below);
+            sketch_bin_bounds(&sketch, bin, &bounds[0], &bounds[1]);
+            result->quantiles[q] = (int)(bounds[0] + (bounds[1] - bounds[0]) / 2);
+        }
+        instr_stop(PHASE_SELECT, t0);
+        result->quantile_rounds = 1;
+        result->approx_bytes = sketch_bytes(&sketch);
+        sketch_free(&sketch);
+        instr_set_bucket_size(local_size);
+    } else if (opts->num_quantiles > 0) {
+        // ÉTAPE 2 (--quantiles, --kth): raffinement d'histogramme global,
+        // sans échange des données ni tri
+        result->quantiles = (int*)malloc(opts->num_quantiles * sizeof(int));
+        result->quantile_rounds = quantile_select(local_data, local_size, opts->quantile_ranks,
+                                                  opts->num_quantiles, result->quantiles,
+                                                  MPI_COMM_WORLD);
+        instr_set_bucket_size(local_size);
+    } else if (opts->output_mode != OUTPUT_SORT) {
+        // ÉTAPES 2 à 5 (--unique / --count): échange des paires (clé, nombre)
+        result->total_distinct = bucket_sort_distinct(local_data, local_size, num_procs, rank,
+                                                      opts->output_mode, &result->sorted_data,
+                                                      &result->histogram, &result->local_pairs,
+                                                      &result->local_output_size, &result->bytes_sent);
+    } else {
+        // Préordre (--presort): un tableau déjà trié reste en place, un
+        // tableau inversé est retourné, un tableau presque trié passe par le
+        // tri fusion naturel au lieu de qsort
+        strategy_t strategy = opts->strategy;
+        result->presort = PRESORT_RANDOM;
+        if (opts->presort) {
+            t0 = instr_start();
+            presort_info_t presort;
+            presort_probe(local_data, local_size, &presort, MPI_COMM_WORLD);
+            instr_stop(PHASE_CLASSIFY, t0);
+            result->presort = presort.order;
+            if (presort.order == PRESORT_NEARLY
+                && (strategy.local_sort == SORT_QSORT || strategy.local_sort == STRATEGY_AUTO)) {
+                strategy.local_sort = SORT_NATURAL;
+            }
+        }
+        
+        result->bytes_sent = (long long)local_size * sizeof(int);
+        if (result->presort == PRESORT_SORTED) {
+            recv_bucket = (int*)malloc((local_size + 1) * sizeof(int));
+            memcpy(recv_bucket, local_data, local_size * sizeof(int));
+            total_recv = local_size;
+            result->bytes_sent = 0;
+        } else if (result->presort == PRESORT_REVERSE) {
+            t0 = instr_start();
+            recv_bucket = presort_reverse(local_data, local_size, &total_recv, MPI_COMM_WORLD);
+            instr_stop(PHASE_DATA_EXCHANGE, t0);
+            instr_add_bytes((long long)local_size * sizeof(int), (long long)total_recv * sizeof(int));
+        } else {
+            // ÉTAPES 2 à 4: buckets locaux, échange All-to-All et tri local
+            recv_bucket = bucket_sort_exchange(local_data, local_size, num_procs, &strategy,
+                                               &total_recv, &result->partition,
+                                               &result->exchange, &result->splitters);
+        }
+        if (result->splitters == NULL) {
+            result->splitters = presort_splitters(recv_bucket, total_recv, MPI_COMM_WORLD);
+        }
+        instr_set_bucket_size(total_recv);
+        result->local_sorted = recv_bucket;
+        result->local_output_size = total_recv;
+        
+        // ÉTAPE 5: Rassemblement des résultats
+        
+        // Communication des tailles de buckets triés
+        t0 = instr_start();
+        int *final_counts = NULL;
+        int *final_displs = NULL;
+        
+        if (rank == 0) {
+            final_counts = (int*)malloc(num_procs * sizeof(int));
+            final_displs = (int*)malloc(num_procs * sizeof(int));
+            result->sorted_data = (int*)malloc(total_size * sizeof(int));
+        }
+        
+        TRACED("MPI_Gather",
+               MPI_Gather(&total_recv, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD));
+        
+        if (rank == 0) {
+            final_displs[0] = 0;
+            for (int i = 1; i < num_procs; i++) {
+                final_displs[i] = final_displs[i-1] + final_counts[i-1];
+            }
+        }
+        
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(recv_bucket, total_recv, MPI_INT,
+                           result->sorted_data, final_counts, final_displs, MPI_INT,
+                           0, MPI_COMM_WORLD));
+        instr_stop(PHASE_GATHER, t0);
+        
+        free(final_counts);
+        free(final_displs);
     }
     
-    // Allocation des buckets locaux
-    int **local_buckets = (int**)malloc(num_procs * sizeof(int*));
-    int *bucket_indices = (int*)calloc(num_procs, sizeof(int));
+    // Fin du chronométrage
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    result->total_time = MPI_Wtime() - start_time;
     
-    for (int i = 0; i < num_procs; i++) {
-        local_buckets[i] = (int*)malloc(bucket_counts[i] * sizeof(int));
-    }
+    result->local_input = local_data;
+    result->local_input_size = local_size;
     
-    // Remplissage des buckets
-    for (int i = 0; i < local_size; i++) {
-        int bucket_id = (int)(local_data[i] / range);
-        if (bucket_id >= num_procs) bucket_id = num_procs - 1;
-        local_buckets[bucket_id][bucket_indices[bucket_id]++] = local_data[i];
-    }
+    free(sendcounts);
+    free(displs);
+}
 
-    // ÉTAPE 3: Échange des buckets (All-to-All)
+/**
+ * Libère le résultat d'une exécution
+ */
+void free_sort_result(sort_result_t *result) {
+    free(result->sorted_data);
+    free(result->histogram);
+    free(result->local_input);
+    free(result->local_sorted);
+    free(result->local_pairs);
+    free(result->quantiles);
+    free(result->quantile_bounds);
+    free(result->splitters);
+    memset(result, 0, sizeof(*result));
+}
 
-    // Communication des tailles de buckets
-    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
-    MPI_Alltoall(bucket_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD);
+/**
+ * Mode --incremental: après le tri initial, ajoute incremental_rounds lots
+ * de batch_percent % de nouvelles clés (générées sur le processus 0, graine
+ * seed + numéro du lot). Chaque processus garde sa partition triée et les
+ * séparateurs du tri initial: seul le lot est distribué, classé, échangé et
+ * trié, puis fusionné en place (incremental.h). Les partitions ne sont
+ * rééquilibrées que si le déséquilibre dépasse rebalance_threshold.
+ */
+void run_incremental(const options_t *opts, sort_result_t *result, int rank, int num_procs) {
+    int batch_size = (int)((double)opts->total_size * opts->batch_percent / 100.0);
+    if (batch_size < 1) batch_size = 1;
     
-    // Calcul des déplacements pour l'envoi et la réception
-    int *send_displs = (int*)malloc(num_procs * sizeof(int));
-    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    // La partition triée et les séparateurs du tri initial sont repris
+    sorted_partition_t part;
+    incremental_init(&part, result->local_sorted, result->local_output_size, result->splitters,
+                     num_procs);
+    result->local_sorted = NULL;
+    result->splitters = NULL;
     
-    send_displs[0] = 0;
-    recv_displs[0] = 0;
-    int total_send = bucket_counts[0];
-    int total_recv = recv_counts[0];
+    // Empreinte de toutes les clés insérées (tri initial puis lots)
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    checksum_add_array(&before, result->local_input, result->local_input_size);
     
-    for (int i = 1; i < num_procs; i++) {
-        send_displs[i] = send_displs[i-1] + bucket_counts[i-1];
-        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
-        total_send += bucket_counts[i];
-        total_recv += recv_counts[i];
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = batch_size / num_procs + (i < batch_size % num_procs ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
     }
+    int local_batch_size = sendcounts[rank];
+    int *batch = (rank == 0) ? (int*)malloc(batch_size * sizeof(int)) : NULL;
+    int *local_batch = (int*)malloc((local_batch_size + 1) * sizeof(int));
     
-    // Préparation du buffer d'envoi contigu
-    int *send_buffer = (int*)malloc(total_send * sizeof(int));
-    int pos = 0;
-    for (int i = 0; i < num_procs; i++) {
-        memcpy(send_buffer + pos, local_buckets[i], bucket_counts[i] * sizeof(int));
-        pos += bucket_counts[i];
+    if (rank == 0) {
+        printf("\n=== Mises à jour incrémentales (%d lots de %d clés, rééquilibrage au-delà "
+               "de %.2f) ===\n", opts->incremental_rounds, batch_size, opts->rebalance_threshold);
     }
     
-    // Allocation du buffer de réception
-    recv_bucket = (int*)malloc(total_recv * sizeof(int));
+    double update_total = 0.0;
+    long long bytes_sent = 0;
+    int rebalances = 0;
+    for (int round = 0; round < opts->incremental_rounds; round++) {
+        if (rank == 0) {
+            workload_generate(batch, 0, batch_size, batch_size, MAX_VALUE, opts->dist,
+                              opts->seed + 1 + round);
+        }
+        instr_reset();
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        double start_time = MPI_Wtime();
+        
+        double t0 = instr_start();
+        TRACED("MPI_Scatterv",
+               MPI_Scatterv(batch, sendcounts, displs, MPI_INT,
+                            local_batch, local_batch_size, MPI_INT,
+                            0, MPI_COMM_WORLD));
+        instr_stop(PHASE_SCATTER, t0);
+        
+        bytes_sent += incremental_insert(&part, local_batch, local_batch_size, &opts->strategy,
+                                         MPI_COMM_WORLD);
+        double imbalance = incremental_imbalance(&part, MPI_COMM_WORLD);
+        int rebalanced = (imbalance > opts->rebalance_threshold);
+        if (rebalanced) {
+            bytes_sent += incremental_rebalance(&part, MPI_COMM_WORLD);
+            rebalances++;
+        }
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        double update_time = MPI_Wtime() - start_time;
+        update_total += update_time;
+        checksum_add_array(&before, local_batch, local_batch_size);
+        
+        if (rank == 0) {
+            printf("Lot %d: %.6f s, déséquilibre %.2f%s\n", round + 1, update_time, imbalance,
+                   rebalanced ? " (rééquilibrage)" : "");
+        }
+    }
     
-    // Échange All-to-All des données
-    MPI_Alltoallv(send_buffer, bucket_counts, send_displs, MPI_INT,
-                  recv_bucket, recv_counts, recv_displs, MPI_INT,
-                  MPI_COMM_WORLD);
-
-    // ÉTAPE 4: Tri local du bucket
-
-    qsort(recv_bucket, total_recv, sizeof(int), compare_int);
-
-    // ÉTAPE 5: Rassemblement des résultats
-
-    // Communication des tailles de buckets triés
-    int *final_counts = NULL;
-    int *final_displs = NULL;
+    // Vérification: ordre global et mêmes clés que l'ensemble des entrées
+    double t0 = instr_start();
+    checksum_add_array(&after, part.data, part.size);
+    int sorted = verify_sorted_distributed(part.data, part.size, 0, MPI_COMM_WORLD);
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        sorted = 0;
+    }
+    instr_stop(PHASE_VERIFY, t0);
+    
+    long long total_bytes;
+    long long total_elements = part.size;
+    long long global_elements;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&total_elements, &global_elements, 1, MPI_LONG_LONG, MPI_SUM, 0,
+                      MPI_COMM_WORLD));
+    
+    if (rank == 0 && opts->incremental_rounds > 0) {
+        double mean = update_total / opts->incremental_rounds;
+        printf("Tableau final: %lld éléments, tri correct: %s\n", global_elements,
+               sorted ? "OUI" : "NON");
+        printf("Mise à jour moyenne: %.6f s (tri complet initial: %.6f s, %.1f fois moins)\n",
+               mean, result->total_time, mean > 0 ? result->total_time / mean : 0.0);
+        printf("Volume échangé par lot: %lld octets, rééquilibrages: %d\n",
+               total_bytes / opts->incremental_rounds, rebalances);
+    }
     
+    incremental_free(&part);
+    free(sendcounts);
+    free(displs);
+    free(batch);
+    free(local_batch);
+}
+
+/**
+ * Mode --keys=string: Bucket Sort de total_size clés chaînes de type URL
+ * (générées sur le processus 0) par le pipeline de strsort.h. Même
+ * déroulement que le tri d'entiers: distribution, séparateurs échantillonnés,
+ * échange au format compact, tri multiclé local, rassemblement, puis
+ * vérification distribuée (ordre, frontières et empreinte des clés).
+ */
+void run_string_sort(const options_t *opts, int rank, int num_procs, bench_t *bench) {
+    int total_size = opts->total_size;
+    string_set_t keys = { 0, NULL, NULL };
     if (rank == 0) {
-        final_counts = (int*)malloc(num_procs * sizeof(int));
-        final_displs = (int*)malloc(num_procs * sizeof(int));
-        sorted_data = (int*)malloc(total_size * sizeof(int));
+        strsort_generate(&keys, 0, total_size, total_size, opts->dist, opts->seed);
+        printf("Clés chaînes: %d (%.1f octets en moyenne)\n", keys.count,
+               keys.count > 0 ? (double)keys.offsets[keys.count] / keys.count : 0.0);
+    }
+    
+    string_set_t local = { 0, NULL, NULL };
+    string_set_t sorted = { 0, NULL, NULL };
+    string_set_t gathered = { 0, NULL, NULL };
+    long long bytes_sent = 0;
+    double total_time = 0.0;
+    for (int iter = 0; iter < bench_iterations(bench); iter++) {
+        strset_free(&local);
+        strset_free(&sorted);
+        strset_free(&gathered);
+        instr_reset();
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        double start_time = MPI_Wtime();
+        
+        double t0 = instr_start();
+        strsort_scatter(&keys, &local, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_SCATTER, t0);
+        
+        bytes_sent = strsort_exchange(&local, &sorted, MPI_COMM_WORLD);
+        
+        t0 = instr_start();
+        strsort_gather(&sorted, &gathered, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_GATHER, t0);
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        total_time = MPI_Wtime() - start_time;
+        bench_record(bench, iter, total_time, MPI_COMM_WORLD);
+    }
+    
+    // Vérification: ordre global et mêmes clés avant et après
+    double t0 = instr_start();
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    strsort_checksum(&before, &local);
+    strsort_checksum(&after, &sorted);
+    int ok = strsort_verify_distributed(&sorted, MPI_COMM_WORLD);
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        ok = 0;
     }
+    instr_stop(PHASE_VERIFY, t0);
     
-    MPI_Gather(&total_recv, 1, MPI_INT, final_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    long long total_bytes = 0;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
     
     if (rank == 0) {
-        final_displs[0] = 0;
-        for (int i = 1; i < num_procs; i++) {
-            final_displs[i] = final_displs[i-1] + final_counts[i-1];
+        printf("\n=== Résultats ===\n");
+        printf("Tri correct: %s\n", ok ? "OUI" : "NON");
+        if (gathered.count > 0) {
+            int first = gathered.offsets[1];
+            int last = gathered.offsets[gathered.count] - gathered.offsets[gathered.count - 1];
+            printf("Première clé: %.*s\n", first, gathered.bytes);
+            printf("Dernière clé: %.*s\n", last,
+                   gathered.bytes + gathered.offsets[gathered.count - 1]);
         }
+        printf("Volume échangé: %lld octets (longueurs et octets des clés)\n", total_bytes);
+        printf("Temps d'exécution: %.6f secondes\n", total_time);
+        printf("Clés triées par seconde: %.2f millions (%.1f Mo/s)\n",
+               (total_size / total_time) / 1000000.0,
+               keys.offsets[keys.count] / total_time / 1e6);
+        
+        // Format CSV pour les benchmarks
+        printf("\nCSV: %d,%d,%.6f\n", num_procs, total_size, total_time);
     }
     
-    MPI_Gatherv(recv_bucket, total_recv, MPI_INT,
-                sorted_data, final_counts, final_displs, MPI_INT,
-                0, MPI_COMM_WORLD);
+    if (opts->bench) {
+        bench_report(bench, "bucket_sort_mpi", num_procs, 1, total_size, 0,
+                     opts->bench_csv, MPI_COMM_WORLD);
+    }
     
-    // Fin du chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    end_time = MPI_Wtime();
-    total_time = end_time - start_time;
+    strset_free(&keys);
+    strset_free(&local);
+    strset_free(&sorted);
+    strset_free(&gathered);
+}
 
-    // ÉTAPE 6: Vérification et affichage des résultats
+/**
+ * Affiche un enregistrement du mode --order/--stable/--keys=pair
+ */
+static void print_record(const char *label, const sortopt_ops_t *ops, const int *record) {
+    printf("%s: %d", label, record[0]);
+    if (ops->pair) printf(", %d", record[1]);
+    if (ops->stable) printf(" (indice %d)", record[ops->fields - 1]);
+    printf("\n");
+}
 
+/**
+ * Modes --order=desc, --stable et --keys=pair: Bucket Sort
+ * d'enregistrements (clé, [clé2], [indice d'origine]) par le pipeline de
+ * sortopt.h, avec les noyaux spécialisés de la combinaison d'options. La
+ * seconde clé est uniforme (graine + 1). Même déroulement que les clés
+ * chaînes: distribution, séparateurs échantillonnés, échange, tri local,
+ * rassemblement, puis vérification distribuée (ordre, frontières et
+ * empreinte des enregistrements).
+ */
+void run_ordered_sort(const options_t *opts, int rank, int num_procs, bench_t *bench) {
+    int total_size = opts->total_size;
+    sort_options_t sort_opts = { opts->order, opts->stable, opts->key_type == KEYS_PAIR };
+    const sortopt_ops_t *ops = sortopt_select(&sort_opts);
+    
+    int *records = NULL;
     if (rank == 0) {
-        // Vérification du tri
-        int sorted = is_sorted(sorted_data, total_size);
-        // print_array(sorted_data, total_size, "Données triées");
+        int *keys = (int*)malloc((total_size + 1) * sizeof(int));
+        int *keys2 = NULL;
+        workload_generate(keys, 0, total_size, total_size, MAX_VALUE, opts->dist, opts->seed);
+        if (ops->pair) {
+            keys2 = (int*)malloc((total_size + 1) * sizeof(int));
+            workload_generate(keys2, 0, total_size, total_size, MAX_VALUE, DIST_UNIFORM,
+                              opts->seed + 1);
+        }
+        records = sortopt_build(ops, keys, keys2, total_size, 0);
+        free(keys);
+        free(keys2);
+        printf("Enregistrements: %s (%d entiers chacun)\n", ops->name, ops->fields);
+    }
+    
+    int *local = NULL, *sorted = NULL, *gathered = NULL;
+    int local_count = 0, sorted_count = 0, gathered_count = 0;
+    long long bytes_sent = 0;
+    double total_time = 0.0;
+    for (int iter = 0; iter < bench_iterations(bench); iter++) {
+        free(local);
+        free(sorted);
+        free(gathered);
+        instr_reset();
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        double start_time = MPI_Wtime();
+        
+        double t0 = instr_start();
+        sortopt_scatter(ops, records, total_size, &local, &local_count, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_SCATTER, t0);
         
+        bytes_sent = sortopt_exchange(ops, local, local_count, &sorted, &sorted_count,
+                                      MPI_COMM_WORLD);
+        
+        t0 = instr_start();
+        sortopt_gather(ops, sorted, sorted_count, &gathered, &gathered_count, 0,
+                       MPI_COMM_WORLD);
+        instr_stop(PHASE_GATHER, t0);
+        
+        TRACED("MPI_Barrier",
+               MPI_Barrier(MPI_COMM_WORLD));
+        total_time = MPI_Wtime() - start_time;
+        bench_record(bench, iter, total_time, MPI_COMM_WORLD);
+    }
+    
+    // Vérification: ordre global et mêmes enregistrements avant et après
+    double t0 = instr_start();
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    sortopt_checksum(&before, ops, local, local_count);
+    sortopt_checksum(&after, ops, sorted, sorted_count);
+    int ok = sortopt_verify_distributed(ops, sorted, sorted_count, MPI_COMM_WORLD);
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        ok = 0;
+    }
+    instr_stop(PHASE_VERIFY, t0);
+    
+    long long total_bytes = 0;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+    
+    if (rank == 0) {
         printf("\n=== Résultats ===\n");
-        printf("Tri correct: %s\n", sorted ? "OUI" : "NON");
+        printf("Tri correct: %s\n", ok ? "OUI" : "NON");
+        if (gathered_count > 0) {
+            print_record("Premier", ops, gathered);
+            print_record("Dernier", ops, gathered + (size_t)(gathered_count - 1) * ops->fields);
+        }
+        printf("Volume échangé: %lld octets\n", total_bytes);
         printf("Temps d'exécution: %.6f secondes\n", total_time);
-        printf("Éléments triés par seconde: %.2f millions\n", 
+        printf("Éléments triés par seconde: %.2f millions\n",
                (total_size / total_time) / 1000000.0);
         
         // Format CSV pour les benchmarks
         printf("\nCSV: %d,%d,%.6f\n", num_procs, total_size, total_time);
     }
+    
+    if (opts->bench) {
+        bench_report(bench, "bucket_sort_mpi", num_procs, 1, total_size, 0,
+                     opts->bench_csv, MPI_COMM_WORLD);
+    }
+    
+    free(records);
+    free(local);
+    free(sorted);
+    free(gathered);
+}
 
-    // Libération de la mémoire
+/**
+ * Calibration (--tune): seuils du tri local par balayage, puis seuil de
+ * déséquilibre à partir des meilleurs temps de chaque partitionnement sur
+ * les données courantes. Le résultat est enregistré dans le cache.
+ */
+void tune_bucket_sort(int *data, options_t *opts, int rank, int num_procs) {
+    strategy_t *strategy = &opts->strategy;
+    tuning_calibrate_local_sort(strategy, opts->total_size / num_procs, MPI_COMM_WORLD);
+    
+    if (opts->output_mode == OUTPUT_SORT) {
+        options_t trial = *opts;
+        trial.presort = 0;
+        sort_result_t result;
+        double local_times[NUM_PARTITIONS];
+        double times[NUM_PARTITIONS];
+        int largest = 0, total = 0;
+        
+        for (int p = 0; p < NUM_PARTITIONS; p++) {
+            trial.strategy.partition = p;
+            local_times[p] = 1e30;
+            for (int rep = 0; rep < 3; rep++) {
+                run_bucket_sort(data, &trial, rank, num_procs, &result);
+                if (result.total_time < local_times[p]) local_times[p] = result.total_time;
+                if (p == PARTITION_RANGE && rep == 0) {
+                    MPI_Allreduce(&result.local_output_size, &largest, 1, MPI_INT, MPI_MAX,
+                                  MPI_COMM_WORLD);
+                    MPI_Allreduce(&result.local_output_size, &total, 1, MPI_INT, MPI_SUM,
+                                  MPI_COMM_WORLD);
+                }
+                free_sort_result(&result);
+            }
+        }
+        MPI_Allreduce(local_times, times, NUM_PARTITIONS, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        
+        double imbalance = total > 0 ? (double)largest * num_procs / total : 1.0;
+        strategy->sample_imbalance = tuning_fit_imbalance(times[PARTITION_RANGE], imbalance,
+                                                          times[PARTITION_SAMPLE]);
+        if (rank == 0) {
+            printf("Calibration: intervalles %.6f s (déséquilibre %.2f), échantillonnage %.6f s\n",
+                   times[PARTITION_RANGE], imbalance, times[PARTITION_SAMPLE]);
+        }
+    }
+    
+    tuning_store(opts->tune_file, "bucket_sort_mpi", num_procs, 1, opts->total_size, 0,
+                 strategy, MPI_COMM_WORLD);
+}
 
-    free(local_data);
-    free(sendcounts);
-    free(displs);
-    free(bucket_counts);
-    free(bucket_indices);
-    free(recv_counts);
-    free(send_displs);
-    free(recv_displs);
-    free(send_buffer);
-    free(recv_bucket);
+/**
+ * Fonction principale du Bucket Sort distribué
+ */
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    int *data = NULL;
+    int total_size;
+    double total_time;
+    options_t opts;
+    sort_result_t result;
+    bench_t bench;
     
-    for (int i = 0; i < num_procs; i++) {
-        free(local_buckets[i]);
+    // Initialisation MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    
+    // Lecture de la taille du tableau et des options
+    parse_arguments(argc, argv, &opts);
+    total_size = opts.total_size;
+    instr_init(opts.stats_format, opts.trace_path != NULL || opts.bench);
+    if (opts.profile) {
+        instr_profile_init();
+    }
+    if (opts.trace_path != NULL) {
+        trace_init(opts.trace_path, MPI_COMM_WORLD);
     }
-    free(local_buckets);
+    
+    // Vérification de la distribution
+    if (opts.dist < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: distribution inconnue (uniform, zipf, gaussian, sorted, "
+                    "reverse, nearly-sorted, all-equal, few-unique)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.strategy.partition == -1 || opts.strategy.local_sort == -1
+        || opts.strategy.exchange == -1) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: stratégie inconnue (--partition=range|sample|auto, "
+                    "--local-sort=qsort|radix|counting|natural|auto, --exchange=dense|sparse|auto)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.num_quantiles < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: liste invalide (--quantiles=q1,q2,... dans [0, 1], "
+                    "--kth=r1,r2,... dans [0, taille - 1])\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.incremental_rounds > 0 && (opts.output_mode != OUTPUT_SORT || opts.num_quantiles > 0)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --incremental ne s'applique qu'au tri\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.key_type < 0 || opts.order < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: option inconnue (--keys=int|string|pair, "
+                    "--order=asc|desc)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    int ordered = opts.order == SORT_DESC || opts.stable || opts.key_type == KEYS_PAIR;
+    if (opts.key_type == KEYS_STRING && ordered) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --keys=string ne se combine pas avec --order=desc ni "
+                    "--stable\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (ordered && (opts.output_mode != OUTPUT_SORT || opts.num_quantiles > 0
+                    || opts.incremental_rounds > 0 || opts.tune)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --order=desc, --stable et --keys=pair ne s'appliquent "
+                    "qu'au tri (sans --incremental ni --tune)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.key_type == KEYS_STRING && (opts.output_mode != OUTPUT_SORT || opts.num_quantiles > 0
+                             || opts.incremental_rounds > 0 || opts.tune)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --keys=string ne s'applique qu'au tri (sans --incremental "
+                    "ni --tune)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.approx_bits >= 0 && opts.num_quantiles == 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --approx s'utilise avec --quantiles ou --kth\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // --strategy=auto: seuils du cache de calibration (sinon seuils par défaut)
+    int cached = 0;
+    if (opts.strategy_auto && !opts.tune) {
+        cached = tuning_load(opts.tune_file, "bucket_sort_mpi", num_procs, 1, total_size, 0,
+                             &opts.strategy, MPI_COMM_WORLD);
+    }
+    
+    // Sans --bench: une seule itération mesurée, sans chauffe
+    bench_init(&bench, opts.bench ? opts.bench_warmup : 0, opts.bench ? opts.bench_reps : 1);
+    
+    if (rank == 0) {
+        printf("=== Bucket Sort Distribué avec MPI ===\n");
+        printf("Nombre de processus: %d\n", num_procs);
+        printf("Taille du tableau: %d\n", total_size);
+        printf("Valeur maximale: %d\n", MAX_VALUE);
+        printf("Distribution: %s (graine %llu)\n", workload_dist_name(opts.dist), opts.seed);
+        if (opts.output_mode == OUTPUT_UNIQUE) {
+            printf("Mode: clés distinctes (--unique)\n");
+        } else if (opts.output_mode == OUTPUT_COUNT) {
+            printf("Mode: histogramme (--count)\n");
+        }
+        if (opts.num_quantiles > 0) {
+            printf("Mode: statistiques d'ordre (%d rangs, sans tri)%s\n", opts.num_quantiles,
+                   opts.approx_bits >= 0 ? ", approchées" : "");
+        }
+    }
+    
+    // Clés chaînes: pipeline dédié (strsort.h)
+    if (opts.key_type == KEYS_STRING) {
+        if (rank == 0) {
+            printf("Mode: clés chaînes (--keys=string, partition par préfixes échantillonnés, "
+                   "tri multiclé)\n");
+        }
+        run_string_sort(&opts, rank, num_procs, &bench);
+        instr_report("bucket_sort_mpi", total_size, 1, MPI_COMM_WORLD);
+        trace_write(MPI_COMM_WORLD);
+        bench_free(&bench);
+        MPI_Finalize();
+        return 0;
+    }
+    
+    // Ordre décroissant, stable ou multiclé: pipeline d'enregistrements (sortopt.h)
+    if (ordered) {
+        if (rank == 0) {
+            printf("Mode: ordre %s%s%s (partition échantillonnée, noyaux spécialisés)\n",
+                   opts.order == SORT_DESC ? "décroissant" : "croissant",
+                   opts.key_type == KEYS_PAIR ? ", clés (clé, clé2)" : "",
+                   opts.stable ? ", stable" : "");
+        }
+        run_ordered_sort(&opts, rank, num_procs, &bench);
+        instr_report("bucket_sort_mpi", total_size, 1, MPI_COMM_WORLD);
+        trace_write(MPI_COMM_WORLD);
+        bench_free(&bench);
+        MPI_Finalize();
+        return 0;
+    }
+    
+    // Allocation et génération des données sur le processus 0
+    if (rank == 0) {
+        data = (int*)malloc(total_size * sizeof(int));
+        if (data == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        workload_generate(data, 0, total_size, total_size, MAX_VALUE, opts.dist, opts.seed);
+        // print_array(data, total_size, "Données initiales");
+    }
+    
+    // Calibration sur la machine courante (--tune)
+    if (opts.tune) {
+        tune_bucket_sort(data, &opts, rank, num_procs);
+    }
+    
+    if (rank == 0) {
+        printf("Stratégie: partition=%s, échange=%s, tri local=%s",
+               strategy_choice_name(opts.strategy.partition, partition_name),
+               strategy_choice_name(opts.strategy.exchange, exchange_name),
+               strategy_choice_name(opts.strategy.local_sort, sort_kernel_name));
+        if (opts.strategy_auto || opts.tune) {
+            printf(" (seuils %s: déséquilibre %.2f, base >= %d, comptage <= %.2f x taille)",
+                   opts.tune ? "calibrés" : (cached ? "du cache" : "par défaut"),
+                   opts.strategy.sample_imbalance, opts.strategy.radix_min_size,
+                   opts.strategy.counting_max_ratio);
+        }
+        printf("\n");
+    }
+    
+    // ÉTAPES 1 à 5 (répétées en mode --bench; l'entrée n'est jamais modifiée)
+    for (int iter = 0; iter < bench_iterations(&bench); iter++) {
+        if (iter > 0) {
+            free_sort_result(&result);
+        }
+        instr_reset();
+        run_bucket_sort(data, &opts, rank, num_procs, &result);
+        bench_record(&bench, iter, result.total_time, MPI_COMM_WORLD);
+    }
+    total_time = result.total_time;
+    
+    // Volume total envoyé lors de l'échange All-to-All
+    long long total_bytes = 0;
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&result.bytes_sent, &total_bytes, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+    
+    // ÉTAPE 6: Vérification et affichage des résultats
+    
+    // Vérification distribuée: ordre local, frontières entre processus et
+    // empreinte du multi-ensemble des clés avant/après (O(n/p) par processus)
+    int sorted;
+    double t0 = instr_start();
+    checksum_t before, after;
+    checksum_init(&before);
+    checksum_init(&after);
+    
+    int *exact = NULL;
+    if (opts.num_quantiles > 0 && opts.approx_bits >= 0) {
+        // Valeurs exactes par sélection distribuée: chacune doit être dans
+        // l'encadrement donné par le résumé
+        exact = (int*)malloc(opts.num_quantiles * sizeof(int));
+        quantile_select(result.local_input, result.local_input_size, opts.quantile_ranks,
+                        opts.num_quantiles, exact, MPI_COMM_WORLD);
+        sorted = 1;
+        for (int q = 0; q < opts.num_quantiles; q++) {
+            if (exact[q] < result.quantile_bounds[2 * q] ||
+                exact[q] > result.quantile_bounds[2 * q + 1]) {
+                sorted = 0;
+            }
+        }
+    } else if (opts.num_quantiles > 0) {
+        // Rang global de chaque valeur encadré par comptage distribué
+        sorted = verify_quantiles_distributed(result.local_input, result.local_input_size,
+                                              opts.quantile_ranks, result.quantiles,
+                                              opts.num_quantiles, MPI_COMM_WORLD);
+    } else if (opts.output_mode == OUTPUT_SORT) {
+        checksum_add_array(&before, result.local_input, result.local_input_size);
+        checksum_add_array(&after, result.local_sorted, result.local_output_size);
+        sorted = verify_sorted_distributed(result.local_sorted, result.local_output_size,
+                                           0, MPI_COMM_WORLD);
+    } else {
+        // Clés strictement croissantes; en mode --count, les occurrences
+        // reconstituent exactement les données d'entrée
+        sorted = verify_pairs_distributed(result.local_pairs, result.local_output_size,
+                                          MPI_COMM_WORLD);
+        if (opts.output_mode == OUTPUT_COUNT) {
+            checksum_add_array(&before, result.local_input, result.local_input_size);
+            checksum_add_pairs(&after, result.local_pairs, result.local_output_size);
+        }
+    }
+    if (!checksum_equal(&before, &after, MPI_COMM_WORLD)) {
+        sorted = 0;
+    }
+    instr_stop(PHASE_VERIFY, t0);
+    
+    if (rank == 0) {
+        key_count_t *histogram = result.histogram;
+        int total_distinct = result.total_distinct;
+        
+        
+        printf("\n=== Résultats ===\n");
+        if (opts.num_quantiles > 0 && opts.approx_bits >= 0) {
+            printf("Statistiques d'ordre approchées (précision 2^-%d, un MPI_Allreduce de "
+                   "%lld octets):\n", opts.approx_bits, result.approx_bytes);
+            for (int q = 0; q < opts.num_quantiles; q++) {
+                printf("  rang %lld (%.4f%%): %d, dans [%lld, %lld] (exact: %d)\n",
+                       opts.quantile_ranks[q], quantile_percent(opts.quantile_ranks[q], total_size),
+                       result.quantiles[q], result.quantile_bounds[2 * q],
+                       result.quantile_bounds[2 * q + 1], exact[q]);
+            }
+            printf("Borne d'erreur respectée: %s\n", sorted ? "OUI" : "NON");
+        } else if (opts.num_quantiles > 0) {
+            printf("Statistiques d'ordre (%d tours de MPI_Allreduce):\n", result.quantile_rounds);
+            for (int q = 0; q < opts.num_quantiles; q++) {
+                printf("  rang %lld (%.4f%%): %d\n", opts.quantile_ranks[q],
+                       quantile_percent(opts.quantile_ranks[q], total_size), result.quantiles[q]);
+            }
+            printf("Valeurs correctes: %s\n", sorted ? "OUI" : "NON");
+        } else {
+            printf("Tri correct: %s\n", sorted ? "OUI" : "NON");
+        }
+        if (opts.output_mode == OUTPUT_SORT && opts.num_quantiles == 0) {
+            if (result.presort == PRESORT_SORTED || result.presort == PRESORT_REVERSE) {
+                printf("Préordre détecté: %s (%s)\n", presort_name(result.presort),
+                       result.presort == PRESORT_SORTED ? "ni échange ni tri"
+                                                        : "inversion et échange entre paires");
+            } else {
+                if (opts.presort) {
+                    printf("Préordre détecté: %s\n", presort_name(result.presort));
+                }
+                printf("Partitionnement utilisé: %s, échange: %s\n",
+                       partition_name(result.partition), exchange_name(result.exchange));
+            }
+        }
+        if (opts.output_mode != OUTPUT_SORT) {
+            printf("Clés distinctes: %d (facteur de duplication: %.2f)\n",
+                   total_distinct, total_distinct > 0 ? (double)total_size / total_distinct : 0.0);
+            printf("Volume échangé: %lld octets (%.1f%% du tri complet)\n",
+                   total_bytes, total_size > 0 ? 100.0 * total_bytes / ((double)total_size * sizeof(int)) : 0.0);
+            if (opts.output_mode == OUTPUT_COUNT && total_distinct > 0) {
+                printf("Premières entrées: ");
+                for (int i = 0; i < total_distinct && i < 5; i++) {
+                    printf("(%d, %d) ", histogram[i].key, histogram[i].count);
+                }
+                printf("...\n");
+            }
+        }
+        printf("Temps d'exécution: %.6f secondes\n", total_time);
+        if (opts.num_quantiles > 0) {
+            // Rien n'est trié: ligne propre, pour ne pas se mêler aux temps de tri
+            printf("\nCSV_QUANTILES: %d,%d,%d,%.6f\n", num_procs, total_size,
+                   opts.num_quantiles, total_time);
+        } else {
+            printf("Éléments triés par seconde: %.2f millions\n",
+                   (total_size / total_time) / 1000000.0);
+            
+            // Format CSV pour les benchmarks
+            printf("\nCSV: %d,%d,%.6f\n", num_procs, total_size, total_time);
+        }
+    }
+    
+    // Statistiques du mode --bench (toutes les itérations mesurées)
+    if (opts.bench) {
+        bench_report(&bench, "bucket_sort_mpi", num_procs, 1, total_size, 0,
+                     opts.bench_csv, MPI_COMM_WORLD);
+    }
+    
+    // Mises à jour incrémentales à partir du tableau trié
+    if (opts.incremental_rounds > 0) {
+        run_incremental(&opts, &result, rank, num_procs);
+    }
+    
+    // Statistiques par phase et par processus (--stats, dernière itération
+    // ou dernier lot en mode --incremental)
+    instr_report("bucket_sort_mpi", total_size, 1, MPI_COMM_WORLD);
+    trace_write(MPI_COMM_WORLD);
+    
+    // Libération de la mémoire
+    
+    free_sort_result(&result);
+    free(exact);
+    bench_free(&bench);
     
     if (rank == 0) {
         free(data);
-        free(sorted_data);
-        free(final_counts);
-        free(final_displs);
     }
     
     MPI_Finalize();
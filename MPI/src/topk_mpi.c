@@ -11,37 +11,65 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
 #include <mpi.h>
 
+#include "instrument.h"
+#include "trace.h"
+#include "bench.h"
+#include "workload.h"
+#include "verify.h"
+#include "partition.h"
+#include "tuning.h"
+#include "argtopk.h"
+#include "sort_kernels.h"
+#include "stream.h"
+#include "sketch.h"
+#include "quantile.h"
+
 // Taille par défaut du tableau
 #define DEFAULT_SIZE 1000000
 #define MAX_VALUE 1000000
 #define DEFAULT_K 100
+#define MAX_QUERIES 64
 
 /**
- * Comparateur pour qsort - tri décroissant
+ * Requête du mode --batch: les K plus grands d'une colonne
  */
-int compare_int_desc(const void *a, const void *b) {
-    return (*(int*)b - *(int*)a);
-}
+typedef struct {
+    int column;         // Colonne interrogée (données de graine seed + column)
+    int k;
+} topk_query_t;
 
 /**
- * Comparateur pour qsort - tri croissant
+ * Options de la ligne de commande
  */
-int compare_int_asc(const void *a, const void *b) {
-    return (*(int*)a - *(int*)b);
-}
-
-/**
- * Génère un tableau d'entiers aléatoires
- */
-void generate_random_array(int *arr, int size, int max_value, unsigned int seed) {
-    srand(seed);
-    for (int i = 0; i < size; i++) {
-        arr[i] = rand() % max_value;
-    }
-}
+typedef struct {
+    int total_size;     // Taille du tableau (1er argument positionnel)
+    int k;              // Nombre de valeurs à extraire (2e argument positionnel)
+    int stats_format;   // STATS_NONE, STATS_CSV ou STATS_JSON (--stats)
+    const char *trace_path; // Fichier de trace Chrome/Perfetto (--trace), NULL sinon
+    int profile;        // Compteurs matériels par phase (--profile)
+    int bench;          // Mode benchmark intégré (--bench[=W,M])
+    int bench_warmup;   // Itérations de chauffe
+    int bench_reps;     // Itérations mesurées
+    const char *bench_csv;  // Fichier CSV des résultats (--bench-csv=fichier)
+    int dist;           // Distribution des données (--dist=nom, DIST_*)
+    unsigned long long seed;    // Graine du générateur (--seed=n)
+    strategy_t strategy;        // Méthode de fusion (--topk-method=nom)
+    int strategy_auto;  // Méthode lue dans le cache (--strategy=auto)
+    int tune;           // Calibration et mise à jour du cache (--tune)
+    const char *tune_file;      // Cache de calibration (--tune-file=fichier)
+    int argtopk;        // Indices globaux des K plus grands (--argtopk)
+    int payload;        // Charge utile transportée avec chaque indice (--payload)
+    topk_query_t queries[MAX_QUERIES];  // Requêtes (--batch=colonne:K,...)
+    int num_queries;    // 0 sans --batch, -1 si la liste est invalide
+    const char *stream_source;  // Source du mode flux (--stream[=source]), NULL sinon
+    int chunk_size;     // Taille des blocs lus (--chunk=n)
+    int snapshot_every; // Instantané global tous les n blocs (--snapshot=n), 0: à la fin
+    int approx_bits;    // Top-K approché de précision 2^-bits (--approx[=bits]), -1 sinon
+} options_t;
 
 /**
  * Vérifie si un tableau est trié en ordre décroissant
@@ -69,59 +97,285 @@ void print_array(int *arr, int size, const char *name) {
 }
 
 /**
- * Fonction principale du Top-K distribué
- * 
- * Stratégie:
- * - Utiliser le Bucket Sort pour partitionner les données
- * - Commencer par les buckets des plus grandes valeurs
- * - S'arrêter dès qu'on a collecté K éléments
+ * Lit une liste de requêtes "colonne:K,colonne:K,..." ("K" seul: colonne 0).
+ * Retourne le nombre de requêtes, ou -1 si la liste est invalide.
  */
-int main(int argc, char *argv[]) {
-    int rank, num_procs;
-    int *data = NULL;
-    int *topk_result = NULL;
-    int total_size, k;
-    double start_time, end_time, total_time;
+static int parse_queries(const char *spec, topk_query_t *queries) {
+    int count = 0;
+    const char *p = spec;
+    while (*p != '\0') {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p || count == MAX_QUERIES) {
+            return -1;
+        }
+        queries[count].column = 0;
+        queries[count].k = (int)first;
+        if (*end == ':') {
+            p = end + 1;
+            queries[count].column = (int)first;
+            queries[count].k = (int)strtol(p, &end, 10);
+            if (end == p) {
+                return -1;
+            }
+        }
+        if (queries[count].column < 0 || queries[count].k <= 0) {
+            return -1;
+        }
+        count++;
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p = end;
+    }
+    return count > 0 ? count : -1;
+}
+
+/**
+ * Lecture des arguments: <taille> <k> [--stats[=csv|json]]
+ *                        [--trace[=fichier.json]] [--profile]
+ *                        [--bench[=W,M]] [--bench-csv=fichier]
+ *                        [--dist=nom] [--seed=n]
+ *                        [--strategy=auto] [--tune] [--tune-file=fichier]
+ *                        [--topk-method=gather|tree|histogram|auto]
+ *                        [--argtopk [--payload]]
+ *                        [--batch=colonne:K,colonne:K,...]
+ *                        [--stream[=gen[:N]|-|fichier] [--chunk=n] [--snapshot=n]]
+ *                        [--approx[=bits]]
+ */
+void parse_arguments(int argc, char *argv[], options_t *opts) {
+    int positional = 0;
+    int method = TOPK_GATHER;
+    int explicit_method = 0;
     
-    // Initialisation MPI
-    MPI_Init(&argc, &argv);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    opts->total_size = DEFAULT_SIZE;
+    opts->k = DEFAULT_K;
+    opts->stats_format = STATS_NONE;
+    opts->trace_path = NULL;
+    opts->profile = 0;
+    opts->bench = 0;
+    opts->bench_csv = NULL;
+    opts->dist = DIST_UNIFORM;
+    opts->seed = WORKLOAD_DEFAULT_SEED;
+    opts->strategy_auto = 0;
+    opts->tune = 0;
+    opts->tune_file = TUNING_DEFAULT_FILE;
+    opts->argtopk = 0;
+    opts->payload = 0;
+    opts->num_queries = 0;
+    opts->stream_source = NULL;
+    opts->chunk_size = STREAM_DEFAULT_CHUNK;
+    opts->snapshot_every = 0;
+    opts->approx_bits = -1;
     
-    // Lecture des paramètres
-    total_size = (argc > 1) ? atoi(argv[1]) : DEFAULT_SIZE;
-    k = (argc > 2) ? atoi(argv[2]) : DEFAULT_K;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=csv") == 0) {
+            opts->stats_format = STATS_CSV;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            opts->stats_format = STATS_JSON;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opts->trace_path = "trace.json";
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            opts->trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            opts->profile = 1;
+        } else if (bench_parse_option(argv[i], &opts->bench_warmup, &opts->bench_reps)) {
+            opts->bench = 1;
+        } else if (strncmp(argv[i], "--bench-csv=", 12) == 0) {
+            opts->bench_csv = argv[i] + 12;
+        } else if (strncmp(argv[i], "--dist=", 7) == 0) {
+            opts->dist = workload_parse_dist(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            opts->seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strcmp(argv[i], "--strategy=auto") == 0) {
+            opts->strategy_auto = 1;
+        } else if (strcmp(argv[i], "--tune") == 0) {
+            opts->tune = 1;
+        } else if (strncmp(argv[i], "--tune-file=", 12) == 0) {
+            opts->tune_file = argv[i] + 12;
+        } else if (strncmp(argv[i], "--topk-method=", 14) == 0) {
+            method = strategy_parse_choice(argv[i] + 14, topk_method_parse);
+            explicit_method = 1;
+        } else if (strcmp(argv[i], "--argtopk") == 0) {
+            opts->argtopk = 1;
+        } else if (strcmp(argv[i], "--payload") == 0) {
+            opts->argtopk = 1;
+            opts->payload = 1;
+        } else if (strncmp(argv[i], "--batch=", 8) == 0) {
+            opts->num_queries = parse_queries(argv[i] + 8, opts->queries);
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            opts->stream_source = "gen";
+        } else if (strncmp(argv[i], "--stream=", 9) == 0) {
+            opts->stream_source = argv[i] + 9;
+        } else if (strncmp(argv[i], "--chunk=", 8) == 0) {
+            opts->chunk_size = atoi(argv[i] + 8);
+            if (opts->chunk_size < 1) opts->chunk_size = STREAM_DEFAULT_CHUNK;
+        } else if (strncmp(argv[i], "--snapshot=", 11) == 0) {
+            opts->snapshot_every = atoi(argv[i] + 11);
+            if (opts->snapshot_every < 0) opts->snapshot_every = 0;
+        } else if (strcmp(argv[i], "--approx") == 0) {
+            opts->approx_bits = TOP_SKETCH_DEFAULT_BITS;
+        } else if (strncmp(argv[i], "--approx=", 9) == 0) {
+            opts->approx_bits = atoi(argv[i] + 9);
+            if (opts->approx_bits < 0 || opts->approx_bits > TOP_SKETCH_MAX_BITS) {
+                opts->approx_bits = TOP_SKETCH_DEFAULT_BITS;
+            }
+        } else if (positional == 0) {
+            opts->total_size = atoi(argv[i]);
+            positional++;
+        } else if (positional == 1) {
+            opts->k = atoi(argv[i]);
+            positional++;
+        }
+    }
     
-    // Vérification de k
-    if (k > total_size) {
-        if (rank == 0) {
-            fprintf(stderr, "Erreur: k (%d) > taille du tableau (%d)\n", k, total_size);
+    // --strategy=auto: méthode lue dans le cache si elle n'est pas imposée
+    if (opts->strategy_auto && !explicit_method) {
+        method = STRATEGY_AUTO;
+    }
+    strategy_init(&opts->strategy, -1, -1, method);
+}
+
+/**
+ * Fusionne deux listes décroissantes en gardant au plus k éléments
+ */
+static int merge_desc(const int *a, int size_a, const int *b, int size_b, int k, int *out) {
+    int i = 0, j = 0, n = 0;
+    while (n < k && (i < size_a || j < size_b)) {
+        if (j >= size_b || (i < size_a && a[i] >= b[j])) {
+            out[n++] = a[i++];
+        } else {
+            out[n++] = b[j++];
         }
-        MPI_Finalize();
-        return 1;
     }
+    return n;
+}
+
+/**
+ * Fusion par rassemblement: les K locaux sont envoyés au processus 0
+ * (MPI_Gatherv), qui les trie et garde les K premiers
+ */
+int *topk_gather(int *local_topk, int local_k, int k, int rank, int num_procs) {
+    int *topk_result = NULL;
+    int *recv_buffer = NULL;
+    int *all_k = NULL;
+    int *all_displs = NULL;
+    int total_elements = 0;
     
+    double t0 = instr_start();
     if (rank == 0) {
-        printf("=== Top-K Extraction avec MPI ===\n");
-        printf("Nombre de processus: %d\n", num_procs);
-        printf("Taille du tableau: %d\n", total_size);
-        printf("K (top éléments à extraire): %d\n", k);
-        printf("Valeur maximale: %d\n", MAX_VALUE);
+        all_k = (int*)malloc(num_procs * sizeof(int));
+        all_displs = (int*)malloc(num_procs * sizeof(int));
     }
     
-    // Allocation et génération des données sur le processus 0
+    TRACED("MPI_Gather",
+           MPI_Gather(&local_k, 1, MPI_INT, all_k, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    
     if (rank == 0) {
-        data = (int*)malloc(total_size * sizeof(int));
-        if (data == NULL) {
-            fprintf(stderr, "Erreur d'allocation mémoire\n");
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        for (int i = 0; i < num_procs; i++) {
+            all_displs[i] = total_elements;
+            total_elements += all_k[i];
+        }
+        recv_buffer = (int*)malloc(total_elements * sizeof(int));
+    }
+    
+    // Gather de tous les top-K locaux
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv(local_topk, local_k, MPI_INT,
+                       recv_buffer, all_k, all_displs, MPI_INT,
+                       0, MPI_COMM_WORLD));
+    instr_stop(PHASE_GATHER, t0);
+    instr_add_bytes((long long)local_k * sizeof(int), 0);
+    
+    // Fusion finale et extraction du top-K global
+    if (rank == 0) {
+        t0 = instr_start();
+        instr_add_bytes(0, (long long)total_elements * sizeof(int));
+        
+        // Tri de tous les éléments reçus (décroissant)
+        sort_int_order(recv_buffer, total_elements, SORT_DESC);
+        
+        // Extraction des K premiers
+        topk_result = (int*)malloc(k * sizeof(int));
+        memcpy(topk_result, recv_buffer, k * sizeof(int));
+        instr_stop(PHASE_MERGE, t0);
+        
+        free(recv_buffer);
+        free(all_k);
+        free(all_displs);
+    }
+    return topk_result;
+}
+
+/**
+ * Fusion en arbre binaire: à l'étape s, le processus rank + s envoie sa
+ * liste au processus rank, qui la fusionne avec la sienne (log2 p étapes,
+ * taille des messages découverte par MPI_Probe)
+ */
+int *topk_tree(int *local_topk, int local_k, int k, int rank, int num_procs) {
+    int *current = (int*)malloc((k + 1) * sizeof(int));
+    int *received = (int*)malloc((k + 1) * sizeof(int));
+    int *merged = (int*)malloc((k + 1) * sizeof(int));
+    int current_k = local_k;
+    memcpy(current, local_topk, local_k * sizeof(int));
+    
+    for (int step = 1; step < num_procs; step *= 2) {
+        if (rank % (2 * step) == step) {
+            double t0 = instr_start();
+            TRACED("MPI_Send",
+                   MPI_Send(current, current_k, MPI_INT, rank - step, 0, MPI_COMM_WORLD));
+            instr_stop(PHASE_GATHER, t0);
+            instr_add_bytes((long long)current_k * sizeof(int), 0);
+            break;
+        }
+        if (rank % (2 * step) == 0 && rank + step < num_procs) {
+            MPI_Status status;
+            int received_k;
+            double t0 = instr_start();
+            TRACED("MPI_Probe",
+                   MPI_Probe(rank + step, 0, MPI_COMM_WORLD, &status));
+            MPI_Get_count(&status, MPI_INT, &received_k);
+            TRACED("MPI_Recv",
+                   MPI_Recv(received, received_k, MPI_INT, rank + step, 0, MPI_COMM_WORLD,
+                            MPI_STATUS_IGNORE));
+            instr_stop(PHASE_GATHER, t0);
+            instr_add_bytes(0, (long long)received_k * sizeof(int));
+            
+            t0 = instr_start();
+            current_k = merge_desc(current, current_k, received, received_k, k, merged);
+            int *tmp = current;
+            current = merged;
+            merged = tmp;
+            instr_stop(PHASE_MERGE, t0);
         }
-        generate_random_array(data, total_size, MAX_VALUE, 42);
     }
     
+    free(received);
+    free(merged);
+    if (rank != 0) {
+        free(current);
+        return NULL;
+    }
+    return current;
+}
+
+/**
+ * Exécution chronométrée du Top-K (étapes 1 à 4) à partir des données du
+ * processus 0, qui ne sont pas modifiées, avec la méthode de fusion donnée
+ * (TOPK_*). Retourne les K plus grandes valeurs sur le processus 0 (NULL
+ * ailleurs, à libérer). La partie locale des données est conservée dans
+ * *local_out pour la vérification.
+ */
+int *run_topk(int *data, int total_size, int k, int method, int rank, int num_procs,
+              int **local_out, int *local_size_out, double *total_time) {
+    int *topk_result = NULL;
+    
     // Synchronisation avant le chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    start_time = MPI_Wtime();
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
 
     // ÉTAPE 1: Distribution des données
 
@@ -141,120 +395,1020 @@ int main(int argc, char *argv[]) {
     
     int *local_data = (int*)malloc(local_size * sizeof(int));
     
-    MPI_Scatterv(data, sendcounts, displs, MPI_INT,
-                 local_data, local_size, MPI_INT,
-                 0, MPI_COMM_WORLD);
+    double t0 = instr_start();
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    instr_stop(PHASE_SCATTER, t0);
     
     // ÉTAPE 2: Trouver les K plus grands localement
+    
+    int *local_topk;
+    int local_k;
+    
+    if (method == TOPK_HISTOGRAM) {
+        // Seuil global par histogramme (MPI_Allreduce): seuls les éléments
+        // au-dessus du seuil sont triés, au lieu du tableau local entier
+        t0 = instr_start();
+        int threshold = topk_histogram_threshold(local_data, local_size, k, MAX_VALUE,
+                                                 MPI_COMM_WORLD);
+        int num_candidates = 0;
+        local_topk = (int*)malloc((local_size + 1) * sizeof(int));
+        for (int i = 0; i < local_size; i++) {
+            if (local_data[i] >= threshold) {
+                local_topk[num_candidates++] = local_data[i];
+            }
+        }
+        instr_stop(PHASE_SELECT, t0);
+        
+        t0 = instr_start();
+        sort_int_order(local_topk, num_candidates, SORT_DESC);
+        instr_stop(PHASE_LOCAL_SORT, t0);
+        local_k = (k < num_candidates) ? k : num_candidates;
+    } else {
+        // Tri décroissant du tableau local, puis les local_k premiers
+        local_k = (k < local_size) ? k : local_size;
+        
+        t0 = instr_start();
+        sort_int_order(local_data, local_size, SORT_DESC);
+        instr_stop(PHASE_LOCAL_SORT, t0);
+        
+        local_topk = (int*)malloc((local_k + 1) * sizeof(int));
+        memcpy(local_topk, local_data, local_k * sizeof(int));
+    }
+    instr_set_bucket_size(local_size);
+
+    // ÉTAPES 3 et 4: Collecte et fusion des top-K locaux
 
-    // Chaque processus trouve ses K plus grands éléments locaux
-    // Utilisation d'un tri partiel ou complet selon k vs local_size
+    if (method == TOPK_TREE) {
+        topk_result = topk_tree(local_topk, local_k, k, rank, num_procs);
+    } else {
+        topk_result = topk_gather(local_topk, local_k, k, rank, num_procs);
+    }
     
-    int local_k = (k < local_size) ? k : local_size;
+    // Fin du chronométrage
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    *total_time = MPI_Wtime() - start_time;
     
-    // Tri décroissant du tableau local
-    qsort(local_data, local_size, sizeof(int), compare_int_desc);
+    *local_out = local_data;
+    *local_size_out = local_size;
+    free(local_topk);
+    free(sendcounts);
+    free(displs);
     
-    // Garder seulement les local_k premiers (les plus grands)
-    int *local_topk = (int*)malloc(local_k * sizeof(int));
-    memcpy(local_topk, local_data, local_k * sizeof(int));
-
-    // ÉTAPE 3: Collecte et fusion des top-K locaux
+    return topk_result;
+}
 
-    // Méthode: Réduction arborescente pour fusionner les top-K
-    // Cela réduit la communication comparé à un Gather direct
+/**
+ * Arg-top-K (--argtopk): mêmes étapes que run_topk, mais les candidats
+ * portent leur indice global (et la charge utile de payload si elle est
+ * non NULL sur le processus 0). Les données locales ne sont pas triées:
+ * la sélection ne matérialise que les K gagnants de chaque processus.
+ * Retourne les K entrées sur le processus 0 (NULL ailleurs, à libérer).
+ */
+topk_entry_t *run_argtopk(int *data, int *payload, int with_payload, int total_size, int k,
+                          int method, int rank, int num_procs, int **local_out,
+                          int **local_payload_out, int *local_size_out, double *total_time) {
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
     
-    int *recv_buffer = NULL;
-    int current_k = local_k;
-    int *current_topk = local_topk;
+    // ÉTAPE 1: Distribution des données (et de la charge utile)
     
-    // Gather des tailles
-    int *all_k = NULL;
-    int *all_displs = NULL;
+    int base_size = total_size / num_procs;
+    int remainder = total_size % num_procs;
+    int local_size = base_size + (rank < remainder ? 1 : 0);
     
-    if (rank == 0) {
-        all_k = (int*)malloc(num_procs * sizeof(int));
-        all_displs = (int*)malloc(num_procs * sizeof(int));
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
     }
     
-    MPI_Gather(&local_k, 1, MPI_INT, all_k, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    int *local_data = (int*)malloc((local_size + 1) * sizeof(int));
+    int *local_payload = NULL;
     
-    if (rank == 0) {
-        int total_elements = 0;
-        for (int i = 0; i < num_procs; i++) {
-            all_displs[i] = total_elements;
-            total_elements += all_k[i];
-        }
-        recv_buffer = (int*)malloc(total_elements * sizeof(int));
+    double t0 = instr_start();
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    if (with_payload) {
+        local_payload = (int*)malloc((local_size + 1) * sizeof(int));
+        TRACED("MPI_Scatterv",
+               MPI_Scatterv(payload, sendcounts, displs, MPI_INT,
+                            local_payload, local_size, MPI_INT,
+                            0, MPI_COMM_WORLD));
     }
+    instr_stop(PHASE_SCATTER, t0);
     
-    // Gather de tous les top-K locaux
-    MPI_Gatherv(current_topk, current_k, MPI_INT,
-                recv_buffer, all_k, all_displs, MPI_INT,
-                0, MPI_COMM_WORLD);
+    // ÉTAPE 2: Sélection locale des K premiers (valeur, indice)
+    
+    int min_value = INT_MIN;
+    if (method == TOPK_HISTOGRAM) {
+        min_value = topk_histogram_threshold(local_data, local_size, k, MAX_VALUE,
+                                             MPI_COMM_WORLD);
+    }
+    t0 = instr_start();
+    topk_entry_t *local_topk = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    int local_k = argtopk_select(local_data, local_payload, local_size, displs[rank], k,
+                                 min_value, local_topk);
+    instr_stop(PHASE_SELECT, t0);
+    instr_set_bucket_size(local_size);
+    
+    // ÉTAPES 3 et 4: Fusion des candidats (départage par indice)
+    
+    topk_entry_t *result = argtopk_reduce(local_topk, local_k, k, method, MPI_COMM_WORLD);
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    *total_time = MPI_Wtime() - start_time;
+    
+    *local_out = local_data;
+    *local_payload_out = local_payload;
+    *local_size_out = local_size;
+    free(local_topk);
+    free(sendcounts);
+    free(displs);
+    
+    return result;
+}
 
-    // ÉTAPE 4: Fusion finale et extraction du top-K global
+/**
+ * Taille du message d'un processus de local_size éléments en mode --batch:
+ * un compteur par colonne, puis au plus column_k[c] valeurs par colonne
+ */
+static int batch_message_size(const int *column_k, int num_columns, int local_size) {
+    int size = num_columns;
+    for (int c = 0; c < num_columns; c++) {
+        size += (column_k[c] < local_size) ? column_k[c] : local_size;
+    }
+    return size;
+}
 
-    if (rank == 0) {
-        int total_elements = 0;
-        for (int i = 0; i < num_procs; i++) {
-            total_elements += all_k[i];
+/**
+ * Fusionne deux messages --batch colonne par colonne (au plus column_k[c]
+ * valeurs par colonne). Retourne la taille du message écrit dans out.
+ */
+static int merge_batch_messages(const int *a, const int *b, const int *column_k,
+                                int num_columns, int *out) {
+    const int *values_a = a + num_columns;
+    const int *values_b = b + num_columns;
+    int pos = num_columns;
+    for (int c = 0; c < num_columns; c++) {
+        out[c] = merge_desc(values_a, a[c], values_b, b[c], column_k[c], out + pos);
+        values_a += a[c];
+        values_b += b[c];
+        pos += out[c];
+    }
+    return pos;
+}
+
+/**
+ * Mode --batch (étapes 1 à 4 pour toutes les requêtes): chaque colonne
+ * interrogée (column_k[c] > 0, plus grand K demandé sur la colonne) est
+ * distribuée une seule fois et sélectionnée une seule fois, sans tri complet.
+ * Les listes locales de toutes les colonnes voyagent dans un message unique
+ * par processus ([compteurs][valeurs colonne 0][valeurs colonne 1]...),
+ * rassemblé par un seul MPI_Gatherv ou fusionné en arbre binaire (TOPK_TREE).
+ * La sélection évitant déjà le tri complet, TOPK_HISTOGRAM, qui coûterait un
+ * MPI_Allreduce par colonne, utilise le rassemblement.
+ * Retourne sur le processus 0 les column_k[c] plus grands de chaque colonne
+ * à partir de l'indice offsets[c] (NULL ailleurs, à libérer). Les parties
+ * locales sont conservées dans local_columns pour la vérification.
+ */
+int *run_topk_batch(int **columns, int num_columns, const int *column_k, const int *offsets,
+                    int total_size, int method, int rank, int num_procs,
+                    int **local_columns, int *local_size_out, double *total_time) {
+    int *topk_result = NULL;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    // ÉTAPE 1: Distribution de chaque colonne interrogée (une seule fois)
+    
+    int base_size = total_size / num_procs;
+    int remainder = total_size % num_procs;
+    int local_size = base_size + (rank < remainder ? 1 : 0);
+    
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
+    }
+    
+    double t0 = instr_start();
+    for (int c = 0; c < num_columns; c++) {
+        local_columns[c] = NULL;
+        if (column_k[c] == 0) continue;
+        local_columns[c] = (int*)malloc((local_size + 1) * sizeof(int));
+        TRACED("MPI_Scatterv",
+               MPI_Scatterv(rank == 0 ? columns[c] : NULL, sendcounts, displs, MPI_INT,
+                            local_columns[c], local_size, MPI_INT,
+                            0, MPI_COMM_WORLD));
+    }
+    instr_stop(PHASE_SCATTER, t0);
+    
+    // ÉTAPE 2: Une sélection par colonne, au plus grand K de la colonne
+    
+    int capacity = num_columns + offsets[num_columns] + 1;
+    int *current = (int*)malloc(capacity * sizeof(int));
+    int *received = (int*)malloc(capacity * sizeof(int));
+    int *merged = (int*)malloc(capacity * sizeof(int));
+    
+    t0 = instr_start();
+    int current_size = num_columns;
+    for (int c = 0; c < num_columns; c++) {
+        current[c] = 0;
+        if (column_k[c] == 0) continue;
+        current[c] = sort_top_desc(local_columns[c], local_size, column_k[c]);
+        memcpy(current + current_size, local_columns[c], current[c] * sizeof(int));
+        current_size += current[c];
+    }
+    instr_stop(PHASE_SELECT, t0);
+    instr_set_bucket_size(local_size);
+    
+    // ÉTAPES 3 et 4: Un seul message par processus pour toutes les requêtes
+    
+    if (method == TOPK_TREE) {
+        for (int step = 1; step < num_procs; step *= 2) {
+            if (rank % (2 * step) == step) {
+                t0 = instr_start();
+                TRACED("MPI_Send",
+                       MPI_Send(current, current_size, MPI_INT, rank - step, 0, MPI_COMM_WORLD));
+                instr_stop(PHASE_GATHER, t0);
+                instr_add_bytes((long long)current_size * sizeof(int), 0);
+                break;
+            }
+            if (rank % (2 * step) == 0 && rank + step < num_procs) {
+                MPI_Status status;
+                int received_size;
+                t0 = instr_start();
+                TRACED("MPI_Probe",
+                       MPI_Probe(rank + step, 0, MPI_COMM_WORLD, &status));
+                MPI_Get_count(&status, MPI_INT, &received_size);
+                TRACED("MPI_Recv",
+                       MPI_Recv(received, received_size, MPI_INT, rank + step, 0,
+                                MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+                instr_stop(PHASE_GATHER, t0);
+                instr_add_bytes(0, (long long)received_size * sizeof(int));
+                
+                t0 = instr_start();
+                current_size = merge_batch_messages(current, received, column_k, num_columns,
+                                                    merged);
+                int *tmp = current;
+                current = merged;
+                merged = tmp;
+                instr_stop(PHASE_MERGE, t0);
+            }
+        }
+    } else {
+        // Les tailles des messages se déduisent des tailles locales: un seul
+        // MPI_Gatherv, sans échange préalable des compteurs
+        int *recvcounts = NULL;
+        int *recvdispls = NULL;
+        int *all_messages = NULL;
+        int total_received = 0;
+        if (rank == 0) {
+            recvcounts = (int*)malloc(num_procs * sizeof(int));
+            recvdispls = (int*)malloc(num_procs * sizeof(int));
+            for (int r = 0; r < num_procs; r++) {
+                recvcounts[r] = batch_message_size(column_k, num_columns, sendcounts[r]);
+                recvdispls[r] = total_received;
+                total_received += recvcounts[r];
+            }
+            all_messages = (int*)malloc(total_received * sizeof(int));
         }
         
-        // Tri de tous les éléments reçus (décroissant)
-        qsort(recv_buffer, total_elements, sizeof(int), compare_int_desc);
+        t0 = instr_start();
+        TRACED("MPI_Gatherv",
+               MPI_Gatherv(current, current_size, MPI_INT,
+                           all_messages, recvcounts, recvdispls, MPI_INT,
+                           0, MPI_COMM_WORLD));
+        instr_stop(PHASE_GATHER, t0);
+        instr_add_bytes((long long)current_size * sizeof(int),
+                        rank == 0 ? (long long)total_received * sizeof(int) : 0);
         
-        // Extraction des K premiers
-        topk_result = (int*)malloc(k * sizeof(int));
-        memcpy(topk_result, recv_buffer, k * sizeof(int));
+        if (rank == 0) {
+            t0 = instr_start();
+            for (int r = 1; r < num_procs; r++) {
+                current_size = merge_batch_messages(current, all_messages + recvdispls[r],
+                                                    column_k, num_columns, merged);
+                int *tmp = current;
+                current = merged;
+                merged = tmp;
+            }
+            instr_stop(PHASE_MERGE, t0);
+            free(recvcounts);
+            free(recvdispls);
+            free(all_messages);
+        }
     }
     
-    // Fin du chronométrage
-    MPI_Barrier(MPI_COMM_WORLD);
-    end_time = MPI_Wtime();
-    total_time = end_time - start_time;
-  
-    // ÉTAPE 5: Vérification et affichage des résultats
+    // Chaque colonne contient alors ses column_k[c] plus grands, dans l'ordre
+    // des colonnes: le message sans ses compteurs est le résultat
+    if (rank == 0) {
+        topk_result = (int*)malloc((offsets[num_columns] + 1) * sizeof(int));
+        memcpy(topk_result, current + num_columns, offsets[num_columns] * sizeof(int));
+    }
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    *total_time = MPI_Wtime() - start_time;
+    
+    *local_size_out = local_size;
+    free(current);
+    free(received);
+    free(merged);
+    free(sendcounts);
+    free(displs);
+    
+    return topk_result;
+}
 
+/**
+ * Mode --batch: génère les colonnes interrogées (colonne c: graine seed + c,
+ * la colonne 0 étant data), exécute toutes les requêtes en une passe
+ * (répétée en mode --bench), puis vérifie et affiche chaque réponse, tirée
+ * du résultat de sa colonne
+ */
+void run_batch(int *data, const options_t *opts, int method, int rank, int num_procs,
+                 bench_t *bench) {
+    int num_columns = 0;
+    for (int q = 0; q < opts->num_queries; q++) {
+        if (opts->queries[q].column + 1 > num_columns) {
+            num_columns = opts->queries[q].column + 1;
+        }
+    }
+    
+    // Plus grand K demandé sur chaque colonne et position de son résultat
+    int *column_k = (int*)calloc(num_columns, sizeof(int));
+    int *offsets = (int*)malloc((num_columns + 1) * sizeof(int));
+    for (int q = 0; q < opts->num_queries; q++) {
+        int c = opts->queries[q].column;
+        if (opts->queries[q].k > column_k[c]) {
+            column_k[c] = opts->queries[q].k;
+        }
+    }
+    offsets[0] = 0;
+    for (int c = 0; c < num_columns; c++) {
+        offsets[c + 1] = offsets[c] + column_k[c];
+    }
+    
+    int **columns = (int**)calloc(num_columns, sizeof(int*));
+    int **local_columns = (int**)calloc(num_columns, sizeof(int*));
+    if (rank == 0) {
+        columns[0] = data;
+        for (int c = 1; c < num_columns; c++) {
+            if (column_k[c] == 0) continue;
+            columns[c] = (int*)malloc(opts->total_size * sizeof(int));
+            workload_generate(columns[c], 0, opts->total_size, opts->total_size, MAX_VALUE,
+                              opts->dist, opts->seed + c);
+        }
+    }
+    
+    int *topk_result = NULL;
+    int local_size = 0;
+    double total_time = 0.0;
+    for (int iter = 0; iter < bench_iterations(bench); iter++) {
+        free(topk_result);
+        for (int c = 0; c < num_columns; c++) {
+            free(local_columns[c]);
+        }
+        instr_reset();
+        topk_result = run_topk_batch(columns, num_columns, column_k, offsets, opts->total_size,
+                                     method, rank, num_procs, local_columns, &local_size,
+                                     &total_time);
+        bench_record(bench, iter, total_time, MPI_COMM_WORLD);
+    }
+    
+    // ÉTAPE 5: Vérification distribuée de chaque requête (K premiers du
+    // résultat de sa colonne)
     if (rank == 0) {
-        // Vérification: les résultats sont-ils triés en ordre décroissant?
-        int sorted = is_sorted_desc(topk_result, k);
+        printf("\n=== Résultats (%d requêtes, %d colonnes) ===\n", opts->num_queries,
+               num_columns);
+    }
+    int all_correct = 1;
+    for (int q = 0; q < opts->num_queries; q++) {
+        int c = opts->queries[q].column;
+        int k = opts->queries[q].k;
+        int *answer = (rank == 0) ? topk_result + offsets[c] : NULL;
+        
+        double t0 = instr_start();
+        int correct = verify_topk_distributed(local_columns[c], local_size, answer, k, 0,
+                                              MPI_COMM_WORLD);
+        instr_stop(PHASE_VERIFY, t0);
         
-        // Vérification supplémentaire: comparer avec un tri séquentiel
-        qsort(data, total_size, sizeof(int), compare_int_desc);
-        int correct = 1;
-        for (int i = 0; i < k; i++) {
-            if (topk_result[i] != data[i]) {
-                correct = 0;
+        if (rank == 0) {
+            int sorted = is_sorted_desc(answer, k);
+            printf("Requête %d (colonne %d, K=%d): max %d, K-ième %d, tri %s, valeurs %s\n",
+                   q, c, k, answer[0], answer[k - 1], sorted ? "OUI" : "NON",
+                   correct ? "OUI" : "NON");
+            all_correct = all_correct && sorted && correct;
+        }
+    }
+    if (rank == 0) {
+        printf("Valeurs correctes: %s\n", all_correct ? "OUI" : "NON");
+        printf("Temps d'exécution: %.6f secondes\n", total_time);
+        printf("\nCSV: %d,%d,%d,%.6f\n", num_procs, opts->total_size, offsets[num_columns],
+               total_time);
+    }
+    
+    free(topk_result);
+    for (int c = 0; c < num_columns; c++) {
+        free(local_columns[c]);
+        if (rank == 0 && c > 0) free(columns[c]);
+    }
+    free(local_columns);
+    free(columns);
+    free(column_k);
+    free(offsets);
+}
+
+/**
+ * Mode --stream: chaque processus consomme sa source par blocs (lecture en
+ * double tampon par un thread) dans un tas de K éléments, sans jamais
+ * stocker le flux. Tous les snapshot_every blocs (ou à la fin du flux), un
+ * instantané global est calculé par MPI_Allreduce; les processus dont le
+ * flux est terminé continuent d'y participer jusqu'à la fin de tous les
+ * flux. Retourne 0 si la source ne peut pas être ouverte.
+ */
+int run_stream(const options_t *opts, int k, int rank, int num_procs) {
+    stream_t stream;
+    topk_heap_t heap;
+    
+    int status = stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                             rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+    int all_opened;
+    int opened = (status == 0);
+    MPI_Allreduce(&opened, &all_opened, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_opened) {
+        if (!opened) {
+            fprintf(stderr, "Erreur: processus %d: source %s illisible\n", rank,
+                    opts->stream_source);
+        } else {
+            stream_close(&stream);
+        }
+        return 0;
+    }
+    
+    topk_heap_init(&heap, k);
+    int *local_topk = (int*)malloc((k + 1) * sizeof(int));
+    int *global_topk = (int*)malloc((k + 1) * sizeof(int));
+    int global_count = 0;
+    long long consumed = 0, inserted = 0;
+    long long totals[2] = { 0, 0 };
+    int snapshots = 0;
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    int active = 1;
+    for (;;) {
+        for (int c = 0; active && (opts->snapshot_every == 0 || c < opts->snapshot_every); c++) {
+            const int *chunk;
+            // Attente du thread de lecture
+            double t0 = instr_start();
+            int count = stream_next(&stream, &chunk);
+            instr_stop(PHASE_SCATTER, t0);
+            if (count == 0) {
+                active = 0;
                 break;
             }
+            
+            t0 = instr_start();
+            inserted += topk_heap_push_chunk(&heap, chunk, count);
+            instr_stop(PHASE_SELECT, t0);
+            consumed += count;
         }
         
-        printf("\n=== Résultats ===\n");
-        print_array(topk_result, k, "Top-K");
-        printf("Tri décroissant correct: %s\n", sorted ? "OUI" : "NON");
-        printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
+        // Instantané global
+        double t0 = instr_start();
+        int local_count = topk_heap_sorted(&heap, local_topk);
+        int any_active = topk_snapshot(local_topk, local_count, k, active, global_topk,
+                                       &global_count, MPI_COMM_WORLD);
+        long long local_totals[2] = { consumed, inserted };
+        TRACED("MPI_Reduce",
+               MPI_Reduce(local_totals, totals, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+        instr_stop(PHASE_MERGE, t0);
+        snapshots++;
+        
+        if (rank == 0 && opts->snapshot_every > 0 && global_count > 0) {
+            printf("Instantané %d: %lld éléments lus, max %d, %d-ième %d (%.3f s)\n",
+                   snapshots, totals[0], global_topk[0], global_count,
+                   global_topk[global_count - 1], MPI_Wtime() - start_time);
+        }
+        if (!any_active) break;
+    }
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double total_time = MPI_Wtime() - start_time;
+    stream_close(&stream);
+    instr_set_bucket_size(consumed);
+    
+    // Vérification: seconde lecture de la source (sauf entrée standard)
+    int correct = -1;
+    if (stream_rereadable(opts->stream_source)) {
+        topk_tally_t tally;
+        double t0 = instr_start();
+        topk_tally_init(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        stream_open(&stream, opts->stream_source, opts->total_size, opts->chunk_size,
+                    rank, num_procs, opts->dist, opts->seed, MAX_VALUE);
+        const int *chunk;
+        int count;
+        while ((count = stream_next(&stream, &chunk)) > 0) {
+            topk_tally_add(&tally, chunk, count);
+        }
+        stream_close(&stream);
+        correct = topk_tally_check(&tally, global_topk, global_count, 0, MPI_COMM_WORLD);
+        instr_stop(PHASE_VERIFY, t0);
+    }
+    
+    if (rank == 0) {
+        printf("\n=== Résultats (flux) ===\n");
+        print_array(global_topk, global_count, "Top-K");
+        if (global_count < k) {
+            printf("Flux plus court que K: %d éléments retenus\n", global_count);
+        }
+        printf("Éléments lus: %lld (%d instantanés)\n", totals[0], snapshots);
+        printf("Rejetés en une comparaison: %.2f%%\n",
+               totals[0] > 0 ? 100.0 * (totals[0] - totals[1]) / totals[0] : 0.0);
+        printf("Mémoire par processus: %.1f Ko (tas de K + 2 blocs de %d)\n",
+               ((double)k + 2.0 * opts->chunk_size) * sizeof(int) / 1024.0, opts->chunk_size);
+        if (correct < 0) {
+            printf("Valeurs correctes: non vérifiées (entrée standard)\n");
+        } else {
+            printf("Tri décroissant correct: %s\n",
+                   is_sorted_desc(global_topk, global_count) ? "OUI" : "NON");
+            printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
+        }
+        printf("Temps d'exécution: %.6f secondes (%.2f millions d'éléments/s)\n", total_time,
+               total_time > 0 ? totals[0] / total_time / 1e6 : 0.0);
+        printf("\nCSV: %d,%lld,%d,%.6f\n", num_procs, totals[0], k, total_time);
+    }
+    
+    topk_heap_free(&heap);
+    free(local_topk);
+    free(global_topk);
+    return 1;
+}
+
+/**
+ * Top-K approché (--approx): étape 1 de run_topk, puis chaque processus
+ * résume ses données par l'histogramme des distances au sommet du domaine
+ * [0, MAX_VALUE) (sketch.h) et un seul MPI_Allreduce de taille fixe
+ * fusionne les résumés. Retourne, sur tous les processus, la classe qui
+ * contient la K-ième valeur (*sketch contient le résumé global). La partie
+ * locale des données est conservée dans *local_out pour la comparaison
+ * avec le résultat exact.
+ */
+int run_topk_approx(int *data, int total_size, int k, int bits, int rank, int num_procs,
+                    top_sketch_t *sketch, int **local_out, int *local_size_out,
+                    double *total_time) {
+    // Synchronisation avant le chronométrage
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    double start_time = MPI_Wtime();
+    
+    // ÉTAPE 1: Distribution des données
+    int base_size = total_size / num_procs;
+    int remainder = total_size % num_procs;
+    int local_size = base_size + (rank < remainder ? 1 : 0);
+    
+    int *sendcounts = (int*)malloc(num_procs * sizeof(int));
+    int *displs = (int*)malloc(num_procs * sizeof(int));
+    int offset = 0;
+    for (int i = 0; i < num_procs; i++) {
+        sendcounts[i] = base_size + (i < remainder ? 1 : 0);
+        displs[i] = offset;
+        offset += sendcounts[i];
+    }
+    int *local_data = (int*)malloc(local_size * sizeof(int));
+    
+    double t0 = instr_start();
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(data, sendcounts, displs, MPI_INT,
+                        local_data, local_size, MPI_INT,
+                        0, MPI_COMM_WORLD));
+    instr_stop(PHASE_SCATTER, t0);
+    
+    // ÉTAPE 2: Résumé local (un parcours, sans tri ni sélection)
+    t0 = instr_start();
+    top_sketch_init(sketch, 0, MAX_VALUE - 1, bits);
+    top_sketch_add(sketch, local_data, local_size);
+    instr_stop(PHASE_CLASSIFY, t0);
+    instr_set_bucket_size(local_size);
+    
+    // ÉTAPE 3: Fusion des résumés (message de taille fixe)
+    t0 = instr_start();
+    top_sketch_allreduce(sketch, MPI_COMM_WORLD);
+    instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    instr_add_bytes(top_sketch_bytes(sketch), top_sketch_bytes(sketch));
+    
+    // ÉTAPE 4: Classe du K-ième plus grand (identique sur tous les processus)
+    t0 = instr_start();
+    long long above;
+    int bin = top_sketch_top_bin(sketch, k, &above);
+    instr_stop(PHASE_SELECT, t0);
+    
+    TRACED("MPI_Barrier",
+           MPI_Barrier(MPI_COMM_WORLD));
+    *total_time = MPI_Wtime() - start_time;
+    
+    *local_out = local_data;
+    *local_size_out = local_size;
+    free(sendcounts);
+    free(displs);
+    return bin;
+}
+
+/**
+ * Mode --approx: seuil approché du Top-K, borne d'erreur et nombre de
+ * candidats (éléments >= seuil, connus localement sur chaque processus et
+ * jamais rassemblés). Le résultat est comparé à la K-ième valeur exacte
+ * (sélection distribuée, quantile.h) et au nombre exact de candidats.
+ */
+void run_approx(int *data, const options_t *opts, int rank, int num_procs, bench_t *bench) {
+    int k = opts->k;
+    top_sketch_t sketch = { 0 };
+    int *local_data = NULL;
+    int local_size = 0;
+    int bin = 0;
+    double total_time = 0.0;
+    
+    for (int iter = 0; iter < bench_iterations(bench); iter++) {
+        top_sketch_free(&sketch);
+        free(local_data);
+        instr_reset();
+        bin = run_topk_approx(data, opts->total_size, k, opts->approx_bits, rank, num_procs,
+                              &sketch, &local_data, &local_size, &total_time);
+        bench_record(bench, iter, total_time, MPI_COMM_WORLD);
+    }
+    
+    long long lo, hi, above;
+    top_sketch_bin_bounds(&sketch, bin, &lo, &hi);
+    top_sketch_top_bin(&sketch, k, &above);
+    long long candidates = above + sketch.counts[bin];
+    
+    // Comparaison avec le résultat exact: K-ième valeur par sélection
+    // distribuée, et nombre exact de candidats
+    double t0 = instr_start();
+    long long exact_rank = (long long)opts->total_size - k;
+    int exact_kth;
+    quantile_select(local_data, local_size, &exact_rank, 1, &exact_kth, MPI_COMM_WORLD);
+    long long local_count = 0, counted;
+    for (int i = 0; i < local_size; i++) {
+        if (local_data[i] >= lo) local_count++;
+    }
+    TRACED("MPI_Reduce",
+           MPI_Reduce(&local_count, &counted, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD));
+    instr_stop(PHASE_VERIFY, t0);
+    
+    if (rank == 0) {
+        long long estimate = lo + (hi - lo) / 2;
+        long long magnitude = llabs(exact_kth) > 0 ? llabs(exact_kth) : 1;
+        double relative_error = (double)llabs(estimate - exact_kth) / magnitude;
+        double bound = (double)(hi - lo) / (lo > 0 ? lo : 1);
+        int within = (exact_kth >= lo && exact_kth <= hi) && counted == candidates;
+        long long exact_bytes = (long long)num_procs * k * sizeof(int);
+        
+        printf("\n=== Résultats (approché, précision 2^-%d sur la distance à %d) ===\n",
+               opts->approx_bits, MAX_VALUE - 1);
+        printf("K-ième valeur: %lld, dans [%lld, %lld] (erreur relative au plus %.4f%%)\n",
+               estimate, lo, hi, 100.0 * bound);
+        printf("Candidats (>= %lld): %lld, soit %lld de plus que K (non rassemblés)\n", lo,
+               candidates, candidates - k);
+        printf("Message de fusion: %lld octets, un MPI_Allreduce (exact: %lld octets "
+               "rassemblés)\n", top_sketch_bytes(&sketch), exact_bytes);
+        printf("K-ième valeur exacte: %d (erreur relative %.4f%%)\n", exact_kth,
+               100.0 * relative_error);
+        printf("Borne d'erreur respectée: %s\n", within ? "OUI" : "NON");
         printf("Temps d'exécution: %.6f secondes\n", total_time);
         
-        // Format CSV pour les benchmarks
-        printf("\nCSV: %d,%d,%d,%.6f\n", num_procs, total_size, k, total_time);
+        // Format CSV: champs du mode exact, puis précision, octets, erreur et
+        // nombre de candidats
+        printf("\nCSV: %d,%d,%d,%.6f,%d,%lld,%.6f,%lld\n", num_procs, opts->total_size, k,
+               total_time, opts->approx_bits, top_sketch_bytes(&sketch), relative_error,
+               candidates);
+    }
+    
+    top_sketch_free(&sketch);
+    free(local_data);
+}
+
+/**
+ * Calibration (--tune): chaque méthode de fusion est exécutée sur les
+ * données courantes; la plus rapide (meilleur temps, processus le plus
+ * lent) est enregistrée dans le cache pour cette classe de taille et de K
+ */
+int tune_topk(int *data, options_t *opts, int rank, int num_procs) {
+    double local_times[NUM_TOPK_METHODS];
+    double times[NUM_TOPK_METHODS];
+    int *local_data = NULL;
+    int local_size = 0;
+    double elapsed;
+    
+    for (int m = 0; m < NUM_TOPK_METHODS; m++) {
+        local_times[m] = 1e30;
+        for (int rep = 0; rep < 3; rep++) {
+            int *result = run_topk(data, opts->total_size, opts->k, m, rank, num_procs,
+                                   &local_data, &local_size, &elapsed);
+            if (elapsed < local_times[m]) local_times[m] = elapsed;
+            free(result);
+            free(local_data);
+        }
+    }
+    MPI_Allreduce(local_times, times, NUM_TOPK_METHODS, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    
+    int best = 0;
+    for (int m = 1; m < NUM_TOPK_METHODS; m++) {
+        if (times[m] < times[best]) best = m;
+    }
+    if (rank == 0) {
+        printf("Calibration:");
+        for (int m = 0; m < NUM_TOPK_METHODS; m++) {
+            printf(" %s %.6f s%s", topk_method_name(m), times[m],
+                   m < NUM_TOPK_METHODS - 1 ? "," : "\n");
+        }
+    }
+    
+    opts->strategy.topk_method = best;
+    tuning_store(opts->tune_file, "topk_mpi", num_procs, 1, opts->total_size, opts->k,
+                 &opts->strategy, MPI_COMM_WORLD);
+    return best;
+}
+
+/**
+ * Fonction principale du Top-K distribué
+ * 
+ * Stratégie:
+ * - Utiliser le Bucket Sort pour partitionner les données
+ * - Commencer par les buckets des plus grandes valeurs
+ * - S'arrêter dès qu'on a collecté K éléments
+ */
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    int *data = NULL;
+    int *payload = NULL;
+    int *topk_result = NULL;
+    topk_entry_t *entries = NULL;
+    int *local_data = NULL;
+    int *local_payload = NULL;
+    int local_size = 0;
+    int total_size, k;
+    double total_time;
+    options_t opts;
+    bench_t bench;
+    
+    // Initialisation MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    
+    // Lecture des paramètres
+    parse_arguments(argc, argv, &opts);
+    total_size = opts.total_size;
+    k = opts.k;
+    instr_init(opts.stats_format, opts.trace_path != NULL || opts.bench);
+    if (opts.profile) {
+        instr_profile_init();
+    }
+    if (opts.trace_path != NULL) {
+        trace_init(opts.trace_path, MPI_COMM_WORLD);
+    }
+    
+    // Vérification de la distribution
+    if (opts.dist < 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: distribution inconnue (uniform, zipf, gaussian, sorted, "
+                    "reverse, nearly-sorted, all-equal, few-unique)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // Mode --stream: aucune donnée n'est stockée, ni sur le processus 0 ni
+    // ailleurs (la taille n'est utilisée que par la source "gen")
+    if (opts.stream_source != NULL) {
+        if (rank == 0) {
+            printf("=== Top-K en flux avec MPI ===\n");
+            printf("Nombre de processus: %d\n", num_procs);
+            printf("Source: %s, K=%d, blocs de %d, instantané %s\n", opts.stream_source, k,
+                   opts.chunk_size, opts.snapshot_every > 0 ? "périodique" : "final");
+        }
+        int ok = run_stream(&opts, k, rank, num_procs);
+        instr_report("topk_mpi", 0, 1, MPI_COMM_WORLD);
+        trace_write(MPI_COMM_WORLD);
+        MPI_Finalize();
+        return ok ? 0 : 1;
+    }
+    
+    // Mode --batch: K est le plus grand K demandé
+    if (opts.num_queries < 0 || (opts.num_queries > 0 && opts.argtopk)) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: --batch=colonne:K,... invalide ou combiné à --argtopk\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    for (int q = 0; q < opts.num_queries; q++) {
+        if (q == 0 || opts.queries[q].k > k) {
+            k = opts.queries[q].k;
+        }
+    }
+    opts.k = k;
+    
+    // Vérification de k
+    if (k > total_size) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: k (%d) > taille du tableau (%d)\n", k, total_size);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (opts.strategy.topk_method == -1) {
+        if (rank == 0) {
+            fprintf(stderr, "Erreur: méthode inconnue (--topk-method=gather|tree|histogram|auto)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    
+    // --strategy=auto: méthode du cache de calibration (sinon règle par défaut)
+    int cached = 0;
+    if (opts.strategy_auto && !opts.tune) {
+        cached = tuning_load(opts.tune_file, "topk_mpi", num_procs, 1, total_size, k,
+                             &opts.strategy, MPI_COMM_WORLD);
+    }
+    
+    // Sans --bench: une seule itération mesurée, sans chauffe
+    bench_init(&bench, opts.bench ? opts.bench_warmup : 0, opts.bench ? opts.bench_reps : 1);
+    
+    if (rank == 0) {
+        printf("=== Top-K Extraction avec MPI ===\n");
+        printf("Nombre de processus: %d\n", num_procs);
+        printf("Taille du tableau: %d\n", total_size);
+        printf("K (top éléments à extraire): %d\n", k);
+        printf("Valeur maximale: %d\n", MAX_VALUE);
+        printf("Distribution: %s (graine %llu)\n", workload_dist_name(opts.dist), opts.seed);
+        if (opts.argtopk) {
+            printf("Mode: indices globaux (--argtopk)%s\n", opts.payload ? " avec charge utile" : "");
+        }
+        if (opts.approx_bits >= 0) {
+            printf("Mode: approché (--approx=%d, un MPI_Allreduce de taille fixe)\n",
+                   opts.approx_bits);
+        }
+        if (opts.num_queries > 0) {
+            printf("Requêtes (colonne:K):");
+            for (int q = 0; q < opts.num_queries; q++) {
+                printf(" %d:%d", opts.queries[q].column, opts.queries[q].k);
+            }
+            printf("\n");
+        }
+    }
+    
+    // Allocation et génération des données sur le processus 0
+    if (rank == 0) {
+        data = (int*)malloc(total_size * sizeof(int));
+        if (data == NULL) {
+            fprintf(stderr, "Erreur d'allocation mémoire\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        workload_generate(data, 0, total_size, total_size, MAX_VALUE, opts.dist, opts.seed);
         
-        free(topk_result);
-        free(recv_buffer);
-        free(all_k);
-        free(all_displs);
+        // Charge utile: seconde colonne uniforme (graine suivante)
+        if (opts.payload) {
+            payload = (int*)malloc(total_size * sizeof(int));
+            workload_generate(payload, 0, total_size, total_size, MAX_VALUE, DIST_UNIFORM,
+                              opts.seed + 1);
+        }
+    }
+    
+    // Choix de la méthode de fusion (calibration sur la machine courante avec --tune)
+    int method;
+    if (opts.tune) {
+        method = tune_topk(data, &opts, rank, num_procs);
+    } else {
+        method = strategy_choose_topk(&opts.strategy, total_size, k, num_procs);
+    }
+    if (rank == 0) {
+        printf("Méthode de fusion: %s%s\n", topk_method_name(method),
+               opts.tune ? " (calibrée)"
+               : cached ? " (cache)"
+               : opts.strategy.topk_method == STRATEGY_AUTO ? " (règle par défaut)" : "");
     }
     
+    if (opts.approx_bits >= 0) {
+        // Mode --approx: seuil approché par un résumé de taille fixe
+        run_approx(data, &opts, rank, num_procs, &bench);
+    } else if (opts.num_queries > 0) {
+        // Mode --batch: toutes les requêtes en une passe
+        run_batch(data, &opts, method, rank, num_procs, &bench);
+    } else {
+        // ÉTAPES 1 à 4 (répétées en mode --bench; l'entrée n'est jamais modifiée)
+        for (int iter = 0; iter < bench_iterations(&bench); iter++) {
+            free(topk_result);
+            free(entries);
+            free(local_data);
+            free(local_payload);
+            topk_result = NULL;
+            entries = NULL;
+            instr_reset();
+            if (opts.argtopk) {
+                entries = run_argtopk(data, payload, opts.payload, total_size, k, method, rank,
+                                      num_procs, &local_data, &local_payload, &local_size,
+                                      &total_time);
+            } else {
+                topk_result = run_topk(data, total_size, k, method, rank, num_procs,
+                                       &local_data, &local_size, &total_time);
+            }
+            bench_record(&bench, iter, total_time, MPI_COMM_WORLD);
+        }
+        
+        // Valeurs seules de l'arg-top-K pour l'affichage
+        if (opts.argtopk && rank == 0) {
+            topk_result = (int*)malloc(k * sizeof(int));
+            for (int i = 0; i < k; i++) {
+                topk_result[i] = entries[i].value;
+            }
+        }
+      
+        // ÉTAPE 5: Vérification et affichage des résultats
 
+        // Vérification distribuée: chaque processus compte ses éléments
+        // supérieurs à la K-ième valeur (au lieu d'un tri complet sur le processus 0)
+        double t0 = instr_start();
+        int correct;
+        if (opts.argtopk) {
+            correct = verify_argtopk_distributed(local_data, local_payload, local_size, entries, k,
+                                                 0, MPI_COMM_WORLD);
+        } else {
+            correct = verify_topk_distributed(local_data, local_size, topk_result, k, 0,
+                                              MPI_COMM_WORLD);
+        }
+        instr_stop(PHASE_VERIFY, t0);
+        
+        if (rank == 0) {
+            // Les résultats sont-ils triés en ordre décroissant?
+            int sorted = is_sorted_desc(topk_result, k);
+            
+            printf("\n=== Résultats ===\n");
+            print_array(topk_result, k, "Top-K");
+            if (opts.argtopk) {
+                printf("Entrées (valeur, indice%s): ", opts.payload ? ", charge" : "");
+                for (int i = 0; i < k && i < 5; i++) {
+                    if (opts.payload) {
+                        printf("(%d, %lld, %d) ", entries[i].value, entries[i].index,
+                               entries[i].payload);
+                    } else {
+                        printf("(%d, %lld) ", entries[i].value, entries[i].index);
+                    }
+                }
+                printf("...\n");
+            }
+            printf("Tri décroissant correct: %s\n", sorted ? "OUI" : "NON");
+            printf("Valeurs correctes: %s\n", correct ? "OUI" : "NON");
+            printf("Temps d'exécution: %.6f secondes\n", total_time);
+            
+            // Format CSV pour les benchmarks
+            printf("\nCSV: %d,%d,%d,%.6f\n", num_procs, total_size, k, total_time);
+        }
+    }
+    
+    // Statistiques du mode --bench (toutes les itérations mesurées)
+    if (opts.bench) {
+        bench_report(&bench, "topk_mpi", num_procs, 1, total_size, k,
+                     opts.bench_csv, MPI_COMM_WORLD);
+    }
+    
+    // Statistiques par phase et par processus (--stats, dernière itération)
+    instr_report("topk_mpi", total_size, 1, MPI_COMM_WORLD);
+    trace_write(MPI_COMM_WORLD);
+    
     // Libération de la mémoire
 
+    free(topk_result);
+    free(entries);
     free(local_data);
-    free(local_topk);
-    free(sendcounts);
-    free(displs);
+    free(local_payload);
+    bench_free(&bench);
     
     if (rank == 0) {
         free(data);
+        free(payload);
     }
     
     MPI_Finalize();
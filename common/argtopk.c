@@ -0,0 +1,207 @@
+/**
+ * Arg-top-K: indices globaux (et charge utile) des K plus grands éléments
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <mpi.h>
+
+#include "argtopk.h"
+#include "sort_kernels.h"
+#include "tuning.h"
+#include "instrument.h"
+#include "trace.h"
+
+SORT_DEFINE_KERNELS(topk_entry, topk_entry_t, topk_entry_before)
+
+MPI_Datatype topk_entry_type(void) {
+    int lengths[3] = { 1, 1, 1 };
+    MPI_Aint displs[3] = {
+        offsetof(topk_entry_t, value),
+        offsetof(topk_entry_t, payload),
+        offsetof(topk_entry_t, index)
+    };
+    MPI_Datatype types[3] = { MPI_INT, MPI_INT, MPI_LONG_LONG };
+    MPI_Datatype packed, entry_type;
+    
+    MPI_Type_create_struct(3, lengths, displs, types, &packed);
+    MPI_Type_create_resized(packed, 0, sizeof(topk_entry_t), &entry_type);
+    MPI_Type_commit(&entry_type);
+    MPI_Type_free(&packed);
+    return entry_type;
+}
+
+int argtopk_select(const int *values, const int *payload, int size, long long first_index,
+                   int k, int min_value, topk_entry_t *out) {
+    if (k <= 0 || size <= 0) {
+        return 0;
+    }
+    
+    // K-ième valeur locale, sur une copie des seules valeurs candidates
+    int *candidates = (int*)malloc(size * sizeof(int));
+    int num_candidates = 0;
+    for (int i = 0; i < size; i++) {
+        if (values[i] >= min_value) {
+            candidates[num_candidates++] = values[i];
+        }
+    }
+    int take = (k < num_candidates) ? k : num_candidates;
+    if (take == 0) {
+        free(candidates);
+        return 0;
+    }
+    int kth = sort_select_desc(candidates, num_candidates, take - 1);
+    
+    int num_greater = 0;
+    for (int i = 0; i < num_candidates; i++) {
+        if (candidates[i] > kth) num_greater++;
+    }
+    free(candidates);
+    
+    // Matérialisation des seuls gagnants: valeurs > kth, puis valeurs
+    // égales à kth par indice croissant jusqu'à K
+    int equal_needed = take - num_greater;
+    int count = 0;
+    for (int i = 0; i < size && count < take; i++) {
+        int v = values[i];
+        if (v > kth || (v == kth && equal_needed > 0)) {
+            if (v == kth) equal_needed--;
+            out[count].value = v;
+            out[count].payload = (payload != NULL) ? payload[i] : 0;
+            out[count].index = first_index + i;
+            count++;
+        }
+    }
+    
+    topk_entry_sort(out, count);
+    return count;
+}
+
+int argtopk_merge(const topk_entry_t *a, int size_a, const topk_entry_t *b, int size_b,
+                  int k, topk_entry_t *out) {
+    int i = 0, j = 0, n = 0;
+    while (n < k && (i < size_a || j < size_b)) {
+        if (j >= size_b || (i < size_a && topk_entry_before(&a[i], &b[j]))) {
+            out[n++] = a[i++];
+        } else {
+            out[n++] = b[j++];
+        }
+    }
+    return n;
+}
+
+/**
+ * Rassemblement des candidats sur le processus 0 (MPI_Gatherv) puis tri
+ */
+static topk_entry_t *reduce_gather(const topk_entry_t *local, int local_count, int k,
+                                   MPI_Datatype entry_type, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    int *counts = NULL;
+    int *displs = NULL;
+    topk_entry_t *all = NULL;
+    int total = 0;
+    
+    double t0 = instr_start();
+    if (rank == 0) {
+        counts = (int*)malloc(num_procs * sizeof(int));
+        displs = (int*)malloc(num_procs * sizeof(int));
+    }
+    TRACED("MPI_Gather",
+           MPI_Gather(&local_count, 1, MPI_INT, counts, 1, MPI_INT, 0, comm));
+    if (rank == 0) {
+        for (int r = 0; r < num_procs; r++) {
+            displs[r] = total;
+            total += counts[r];
+        }
+        all = (topk_entry_t*)malloc((total + 1) * sizeof(topk_entry_t));
+    }
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv((void*)local, local_count, entry_type,
+                       all, counts, displs, entry_type, 0, comm));
+    instr_stop(PHASE_GATHER, t0);
+    instr_add_bytes((long long)local_count * sizeof(topk_entry_t),
+                    (long long)total * sizeof(topk_entry_t));
+    
+    if (rank == 0) {
+        t0 = instr_start();
+        topk_entry_sort(all, total);
+        instr_stop(PHASE_MERGE, t0);
+        free(counts);
+        free(displs);
+    }
+    return all;
+}
+
+/**
+ * Fusion en arbre binaire: à l'étape s, le processus rank + s envoie ses
+ * candidats au processus rank (taille découverte par MPI_Probe)
+ */
+static topk_entry_t *reduce_tree(const topk_entry_t *local, int local_count, int k,
+                                 MPI_Datatype entry_type, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    topk_entry_t *current = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    topk_entry_t *received = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    topk_entry_t *merged = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    int current_count = (local_count < k) ? local_count : k;
+    memcpy(current, local, current_count * sizeof(topk_entry_t));
+    
+    for (int step = 1; step < num_procs; step *= 2) {
+        if (rank % (2 * step) == step) {
+            double t0 = instr_start();
+            TRACED("MPI_Send",
+                   MPI_Send(current, current_count, entry_type, rank - step, 0, comm));
+            instr_stop(PHASE_GATHER, t0);
+            instr_add_bytes((long long)current_count * sizeof(topk_entry_t), 0);
+            break;
+        }
+        if (rank % (2 * step) == 0 && rank + step < num_procs) {
+            MPI_Status status;
+            int received_count;
+            double t0 = instr_start();
+            TRACED("MPI_Probe",
+                   MPI_Probe(rank + step, 0, comm, &status));
+            MPI_Get_count(&status, entry_type, &received_count);
+            TRACED("MPI_Recv",
+                   MPI_Recv(received, received_count, entry_type, rank + step, 0, comm,
+                            MPI_STATUS_IGNORE));
+            instr_stop(PHASE_GATHER, t0);
+            instr_add_bytes(0, (long long)received_count * sizeof(topk_entry_t));
+            
+            t0 = instr_start();
+            current_count = argtopk_merge(current, current_count, received, received_count,
+                                          k, merged);
+            topk_entry_t *tmp = current;
+            current = merged;
+            merged = tmp;
+            instr_stop(PHASE_MERGE, t0);
+        }
+    }
+    
+    free(received);
+    free(merged);
+    if (rank != 0) {
+        free(current);
+        return NULL;
+    }
+    return current;
+}
+
+topk_entry_t *argtopk_reduce(const topk_entry_t *local, int local_count, int k, int method,
+                             MPI_Comm comm) {
+    MPI_Datatype entry_type = topk_entry_type();
+    topk_entry_t *result;
+    if (method == TOPK_TREE) {
+        result = reduce_tree(local, local_count, k, entry_type, comm);
+    } else {
+        result = reduce_gather(local, local_count, k, entry_type, comm);
+    }
+    MPI_Type_free(&entry_type);
+    return result;
+}
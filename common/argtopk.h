@@ -0,0 +1,66 @@
+/**
+ * Arg-top-K: indices globaux (et charge utile) des K plus grands éléments
+ *
+ * Les valeurs seules ne disent pas quelles lignes appartiennent au Top-K,
+ * ni comment départager des valeurs égales. Chaque candidat porte ici sa
+ * valeur, son indice global dans le tableau d'entrée et une charge utile
+ * optionnelle; à valeur égale, le plus petit indice l'emporte. L'ordre est
+ * total: le résultat ne dépend ni du nombre de processus ni du nombre de
+ * threads.
+ *
+ * Les entrées ne sont matérialisées que pour les candidats retenus: la
+ * K-ième valeur locale est d'abord trouvée par sélection sur les valeurs
+ * seules, puis un unique parcours extrait les K gagnants.
+ */
+
+#ifndef ARGTOPK_H
+#define ARGTOPK_H
+
+#include <mpi.h>
+
+/**
+ * Candidat du Top-K
+ */
+typedef struct {
+    int value;
+    int payload;            // Charge utile (0 sans --payload)
+    long long index;        // Indice global dans le tableau d'entrée
+} topk_entry_t;
+
+/**
+ * a précède b: valeur plus grande, ou valeur égale et indice plus petit
+ */
+static inline int topk_entry_before(const topk_entry_t *a, const topk_entry_t *b) {
+    return a->value > b->value || (a->value == b->value && a->index < b->index);
+}
+
+/**
+ * Crée le type MPI correspondant à topk_entry_t (à libérer par MPI_Type_free)
+ */
+MPI_Datatype topk_entry_type(void);
+
+/**
+ * Sélectionne les K premiers éléments de values (indices globaux
+ * first_index + i) parmi ceux supérieurs ou égaux à min_value (INT_MIN:
+ * tous). payload peut être NULL. Écrit au plus k entrées ordonnées dans out
+ * et retourne leur nombre.
+ */
+int argtopk_select(const int *values, const int *payload, int size, long long first_index,
+                   int k, int min_value, topk_entry_t *out);
+
+/**
+ * Fusionne deux listes ordonnées en gardant au plus k entrées
+ */
+int argtopk_merge(const topk_entry_t *a, int size_a, const topk_entry_t *b, int size_b,
+                  int k, topk_entry_t *out);
+
+/**
+ * Fusion des candidats locaux de tous les processus sur le processus 0,
+ * par rassemblement (TOPK_GATHER, TOPK_HISTOGRAM) ou en arbre binaire
+ * (TOPK_TREE). Retourne les K entrées sur le processus 0 (NULL ailleurs,
+ * à libérer). Opération collective.
+ */
+topk_entry_t *argtopk_reduce(const topk_entry_t *local, int local_count, int k, int method,
+                             MPI_Comm comm);
+
+#endif
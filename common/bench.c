@@ -0,0 +1,158 @@
+/**
+ * Harnais de benchmark intégré (--bench)
+ *
+ * Statistiques robustes (médiane, percentiles) sur des itérations répétées
+ * dans le même communicateur.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "bench.h"
+#include "instrument.h"
+
+// Une colonne par phase puis le temps total
+#define NUM_COLUMNS (NUM_PHASES + 1)
+#define COLUMN_TOTAL NUM_PHASES
+
+#define BENCH_HEADER "program,num_procs,num_threads,array_size,k,phase,reps," \
+                     "median,p5,p95,mean,std,elements_per_s"
+
+int bench_parse_option(const char *arg, int *warmup, int *reps) {
+    if (strcmp(arg, "--bench") == 0) {
+        *warmup = BENCH_DEFAULT_WARMUP;
+        *reps = BENCH_DEFAULT_REPS;
+        return 1;
+    }
+    if (strncmp(arg, "--bench=", 8) == 0) {
+        *warmup = BENCH_DEFAULT_WARMUP;
+        *reps = BENCH_DEFAULT_REPS;
+        if (sscanf(arg + 8, "%d,%d", warmup, reps) < 2) {
+            // Forme courte "--bench=M": chauffe par défaut
+            *reps = *warmup;
+            *warmup = BENCH_DEFAULT_WARMUP;
+        }
+        if (*warmup < 0) *warmup = 0;
+        if (*reps < 1) *reps = 1;
+        return 1;
+    }
+    return 0;
+}
+
+void bench_init(bench_t *bench, int warmup, int reps) {
+    bench->warmup = warmup;
+    bench->reps = reps;
+    bench->recorded = 0;
+    bench->samples = (double*)calloc((size_t)reps * NUM_COLUMNS, sizeof(double));
+}
+
+void bench_record(bench_t *bench, int iter, double total_time, MPI_Comm comm) {
+    double local[NUM_COLUMNS];
+    double global[NUM_COLUMNS];
+
+    for (int p = 0; p < NUM_PHASES; p++) {
+        local[p] = instr_phase_time((phase_t)p);
+    }
+    local[COLUMN_TOTAL] = total_time;
+
+    // Le temps d'une phase est celui du processus le plus lent
+    MPI_Reduce(local, global, NUM_COLUMNS, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+    if (iter < bench->warmup || bench->recorded >= bench->reps) {
+        return;
+    }
+    memcpy(bench->samples + (size_t)bench->recorded * NUM_COLUMNS, global, sizeof(global));
+    bench->recorded++;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Percentile par interpolation linéaire sur un tableau trié
+ */
+static double percentile(const double *sorted, int n, double q) {
+    if (n == 1) return sorted[0];
+    double position = q * (n - 1);
+    int lower = (int)position;
+    int upper = (lower + 1 < n) ? lower + 1 : lower;
+    double fraction = position - lower;
+    return sorted[lower] * (1.0 - fraction) + sorted[upper] * fraction;
+}
+
+void bench_report(const bench_t *bench, const char *program, int num_procs,
+                  int num_threads, int total_size, int k, const char *csv_path,
+                  MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank != 0 || bench->recorded == 0) {
+        return;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL) {
+        FILE *existing = fopen(csv_path, "r");
+        int is_new = (existing == NULL);
+        if (existing != NULL) fclose(existing);
+        csv = fopen(csv_path, "a");
+        if (csv == NULL) {
+            fprintf(stderr, "Erreur: impossible d'écrire %s\n", csv_path);
+        } else if (is_new) {
+            fprintf(csv, "%s\n", BENCH_HEADER);
+        }
+    }
+
+    int n = bench->recorded;
+    double *column = (double*)malloc(n * sizeof(double));
+
+    printf("\n=== Benchmark (%d itérations de chauffe, %d mesurées) ===\n",
+           bench->warmup, n);
+    printf("BENCH: %s\n", BENCH_HEADER);
+
+    for (int c = 0; c < NUM_COLUMNS; c++) {
+        double sum = 0.0, sum_sq = 0.0;
+        for (int i = 0; i < n; i++) {
+            column[i] = bench->samples[(size_t)i * NUM_COLUMNS + c];
+            sum += column[i];
+        }
+        // Phases non exécutées par ce programme
+        if (c != COLUMN_TOTAL && sum == 0.0) continue;
+
+        qsort(column, n, sizeof(double), compare_double);
+        double mean = sum / n;
+        for (int i = 0; i < n; i++) {
+            sum_sq += (column[i] - mean) * (column[i] - mean);
+        }
+        double std = (n > 1) ? sqrt(sum_sq / (n - 1)) : 0.0;
+        double median = percentile(column, n, 0.5);
+        double p5 = percentile(column, n, 0.05);
+        double p95 = percentile(column, n, 0.95);
+        double throughput = median > 0 ? total_size / median : 0.0;
+        const char *name = (c == COLUMN_TOTAL) ? "total" : instr_phase_name((phase_t)c);
+
+        char line[512];
+        snprintf(line, sizeof(line), "%s,%d,%d,%d,%d,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.1f",
+                 program, num_procs, num_threads, total_size, k, name, n,
+                 median, p5, p95, mean, std, throughput);
+        printf("BENCH: %s\n", line);
+        if (csv != NULL) {
+            fprintf(csv, "%s\n", line);
+        }
+    }
+
+    free(column);
+    if (csv != NULL) {
+        fclose(csv);
+    }
+}
+
+void bench_free(bench_t *bench) {
+    free(bench->samples);
+    bench->samples = NULL;
+}
@@ -0,0 +1,68 @@
+/**
+ * Harnais de benchmark intégré (--bench)
+ *
+ * Répète l'algorithme dans le même processus MPI: W itérations de chauffe
+ * (non mesurées) puis M itérations mesurées, sans relancer mpirun ni
+ * retoucher des buffers froids. Pour chaque phase (temps maximal sur les
+ * processus) et pour le temps total, affiche médiane, p5/p95, moyenne,
+ * écart-type et éléments/s sous forme de lignes "BENCH:" (CSV).
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <mpi.h>
+
+#define BENCH_DEFAULT_WARMUP 2
+#define BENCH_DEFAULT_REPS 10
+
+/**
+ * Configuration et échantillons d'une série de mesures
+ */
+typedef struct {
+    int warmup;             // Itérations de chauffe
+    int reps;               // Itérations mesurées
+    int recorded;           // Itérations mesurées enregistrées
+    double *samples;        // reps x (NUM_PHASES + 1) valeurs (processus 0)
+} bench_t;
+
+/**
+ * Lit "--bench" ou "--bench=W,M" (retourne 0 si l'argument ne correspond pas)
+ */
+int bench_parse_option(const char *arg, int *warmup, int *reps);
+
+/**
+ * Prépare une série de mesures
+ */
+void bench_init(bench_t *bench, int warmup, int reps);
+
+/**
+ * Nombre total d'itérations (chauffe + mesures)
+ */
+static inline int bench_iterations(const bench_t *bench) {
+    return bench->warmup + bench->reps;
+}
+
+/**
+ * Enregistre l'itération iter (ignorée pendant la chauffe): temps total
+ * et temps maximal de chaque phase sur les processus. Opération collective.
+ * Les compteurs de phase (instrument.h) doivent être remis à zéro par
+ * instr_reset() avant chaque itération.
+ */
+void bench_record(bench_t *bench, int iter, double total_time, MPI_Comm comm);
+
+/**
+ * Affiche les statistiques (processus 0) et les ajoute au fichier CSV
+ * csv_path s'il est non NULL (en-tête écrit si le fichier est nouveau).
+ * k vaut 0 pour les programmes de tri.
+ */
+void bench_report(const bench_t *bench, const char *program, int num_procs,
+                  int num_threads, int total_size, int k, const char *csv_path,
+                  MPI_Comm comm);
+
+/**
+ * Libère les échantillons
+ */
+void bench_free(bench_t *bench);
+
+#endif
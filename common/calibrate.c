@@ -0,0 +1,489 @@
+/**
+ * Calibration du modèle de coût (cibles make calibrate et make predict)
+ *
+ * Mesure sur la machine courante les paramètres du modèle de type LogGP de
+ * scripts/predict_scaling.py:
+ * - ping-pong entre les processus 0 et 1: latence L et temps par octet G;
+ * - MPI_Alltoallv sur les q premiers processus (q = 2, 4, ..., p) pour
+ *   plusieurs tailles de message par paire: surcoût par pair et par octet;
+ * - MPI_Scatterv et MPI_Gatherv (racine 0) sur q processus;
+ * - noyaux locaux sur le processus 0 seul: comptage et répartition dans
+ *   les buckets, tri (sections et fusions avec OpenMP), fusion de deux
+ *   séquences, sélection des K plus grands et fusion de deux listes top-K,
+ *   pour plusieurs tailles et, avec OpenMP, plusieurs nombres de threads.
+ * Chaque mesure est la médiane de CALIBRATE_SAMPLES échantillons d'au moins
+ * --sample-ms de calcul; pour les communications, un échantillon est le
+ * temps maximal sur les processus. Pendant la mesure des noyaux, les autres
+ * processus attendent en dormant pour ne pas occuper de cœur.
+ *
+ * Format CSV: kind,procs,threads,size,param,seconds
+ * - pingpong: size = octets, seconds = temps aller simple;
+ * - alltoallv: size = octets par paire; scatterv, gatherv: size = octets
+ *   par processus; seconds = temps d'une opération;
+ * - kernel_*: size = éléments, param = buckets ou K, seconds par élément.
+ *
+ * Usage: mpirun -np p cost_calibrate [--quick] [--max-size=n] [--sample-ms=n]
+ *                                    [--csv=fichier]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "kernels.h"
+#include "scatter.h"
+#include "sort_kernels.h"
+#include "workload.h"
+
+#define MAX_VALUE 1000000
+#define DEFAULT_MAX_SIZE (1 << 24)
+#define DEFAULT_SAMPLE_MS 20
+#define CALIBRATE_SAMPLES 5
+
+// Noyaux mesurés
+#define KERNEL_COUNT      0
+#define KERNEL_SCATTER    1
+#define KERNEL_SORT       2
+#define KERNEL_MERGE      3
+#define KERNEL_SELECT     4
+#define KERNEL_MERGE_TOPK 5
+#define NUM_KERNELS       6
+
+static const char *kernel_names[NUM_KERNELS] = {
+    "kernel_count", "kernel_scatter", "kernel_sort", "kernel_merge", "kernel_select",
+    "kernel_merge_topk"
+};
+
+// Noyaux parallélisés avec OpenMP (mesurés pour chaque nombre de threads)
+static const int kernel_threaded[NUM_KERNELS] = { 1, 0, 1, 0, 0, 0 };
+
+static const int bucket_counts[] = { 4, 64, 1024 };
+static const int k_values[] = { 100, 10000 };
+static const int message_sizes[] = { 4, 64, 1024, 16384, 262144 };
+static const int message_sizes_quick[] = { 4, 1024, 65536 };
+static const int root_sizes[] = { 4096, 65536, 1048576 };
+
+/**
+ * Options de la ligne de commande
+ */
+typedef struct {
+    int quick;          // Balayage réduit (--quick)
+    int max_size;       // Taille maximale des noyaux (--max-size=n)
+    double sample_time; // Durée minimale d'un échantillon en secondes (--sample-ms)
+    const char *csv_path;       // Fichier CSV (--csv=fichier), NULL sinon
+} options_t;
+
+/**
+ * Paramètres d'une opération de communication mesurée
+ */
+typedef struct {
+    int kind;           // 0 ping-pong, 1 Alltoallv, 2 Scatterv, 3 Gatherv
+    int bytes;          // Octets par message (par paire, par processus)
+    char *send;
+    char *recv;
+    int *counts;
+    int *displs;
+    MPI_Comm comm;
+} comm_case_t;
+
+/**
+ * Paramètres d'un noyau mesuré
+ */
+typedef struct {
+    int kernel;
+    int size;
+    int param;          // Buckets (comptage, répartition) ou K (sélection)
+    const int *data;
+    int *work;
+    int *out;
+    int *counts;
+    int *offsets;
+} kernel_case_t;
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *samples, int count) {
+    qsort(samples, count, sizeof(double), compare_double);
+    return samples[count / 2];
+}
+
+/**
+ * Une opération de communication (ping-pong: aller-retour)
+ */
+static void run_comm(comm_case_t *c) {
+    int rank;
+    MPI_Comm_rank(c->comm, &rank);
+    switch (c->kind) {
+        case 0:
+            if (rank == 0) {
+                MPI_Send(c->send, c->bytes, MPI_CHAR, 1, 0, c->comm);
+                MPI_Recv(c->recv, c->bytes, MPI_CHAR, 1, 0, c->comm, MPI_STATUS_IGNORE);
+            } else {
+                MPI_Recv(c->recv, c->bytes, MPI_CHAR, 0, 0, c->comm, MPI_STATUS_IGNORE);
+                MPI_Send(c->send, c->bytes, MPI_CHAR, 0, 0, c->comm);
+            }
+            break;
+        case 1:
+            MPI_Alltoallv(c->send, c->counts, c->displs, MPI_CHAR,
+                          c->recv, c->counts, c->displs, MPI_CHAR, c->comm);
+            break;
+        case 2:
+            MPI_Scatterv(c->send, c->counts, c->displs, MPI_CHAR,
+                         c->recv, c->bytes, MPI_CHAR, 0, c->comm);
+            break;
+        case 3:
+            MPI_Gatherv(c->send, c->bytes, MPI_CHAR,
+                        c->recv, c->counts, c->displs, MPI_CHAR, 0, c->comm);
+            break;
+    }
+}
+
+/**
+ * Temps d'une opération collective sur c->comm: nombre de répétitions
+ * doublé jusqu'à sample_time (décision commune), puis médiane des
+ * échantillons du temps maximal sur les processus
+ */
+static double time_comm(comm_case_t *c, double sample_time) {
+    int reps = 1;
+    double samples[CALIBRATE_SAMPLES];
+    for (;;) {
+        MPI_Barrier(c->comm);
+        double t0 = MPI_Wtime();
+        for (int r = 0; r < reps; r++) run_comm(c);
+        double elapsed = MPI_Wtime() - t0, slowest;
+        MPI_Allreduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, c->comm);
+        if (slowest >= sample_time || reps >= (1 << 20)) break;
+        reps *= 2;
+    }
+    for (int s = 0; s < CALIBRATE_SAMPLES; s++) {
+        MPI_Barrier(c->comm);
+        double t0 = MPI_Wtime();
+        for (int r = 0; r < reps; r++) run_comm(c);
+        double elapsed = (MPI_Wtime() - t0) / reps;
+        MPI_Allreduce(&elapsed, &samples[s], 1, MPI_DOUBLE, MPI_MAX, c->comm);
+    }
+    return median(samples, CALIBRATE_SAMPLES);
+}
+
+/**
+ * Écrit une mesure (processus 0)
+ */
+static void emit(FILE *csv, const char *kind, int procs, int threads, long long size, int param,
+                 double seconds) {
+    printf("%-18s %5d %4d %10lld %6d %14.4e\n", kind, procs, threads, size, param, seconds);
+    if (csv != NULL) {
+        fprintf(csv, "%s,%d,%d,%lld,%d,%.12f\n", kind, procs, threads, size, param, seconds);
+    }
+}
+
+/**
+ * Ping-pong, Alltoallv, Scatterv et Gatherv sur les q premiers processus
+ */
+static void calibrate_comm(const options_t *opts, FILE *csv, int rank, int num_procs) {
+    static const char *kind_names[4] = { "pingpong", "alltoallv", "scatterv", "gatherv" };
+    const int *sizes = opts->quick ? message_sizes_quick : message_sizes;
+    int num_sizes = opts->quick ? 3 : 5;
+    
+    int group_sizes[32];
+    int num_groups = 0;
+    for (int q = 2; q < num_procs; q *= 2) {
+        group_sizes[num_groups++] = q;
+    }
+    group_sizes[num_groups++] = num_procs;
+    
+    for (int kind = 0; kind < 4; kind++) {
+        for (int g = 0; g < num_groups; g++) {
+            int q = (kind == 0) ? 2 : group_sizes[g];
+            if (kind == 0 && g > 0) break;
+            MPI_Comm comm;
+            MPI_Comm_split(MPI_COMM_WORLD, rank < q ? 0 : MPI_UNDEFINED, rank, &comm);
+    
+            // Ping-pong: tailles de 1 octet à 16 Mo (x 16)
+            int kind_sizes[16];
+            int count = 0;
+            if (kind == 0) {
+                for (int b = 1; b <= (1 << 24); b *= 16) kind_sizes[count++] = b;
+            } else if (kind == 1) {
+                for (int i = 0; i < num_sizes; i++) {
+                    // Au plus 64 Mo par processus
+                    if ((long long)sizes[i] * q <= (64LL << 20)) kind_sizes[count++] = sizes[i];
+                }
+            } else {
+                for (int i = 0; i < 3; i++) {
+                    if ((long long)root_sizes[i] * q <= (256LL << 20)) {
+                        kind_sizes[count++] = root_sizes[i];
+                    }
+                }
+            }
+    
+            for (int i = 0; i < count && comm != MPI_COMM_NULL; i++) {
+                comm_case_t c;
+                c.kind = kind;
+                c.bytes = kind_sizes[i];
+                c.comm = comm;
+                size_t total = (kind == 0) ? (size_t)c.bytes : (size_t)c.bytes * q;
+                c.send = (char*)calloc(total, 1);
+                c.recv = (char*)calloc(total, 1);
+                c.counts = (int*)malloc(q * sizeof(int));
+                c.displs = (int*)malloc(q * sizeof(int));
+                for (int r = 0; r < q; r++) {
+                    c.counts[r] = c.bytes;
+                    c.displs[r] = r * c.bytes;
+                }
+    
+                double seconds = time_comm(&c, opts->sample_time);
+                if (kind == 0) seconds /= 2;
+                if (rank == 0) {
+                    emit(csv, kind_names[kind], q, 1, c.bytes, 0, seconds);
+                }
+                free(c.send);
+                free(c.recv);
+                free(c.counts);
+                free(c.displs);
+            }
+            if (comm != MPI_COMM_NULL) {
+                MPI_Comm_free(&comm);
+            }
+        }
+    }
+}
+
+static void sort_section(int *arr, int size, const void *context) {
+    (void)context;
+    sort_local(arr, size, SORT_QSORT);
+}
+
+/**
+ * Prépare un appel (hors mesure)
+ */
+static void prepare_kernel(kernel_case_t *c) {
+    if (c->kernel == KERNEL_SORT || c->kernel == KERNEL_SELECT) {
+        memcpy(c->work, c->data, c->size * sizeof(int));
+    }
+}
+
+/**
+ * Un appel du noyau (mesuré)
+ */
+static void run_kernel(kernel_case_t *c) {
+    double range = (double)MAX_VALUE / (c->param > 0 ? c->param : 1);
+    int half = c->size / 2;
+    switch (c->kernel) {
+        case KERNEL_COUNT:
+            kernel_count_buckets(c->data, c->size, c->counts, c->param, range, NULL);
+            break;
+        case KERNEL_SCATTER:
+            scatter_buckets(c->data, c->size, c->out, c->offsets, c->param, range, NULL);
+            break;
+        case KERNEL_SORT:
+            kernel_parallel_sort(c->work, c->size, sort_section, NULL);
+            break;
+        case KERNEL_MERGE:
+            kernel_merge_runs(c->data, half, c->data + half, c->size - half, c->out);
+            break;
+        case KERNEL_SELECT:
+            sort_top_desc(c->work, c->size, c->param);
+            break;
+        case KERNEL_MERGE_TOPK:
+            kernel_merge_topk(c->data, c->size, c->data + c->size, c->size, c->out, c->size);
+            break;
+    }
+}
+
+/**
+ * Secondes par élément d'un noyau: médiane de CALIBRATE_SAMPLES
+ * échantillons d'au moins sample_time secondes
+ */
+static double time_kernel(kernel_case_t *c, double sample_time) {
+    double samples[CALIBRATE_SAMPLES];
+    prepare_kernel(c);
+    run_kernel(c);
+    for (int s = 0; s < CALIBRATE_SAMPLES; s++) {
+        double elapsed = 0.0;
+        long long calls = 0;
+        while (elapsed < sample_time || calls == 0) {
+            prepare_kernel(c);
+            double t0 = MPI_Wtime();
+            run_kernel(c);
+            elapsed += MPI_Wtime() - t0;
+            calls++;
+        }
+        samples[s] = elapsed / calls / c->size;
+    }
+    return median(samples, CALIBRATE_SAMPLES);
+}
+
+/**
+ * Noyaux locaux (processus 0 seul)
+ */
+static void calibrate_kernels(const options_t *opts, FILE *csv) {
+    int max_threads = 1;
+    #ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+    #endif
+    int threads[32];
+    int num_thread_counts = 0;
+    for (int t = 1; t < max_threads; t *= 2) {
+        threads[num_thread_counts++] = t;
+    }
+    threads[num_thread_counts++] = max_threads;
+    
+    int max_size = opts->max_size;
+    int *data = (int*)malloc(((size_t)max_size * 2 + 1) * sizeof(int));
+    int *work = (int*)malloc(((size_t)max_size + 1) * sizeof(int));
+    int *out = scatter_alloc(max_size * 2 + 1);
+    int *counts = (int*)malloc(1024 * sizeof(int));
+    int *offsets = (int*)malloc(1025 * sizeof(int));
+    workload_generate(data, 0, max_size * 2, (long long)max_size * 2, MAX_VALUE, DIST_UNIFORM,
+                      WORKLOAD_DEFAULT_SEED);
+    
+    for (int kernel = 0; kernel < NUM_KERNELS; kernel++) {
+        int num_params = 1;
+        const int *params = NULL;
+        if (kernel == KERNEL_COUNT || kernel == KERNEL_SCATTER) {
+            params = bucket_counts;
+            num_params = 3;
+        } else if (kernel == KERNEL_SELECT) {
+            params = k_values;
+            num_params = 2;
+        }
+        int thread_counts = kernel_threaded[kernel] ? num_thread_counts : 1;
+    
+        for (long long size = 1024; size <= max_size; size *= opts->quick ? 16 : 4) {
+            // Fusions: deux listes triées de size éléments
+            if (kernel == KERNEL_MERGE || kernel == KERNEL_MERGE_TOPK) {
+                sort_radix(data, (int)size);
+                sort_radix(data + size, (int)size);
+                if (kernel == KERNEL_MERGE_TOPK) {
+                    for (long long i = 0; i < size; i++) {
+                        data[i] = MAX_VALUE - data[i];
+                        data[size + i] = MAX_VALUE - data[size + i];
+                    }
+                }
+            }
+            for (int pi = 0; pi < num_params; pi++) {
+                int param = params != NULL ? params[pi] : 0;
+                if (kernel == KERNEL_SELECT && param >= size) continue;
+                for (int ti = 0; ti < thread_counts; ti++) {
+                    #ifdef _OPENMP
+                    omp_set_num_threads(threads[ti]);
+                    #endif
+                    kernel_case_t c = { kernel, (int)size, param, data, work, out, counts,
+                                        offsets };
+                    if (kernel == KERNEL_SCATTER) {
+                        kernel_count_buckets(data, c.size, counts, param,
+                                             (double)MAX_VALUE / param, NULL);
+                        offsets[0] = 0;
+                        for (int b = 0; b < param; b++) offsets[b + 1] = offsets[b] + counts[b];
+                    }
+                    double seconds = time_kernel(&c, opts->sample_time);
+                    emit(csv, kernel_names[kernel], 1, threads[ti], size, param, seconds);
+                }
+            }
+            // Données de nouveau aléatoires pour les noyaux suivants
+            if (kernel == KERNEL_MERGE || kernel == KERNEL_MERGE_TOPK) {
+                workload_generate(data, 0, max_size * 2, (long long)max_size * 2, MAX_VALUE,
+                                  DIST_UNIFORM, WORKLOAD_DEFAULT_SEED);
+            }
+        }
+    }
+    #ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+    #endif
+    
+    free(data);
+    free(work);
+    free(out);
+    free(counts);
+    free(offsets);
+}
+
+/**
+ * Attend le message de fin du processus 0 sans attente active (une
+ * barrière MPI interrogerait la file en boucle et ralentirait les noyaux
+ * mesurés si les processus partagent des cœurs)
+ */
+static void wait_idle(void) {
+    int done = 0, token;
+    MPI_Request request;
+    struct timespec pause = { 0, 1000000 };
+    MPI_Irecv(&token, 1, MPI_INT, 0, 1, MPI_COMM_WORLD, &request);
+    while (!done) {
+        nanosleep(&pause, NULL);
+        MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    
+    options_t opts = { 0, DEFAULT_MAX_SIZE, DEFAULT_SAMPLE_MS * 1e-3, NULL };
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            opts.quick = 1;
+            opts.max_size = 1 << 20;
+            opts.sample_time = 5e-3;
+        } else if (strncmp(argv[i], "--max-size=", 11) == 0) {
+            opts.max_size = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--sample-ms=", 12) == 0) {
+            opts.sample_time = atof(argv[i] + 12) * 1e-3;
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            opts.csv_path = argv[i] + 6;
+        }
+    }
+    if (opts.max_size < 1024) opts.max_size = 1024;
+    
+    FILE *csv = NULL;
+    if (rank == 0) {
+        if (opts.csv_path != NULL) {
+            csv = fopen(opts.csv_path, "w");
+            if (csv == NULL) {
+                fprintf(stderr, "Erreur: impossible d'écrire %s\n", opts.csv_path);
+            } else {
+                fprintf(csv, "kind,procs,threads,size,param,seconds\n");
+            }
+        }
+        printf("=== Calibration du modèle de coût ===\n");
+        printf("Processus: %d, échantillons: %d x %.0f ms\n", num_procs, CALIBRATE_SAMPLES,
+               opts.sample_time * 1e3);
+        printf("\n%-18s %5s %4s %10s %6s %14s\n", "mesure", "proc", "thr", "taille", "param",
+               "secondes");
+    }
+    
+    if (num_procs >= 2) {
+        calibrate_comm(&opts, csv, rank, num_procs);
+    } else if (rank == 0) {
+        printf("(un seul processus: communications non mesurées)\n");
+    }
+    if (rank == 0) {
+        calibrate_kernels(&opts, csv);
+        int token = 0;
+        for (int r = 1; r < num_procs; r++) {
+            MPI_Send(&token, 1, MPI_INT, r, 1, MPI_COMM_WORLD);
+        }
+        if (csv != NULL) {
+            fclose(csv);
+            printf("\nMesures écrites dans %s\n", opts.csv_path);
+        }
+    } else {
+        wait_idle();
+    }
+    
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * Modes --unique et --count du Bucket Sort distribué
+ *
+ * Regroupement local des doublons, échange des paires (clé, nombre)
+ * et fusion des occurrences côté réception.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "dedup.h"
+#include "instrument.h"
+#include "trace.h"
+#include "sort_kernels.h"
+
+/**
+ * Paires par clé croissante (noyaux de sort_kernels.h)
+ */
+static inline int pair_key_before(const key_count_t *a, const key_count_t *b) {
+    return a->key < b->key;
+}
+
+SORT_DEFINE_KERNELS(pair_key, key_count_t, pair_key_before)
+
+/**
+ * Indice du bucket (processus destinataire) d'une clé
+ */
+static inline int bucket_of(int key, int num_buckets, double range) {
+    int bucket_id = (int)(key / range);
+    return (bucket_id >= num_buckets) ? num_buckets - 1 : bucket_id;
+}
+
+MPI_Datatype dedup_pair_type(void) {
+    MPI_Datatype pair_type;
+    MPI_Type_contiguous(2, MPI_INT, &pair_type);
+    MPI_Type_commit(&pair_type);
+    return pair_type;
+}
+
+int dedup_collapse_local(const int *local_data, int local_size, int max_value,
+                         int num_buckets, double range,
+                         key_count_t **pairs, int *bucket_counts) {
+    memset(bucket_counts, 0, num_buckets * sizeof(int));
+    int num_pairs = 0;
+    key_count_t *out = NULL;
+
+    if ((long long)local_size * 4 >= max_value) {
+        // Données denses: histogramme direct sur [0, max_value), aucun tri
+        int *counts = (int*)calloc(max_value, sizeof(int));
+
+        #ifdef _OPENMP
+        #pragma omp parallel for
+        #endif
+        for (int i = 0; i < local_size; i++) {
+            #ifdef _OPENMP
+            #pragma omp atomic
+            #endif
+            counts[local_data[i]]++;
+        }
+
+        for (int v = 0; v < max_value; v++) {
+            num_pairs += (counts[v] != 0);
+        }
+
+        out = (key_count_t*)malloc((num_pairs + 1) * sizeof(key_count_t));
+        int pos = 0;
+        for (int v = 0; v < max_value; v++) {
+            if (counts[v] != 0) {
+                out[pos].key = v;
+                out[pos].count = counts[v];
+                bucket_counts[bucket_of(v, num_buckets, range)]++;
+                pos++;
+            }
+        }
+        free(counts);
+    } else {
+        // Données clairsemées: tri d'une copie puis encodage par plages
+        int *sorted = (int*)malloc((local_size + 1) * sizeof(int));
+        memcpy(sorted, local_data, local_size * sizeof(int));
+        sort_int_order(sorted, local_size, SORT_ASC);
+
+        out = (key_count_t*)malloc((local_size + 1) * sizeof(key_count_t));
+        for (int i = 0; i < local_size; ) {
+            int j = i + 1;
+            while (j < local_size && sorted[j] == sorted[i]) j++;
+            out[num_pairs].key = sorted[i];
+            out[num_pairs].count = j - i;
+            bucket_counts[bucket_of(sorted[i], num_buckets, range)]++;
+            num_pairs++;
+            i = j;
+        }
+        free(sorted);
+    }
+
+    // Les clés sont triées et bucket_of est croissant: les paires de chaque
+    // bucket sont déjà contiguës, prêtes pour l'envoi
+    *pairs = out;
+    return num_pairs;
+}
+
+int dedup_exchange_merge(const key_count_t *pairs, const int *bucket_counts,
+                         int mode, key_count_t **result, long long *bytes_sent,
+                         MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+
+    // Échange des nombres de paires
+    double t0 = instr_start();
+    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+    TRACED("MPI_Alltoall",
+           MPI_Alltoall((void*)bucket_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, comm));
+    instr_stop(PHASE_COUNT_EXCHANGE, t0);
+
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    send_displs[0] = 0;
+    recv_displs[0] = 0;
+    int total_send = bucket_counts[0];
+    int total_recv = recv_counts[0];
+    for (int i = 1; i < num_procs; i++) {
+        send_displs[i] = send_displs[i-1] + bucket_counts[i-1];
+        recv_displs[i] = recv_displs[i-1] + recv_counts[i-1];
+        total_send += bucket_counts[i];
+        total_recv += recv_counts[i];
+    }
+
+    key_count_t *recv_pairs = (key_count_t*)malloc((total_recv + 1) * sizeof(key_count_t));
+    long long pair_bytes = (mode == OUTPUT_UNIQUE) ? sizeof(int) : sizeof(key_count_t);
+
+    t0 = instr_start();
+    if (mode == OUTPUT_UNIQUE) {
+        // Seules les clés voyagent: les nombres d'occurrences sont inutiles
+        int *send_keys = (int*)malloc((total_send + 1) * sizeof(int));
+        int *recv_keys = (int*)malloc((total_recv + 1) * sizeof(int));
+        for (int i = 0; i < total_send; i++) {
+            send_keys[i] = pairs[i].key;
+        }
+        TRACED("MPI_Alltoallv",
+               MPI_Alltoallv(send_keys, (int*)bucket_counts, send_displs, MPI_INT,
+                             recv_keys, recv_counts, recv_displs, MPI_INT, comm));
+        for (int i = 0; i < total_recv; i++) {
+            recv_pairs[i].key = recv_keys[i];
+            recv_pairs[i].count = 1;
+        }
+        free(send_keys);
+        free(recv_keys);
+    } else {
+        MPI_Datatype pair_type = dedup_pair_type();
+        TRACED("MPI_Alltoallv",
+               MPI_Alltoallv((void*)pairs, (int*)bucket_counts, send_displs, pair_type,
+                             recv_pairs, recv_counts, recv_displs, pair_type, comm));
+        MPI_Type_free(&pair_type);
+    }
+    instr_stop(PHASE_DATA_EXCHANGE, t0);
+    instr_add_bytes(total_send * pair_bytes, total_recv * pair_bytes);
+    if (bytes_sent != NULL) {
+        *bytes_sent = total_send * pair_bytes;
+    }
+
+    // Fusion des occurrences d'une même clé reçues de plusieurs processus
+    t0 = instr_start();
+    int num_merged = 0;
+    key_count_t *merged = (key_count_t*)malloc((total_recv + 1) * sizeof(key_count_t));
+
+    if (total_recv > 0) {
+        int min_key = recv_pairs[0].key;
+        int max_key = recv_pairs[0].key;
+        for (int i = 1; i < total_recv; i++) {
+            if (recv_pairs[i].key < min_key) min_key = recv_pairs[i].key;
+            if (recv_pairs[i].key > max_key) max_key = recv_pairs[i].key;
+        }
+        long long span = (long long)max_key - min_key + 1;
+
+        if (span <= 4LL * total_recv + 1024) {
+            // Plage compacte: accumulation directe, linéaire
+            int *counts = (int*)calloc(span, sizeof(int));
+            for (int i = 0; i < total_recv; i++) {
+                counts[recv_pairs[i].key - min_key] += recv_pairs[i].count;
+            }
+            for (long long v = 0; v < span; v++) {
+                if (counts[v] != 0) {
+                    merged[num_merged].key = (int)(v + min_key);
+                    merged[num_merged].count = counts[v];
+                    num_merged++;
+                }
+            }
+            free(counts);
+        } else {
+            // Plage étendue: tri des paires puis cumul des clés égales
+            pair_key_sort(recv_pairs, total_recv);
+            for (int i = 0; i < total_recv; i++) {
+                if (num_merged > 0 && merged[num_merged-1].key == recv_pairs[i].key) {
+                    merged[num_merged-1].count += recv_pairs[i].count;
+                } else {
+                    merged[num_merged++] = recv_pairs[i];
+                }
+            }
+        }
+
+        if (mode == OUTPUT_UNIQUE) {
+            for (int i = 0; i < num_merged; i++) {
+                merged[i].count = 1;
+            }
+        }
+    }
+    instr_stop(PHASE_MERGE, t0);
+
+    free(recv_counts);
+    free(send_displs);
+    free(recv_displs);
+    free(recv_pairs);
+
+    *result = merged;
+    return num_merged;
+}
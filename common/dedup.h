@@ -0,0 +1,54 @@
+/**
+ * Modes --unique et --count du Bucket Sort distribué
+ *
+ * Les doublons sont regroupés localement en paires (clé, nombre) avant
+ * l'échange All-to-All: le volume échangé et le coût du tri local sont
+ * divisés par le facteur de duplication des données.
+ */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <mpi.h>
+
+// Modes de sortie du Bucket Sort
+#define OUTPUT_SORT   0   // Tableau trié complet (comportement historique)
+#define OUTPUT_UNIQUE 1   // Clés distinctes triées
+#define OUTPUT_COUNT  2   // Histogramme trié (clé, nombre d'occurrences)
+
+/**
+ * Paire (clé, nombre d'occurrences) échangée entre les processus
+ */
+typedef struct {
+    int key;
+    int count;
+} key_count_t;
+
+/**
+ * Regroupe les doublons du tableau local en paires triées par clé.
+ * Les clés doivent appartenir à [0, max_value).
+ * bucket_counts[b] reçoit le nombre de paires destinées au bucket b.
+ * Retourne le nombre de paires allouées dans *pairs (à libérer par free).
+ */
+int dedup_collapse_local(const int *local_data, int local_size, int max_value,
+                         int num_buckets, double range,
+                         key_count_t **pairs, int *bucket_counts);
+
+/**
+ * Échange les paires (MPI_Alltoallv) puis fusionne les occurrences reçues.
+ * En mode OUTPUT_UNIQUE seules les clés sont transmises (4 octets par clé)
+ * et les nombres d'occurrences du résultat valent 1.
+ * Retourne le nombre de paires distinctes de la plage de ce processus,
+ * triées par clé, dans *result (à libérer par free).
+ * *bytes_sent reçoit le volume envoyé par ce processus (peut être NULL).
+ */
+int dedup_exchange_merge(const key_count_t *pairs, const int *bucket_counts,
+                         int mode, key_count_t **result, long long *bytes_sent,
+                         MPI_Comm comm);
+
+/**
+ * Crée le type MPI correspondant à key_count_t (à libérer par MPI_Type_free)
+ */
+MPI_Datatype dedup_pair_type(void);
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Échange des buckets entre processus: dense ou creux (NBX)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "exchange.h"
+#include "trace.h"
+
+static const char *exchange_names[NUM_EXCHANGES] = { "dense", "sparse" };
+
+int exchange_parse(const char *name) {
+    for (int e = 0; e < NUM_EXCHANGES; e++) {
+        if (strcmp(name, exchange_names[e]) == 0) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+const char *exchange_name(int exchange) {
+    return (exchange >= 0 && exchange < NUM_EXCHANGES) ? exchange_names[exchange] : "?";
+}
+
+double exchange_density(const int *send_counts, int num_procs, MPI_Comm comm) {
+    if (num_procs < 2) {
+        return 0.0;
+    }
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    long long local_pairs = 0, pairs;
+    for (int d = 0; d < num_procs; d++) {
+        if (d != rank && send_counts[d] > 0) local_pairs++;
+    }
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(&local_pairs, &pairs, 1, MPI_LONG_LONG, MPI_SUM, comm));
+    return (double)pairs / ((double)num_procs * (num_procs - 1));
+}
+
+int *exchange_sparse(const int *send_buffer, const int *send_counts, const int *send_displs,
+                     int *recv_size, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    // Le bucket local est copié sans message
+    int size = send_counts[rank];
+    int capacity = size;
+    int *recv = (int*)malloc((capacity + 1) * sizeof(int));
+    memcpy(recv, send_buffer + send_displs[rank], size * sizeof(int));
+    
+    // Envois synchrones: leur achèvement garantit la réception
+    MPI_Request *requests = (MPI_Request*)malloc(num_procs * sizeof(MPI_Request));
+    int num_requests = 0;
+    for (int d = 0; d < num_procs; d++) {
+        if (d == rank || send_counts[d] == 0) continue;
+        TRACED("MPI_Issend",
+               MPI_Issend(send_buffer + send_displs[d], send_counts[d], MPI_INT, d, EXCHANGE_TAG,
+                          comm, &requests[num_requests++]));
+    }
+    
+    // Réceptions au fil des arrivées jusqu'à la fin de la barrière non
+    // bloquante, posée quand tous les envois locaux ont été reçus
+    MPI_Request barrier = MPI_REQUEST_NULL;
+    int barrier_posted = 0;
+    int done = 0;
+    while (!done) {
+        int arrived;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, EXCHANGE_TAG, comm, &arrived, &status);
+        if (arrived) {
+            int count;
+            MPI_Get_count(&status, MPI_INT, &count);
+            if (size + count > capacity) {
+                capacity = 2 * capacity;
+                if (capacity < size + count) capacity = size + count;
+                recv = (int*)realloc(recv, (capacity + 1) * sizeof(int));
+            }
+            TRACED("MPI_Recv",
+                   MPI_Recv(recv + size, count, MPI_INT, status.MPI_SOURCE, EXCHANGE_TAG, comm,
+                            MPI_STATUS_IGNORE));
+            size += count;
+        }
+    
+        if (barrier_posted) {
+            MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+        } else {
+            int sent;
+            MPI_Testall(num_requests, requests, &sent, MPI_STATUSES_IGNORE);
+            if (sent) {
+                TRACED("MPI_Ibarrier",
+                       MPI_Ibarrier(comm, &barrier));
+                barrier_posted = 1;
+            }
+        }
+    }
+    
+    free(requests);
+    *recv_size = size;
+    return recv;
+}
@@ -0,0 +1,54 @@
+/**
+ * Échange des buckets entre processus
+ *
+ * L'échange dense (MPI_Alltoall des tailles puis MPI_Alltoallv) traite les
+ * p^2 paires (source, destination), même vides. Sur des données
+ * presque triées ou concentrées sur quelques intervalles, la plupart des
+ * paires sont vides: l'échange creux envoie seulement les buckets non vides
+ * par MPI_Issend, sans échange préalable des tailles. Chaque destinataire
+ * découvre les messages par MPI_Iprobe (taille par MPI_Get_count), et la
+ * fin de l'échange est détectée par une barrière non bloquante posée une
+ * fois ses propres envois reçus (protocole NBX): le coût suit le nombre de
+ * messages réels plus log p, et non p^2.
+ */
+
+#ifndef EXCHANGE_H
+#define EXCHANGE_H
+
+#include <mpi.h>
+
+// Modes d'échange (--exchange=nom)
+#define EXCHANGE_DENSE  0   // MPI_Alltoall + MPI_Alltoallv (historique)
+#define EXCHANGE_SPARSE 1   // Envois des seuls buckets non vides (NBX)
+#define NUM_EXCHANGES   2
+
+// Étiquette des messages de l'échange creux
+#define EXCHANGE_TAG 41
+
+/**
+ * Numéro du mode à partir de son nom (-1 si inconnu)
+ */
+int exchange_parse(const char *name);
+
+/**
+ * Nom du mode
+ */
+const char *exchange_name(int exchange);
+
+/**
+ * Densité de la matrice des échanges: proportion des paires (source,
+ * destination) distinctes dont le bucket est non vide (0 pour un seul
+ * processus). Opération collective (un MPI_Allreduce).
+ */
+double exchange_density(const int *send_counts, int num_procs, MPI_Comm comm);
+
+/**
+ * Échange creux: le bucket d'indice d (send_counts[d] éléments à partir de
+ * send_buffer + send_displs[d]) est envoyé au processus d s'il est non
+ * vide. Retourne les éléments reçus (à libérer), concaténés dans l'ordre
+ * d'arrivée, et leur nombre dans *recv_size. Opération collective.
+ */
+int *exchange_sparse(const int *send_buffer, const int *send_counts, const int *send_displs,
+                     int *recv_size, MPI_Comm comm);
+
+#endif
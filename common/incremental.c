@@ -0,0 +1,221 @@
+/**
+ * Mise à jour incrémentale d'un tableau trié distribué
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "incremental.h"
+#include "partition.h"
+#include "presort.h"
+#include "instrument.h"
+#include "trace.h"
+
+int *incremental_range_splitters(double range, int num_procs) {
+    int *splitters = (int*)malloc(num_procs * sizeof(int));
+    for (int i = 0; i < num_procs - 1; i++) {
+        // Plus petite valeur v telle que (int)(v / range) >= i + 1 (même
+        // arrondi que le découpage en intervalles)
+        long long v = (long long)ceil((i + 1) * range);
+        while (v > 0 && (long long)((v - 1) / range) >= i + 1) v--;
+        while ((long long)(v / range) < i + 1) v++;
+        splitters[i] = (v > INT_MAX) ? INT_MAX : (int)v;
+    }
+    return splitters;
+}
+
+void incremental_init(sorted_partition_t *part, int *data, int size, int *splitters,
+                      int num_procs) {
+    part->data = data;
+    part->size = size;
+    part->capacity = size;
+    part->splitters = splitters;
+    part->num_procs = num_procs;
+}
+
+void incremental_free(sorted_partition_t *part) {
+    free(part->data);
+    free(part->splitters);
+    part->data = NULL;
+    part->splitters = NULL;
+}
+
+/**
+ * Fusion en place depuis la fin: data[0..size) et incoming[0..count) sont
+ * triés, data a une capacité d'au moins size + count. Les éléments de data
+ * inférieurs ou égaux à la plus petite clé reçue ne bougent pas.
+ */
+static void merge_backward(int *data, int size, const int *incoming, int count) {
+    int i = size - 1;
+    int j = count - 1;
+    int w = size + count - 1;
+    while (j >= 0) {
+        if (i >= 0 && data[i] > incoming[j]) {
+            data[w--] = data[i--];
+        } else {
+            data[w--] = incoming[j--];
+        }
+    }
+}
+
+long long incremental_insert(sorted_partition_t *part, const int *batch, int batch_size,
+                             const strategy_t *strategy, MPI_Comm comm) {
+    int num_procs = part->num_procs;
+    
+    // Classement du lot seulement, avec les séparateurs existants
+    double t0 = instr_start();
+    int *send_counts = (int*)calloc(num_procs, sizeof(int));
+    int *buckets = (int*)malloc((batch_size + 1) * sizeof(int));
+    for (int i = 0; i < batch_size; i++) {
+        buckets[i] = partition_bucket(batch[i], part->splitters, num_procs);
+        send_counts[buckets[i]]++;
+    }
+    instr_stop(PHASE_CLASSIFY, t0);
+    
+    t0 = instr_start();
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    int *fill = (int*)malloc(num_procs * sizeof(int));
+    send_displs[0] = 0;
+    for (int d = 1; d < num_procs; d++) {
+        send_displs[d] = send_displs[d - 1] + send_counts[d - 1];
+    }
+    memcpy(fill, send_displs, num_procs * sizeof(int));
+    int *send_buffer = (int*)malloc((batch_size + 1) * sizeof(int));
+    for (int i = 0; i < batch_size; i++) {
+        send_buffer[fill[buckets[i]]++] = batch[i];
+    }
+    instr_stop(PHASE_PACK, t0);
+    
+    t0 = instr_start();
+    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+    TRACED("MPI_Alltoall",
+           MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, comm));
+    instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    
+    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    int total_recv = 0;
+    for (int d = 0; d < num_procs; d++) {
+        recv_displs[d] = total_recv;
+        total_recv += recv_counts[d];
+    }
+    
+    // Les clés reçues sont placées à la fin de la partition agrandie, puis
+    // triées et fusionnées
+    if (part->size + total_recv > part->capacity) {
+        int capacity = 2 * part->capacity;
+        if (capacity < part->size + total_recv) capacity = part->size + total_recv;
+        part->data = (int*)realloc(part->data, (capacity + 1) * sizeof(int));
+        part->capacity = capacity;
+    }
+    int *incoming = (int*)malloc((total_recv + 1) * sizeof(int));
+    
+    t0 = instr_start();
+    TRACED("MPI_Alltoallv",
+           MPI_Alltoallv(send_buffer, send_counts, send_displs, MPI_INT,
+                         incoming, recv_counts, recv_displs, MPI_INT, comm));
+    instr_stop(PHASE_DATA_EXCHANGE, t0);
+    instr_add_bytes((long long)batch_size * sizeof(int), (long long)total_recv * sizeof(int));
+    
+    t0 = instr_start();
+    strategy_sort(strategy, incoming, total_recv);
+    instr_stop(PHASE_LOCAL_SORT, t0);
+    
+    t0 = instr_start();
+    merge_backward(part->data, part->size, incoming, total_recv);
+    part->size += total_recv;
+    instr_stop(PHASE_MERGE, t0);
+    instr_set_bucket_size(part->size);
+    
+    free(send_counts);
+    free(buckets);
+    free(send_displs);
+    free(fill);
+    free(send_buffer);
+    free(recv_counts);
+    free(recv_displs);
+    free(incoming);
+    return (long long)batch_size * sizeof(int);
+}
+
+double incremental_imbalance(const sorted_partition_t *part, MPI_Comm comm) {
+    long long size = part->size, largest, total;
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(&size, &largest, 1, MPI_LONG_LONG, MPI_MAX, comm));
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(&size, &total, 1, MPI_LONG_LONG, MPI_SUM, comm));
+    return total > 0 ? (double)largest * part->num_procs / total : 1.0;
+}
+
+long long incremental_rebalance(sorted_partition_t *part, MPI_Comm comm) {
+    int num_procs = part->num_procs;
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Position globale de chaque partition dans l'ordre trié
+    int *sizes = (int*)malloc(num_procs * sizeof(int));
+    TRACED("MPI_Allgather",
+           MPI_Allgather(&part->size, 1, MPI_INT, sizes, 1, MPI_INT, comm));
+    long long *starts = (long long*)malloc((num_procs + 1) * sizeof(long long));
+    long long *targets = (long long*)malloc((num_procs + 1) * sizeof(long long));
+    starts[0] = 0;
+    for (int r = 0; r < num_procs; r++) {
+        starts[r + 1] = starts[r] + sizes[r];
+    }
+    long long total = starts[num_procs];
+    for (int r = 0; r <= num_procs; r++) {
+        targets[r] = total * r / num_procs;
+    }
+    
+    // Tranches contiguës: intersection de [starts[src], starts[src+1]) et
+    // [targets[dst], targets[dst+1])
+    int *send_counts = (int*)malloc(num_procs * sizeof(int));
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    for (int r = 0; r < num_procs; r++) {
+        long long lo = (starts[rank] > targets[r]) ? starts[rank] : targets[r];
+        long long hi = (starts[rank + 1] < targets[r + 1]) ? starts[rank + 1] : targets[r + 1];
+        send_counts[r] = (hi > lo) ? (int)(hi - lo) : 0;
+        send_displs[r] = (hi > lo) ? (int)(lo - starts[rank]) : 0;
+    
+        lo = (starts[r] > targets[rank]) ? starts[r] : targets[rank];
+        hi = (starts[r + 1] < targets[rank + 1]) ? starts[r + 1] : targets[rank + 1];
+        recv_counts[r] = (hi > lo) ? (int)(hi - lo) : 0;
+        recv_displs[r] = (hi > lo) ? (int)(lo - targets[rank]) : 0;
+    }
+    
+    int new_size = (int)(targets[rank + 1] - targets[rank]);
+    int *data = (int*)malloc((new_size + 1) * sizeof(int));
+    double t0 = instr_start();
+    TRACED("MPI_Alltoallv",
+           MPI_Alltoallv(part->data, send_counts, send_displs, MPI_INT,
+                         data, recv_counts, recv_displs, MPI_INT, comm));
+    instr_stop(PHASE_DATA_EXCHANGE, t0);
+    
+    long long sent = 0;
+    for (int r = 0; r < num_procs; r++) {
+        if (r != rank) sent += (long long)send_counts[r] * sizeof(int);
+    }
+    instr_add_bytes(sent, 0);
+    
+    // Nouveaux séparateurs: première clé de chaque partition
+    free(part->splitters);
+    part->splitters = presort_splitters(data, new_size, comm);
+    
+    free(part->data);
+    part->data = data;
+    part->size = new_size;
+    part->capacity = new_size;
+    
+    free(sizes);
+    free(starts);
+    free(targets);
+    free(send_counts);
+    free(send_displs);
+    free(recv_counts);
+    free(recv_displs);
+    return sent;
+}
@@ -0,0 +1,78 @@
+/**
+ * Mise à jour incrémentale d'un tableau trié distribué (--incremental)
+ *
+ * Après un premier tri, chaque processus garde sa partition triée et les
+ * séparateurs qui la délimitent. Un lot de nouvelles clés est réparti avec
+ * ces mêmes séparateurs (seul le lot est classé, échangé et trié), puis
+ * fusionné en place dans la partition par une fusion linéaire depuis la
+ * fin: seuls les éléments supérieurs à la plus petite clé reçue sont
+ * déplacés, sans tampon de la taille de la partition.
+ *
+ * Les séparateurs ne sont recalculés que si le déséquilibre (taille
+ * maximale / taille moyenne) dépasse un seuil: les données étant déjà
+ * globalement triées, le rééquilibrage est un simple décalage de tranches
+ * contiguës entre processus voisins (un MPI_Alltoallv).
+ */
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <mpi.h>
+
+#include "tuning.h"
+
+// Déséquilibre (taille maximale / taille moyenne) déclenchant un rééquilibrage
+#define INCREMENTAL_DEFAULT_REBALANCE 1.5
+
+/**
+ * Partition triée d'un processus et séparateurs globaux
+ */
+typedef struct {
+    int *data;
+    int size;
+    int capacity;
+    int *splitters;         // num_procs - 1 séparateurs croissants (partition_bucket)
+    int num_procs;
+} sorted_partition_t;
+
+/**
+ * Séparateurs équivalents au découpage en intervalles de largeur range
+ * (bucket (int)(valeur / range), borné à num_procs - 1). Tableau alloué.
+ */
+int *incremental_range_splitters(double range, int num_procs);
+
+/**
+ * Prend possession de la partition triée data (size éléments, alloués par
+ * malloc) et des séparateurs
+ */
+void incremental_init(sorted_partition_t *part, int *data, int size, int *splitters,
+                      int num_procs);
+
+/**
+ * Libère la partition et les séparateurs
+ */
+void incremental_free(sorted_partition_t *part);
+
+/**
+ * Insère un lot (part locale de batch_size clés, non triée): classement
+ * par les séparateurs, MPI_Alltoallv, tri des clés reçues (stratégie de
+ * tri local) puis fusion en place. Retourne les octets envoyés par ce
+ * processus. Opération collective.
+ */
+long long incremental_insert(sorted_partition_t *part, const int *batch, int batch_size,
+                             const strategy_t *strategy, MPI_Comm comm);
+
+/**
+ * Déséquilibre des partitions (taille maximale / taille moyenne).
+ * Opération collective.
+ */
+double incremental_imbalance(const sorted_partition_t *part, MPI_Comm comm);
+
+/**
+ * Redistribue les partitions en blocs de tailles égales (l'ordre global
+ * est conservé) et recalcule les séparateurs. Retourne les octets envoyés
+ * par ce processus. Opération collective.
+ */
+long long incremental_rebalance(sorted_partition_t *part, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ * Instrumentation par phase et par processus
+ *
+ * Temps par phase, volume de communication, taille des buckets et
+ * mémoire maximale (RSS) réduits en min/moyenne/max sur les processus;
+ * compteurs matériels par phase (--profile) sommés sur les threads et les
+ * processus.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "instrument.h"
+#include "trace.h"
+#include "perfcount.h"
+
+// Nombre de mesures par processus hors phases
+#define NUM_EXTRA 4
+
+// Phases profilées imbriquées au plus
+#define PROFILE_MAX_DEPTH 16
+
+int instr_enabled = 0;
+int instr_profiling = 0;
+
+static int stats_format = STATS_NONE;
+static double phase_times[NUM_PHASES];
+static int phase_used[NUM_PHASES];
+static long long bytes_sent = 0;
+static long long bytes_received = 0;
+static long long bucket_size = -1;
+
+// Profil matériel: compteurs de chaque thread, cumuls par phase, valeurs
+// à la dernière frontière de phase et phases commencées (horodatage et
+// compteurs au début)
+static perf_counters_t *profile_counters = NULL;
+static int profile_threads = 0;
+static int profile_available[PERF_NUM_EVENTS];
+static long long profile_values[NUM_PHASES][PERF_NUM_EVENTS];
+static long long profile_last[PERF_NUM_EVENTS];
+static int profile_depth = 0;
+static double profile_t0[PROFILE_MAX_DEPTH];
+static long long profile_start[PROFILE_MAX_DEPTH][PERF_NUM_EVENTS];
+
+static const char *phase_names[NUM_PHASES] = {
+    "scatter", "classify", "pack", "count_exchange", "data_exchange",
+    "local_sort", "select", "merge", "gather", "verify"
+};
+
+static const char *extra_names[NUM_EXTRA] = {
+    "bucket_size", "bytes_sent", "bytes_recv", "peak_rss_kb"
+};
+
+void instr_init(int format, int record) {
+    stats_format = format;
+    instr_enabled = (format != STATS_NONE) || record;
+    instr_reset();
+}
+
+int instr_profile_init(void) {
+    #ifdef _OPENMP
+    profile_threads = omp_get_max_threads();
+    #else
+    profile_threads = 1;
+    #endif
+    profile_counters = (perf_counters_t*)malloc(profile_threads * sizeof(perf_counters_t));
+
+    // Chaque thread ouvre ses compteurs (ils ne mesurent que le thread
+    // qui les ouvre); ceux du processus sont lus par le thread principal
+    #ifdef _OPENMP
+    #pragma omp parallel num_threads(profile_threads)
+    #endif
+    {
+        int tid = 0;
+        #ifdef _OPENMP
+        tid = omp_get_thread_num();
+        #endif
+        perf_open(&profile_counters[tid]);
+    }
+
+    // Un événement n'est retenu que s'il est ouvert dans tous les threads
+    int available = 0;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        profile_available[e] = 1;
+        for (int t = 0; t < profile_threads; t++) {
+            if (profile_counters[t].fds[e] < 0) profile_available[e] = 0;
+        }
+        available += profile_available[e];
+    }
+
+    instr_enabled = 1;
+    instr_profiling = 1;
+    instr_reset();
+    return available;
+}
+
+/**
+ * Somme des compteurs de tous les threads du processus
+ */
+static void profile_read(long long values[PERF_NUM_EVENTS]) {
+    memset(values, 0, PERF_NUM_EVENTS * sizeof(long long));
+    for (int t = 0; t < profile_threads; t++) {
+        long long thread_values[PERF_NUM_EVENTS];
+        perf_read(&profile_counters[t], thread_values);
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (thread_values[e] > 0) values[e] += thread_values[e];
+        }
+    }
+}
+
+double instr_profile_start(void) {
+    double t0 = MPI_Wtime();
+    if (profile_depth < PROFILE_MAX_DEPTH) {
+        profile_t0[profile_depth] = t0;
+        profile_read(profile_start[profile_depth]);
+        memcpy(profile_last, profile_start[profile_depth], sizeof(profile_last));
+        profile_depth++;
+    }
+    return t0;
+}
+
+/**
+ * Fin d'une phase profilée: la phase commencée à t0 est retrouvée dans la
+ * pile (celles commencées après sans être terminées sont abandonnées).
+ * Une phase chronométrée sans instr_start (horodatage MPI_Wtime partagé
+ * avec le temps de communication des versions hybrides) compte depuis la
+ * frontière de phase précédente.
+ */
+static void profile_stop(phase_t phase, double t0) {
+    long long values[PERF_NUM_EVENTS];
+    profile_read(values);
+    const long long *start = profile_last;
+    int d = profile_depth - 1;
+    while (d >= 0 && profile_t0[d] != t0) d--;
+    if (d >= 0) {
+        start = profile_start[d];
+        profile_depth = d;
+    }
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        profile_values[phase][e] += values[e] - start[e];
+    }
+    memcpy(profile_last, values, sizeof(profile_last));
+}
+
+void instr_reset(void) {
+    memset(phase_times, 0, sizeof(phase_times));
+    memset(phase_used, 0, sizeof(phase_used));
+    memset(profile_values, 0, sizeof(profile_values));
+    profile_depth = 0;
+    if (instr_profiling) {
+        profile_read(profile_last);
+    }
+    bytes_sent = 0;
+    bytes_received = 0;
+    bucket_size = -1;
+}
+
+void instr_record(phase_t phase, double t0) {
+    if (instr_profiling) {
+        profile_stop(phase, t0);
+    }
+    phase_times[phase] += MPI_Wtime() - t0;
+    phase_used[phase] = 1;
+    trace_end(phase_names[phase], t0);
+}
+
+void instr_add_bytes(long long sent, long long received) {
+    bytes_sent += sent;
+    bytes_received += received;
+}
+
+void instr_set_bucket_size(long long size) {
+    bucket_size = size;
+}
+
+double instr_phase_time(phase_t phase) {
+    return phase_times[phase];
+}
+
+const char *instr_phase_name(phase_t phase) {
+    return phase_names[phase];
+}
+
+/**
+ * Mémoire résidente maximale du processus (Ko)
+ */
+static long long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (long long)usage.ru_maxrss;
+}
+
+/**
+ * Profil matériel par phase (--profile): compteurs sommés sur les threads
+ * et les processus, temps maximal, IPC et défauts par élément du tableau
+ * (NA pour un événement indisponible sur au moins un processus)
+ */
+static void profile_report(const char *program, int total_size, int num_threads,
+                           MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+
+    double local[NUM_PHASES * PERF_NUM_EVENTS];
+    double values[NUM_PHASES * PERF_NUM_EVENTS];
+    for (int p = 0; p < NUM_PHASES; p++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            local[p * PERF_NUM_EVENTS + e] = (double)profile_values[p][e];
+        }
+    }
+    double times[NUM_PHASES];
+    int available[PERF_NUM_EVENTS];
+    int used[NUM_PHASES];
+    MPI_Reduce(local, values, NUM_PHASES * PERF_NUM_EVENTS, MPI_DOUBLE, MPI_SUM, 0, comm);
+    MPI_Reduce(phase_times, times, NUM_PHASES, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(profile_available, available, PERF_NUM_EVENTS, MPI_INT, MPI_MIN, 0, comm);
+    MPI_Reduce(phase_used, used, NUM_PHASES, MPI_INT, MPI_MAX, 0, comm);
+
+    if (rank != 0) {
+        return;
+    }
+
+    int any = 0;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) any |= available[e];
+    if (!any) {
+        printf("Profil: compteurs matériels indisponibles (perf_event_open refusé: "
+               "conteneur ou perf_event_paranoid), temps seuls\n");
+    }
+    printf("PROFILE: program,num_procs,num_threads,array_size,phase,time_max,cycles,"
+           "instructions,ipc,llc_misses_per_elem,dtlb_misses_per_elem,"
+           "branch_misses_per_elem\n");
+    for (int p = 0; p < NUM_PHASES; p++) {
+        if (!used[p]) continue;
+        const double *v = values + p * PERF_NUM_EVENTS;
+        printf("PROFILE: %s,%d,%d,%d,%s,%.6f", program, num_procs, num_threads, total_size,
+               phase_names[p], times[p]);
+        for (int e = PERF_CYCLES; e <= PERF_INSTRUCTIONS; e++) {
+            if (available[e]) printf(",%.0f", v[e]);
+            else printf(",NA");
+        }
+        if (available[PERF_CYCLES] && available[PERF_INSTRUCTIONS] && v[PERF_CYCLES] > 0) {
+            printf(",%.3f", v[PERF_INSTRUCTIONS] / v[PERF_CYCLES]);
+        } else {
+            printf(",NA");
+        }
+        for (int e = PERF_LLC_MISSES; e <= PERF_BRANCH_MISSES; e++) {
+            if (available[e] && total_size > 0) printf(",%.4f", v[e] / total_size);
+            else printf(",NA");
+        }
+        printf("\n");
+    }
+}
+
+void instr_report(const char *program, int total_size, int num_threads, MPI_Comm comm) {
+    if (instr_profiling) {
+        profile_report(program, total_size, num_threads, comm);
+    }
+    if (stats_format == STATS_NONE) {
+        return;
+    }
+
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+
+    // Mesures locales: phases puis grandeurs supplémentaires
+    const int num_values = NUM_PHASES + NUM_EXTRA;
+    double local[NUM_PHASES + NUM_EXTRA];
+    double vmin[NUM_PHASES + NUM_EXTRA];
+    double vmax[NUM_PHASES + NUM_EXTRA];
+    double vsum[NUM_PHASES + NUM_EXTRA];
+    int used[NUM_PHASES];
+
+    for (int p = 0; p < NUM_PHASES; p++) {
+        local[p] = phase_times[p];
+    }
+    local[NUM_PHASES + 0] = (double)(bucket_size < 0 ? 0 : bucket_size);
+    local[NUM_PHASES + 1] = (double)bytes_sent;
+    local[NUM_PHASES + 2] = (double)bytes_received;
+    local[NUM_PHASES + 3] = (double)peak_rss_kb();
+
+    MPI_Reduce(local, vmin, num_values, MPI_DOUBLE, MPI_MIN, 0, comm);
+    MPI_Reduce(local, vmax, num_values, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(local, vsum, num_values, MPI_DOUBLE, MPI_SUM, 0, comm);
+    MPI_Reduce(phase_used, used, NUM_PHASES, MPI_INT, MPI_MAX, 0, comm);
+
+    // Détail par processus (répartition des buckets, volumes, mémoire)
+    double *per_rank = NULL;
+    if (rank == 0 && stats_format == STATS_JSON) {
+        per_rank = (double*)malloc(num_procs * NUM_EXTRA * sizeof(double));
+    }
+    if (stats_format == STATS_JSON) {
+        MPI_Gather(local + NUM_PHASES, NUM_EXTRA, MPI_DOUBLE,
+                   per_rank, NUM_EXTRA, MPI_DOUBLE, 0, comm);
+    }
+
+    if (rank != 0) {
+        return;
+    }
+
+    if (stats_format == STATS_CSV) {
+        printf("STATS: program,num_procs,num_threads,array_size,metric,min,avg,max,imbalance\n");
+        for (int v = 0; v < num_values; v++) {
+            if (v < NUM_PHASES && !used[v]) continue;
+            double avg = vsum[v] / num_procs;
+            printf("STATS: %s,%d,%d,%d,%s%s,%.6f,%.6f,%.6f,%.3f\n",
+                   program, num_procs, num_threads, total_size,
+                   v < NUM_PHASES ? "time_" : "",
+                   v < NUM_PHASES ? phase_names[v] : extra_names[v - NUM_PHASES],
+                   vmin[v], avg, vmax[v], avg > 0 ? vmax[v] / avg : 0.0);
+        }
+    } else {
+        printf("STATS_JSON: {\"program\":\"%s\",\"num_procs\":%d,\"num_threads\":%d,"
+               "\"array_size\":%d,\"phases\":{",
+               program, num_procs, num_threads, total_size);
+        int first = 1;
+        for (int p = 0; p < NUM_PHASES; p++) {
+            if (!used[p]) continue;
+            double avg = vsum[p] / num_procs;
+            printf("%s\"%s\":{\"min\":%.6f,\"avg\":%.6f,\"max\":%.6f,\"imbalance\":%.3f}",
+                   first ? "" : ",", phase_names[p], vmin[p], avg, vmax[p],
+                   avg > 0 ? vmax[p] / avg : 0.0);
+            first = 0;
+        }
+        printf("}");
+        for (int e = 0; e < NUM_EXTRA; e++) {
+            int v = NUM_PHASES + e;
+            double avg = vsum[v] / num_procs;
+            printf(",\"%s\":{\"min\":%.0f,\"avg\":%.1f,\"max\":%.0f,\"imbalance\":%.3f}",
+                   extra_names[e], vmin[v], avg, vmax[v], avg > 0 ? vmax[v] / avg : 0.0);
+        }
+        printf(",\"per_rank\":[");
+        for (int r = 0; r < num_procs; r++) {
+            printf("%s{\"rank\":%d", r == 0 ? "" : ",", r);
+            for (int e = 0; e < NUM_EXTRA; e++) {
+                printf(",\"%s\":%.0f", extra_names[e], per_rank[r * NUM_EXTRA + e]);
+            }
+            printf("}");
+        }
+        printf("]}\n");
+        free(per_rank);
+    }
+}
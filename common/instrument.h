@@ -0,0 +1,121 @@
+/**
+ * Instrumentation par phase et par processus
+ *
+ * Chaque processus chronomètre les phases de l'algorithme (distribution,
+ * classification, échange, tri local, ...). Les mesures sont réduites en
+ * min/moyenne/max sur l'ensemble des processus et affichées en CSV ou JSON
+ * à côté de la ligne "CSV:" existante.
+ *
+ * Désactivée, l'instrumentation se limite à un test de variable globale
+ * par frontière de phase.
+ *
+ * Avec --profile, les compteurs matériels de chaque thread (perfcount.h)
+ * sont lus à chaque frontière de phase et cumulés par phase, puis sommés
+ * sur les processus: IPC et défauts (cache de dernier niveau, TLB de
+ * données, prédiction de branchement) par élément, lignes "PROFILE:". Sans
+ * compteurs disponibles (conteneur, perf_event_paranoid), seuls les temps
+ * sont affichés.
+ */
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <mpi.h>
+
+// Formats de sortie des statistiques (--stats=csv|json)
+#define STATS_NONE 0
+#define STATS_CSV  1
+#define STATS_JSON 2
+
+/**
+ * Phases instrumentées (communes aux quatre programmes)
+ */
+typedef enum {
+    PHASE_SCATTER = 0,      // Distribution des données (MPI_Scatterv)
+    PHASE_CLASSIFY,         // Calcul des buckets / regroupement local
+    PHASE_PACK,             // Remplissage des buckets et du buffer d'envoi
+    PHASE_COUNT_EXCHANGE,   // Échange des tailles (MPI_Alltoall)
+    PHASE_DATA_EXCHANGE,    // Échange des données (MPI_Alltoallv, Send/Recv)
+    PHASE_LOCAL_SORT,       // Tri local
+    PHASE_SELECT,           // Sélection locale des K plus grands
+    PHASE_MERGE,            // Fusion (top-K, occurrences)
+    PHASE_GATHER,           // Rassemblement des résultats (MPI_Gatherv)
+    PHASE_VERIFY,           // Vérification
+    NUM_PHASES
+} phase_t;
+
+extern int instr_enabled;
+extern int instr_profiling;
+
+/**
+ * Active l'instrumentation avec le format donné (STATS_NONE la désactive).
+ * Si record est non nul, les phases sont chronométrées même sans
+ * statistiques (trace chronologique, voir trace.h; mode --bench).
+ */
+void instr_init(int format, int record);
+
+/**
+ * Active le profil matériel par phase (--profile): ouvre les compteurs de
+ * chaque thread OpenMP (à appeler après le choix du nombre de threads).
+ * Retourne le nombre d'événements disponibles sur ce processus.
+ */
+int instr_profile_init(void);
+
+/**
+ * Début d'une phase profilée: horodatage et lecture des compteurs
+ */
+double instr_profile_start(void);
+
+/**
+ * Remet à zéro les compteurs du processus
+ */
+void instr_reset(void);
+
+/**
+ * Enregistre la durée d'une phase (appelée par instr_stop)
+ */
+void instr_record(phase_t phase, double t0);
+
+/**
+ * Début d'une phase: retourne l'horodatage à passer à instr_stop
+ */
+static inline double instr_start(void) {
+    if (!instr_enabled) return 0.0;
+    return instr_profiling ? instr_profile_start() : MPI_Wtime();
+}
+
+/**
+ * Fin d'une phase commencée à t0
+ */
+static inline void instr_stop(phase_t phase, double t0) {
+    if (instr_enabled) instr_record(phase, t0);
+}
+
+/**
+ * Cumule les octets envoyés et reçus par ce processus
+ */
+void instr_add_bytes(long long sent, long long received);
+
+/**
+ * Taille du bucket (ou de la partition) final de ce processus
+ */
+void instr_set_bucket_size(long long size);
+
+/**
+ * Durée cumulée d'une phase sur ce processus
+ */
+double instr_phase_time(phase_t phase);
+
+/**
+ * Nom court d'une phase (utilisé dans les sorties CSV/JSON)
+ */
+const char *instr_phase_name(phase_t phase);
+
+/**
+ * Réduit les mesures sur tous les processus et les affiche sur le
+ * processus 0 (lignes "STATS:" en CSV ou "STATS_JSON:" en JSON, et
+ * "PROFILE:" avec --profile). Opération collective.
+ */
+void instr_report(const char *program, int total_size, int num_threads, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * Noyaux de calcul du Bucket Sort et du Top-K (sans MPI)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "kernels.h"
+
+// Éléments classés d'un coup dans le comptage
+#define KERNEL_BLOCK 256
+
+void kernel_classify(const int *data, int size, int *ids, int num_buckets, double range,
+                     const int *splitters) {
+    if (splitters == NULL) {
+        // Intervalles: boucle sans branchement (vectorisable)
+        for (int i = 0; i < size; i++) {
+            int bucket_id = (int)(data[i] / range);
+            ids[i] = bucket_id >= num_buckets ? num_buckets - 1 : bucket_id;
+        }
+        return;
+    }
+    for (int i = 0; i < size; i++) {
+        ids[i] = partition_bucket(data[i], splitters, num_buckets);
+    }
+}
+
+/**
+ * Comptage séquentiel de data dans counts (classement par blocs, séparé
+ * des incréments)
+ */
+static void count_range(const int *data, int size, int *counts, int num_buckets, double range,
+                        const int *splitters) {
+    int ids[KERNEL_BLOCK];
+    for (int block = 0; block < size; block += KERNEL_BLOCK) {
+        int count = (size - block < KERNEL_BLOCK) ? size - block : KERNEL_BLOCK;
+        kernel_classify(data + block, count, ids, num_buckets, range, splitters);
+        for (int i = 0; i < count; i++) {
+            counts[ids[i]]++;
+        }
+    }
+}
+
+void kernel_count_buckets(const int *data, int size, int *bucket_counts, int num_buckets,
+                          double range, const int *splitters) {
+    memset(bucket_counts, 0, num_buckets * sizeof(int));
+    
+    #ifdef _OPENMP
+    if (omp_get_max_threads() > 1) {
+        // Un histogramme par thread pour éviter les conflits d'écriture
+        #pragma omp parallel
+        {
+            int *local_counts = (int*)calloc(num_buckets, sizeof(int));
+            int num_threads = omp_get_num_threads();
+            int tid = omp_get_thread_num();
+            int start = (int)((long long)tid * size / num_threads);
+            int end = (int)((long long)(tid + 1) * size / num_threads);
+    
+            count_range(data + start, end - start, local_counts, num_buckets, range, splitters);
+    
+            #pragma omp critical
+            {
+                for (int j = 0; j < num_buckets; j++) {
+                    bucket_counts[j] += local_counts[j];
+                }
+            }
+    
+            free(local_counts);
+        }
+        return;
+    }
+    #endif
+    count_range(data, size, bucket_counts, num_buckets, range, splitters);
+}
+
+void kernel_merge_runs(const int *a, int size_a, const int *b, int size_b, int *out) {
+    int i = 0, j = 0, k = 0;
+    while (i < size_a && j < size_b) {
+        out[k++] = (b[j] < a[i]) ? b[j++] : a[i++];
+    }
+    while (i < size_a) out[k++] = a[i++];
+    while (j < size_b) out[k++] = b[j++];
+}
+
+void kernel_sort_sections(int *arr, int size, int num_sections, kernel_sort_fn sort,
+                          const void *context, int *buffer) {
+    int *bounds = (int*)malloc((num_sections + 1) * sizeof(int));
+    for (int s = 0; s <= num_sections; s++) {
+        bounds[s] = (int)((long long)s * size / num_sections);
+    }
+    
+    // Tri local de chaque section
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int s = 0; s < num_sections; s++) {
+        sort(arr + bounds[s], bounds[s+1] - bounds[s], context);
+    }
+    
+    // Fusion des sections triées (alternance entre arr et buffer)
+    int *src = arr;
+    int *dst = buffer;
+    for (int width = 1; width < num_sections; width *= 2) {
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+        #endif
+        for (int s = 0; s < num_sections; s += 2 * width) {
+            int mid = (s + width < num_sections) ? s + width : num_sections;
+            int end = (s + 2 * width < num_sections) ? s + 2 * width : num_sections;
+            kernel_merge_runs(src + bounds[s], bounds[mid] - bounds[s],
+                              src + bounds[mid], bounds[end] - bounds[mid], dst + bounds[s]);
+        }
+        int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != arr) {
+        memcpy(arr, src, size * sizeof(int));
+    }
+    free(bounds);
+}
+
+void kernel_parallel_sort(int *arr, int size, kernel_sort_fn sort, const void *context) {
+    #ifdef _OPENMP
+    int num_sections = omp_get_max_threads();
+    
+    // Pour les grands tableaux, utiliser le tri parallèle
+    if (size > KERNEL_PARALLEL_SORT_MIN && num_sections > 1) {
+        int *buffer = (int*)malloc(size * sizeof(int));
+        kernel_sort_sections(arr, size, num_sections, sort, context, buffer);
+        free(buffer);
+        return;
+    }
+    #endif
+    sort(arr, size, context);
+}
+
+int kernel_merge_topk(const int *arr1, int size1, const int *arr2, int size2, int *result,
+                      int k) {
+    int i = 0, j = 0, r = 0;
+    while (r < k && i < size1 && j < size2) {
+        result[r++] = (arr1[i] >= arr2[j]) ? arr1[i++] : arr2[j++];
+    }
+    while (r < k && i < size1) result[r++] = arr1[i++];
+    while (r < k && j < size2) result[r++] = arr2[j++];
+    return r;
+}
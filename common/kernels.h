@@ -0,0 +1,95 @@
+/**
+ * Noyaux de calcul du Bucket Sort et du Top-K (sans MPI)
+ *
+ * Les étapes locales des programmes, isolées des communications pour être
+ * mesurées seules (microbench.c, cible make microbench) et partagées par
+ * les versions MPI et hybride:
+ * - numéro de bucket d'une valeur (intervalles ou séparateurs);
+ * - comptage des éléments par bucket (un histogramme par thread);
+ * - tri par sections (une par thread) puis fusions deux à deux;
+ * - fusion de deux listes décroissantes en gardant les K premiers.
+ * La répartition dans les buckets est dans scatter.h, les noyaux de tri
+ * séquentiels dans sort_kernels.h.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+// Taille en dessous de laquelle le tri n'est pas découpé entre threads
+#define KERNEL_PARALLEL_SORT_MIN 10000
+
+/**
+ * Noyau de tri d'une section (context: paramètres de l'appelant)
+ */
+typedef void (*kernel_sort_fn)(int *arr, int size, const void *context);
+
+/**
+ * Bucket d'une valeur: nombre de séparateurs inférieurs ou égaux
+ */
+static inline int partition_bucket(int value, const int *splitters, int num_buckets) {
+    int low = 0, high = num_buckets - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (splitters[mid] <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * Bucket d'une valeur: intervalles de largeur range (bucket
+ * (int)(valeur / range), borné à num_buckets - 1), ou séparateurs
+ * (partition_bucket) s'ils sont fournis
+ */
+static inline int kernel_bucket_of(int value, double range, const int *splitters,
+                                   int num_buckets) {
+    if (splitters != NULL) {
+        return partition_bucket(value, splitters, num_buckets);
+    }
+    int bucket_id = (int)(value / range);
+    return bucket_id >= num_buckets ? num_buckets - 1 : bucket_id;
+}
+
+/**
+ * Numéros de bucket des size valeurs de data dans ids
+ */
+void kernel_classify(const int *data, int size, int *ids, int num_buckets, double range,
+                     const int *splitters);
+
+/**
+ * Nombre d'éléments de chaque bucket dans bucket_counts (parallélisé avec
+ * OpenMP: un histogramme par thread, additionnés à la fin)
+ */
+void kernel_count_buckets(const int *data, int size, int *bucket_counts, int num_buckets,
+                          double range, const int *splitters);
+
+/**
+ * Fusionne deux séquences croissantes a et b dans out
+ */
+void kernel_merge_runs(const int *a, int size_a, const int *b, int size_b, int *out);
+
+/**
+ * Trie arr en num_sections sections (en parallèle, chacune par sort), puis
+ * fusionne deux à deux les sections voisines: log2(num_sections) tours,
+ * les fusions d'un même tour en parallèle. buffer: au moins size éléments.
+ */
+void kernel_sort_sections(int *arr, int size, int num_sections, kernel_sort_fn sort,
+                          const void *context, int *buffer);
+
+/**
+ * Tri croissant avec OpenMP: une section par thread au-delà de
+ * KERNEL_PARALLEL_SORT_MIN éléments, sinon un appel à sort
+ */
+void kernel_parallel_sort(int *arr, int size, kernel_sort_fn sort, const void *context);
+
+/**
+ * Fusionne deux tableaux décroissants en gardant les k plus grandes
+ * valeurs dans result. Retourne leur nombre (min(k, size1 + size2)).
+ */
+int kernel_merge_topk(const int *arr1, int size1, const int *arr2, int size2, int *result,
+                      int k);
+
+#endif
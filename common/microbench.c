@@ -0,0 +1,584 @@
+/**
+ * Microbenchmark des noyaux de calcul, sans MPI (cible make microbench)
+ *
+ * Chaque noyau des étapes locales est mesuré seul, hors de mpirun:
+ * - classify: numéro de bucket de chaque élément (kernel_classify);
+ * - count: effectifs des buckets (kernel_count_buckets, threads);
+ * - scatter: répartition dans les buckets (scatter_buckets), sortie vérifiée;
+ * - sort: tri par sections et fusions (kernel_parallel_sort, threads),
+ *   avec chacun des noyaux de tri séquentiels;
+ * - merge_topk: fusion de deux listes décroissantes (kernel_merge_topk).
+ * Les tailles vont de quelques Ko (cache L1) à plusieurs dizaines de Mo
+ * (mémoire principale), combinées aux nombres de buckets, de threads et
+ * aux distributions de clés. Pour chaque cas: médiane de plusieurs
+ * échantillons (chacun d'au moins --sample-ms de calcul), en ns/élément
+ * et en Go/s (débit effectif: octets lus et écrits une fois par élément),
+ * et, si le noyau les autorise, IPC et défauts par élément mesurés par les
+ * compteurs matériels de chaque thread (perfcount.h).
+ *
+ * Usage: microbench [--quick] [--max-size=n] [--threads=n] [--sample-ms=n]
+ *                   [--kernel=liste] [--dist=liste] [--csv=fichier]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "kernels.h"
+#include "scatter.h"
+#include "sort_kernels.h"
+#include "workload.h"
+#include "perfcount.h"
+
+#define MAX_VALUE 1000000
+#define DEFAULT_MAX_SIZE (1 << 24)
+#define DEFAULT_SAMPLE_MS 5
+#define NUM_SAMPLES 5
+#define MAX_THREADS 256
+
+// Noyaux mesurés (--kernel=liste)
+#define KERNEL_CLASSIFY   0
+#define KERNEL_COUNT      1
+#define KERNEL_SCATTER    2
+#define KERNEL_SORT       3
+#define KERNEL_MERGE_TOPK 4
+#define NUM_KERNELS       5
+
+static const char *kernel_names[NUM_KERNELS] = {
+    "classify", "count", "scatter", "sort", "merge_topk"
+};
+
+// Octets lus et écrits par élément (débit effectif)
+static const int kernel_bytes[NUM_KERNELS] = { 8, 4, 8, 8, 8 };
+
+// Au-delà de SCATTER_DIRECT_MAX (256), scatter passe en deux passes
+static const int bucket_counts_sweep[] = { 4, 64, 256, 1024, 16384, 65536 };
+static const int bucket_counts_quick[] = { 64, 16384 };
+static const int k_sweep[] = { 100, 10000, 1000000 };
+
+/**
+ * Options de la ligne de commande
+ */
+typedef struct {
+    int quick;              // Balayage réduit (--quick)
+    int max_size;           // Plus grande taille (--max-size=n)
+    int max_threads;        // Plus grand nombre de threads (--threads=n)
+    double sample_time;     // Durée minimale d'un échantillon en s (--sample-ms=n)
+    int kernels[NUM_KERNELS];   // Noyaux sélectionnés (--kernel=liste)
+    int dists[NUM_DISTS];       // Distributions sélectionnées (--dist=liste)
+    const char *csv_path;   // Fichier CSV des résultats (--csv=fichier)
+} options_t;
+
+/**
+ * Données d'un cas: entrée, tampons de travail et paramètres du noyau
+ */
+typedef struct {
+    int kernel;
+    int size;
+    const int *data;        // Entrée (non modifiée)
+    int *work;              // Copie triée par sort
+    int *ids;               // Numéros de bucket (classify)
+    int *out;               // Sortie (scatter, merge_topk), alignée
+    int *counts;            // Effectifs des buckets
+    int *offsets;           // Sommes préfixes des effectifs (scatter)
+    const int *splitters;   // NULL: intervalles de largeur range
+    int num_buckets;
+    double range;
+    int sort_kernel;        // SORT_* (sort)
+    const int *list1;       // Listes décroissantes (merge_topk)
+    const int *list2;
+    int list_size;
+    int k;
+} bench_case_t;
+
+/**
+ * Résultat d'un cas
+ */
+typedef struct {
+    double median;                  // Secondes par appel
+    double ns_per_element;
+    double gb_per_s;
+    long long counters[PERF_NUM_EVENTS];    // Totaux sur les appels (-1: indisponible)
+    long long calls;
+} bench_result_t;
+
+static perf_counters_t thread_counters[MAX_THREADS];
+static int num_counted_threads = 0;
+static int counters_available = 0;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Ouvre les compteurs de chacun des num_threads threads (fermant les
+ * précédents). Les threads OpenMP d'une équipe de même taille sont
+ * réutilisés d'une région parallèle à l'autre.
+ */
+static void open_counters(int num_threads) {
+    for (int t = 0; t < num_counted_threads; t++) {
+        perf_close(&thread_counters[t]);
+    }
+    num_counted_threads = num_threads;
+    int opened = 0;
+    #ifdef _OPENMP
+    #pragma omp parallel num_threads(num_threads) reduction(+:opened)
+    {
+        opened += perf_open(&thread_counters[omp_get_thread_num()]);
+    }
+    #else
+    opened = perf_open(&thread_counters[0]);
+    #endif
+    counters_available = (opened > 0);
+}
+
+/**
+ * Somme des compteurs de tous les threads
+ */
+static void read_counters(long long values[PERF_NUM_EVENTS]) {
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        values[e] = 0;
+    }
+    for (int t = 0; t < num_counted_threads; t++) {
+        long long thread_values[PERF_NUM_EVENTS];
+        perf_read(&thread_counters[t], thread_values);
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (thread_values[e] < 0 || values[e] < 0) {
+                values[e] = -1;
+            } else {
+                values[e] += thread_values[e];
+            }
+        }
+    }
+}
+
+static void sort_with_kernel(int *arr, int size, const void *context) {
+    sort_local(arr, size, *(const int*)context);
+}
+
+/**
+ * Prépare un appel (hors mesure)
+ */
+static void prepare_call(bench_case_t *c) {
+    if (c->kernel == KERNEL_SORT) {
+        memcpy(c->work, c->data, c->size * sizeof(int));
+    }
+}
+
+/**
+ * Un appel du noyau (mesuré)
+ */
+static void run_call(bench_case_t *c) {
+    switch (c->kernel) {
+        case KERNEL_CLASSIFY:
+            kernel_classify(c->data, c->size, c->ids, c->num_buckets, c->range, c->splitters);
+            break;
+        case KERNEL_COUNT:
+            kernel_count_buckets(c->data, c->size, c->counts, c->num_buckets, c->range,
+                                 c->splitters);
+            break;
+        case KERNEL_SCATTER:
+            scatter_buckets(c->data, c->size, c->out, c->offsets, c->num_buckets, c->range,
+                            c->splitters);
+            break;
+        case KERNEL_SORT:
+            kernel_parallel_sort(c->work, c->size, sort_with_kernel, &c->sort_kernel);
+            break;
+        case KERNEL_MERGE_TOPK:
+            kernel_merge_topk(c->list1, c->list_size, c->list2, c->list_size, c->out, c->k);
+            break;
+    }
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Mesure d'un cas: un appel de chauffe, puis NUM_SAMPLES échantillons
+ * d'au moins sample_time secondes de calcul; elements: éléments traités
+ * par appel
+ */
+static void measure(bench_case_t *c, long long elements, double sample_time,
+                    bench_result_t *result) {
+    prepare_call(c);
+    run_call(c);
+    
+    double samples[NUM_SAMPLES];
+    memset(result, 0, sizeof(*result));
+    for (int s = 0; s < NUM_SAMPLES; s++) {
+        double elapsed = 0.0;
+        long long calls = 0;
+        while (elapsed < sample_time || calls == 0) {
+            prepare_call(c);
+            long long before[PERF_NUM_EVENTS] = { 0 }, after[PERF_NUM_EVENTS] = { 0 };
+            if (counters_available) read_counters(before);
+            double t0 = now();
+            run_call(c);
+            elapsed += now() - t0;
+            if (counters_available) {
+                read_counters(after);
+                for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+                    if (before[e] < 0 || after[e] < 0 || result->counters[e] < 0) {
+                        result->counters[e] = -1;
+                    } else {
+                        result->counters[e] += after[e] - before[e];
+                    }
+                }
+            }
+            calls++;
+        }
+        samples[s] = elapsed / calls;
+        result->calls += calls;
+    }
+    if (!counters_available) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            result->counters[e] = -1;
+        }
+    }
+    
+    qsort(samples, NUM_SAMPLES, sizeof(double), compare_double);
+    result->median = samples[NUM_SAMPLES / 2];
+    result->ns_per_element = result->median * 1e9 / elements;
+    result->gb_per_s = (double)elements * kernel_bytes[c->kernel] / result->median / 1e9;
+}
+
+/**
+ * Compteur par élément (-1 si indisponible)
+ */
+static double per_element(const bench_result_t *result, int event, long long elements) {
+    if (result->counters[event] < 0) return -1.0;
+    return (double)result->counters[event] / (result->calls * elements);
+}
+
+/**
+ * Affiche (et écrit dans le CSV) le résultat d'un cas
+ */
+static void report(FILE *csv, const bench_case_t *c, const char *variant, int dist, int param,
+                   int num_threads, long long elements, const bench_result_t *result) {
+    double ipc = -1.0;
+    if (result->counters[PERF_CYCLES] > 0 && result->counters[PERF_INSTRUCTIONS] >= 0) {
+        ipc = (double)result->counters[PERF_INSTRUCTIONS] / result->counters[PERF_CYCLES];
+    }
+    double llc = per_element(result, PERF_LLC_MISSES, elements);
+    double dtlb = per_element(result, PERF_DTLB_MISSES, elements);
+    double branch = per_element(result, PERF_BRANCH_MISSES, elements);
+    
+    printf("%-10s %-9s %-13s %9d %7d %3d %9.3f %8.2f", kernel_names[c->kernel], variant,
+           workload_dist_name(dist), c->size, param, num_threads, result->ns_per_element,
+           result->gb_per_s);
+    if (ipc >= 0) {
+        printf(" %5.2f %9.4f %9.4f %9.4f", ipc, llc, dtlb, branch);
+    }
+    printf("\n");
+    
+    if (csv != NULL) {
+        fprintf(csv, "%s,%s,%s,%d,%d,%d,%.9f,%.4f,%.4f,%.4f,%.6f,%.6f,%.6f\n",
+                kernel_names[c->kernel], variant, workload_dist_name(dist), c->size, param,
+                num_threads, result->median, result->ns_per_element, result->gb_per_s, ipc,
+                llc, dtlb, branch);
+    }
+}
+
+/**
+ * Séparateurs réguliers de l'entrée (num_buckets - 1 valeurs)
+ */
+static int *make_splitters(const int *data, int size, int num_buckets) {
+    int *sorted = (int*)malloc(size * sizeof(int));
+    memcpy(sorted, data, size * sizeof(int));
+    sort_radix(sorted, size);
+    int *splitters = (int*)malloc(num_buckets * sizeof(int));
+    for (int b = 0; b < num_buckets - 1; b++) {
+        splitters[b] = sorted[(long long)(b + 1) * size / num_buckets];
+    }
+    free(sorted);
+    return splitters;
+}
+
+/**
+ * Vérifie la sortie de scatter: chaque élément est dans la section de son
+ * bucket, et la sortie est une permutation de l'entrée (work et ids
+ * servent de tampons). Couvre la répartition directe et celle en deux
+ * passes (num_buckets > SCATTER_DIRECT_MAX).
+ */
+static int check_scatter(const bench_case_t *c) {
+    for (int b = 0; b < c->num_buckets; b++) {
+        for (int i = c->offsets[b]; i < c->offsets[b + 1]; i++) {
+            if (kernel_bucket_of(c->out[i], c->range, c->splitters, c->num_buckets) != b) {
+                return 0;
+            }
+        }
+    }
+    memcpy(c->work, c->data, c->size * sizeof(int));
+    memcpy(c->ids, c->out, c->size * sizeof(int));
+    sort_radix(c->work, c->size);
+    sort_radix(c->ids, c->size);
+    return memcmp(c->work, c->ids, c->size * sizeof(int)) == 0;
+}
+
+/**
+ * Lit une liste de noms séparés par des virgules dans selected
+ * (parse: numéro d'un nom, -1 si inconnu). Retourne 0 si un nom est inconnu.
+ */
+static int parse_list(const char *list, int *selected, int count, int (*parse)(const char *)) {
+    char name[64];
+    memset(selected, 0, count * sizeof(int));
+    while (*list != '\0') {
+        int length = (int)strcspn(list, ",");
+        if (length >= (int)sizeof(name)) return 0;
+        memcpy(name, list, length);
+        name[length] = '\0';
+        int id = parse(name);
+        if (id < 0 || id >= count) return 0;
+        selected[id] = 1;
+        list += length;
+        if (*list == ',') list++;
+    }
+    return 1;
+}
+
+static int kernel_parse(const char *name) {
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        if (strcmp(name, kernel_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+static int parse_arguments(int argc, char *argv[], options_t *opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->max_size = DEFAULT_MAX_SIZE;
+    opts->max_threads = 1;
+    #ifdef _OPENMP
+    opts->max_threads = omp_get_max_threads();
+    #endif
+    opts->sample_time = DEFAULT_SAMPLE_MS * 1e-3;
+    for (int k = 0; k < NUM_KERNELS; k++) opts->kernels[k] = 1;
+    opts->dists[DIST_UNIFORM] = opts->dists[DIST_ZIPF] = opts->dists[DIST_SORTED] = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            opts->quick = 1;
+        } else if (strncmp(argv[i], "--max-size=", 11) == 0) {
+            opts->max_size = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            opts->max_threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--sample-ms=", 12) == 0) {
+            opts->sample_time = atof(argv[i] + 12) * 1e-3;
+        } else if (strncmp(argv[i], "--kernel=", 9) == 0) {
+            if (!parse_list(argv[i] + 9, opts->kernels, NUM_KERNELS, kernel_parse)) {
+                fprintf(stderr, "Erreur: noyau inconnu dans '%s'\n", argv[i] + 9);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--dist=", 7) == 0) {
+            if (!parse_list(argv[i] + 7, opts->dists, NUM_DISTS, workload_parse_dist)) {
+                fprintf(stderr, "Erreur: distribution inconnue dans '%s'\n", argv[i] + 7);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            opts->csv_path = argv[i] + 6;
+        } else {
+            fprintf(stderr, "Usage: %s [--quick] [--max-size=n] [--threads=n] [--sample-ms=n]\n"
+                            "          [--kernel=classify,count,scatter,sort,merge_topk]\n"
+                            "          [--dist=liste] [--csv=fichier]\n", argv[0]);
+            return 0;
+        }
+    }
+    if (opts->max_size < 1024 || opts->max_threads < 1 || opts->max_threads > MAX_THREADS ||
+        opts->sample_time <= 0) {
+        fprintf(stderr, "Erreur: paramètres invalides\n");
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    options_t opts;
+    if (!parse_arguments(argc, argv, &opts)) {
+        return 1;
+    }
+    
+    // Tailles: 4 Ko (L1) à max_size éléments (mémoire principale)
+    int sizes[16];
+    int num_sizes = 0;
+    for (long long size = 1024; size <= opts.max_size && num_sizes < 15;
+         size *= opts.quick ? 64 : 8) {
+        sizes[num_sizes++] = (int)size;
+    }
+    if (sizes[num_sizes - 1] < opts.max_size) {
+        sizes[num_sizes++] = opts.max_size;
+    }
+    const int *buckets = opts.quick ? bucket_counts_quick : bucket_counts_sweep;
+    int num_bucket_counts = opts.quick ? 2 : 6;
+    
+    // Threads: puissances de 2 jusqu'au maximum (inclus)
+    int threads[32];
+    int num_thread_counts = 0;
+    for (int t = 1; t < opts.max_threads; t *= 2) {
+        threads[num_thread_counts++] = t;
+    }
+    threads[num_thread_counts++] = opts.max_threads;
+    
+    FILE *csv = NULL;
+    if (opts.csv_path != NULL) {
+        csv = fopen(opts.csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Erreur: impossible d'écrire %s\n", opts.csv_path);
+            return 1;
+        }
+        fprintf(csv, "kernel,variant,dist,size,param,threads,median_s,ns_per_element,"
+                     "gb_per_s,ipc,llc_misses_per_element,dtlb_misses_per_element,"
+                     "branch_misses_per_element\n");
+    }
+    
+    open_counters(1);
+    printf("=== Microbenchmark des noyaux (sans MPI) ===\n");
+    printf("Threads: jusqu'à %d, échantillons: %d x %.0f ms\n", opts.max_threads, NUM_SAMPLES,
+           opts.sample_time * 1e3);
+    printf("Compteurs matériels: %s\n", counters_available ? "OUI" :
+           "NON (perf_event_open indisponible ou refusé)");
+    printf("\n%-10s %-9s %-13s %9s %7s %3s %9s %8s", "noyau", "variante", "distribution",
+           "taille", "param", "thr", "ns/élém", "Go/s");
+    if (counters_available) {
+        printf(" %5s %9s %9s %9s", "IPC", "LLC/élém", "dTLB/élém", "br/élém");
+    }
+    printf("\n");
+    
+    int max_size = sizes[num_sizes - 1];
+    int *data = (int*)malloc(max_size * sizeof(int));
+    int *work = (int*)malloc(max_size * sizeof(int));
+    int *ids = (int*)malloc(max_size * sizeof(int));
+    int *out = scatter_alloc(max_size);
+    int *list1 = (int*)malloc(max_size * sizeof(int));
+    int *list2 = (int*)malloc(max_size * sizeof(int));
+    int max_buckets = buckets[num_bucket_counts - 1];
+    int *counts = (int*)malloc(max_buckets * sizeof(int));
+    int *offsets = (int*)malloc((max_buckets + 1) * sizeof(int));
+    
+    for (int dist = 0; dist < NUM_DISTS; dist++) {
+        if (!opts.dists[dist]) continue;
+        for (int si = 0; si < num_sizes; si++) {
+            int size = sizes[si];
+            workload_generate(data, 0, size, size, MAX_VALUE, dist, WORKLOAD_DEFAULT_SEED);
+    
+            bench_case_t c;
+            memset(&c, 0, sizeof(c));
+            c.size = size;
+            c.data = data;
+            c.work = work;
+            c.ids = ids;
+            c.out = out;
+            c.counts = counts;
+            c.offsets = offsets;
+            bench_result_t result;
+    
+            // Classement, comptage et répartition: intervalles ou séparateurs
+            for (int bi = 0; bi < num_bucket_counts; bi++) {
+                c.num_buckets = buckets[bi];
+                if (c.num_buckets > size) continue;
+                c.range = (double)MAX_VALUE / c.num_buckets;
+                int *splitters = make_splitters(data, size, c.num_buckets);
+                for (int variant = 0; variant < 2; variant++) {
+                    const char *variant_name = variant ? "sample" : "range";
+                    c.splitters = variant ? splitters : NULL;
+    
+                    kernel_count_buckets(data, size, counts, c.num_buckets, c.range, c.splitters);
+                    offsets[0] = 0;
+                    for (int b = 0; b < c.num_buckets; b++) {
+                        offsets[b + 1] = offsets[b] + counts[b];
+                    }
+    
+                    for (int kernel = KERNEL_CLASSIFY; kernel <= KERNEL_SCATTER; kernel++) {
+                        if (!opts.kernels[kernel]) continue;
+                        c.kernel = kernel;
+                        // Seul le comptage est parallélisé
+                        int num_counts = (kernel == KERNEL_COUNT) ? num_thread_counts : 1;
+                        for (int ti = 0; ti < num_counts; ti++) {
+                            #ifdef _OPENMP
+                            omp_set_num_threads(threads[ti]);
+                            #endif
+                            open_counters(threads[ti]);
+                            measure(&c, size, opts.sample_time, &result);
+                            report(csv, &c, variant_name, dist, c.num_buckets, threads[ti],
+                                   size, &result);
+                        }
+                        if (kernel == KERNEL_SCATTER && !check_scatter(&c)) {
+                            fprintf(stderr, "Erreur: répartition incorrecte (%s, %s, "
+                                    "%d éléments, %d buckets)\n", variant_name,
+                                    workload_dist_name(dist), size, c.num_buckets);
+                            return 1;
+                        }
+                    }
+                }
+                free(splitters);
+            }
+            c.splitters = NULL;
+    
+            // Tri par sections avec chaque noyau séquentiel
+            if (opts.kernels[KERNEL_SORT]) {
+                c.kernel = KERNEL_SORT;
+                for (int sort_kernel = 0; sort_kernel < NUM_SORT_KERNELS; sort_kernel++) {
+                    c.sort_kernel = sort_kernel;
+                    for (int ti = 0; ti < num_thread_counts; ti++) {
+                        #ifdef _OPENMP
+                        omp_set_num_threads(threads[ti]);
+                        #endif
+                        open_counters(threads[ti]);
+                        measure(&c, size, opts.sample_time, &result);
+                        report(csv, &c, sort_kernel_name(sort_kernel), dist, 0, threads[ti],
+                               size, &result);
+                    }
+                }
+            }
+    
+            // Fusion de deux listes décroissantes de size / 2 éléments
+            if (opts.kernels[KERNEL_MERGE_TOPK]) {
+                #ifdef _OPENMP
+                omp_set_num_threads(1);
+                #endif
+                open_counters(1);
+                c.kernel = KERNEL_MERGE_TOPK;
+                c.list_size = size / 2;
+                memcpy(list1, data, c.list_size * sizeof(int));
+                memcpy(list2, data + c.list_size, c.list_size * sizeof(int));
+                sort_top_desc(list1, c.list_size, c.list_size);
+                sort_top_desc(list2, c.list_size, c.list_size);
+                c.list1 = list1;
+                c.list2 = list2;
+                for (int ki = 0; ki < 3; ki++) {
+                    c.k = (k_sweep[ki] < size) ? k_sweep[ki] : size;
+                    measure(&c, c.k, opts.sample_time, &result);
+                    report(csv, &c, "-", dist, c.k, 1, c.k, &result);
+                    if (c.k == size) break;
+                }
+            }
+        }
+    }
+    
+    if (csv != NULL) {
+        fclose(csv);
+        printf("\nRésultats écrits dans %s\n", opts.csv_path);
+    }
+    for (int t = 0; t < num_counted_threads; t++) {
+        perf_close(&thread_counters[t]);
+    }
+    free(data);
+    free(work);
+    free(ids);
+    free(out);
+    free(list1);
+    free(list2);
+    free(counts);
+    free(offsets);
+    return 0;
+}
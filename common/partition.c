@@ -0,0 +1,113 @@
+/**
+ * Partitionnement des clés entre processus
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "partition.h"
+#include "sort_kernels.h"
+
+static const char *partition_names[NUM_PARTITIONS] = { "range", "sample" };
+
+int partition_parse(const char *name) {
+    for (int p = 0; p < NUM_PARTITIONS; p++) {
+        if (strcmp(name, partition_names[p]) == 0) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+const char *partition_name(int partition) {
+    return (partition >= 0 && partition < NUM_PARTITIONS) ? partition_names[partition] : "?";
+}
+
+int *partition_select_splitters(const int *local_data, int local_size, int num_buckets,
+                                MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    
+    // Échantillon régulier local (positions équidistantes)
+    int samples = PARTITION_OVERSAMPLING * num_buckets;
+    if (samples > local_size) samples = local_size;
+    int *local_samples = (int*)malloc((samples + 1) * sizeof(int));
+    for (int i = 0; i < samples; i++) {
+        local_samples[i] = local_data[(long long)i * local_size / samples];
+    }
+    
+    int *sample_counts = (int*)malloc(num_procs * sizeof(int));
+    int *sample_displs = (int*)malloc(num_procs * sizeof(int));
+    MPI_Allgather(&samples, 1, MPI_INT, sample_counts, 1, MPI_INT, comm);
+    
+    int total_samples = 0;
+    for (int r = 0; r < num_procs; r++) {
+        sample_displs[r] = total_samples;
+        total_samples += sample_counts[r];
+    }
+    
+    int *all_samples = (int*)malloc((total_samples + 1) * sizeof(int));
+    MPI_Allgatherv(local_samples, samples, MPI_INT,
+                   all_samples, sample_counts, sample_displs, MPI_INT, comm);
+    sort_int_order(all_samples, total_samples, SORT_ASC);
+    
+    // Séparateurs aux quantiles de l'échantillon global
+    int *splitters = (int*)malloc(num_buckets * sizeof(int));
+    for (int b = 1; b < num_buckets; b++) {
+        splitters[b-1] = total_samples > 0
+                       ? all_samples[(long long)b * total_samples / num_buckets]
+                       : 0;
+    }
+    
+    free(local_samples);
+    free(sample_counts);
+    free(sample_displs);
+    free(all_samples);
+    return splitters;
+}
+
+double partition_imbalance(const int *bucket_counts, int num_buckets, MPI_Comm comm) {
+    long long *local = (long long*)calloc(num_buckets, sizeof(long long));
+    long long *global = (long long*)malloc(num_buckets * sizeof(long long));
+    for (int b = 0; b < num_buckets; b++) {
+        local[b] = bucket_counts[b];
+    }
+    MPI_Allreduce(local, global, num_buckets, MPI_LONG_LONG, MPI_SUM, comm);
+    
+    long long total = 0, largest = 0;
+    for (int b = 0; b < num_buckets; b++) {
+        total += global[b];
+        if (global[b] > largest) largest = global[b];
+    }
+    free(local);
+    free(global);
+    return total > 0 ? (double)largest * num_buckets / total : 1.0;
+}
+
+int topk_histogram_threshold(const int *local_data, int local_size, int k, int max_value,
+                             MPI_Comm comm) {
+    long long width = ((long long)max_value + TOPK_HISTOGRAM_BINS - 1) / TOPK_HISTOGRAM_BINS;
+    int *local_hist = (int*)calloc(TOPK_HISTOGRAM_BINS, sizeof(int));
+    int *hist = (int*)malloc(TOPK_HISTOGRAM_BINS * sizeof(int));
+    
+    for (int i = 0; i < local_size; i++) {
+        int bin = (int)(local_data[i] / width);
+        if (bin >= TOPK_HISTOGRAM_BINS) bin = TOPK_HISTOGRAM_BINS - 1;
+        if (bin < 0) bin = 0;
+        local_hist[bin]++;
+    }
+    MPI_Allreduce(local_hist, hist, TOPK_HISTOGRAM_BINS, MPI_INT, MPI_SUM, comm);
+    
+    // Parcours des classes depuis le haut jusqu'à cumuler k éléments
+    long long cumulative = 0;
+    int bin = TOPK_HISTOGRAM_BINS - 1;
+    for (; bin > 0; bin--) {
+        cumulative += hist[bin];
+        if (cumulative >= k) break;
+    }
+    
+    free(local_hist);
+    free(hist);
+    return (int)(bin * width);
+}
@@ -0,0 +1,65 @@
+/**
+ * Partitionnement des clés entre processus
+ *
+ * Le Bucket Sort découpe [0, max_value) en intervalles de même largeur:
+ * efficace pour des clés uniformes, mais un seul processus reçoit presque
+ * tout sur des données asymétriques (Zipf, gaussienne). Le tri par
+ * échantillonnage (sample sort) choisit à la place des séparateurs à partir
+ * d'un échantillon des données, pour des buckets de tailles voisines.
+ *
+ * Le Top-K par histogramme utilise le même principe: un histogramme global
+ * grossier donne un seuil au-dessus duquel se trouvent au moins K éléments.
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <mpi.h>
+
+#include "kernels.h"
+
+// Stratégies de partitionnement (--partition=nom)
+#define PARTITION_RANGE  0  // Intervalles de même largeur (historique)
+#define PARTITION_SAMPLE 1  // Séparateurs tirés d'un échantillon
+#define NUM_PARTITIONS   2
+
+// Échantillons par processus et par bucket (sur-échantillonnage)
+#define PARTITION_OVERSAMPLING 32
+
+// Nombre de classes de l'histogramme du Top-K
+#define TOPK_HISTOGRAM_BINS 4096
+
+/**
+ * Numéro de la stratégie à partir de son nom (-1 si inconnu)
+ */
+int partition_parse(const char *name);
+
+/**
+ * Nom de la stratégie
+ */
+const char *partition_name(int partition);
+
+/**
+ * Sélectionne num_buckets - 1 séparateurs croissants à partir d'un
+ * échantillon régulier des données de chaque processus (MPI_Allgather).
+ * Retourne un tableau alloué, identique sur tous les processus.
+ */
+int *partition_select_splitters(const int *local_data, int local_size, int num_buckets,
+                                MPI_Comm comm);
+
+/**
+ * Déséquilibre global des buckets (taille maximale / taille moyenne)
+ * à partir des comptages locaux. Opération collective.
+ */
+double partition_imbalance(const int *bucket_counts, int num_buckets, MPI_Comm comm);
+
+/**
+ * Seuil du Top-K par histogramme: plus grande borne inférieure de classe
+ * telle qu'au moins k éléments (tous processus confondus) lui sont
+ * supérieurs ou égaux. Les clés doivent appartenir à [0, max_value).
+ * Opération collective.
+ */
+int topk_histogram_threshold(const int *local_data, int local_size, int k, int max_value,
+                             MPI_Comm comm);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * Compteurs matériels (perf_event_open, Linux)
+ *
+ * Chaque thread ouvre ses propres compteurs (cycles, instructions, défauts
+ * de cache de dernier niveau et de TLB de données, erreurs de prédiction
+ * de branchement), limités à l'espace utilisateur. Les valeurs sont
+ * corrigées du multiplexage (temps actif / temps compté) quand le
+ * processeur n'a pas assez de compteurs. Hors de Linux, ou si le noyau
+ * les refuse (conteneur, perf_event_paranoid), les compteurs sont
+ * simplement indisponibles: les mesures valent -1.
+ */
+
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+// Événements mesurés
+#define PERF_CYCLES         0
+#define PERF_INSTRUCTIONS   1
+#define PERF_LLC_MISSES     2
+#define PERF_DTLB_MISSES    3
+#define PERF_BRANCH_MISSES  4
+#define PERF_NUM_EVENTS     5
+
+/**
+ * Compteurs d'un thread (-1: événement non ouvert)
+ */
+typedef struct {
+    int fds[PERF_NUM_EVENTS];
+} perf_counters_t;
+
+/**
+ * Ouvre les compteurs du thread appelant. Retourne le nombre d'événements
+ * disponibles (0 si aucun).
+ */
+int perf_open(perf_counters_t *counters);
+
+/**
+ * Valeurs courantes (depuis l'ouverture) dans values; -1 pour un événement
+ * indisponible. Peut être appelé depuis un autre thread du processus.
+ */
+void perf_read(const perf_counters_t *counters, long long values[PERF_NUM_EVENTS]);
+
+/**
+ * Ferme les compteurs
+ */
+void perf_close(perf_counters_t *counters);
+
+/**
+ * Nom court d'un événement
+ */
+const char *perf_event_name(int event);
+
+#endif
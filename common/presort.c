@@ -0,0 +1,108 @@
+/**
+ * Détection du préordre d'un tableau distribué et chemins rapides
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include <mpi.h>
+
+#include "presort.h"
+#include "trace.h"
+
+static const char *presort_names[NUM_PRESORTS] = { "random", "sorted", "reverse", "nearly-sorted" };
+
+const char *presort_name(int order) {
+    return (order >= 0 && order < NUM_PRESORTS) ? presort_names[order] : "?";
+}
+
+void presort_probe(const int *local_data, int local_size, presort_info_t *info,
+                   MPI_Comm comm) {
+    long long counts[3] = { 0, 0, local_size };
+    for (int i = 0; i + 1 < local_size; i++) {
+        counts[0] += (local_data[i] > local_data[i + 1]);
+        counts[1] += (local_data[i] < local_data[i + 1]);
+    }
+    
+    // Frontière avec les processus précédents: plus grande et plus petite
+    // dernière valeur (exactes pour des parties toutes monotones)
+    long long last[2] = { LLONG_MIN, LLONG_MIN };
+    long long previous[2] = { LLONG_MIN, LLONG_MIN };
+    if (local_size > 0) {
+        last[0] = local_data[local_size - 1];
+        last[1] = -(long long)local_data[local_size - 1];
+    }
+    TRACED("MPI_Exscan",
+           MPI_Exscan(last, previous, 2, MPI_LONG_LONG, MPI_MAX, comm));
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank > 0 && local_size > 0) {
+        if (previous[0] != LLONG_MIN && previous[0] > local_data[0]) counts[0]++;
+        if (previous[1] != LLONG_MIN && -previous[1] < local_data[0]) counts[1]++;
+    }
+    
+    long long totals[3];
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(counts, totals, 3, MPI_LONG_LONG, MPI_SUM, comm));
+    info->descents = totals[0];
+    info->ascents = totals[1];
+    info->total_size = totals[2];
+    
+    long long breaks = (info->descents < info->ascents) ? info->descents : info->ascents;
+    if (info->descents == 0) {
+        info->order = PRESORT_SORTED;
+    } else if (info->ascents == 0) {
+        info->order = PRESORT_REVERSE;
+    } else if (breaks * PRESORT_NEARLY_RUN <= info->total_size) {
+        info->order = PRESORT_NEARLY;
+    } else {
+        info->order = PRESORT_RANDOM;
+    }
+}
+
+int *presort_reverse(const int *local_data, int local_size, int *out_size, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    int partner = num_procs - 1 - rank;
+    
+    int *reversed = (int*)malloc((local_size + 1) * sizeof(int));
+    for (int i = 0; i < local_size; i++) {
+        reversed[i] = local_data[local_size - 1 - i];
+    }
+    if (partner == rank) {
+        *out_size = local_size;
+        return reversed;
+    }
+    
+    int size;
+    TRACED("MPI_Sendrecv",
+           MPI_Sendrecv(&local_size, 1, MPI_INT, partner, 0, &size, 1, MPI_INT, partner, 0,
+                        comm, MPI_STATUS_IGNORE));
+    int *received = (int*)malloc((size + 1) * sizeof(int));
+    TRACED("MPI_Sendrecv",
+           MPI_Sendrecv(reversed, local_size, MPI_INT, partner, 0, received, size, MPI_INT,
+                        partner, 0, comm, MPI_STATUS_IGNORE));
+    free(reversed);
+    *out_size = size;
+    return received;
+}
+
+int *presort_splitters(const int *sorted_local, int local_size, MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    
+    int first = (local_size > 0) ? sorted_local[0] : INT_MAX;
+    int *firsts = (int*)malloc(num_procs * sizeof(int));
+    TRACED("MPI_Allgather",
+           MPI_Allgather(&first, 1, MPI_INT, firsts, 1, MPI_INT, comm));
+    
+    int *splitters = (int*)malloc(num_procs * sizeof(int));
+    for (int r = num_procs - 2; r >= 0; r--) {
+        splitters[r] = firsts[r + 1];
+        if (r + 1 < num_procs - 1 && splitters[r] > splitters[r + 1]) {
+            splitters[r] = splitters[r + 1];
+        }
+    }
+    free(firsts);
+    return splitters;
+}
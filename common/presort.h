@@ -0,0 +1,72 @@
+/**
+ * Détection du préordre d'un tableau distribué (--presort)
+ *
+ * Les données arrivent souvent déjà presque dans l'ordre. Une lecture de la
+ * partie locale compte les paires voisines décroissantes (a[i] > a[i+1]) et
+ * croissantes; les frontières entre processus sont comparées par un
+ * MPI_Exscan (plus grande et plus petite dernière valeur des processus
+ * précédents), puis un MPI_Allreduce donne les totaux. Le coût est une
+ * lecture en O(n/p) et deux collectives de quelques entiers.
+ *
+ * Classes:
+ * - triée: aucune descente, y compris aux frontières;
+ * - inversée: aucune montée (et au moins une descente);
+ * - presque triée: séquences monotones longues en moyenne (au moins
+ *   PRESORT_NEARLY_RUN éléments), dans un sens ou dans l'autre;
+ * - quelconque sinon.
+ */
+
+#ifndef PRESORT_H
+#define PRESORT_H
+
+#include <mpi.h>
+
+// Classes de préordre
+#define PRESORT_RANDOM  0
+#define PRESORT_SORTED  1
+#define PRESORT_REVERSE 2
+#define PRESORT_NEARLY  3
+#define NUM_PRESORTS    4
+
+// Longueur moyenne minimale des séquences d'une entrée presque triée
+#define PRESORT_NEARLY_RUN 16
+
+/**
+ * Résultat de la détection (identique sur tous les processus)
+ */
+typedef struct {
+    int order;              // PRESORT_*
+    long long descents;     // Paires voisines décroissantes, frontières comprises
+    long long ascents;      // Paires voisines croissantes, frontières comprises
+    long long total_size;
+} presort_info_t;
+
+/**
+ * Nom d'une classe
+ */
+const char *presort_name(int order);
+
+/**
+ * Classe le préordre de la concaténation des parties locales, dans l'ordre
+ * des rangs. Opération collective.
+ */
+void presort_probe(const int *local_data, int local_size, presort_info_t *info,
+                   MPI_Comm comm);
+
+/**
+ * Inverse un tableau globalement décroissant: inversion locale, puis
+ * échange de la partie du processus r avec celle du processus p - 1 - r.
+ * Retourne la nouvelle partie locale (à libérer), croissante, et sa taille
+ * dans *out_size. Opération collective.
+ */
+int *presort_reverse(const int *local_data, int local_size, int *out_size, MPI_Comm comm);
+
+/**
+ * Séparateurs (au sens de partition_bucket) d'un tableau globalement trié
+ * tel qu'il est réparti: première valeur de chaque partie, une partie vide
+ * héritant du séparateur suivant. Tableau alloué de p - 1 valeurs.
+ * Opération collective.
+ */
+int *presort_splitters(const int *sorted_local, int local_size, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * Quantiles et statistiques d'ordre distribués, sans tri
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <mpi.h>
+
+#include "quantile.h"
+#include "instrument.h"
+#include "trace.h"
+
+/**
+ * Intervalle de valeurs [lo, hi] encore ambigu et éléments locaux qu'il
+ * contient
+ */
+typedef struct {
+    long long lo;
+    long long hi;
+    long long width;        // Largeur d'une classe au tour courant
+    const int *values;
+    int *buffer;            // Éléments conservés (NULL: données d'entrée)
+    int count;
+    int parent;             // Intervalle du tour précédent
+    int bin;                // Classe retenue dans l'intervalle parent
+} interval_t;
+
+long long quantile_rank(double q, long long n) {
+    long long rank = (long long)(q * n);
+    if ((double)rank < q * n) rank++;   // ceil(q n)
+    rank--;
+    if (rank < 0) rank = 0;
+    if (rank > n - 1) rank = n - 1;
+    return rank;
+}
+
+double quantile_percent(long long rank, long long n) {
+    return (n > 1) ? 100.0 * rank / (n - 1) : 0.0;
+}
+
+int quantile_parse(const char *spec, int is_rank, long long n, long long *ranks) {
+    int count = 0;
+    const char *p = spec;
+    while (*p != '\0') {
+        char *end;
+        if (count == MAX_QUANTILES) {
+            return -1;
+        }
+        if (is_rank) {
+            ranks[count] = strtoll(p, &end, 10);
+        } else {
+            double q = strtod(p, &end);
+            if (q < 0.0 || q > 1.0) {
+                return -1;
+            }
+            ranks[count] = quantile_rank(q, n);
+        }
+        if (end == p || ranks[count] < 0 || ranks[count] >= n) {
+            return -1;
+        }
+        count++;
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p = end;
+    }
+    return count > 0 ? count : -1;
+}
+
+/**
+ * Découpe [lo, hi] en au plus QUANTILE_BINS classes de même largeur
+ */
+static void set_bins(interval_t *interval) {
+    long long span = interval->hi - interval->lo + 1;
+    interval->width = (span + QUANTILE_BINS - 1) / QUANTILE_BINS;
+}
+
+int quantile_select(const int *local_data, int local_size, const long long *ranks,
+                    int num_ranks, int *values, MPI_Comm comm) {
+    if (num_ranks <= 0) {
+        return 0;
+    }
+    
+    // Intervalle initial: minimum et maximum globaux (un seul MPI_Allreduce)
+    long long local_bounds[2] = { LLONG_MIN, LLONG_MIN };
+    long long bounds[2];
+    for (int i = 0; i < local_size; i++) {
+        if (-(long long)local_data[i] > local_bounds[0]) local_bounds[0] = -(long long)local_data[i];
+        if (local_data[i] > local_bounds[1]) local_bounds[1] = local_data[i];
+    }
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(local_bounds, bounds, 2, MPI_LONG_LONG, MPI_MAX, comm));
+    
+    // Au plus une nouvelle classe par requête et par tour
+    interval_t *intervals = (interval_t*)malloc(num_ranks * sizeof(interval_t));
+    interval_t *next = (interval_t*)malloc(num_ranks * sizeof(interval_t));
+    int *owner = (int*)malloc(num_ranks * sizeof(int));
+    long long *residual = (long long*)malloc(num_ranks * sizeof(long long));
+    long long *local_hist = (long long*)malloc((size_t)num_ranks * QUANTILE_BINS * sizeof(long long));
+    long long *hist = (long long*)malloc((size_t)num_ranks * QUANTILE_BINS * sizeof(long long));
+    int *bin_target = (int*)malloc(QUANTILE_BINS * sizeof(int));
+    
+    int num_intervals = 1;
+    intervals[0].lo = -bounds[0];
+    intervals[0].hi = bounds[1];
+    intervals[0].values = local_data;
+    intervals[0].buffer = NULL;
+    intervals[0].count = local_size;
+    
+    int unresolved = 0;
+    for (int q = 0; q < num_ranks; q++) {
+        owner[q] = 0;
+        residual[q] = ranks[q];
+        if (intervals[0].lo == intervals[0].hi) {
+            values[q] = (int)intervals[0].lo;
+            owner[q] = -1;
+        } else {
+            unresolved++;
+        }
+    }
+    
+    int rounds = 0;
+    while (unresolved > 0) {
+        // Histogrammes locaux de tous les intervalles actifs
+        double t0 = instr_start();
+        size_t hist_size = (size_t)num_intervals * QUANTILE_BINS;
+        memset(local_hist, 0, hist_size * sizeof(long long));
+        for (int s = 0; s < num_intervals; s++) {
+            interval_t *interval = &intervals[s];
+            long long *bins = local_hist + (size_t)s * QUANTILE_BINS;
+            set_bins(interval);
+            for (int i = 0; i < interval->count; i++) {
+                bins[(interval->values[i] - interval->lo) / interval->width]++;
+            }
+        }
+        instr_stop(PHASE_CLASSIFY, t0);
+    
+        t0 = instr_start();
+        TRACED("MPI_Allreduce",
+               MPI_Allreduce(local_hist, hist, (int)hist_size, MPI_LONG_LONG, MPI_SUM, comm));
+        instr_stop(PHASE_COUNT_EXCHANGE, t0);
+        instr_add_bytes((long long)(hist_size * sizeof(long long)),
+                        (long long)(hist_size * sizeof(long long)));
+        rounds++;
+    
+        // Classe contenant le rang de chaque requête (décision identique sur
+        // tous les processus: l'histogramme est global)
+        t0 = instr_start();
+        int num_next = 0;
+        for (int q = 0; q < num_ranks; q++) {
+            if (owner[q] < 0) continue;
+            interval_t *interval = &intervals[owner[q]];
+            const long long *bins = hist + (size_t)owner[q] * QUANTILE_BINS;
+            int b = 0;
+            while (residual[q] >= bins[b]) {
+                residual[q] -= bins[b];
+                b++;
+            }
+            long long lo = interval->lo + b * interval->width;
+            long long hi = lo + interval->width - 1;
+            if (hi > interval->hi) hi = interval->hi;
+    
+            if (lo == hi) {
+                values[q] = (int)lo;
+                owner[q] = -1;
+                unresolved--;
+                continue;
+            }
+    
+            // Classe déjà retenue par une autre requête de ce tour?
+            int target = -1;
+            for (int s = 0; s < num_next; s++) {
+                if (next[s].parent == owner[q] && next[s].bin == b) {
+                    target = s;
+                    break;
+                }
+            }
+            if (target < 0) {
+                target = num_next++;
+                next[target].lo = lo;
+                next[target].hi = hi;
+                next[target].parent = owner[q];
+                next[target].bin = b;
+                
+                // Nombre local d'éléments de la classe (histogramme local)
+                long long local_count = local_hist[(size_t)owner[q] * QUANTILE_BINS + b];
+                next[target].buffer = (int*)malloc((local_count + 1) * sizeof(int));
+                next[target].values = next[target].buffer;
+                next[target].count = 0;
+            }
+            owner[q] = target;
+        }
+        
+        // Seuls les éléments des classes retenues passent au tour suivant:
+        // un parcours par intervalle, quel que soit le nombre de requêtes
+        for (int s = 0; s < num_intervals; s++) {
+            int has_child = 0;
+            for (int b = 0; b < QUANTILE_BINS; b++) bin_target[b] = -1;
+            for (int t = 0; t < num_next; t++) {
+                if (next[t].parent == s) {
+                    bin_target[next[t].bin] = t;
+                    has_child = 1;
+                }
+            }
+            if (!has_child) continue;
+            
+            interval_t *interval = &intervals[s];
+            for (int i = 0; i < interval->count; i++) {
+                int t = bin_target[(interval->values[i] - interval->lo) / interval->width];
+                if (t >= 0) {
+                    next[t].buffer[next[t].count++] = interval->values[i];
+                }
+            }
+        }
+        
+        for (int s = 0; s < num_intervals; s++) {
+            free(intervals[s].buffer);
+        }
+        interval_t *tmp = intervals;
+        intervals = next;
+        next = tmp;
+        num_intervals = num_next;
+        instr_stop(PHASE_SELECT, t0);
+    }
+    
+    for (int s = 0; s < num_intervals; s++) {
+        free(intervals[s].buffer);
+    }
+    free(intervals);
+    free(next);
+    free(owner);
+    free(residual);
+    free(local_hist);
+    free(hist);
+    free(bin_target);
+    return rounds;
+}
@@ -0,0 +1,55 @@
+/**
+ * Quantiles et statistiques d'ordre distribués, sans tri
+ *
+ * Le rang r (à partir de 0, dans l'ordre croissant global) de chaque requête
+ * est résolu par raffinement d'histogramme: à chaque tour, chaque intervalle
+ * de valeurs encore ambigu est découpé en QUANTILE_BINS classes, les
+ * histogrammes de tous les intervalles actifs sont sommés par un seul
+ * MPI_Allreduce, puis chaque requête ne garde que la classe qui contient son
+ * rang. Seuls les éléments de la classe retenue sont conservés pour le tour
+ * suivant: le premier tour parcourt les n/p éléments locaux, les suivants
+ * une fraction 1/QUANTILE_BINS environ. Une valeur entière sur 32 bits est
+ * résolue en au plus 4 tours, quel que soit le nombre de requêtes.
+ */
+
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <mpi.h>
+
+// Classes par intervalle et par tour (messages de QUANTILE_BINS x 8 octets)
+#define QUANTILE_BINS 1024
+
+// Nombre maximal de requêtes (--quantiles, --kth)
+#define MAX_QUANTILES 64
+
+/**
+ * Rang (à partir de 0) du quantile q d'un tableau de n éléments, au sens du
+ * rang le plus proche: ceil(q n) - 1, borné à [0, n - 1]
+ */
+long long quantile_rank(double q, long long n);
+
+/**
+ * Position du rang dans le tableau trié, en pourcentage: r / (n - 1), de
+ * 0 % (minimum) à 100 % (maximum); 0 pour un seul élément
+ */
+double quantile_percent(long long rank, long long n);
+
+/**
+ * Lit une liste "0.5,0.99,0.999" (fractions, quantile_rank) ou, si is_rank
+ * est non nul, une liste de rangs "0,1000,n-1". Les rangs sont écrits dans
+ * ranks (au plus MAX_QUANTILES). Retourne leur nombre, -1 si la liste est
+ * invalide ou hors de [0, n - 1].
+ */
+int quantile_parse(const char *spec, int is_rank, long long n, long long *ranks);
+
+/**
+ * Valeurs de rangs globaux ranks[0..num_ranks-1] du tableau distribué
+ * (local_data n'est pas modifié). Écrit les valeurs dans values sur tous
+ * les processus et retourne le nombre de tours (MPI_Allreduce) effectués.
+ * Opération collective.
+ */
+int quantile_select(const int *local_data, int local_size, const long long *ranks,
+                    int num_ranks, int *values, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Répartition des éléments dans les buckets par tampons d'une ligne de cache
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "scatter.h"
+
+// Éléments classés d'un coup avant leur répartition
+#define SCATTER_BLOCK 256
+
+int *scatter_alloc(int size) {
+    void *ptr = NULL;
+    size_t bytes = ((size_t)size + SCATTER_LINE) * sizeof(int);
+    if (posix_memalign(&ptr, SCATTER_LINE * sizeof(int), bytes) != 0) {
+        return NULL;
+    }
+    return (int*)ptr;
+}
+
+/**
+ * Copie une ligne complète du tampon vers sa destination (alignée si
+ * streaming), sans la charger dans le cache
+ */
+static inline void flush_line(int *dst, const int *line, int streaming) {
+#ifdef __SSE2__
+    if (streaming) {
+        const __m128i *src = (const __m128i*)line;
+        __m128i *out = (__m128i*)dst;
+        _mm_stream_si128(out, _mm_load_si128(src));
+        _mm_stream_si128(out + 1, _mm_load_si128(src + 1));
+        _mm_stream_si128(out + 2, _mm_load_si128(src + 2));
+        _mm_stream_si128(out + 3, _mm_load_si128(src + 3));
+        return;
+    }
+#endif
+    (void)streaming;
+    memcpy(dst, line, SCATTER_LINE * sizeof(int));
+}
+
+/**
+ * Une passe de répartition en num_slots emplacements: l'emplacement d'une
+ * valeur est bucket / divisor - base, et il commence à out[starts[slot]].
+ * Le tampon d'un emplacement suit l'alignement de sa destination (case
+ * position % SCATTER_LINE): une ligne pleine entièrement dans
+ * l'emplacement est écrite d'un bloc, les lignes partagées avec un
+ * emplacement voisin par des écritures ordinaires.
+ */
+static void scatter_pass(const int *data, int size, int *out, const int *starts, int num_slots,
+                         int divisor, int base, double range, const int *splitters,
+                         int num_buckets, int *stage, int *pos) {
+    int streaming = ((uintptr_t)out % (SCATTER_LINE * sizeof(int)) == 0);
+    memcpy(pos, starts, num_slots * sizeof(int));
+    
+    int ids[SCATTER_BLOCK];
+    for (int block = 0; block < size; block += SCATTER_BLOCK) {
+        int count = (size - block < SCATTER_BLOCK) ? size - block : SCATTER_BLOCK;
+        const int *src = data + block;
+    
+        // Classement d'un bloc (vectorisable pour les intervalles), séparé
+        // des écritures dispersées
+        if (splitters == NULL && divisor == 1) {
+            for (int i = 0; i < count; i++) {
+                int bucket_id = (int)(src[i] / range);
+                ids[i] = (bucket_id >= num_buckets ? num_buckets - 1 : bucket_id) - base;
+            }
+        } else {
+            for (int i = 0; i < count; i++) {
+                ids[i] = kernel_bucket_of(src[i], range, splitters, num_buckets) / divisor - base;
+            }
+        }
+    
+        for (int i = 0; i < count; i++) {
+            int slot = ids[i];
+            unsigned int p = (unsigned int)pos[slot]++;
+            int *line = stage + (size_t)slot * SCATTER_LINE;
+            line[p % SCATTER_LINE] = src[i];
+            if (p % SCATTER_LINE == SCATTER_LINE - 1) {
+                int line_start = (int)p - (SCATTER_LINE - 1);
+                if (line_start >= starts[slot]) {
+                    flush_line(out + line_start, line, streaming);
+                } else {
+                    // Première ligne de l'emplacement, partagée avec le précédent
+                    int from = starts[slot];
+                    memcpy(out + from, line + from % SCATTER_LINE,
+                           ((int)p + 1 - from) * sizeof(int));
+                }
+            }
+        }
+    }
+    
+    // Lignes incomplètes restant dans les tampons
+    for (int slot = 0; slot < num_slots; slot++) {
+        int p = pos[slot];
+        int from = p - p % SCATTER_LINE;
+        if (from < starts[slot]) from = starts[slot];
+        if (from < p) {
+            memcpy(out + from, stage + (size_t)slot * SCATTER_LINE + from % SCATTER_LINE,
+                   (p - from) * sizeof(int));
+        }
+    }
+#ifdef __SSE2__
+    // Les écritures non temporelles sont visibles avant l'envoi des données
+    _mm_sfence();
+#endif
+}
+
+void scatter_buckets(const int *data, int size, int *out, const int *offsets, int num_buckets,
+                     double range, const int *splitters) {
+    if (num_buckets <= SCATTER_DIRECT_MAX) {
+        int *stage = scatter_alloc(num_buckets * SCATTER_LINE);
+        int *pos = (int*)malloc(num_buckets * sizeof(int));
+        scatter_pass(data, size, out, offsets, num_buckets, 1, 0, range, splitters,
+                     num_buckets, stage, pos);
+        free(stage);
+        free(pos);
+        return;
+    }
+    
+    // Deux passes: groupes de fanout buckets consécutifs (fanout ~ sqrt(p)),
+    // rangés dans tmp aux positions finales de leurs buckets, puis buckets
+    // de chaque groupe
+    int fanout = 1;
+    while (fanout * fanout < num_buckets) fanout++;
+    int num_groups = (num_buckets + fanout - 1) / fanout;
+    
+    int *group_starts = (int*)malloc((num_groups + 1) * sizeof(int));
+    for (int g = 0; g < num_groups; g++) {
+        group_starts[g] = offsets[g * fanout];
+    }
+    group_starts[num_groups] = size;
+    
+    int *stage = scatter_alloc(fanout * SCATTER_LINE);
+    int *pos = (int*)malloc(fanout * sizeof(int));
+    int *tmp = scatter_alloc(size);
+    scatter_pass(data, size, tmp, group_starts, num_groups, fanout, 0, range, splitters,
+                 num_buckets, stage, pos);
+    
+    for (int g = 0; g < num_groups; g++) {
+        int first = g * fanout;
+        int count = (first + fanout <= num_buckets) ? fanout : num_buckets - first;
+        scatter_pass(tmp + group_starts[g], group_starts[g + 1] - group_starts[g], out,
+                     offsets + first, count, 1, first, range, splitters, num_buckets,
+                     stage, pos);
+    }
+    
+    free(group_starts);
+    free(stage);
+    free(pos);
+    free(tmp);
+}
@@ -0,0 +1,50 @@
+/**
+ * Répartition des éléments dans les buckets (étape de remplissage)
+ *
+ * Écrire chaque élément directement à la position courante de son bucket
+ * disperse les écritures sur autant de flux que de processus: au-delà de
+ * quelques dizaines de buckets, les lignes de cache, le TLB et les tampons
+ * d'écriture combinée du processeur ne suffisent plus et le remplissage
+ * ralentit avec p.
+ *
+ * Chaque bucket dispose ici d'un petit tampon d'une ligne de cache (64
+ * octets), aligné sur la ligne de destination: une ligne complète est
+ * recopiée d'un bloc, par des écritures non temporelles (SSE2) qui
+ * contournent le cache. Au-delà de SCATTER_DIRECT_MAX buckets, les tampons
+ * eux-mêmes ne tiennent plus dans le cache L1: la répartition se fait alors en
+ * deux passes de type radix (groupes de buckets consécutifs, puis buckets
+ * de chaque groupe), chacune avec au plus ~sqrt(p) tampons.
+ */
+
+#ifndef SCATTER_H
+#define SCATTER_H
+
+#include <stddef.h>
+
+#include "kernels.h"
+
+// Entiers par ligne de cache (64 octets)
+#define SCATTER_LINE 16
+
+// Nombre de buckets au-delà duquel la répartition se fait en deux passes
+// (16 x 16 buckets): 256 tampons de 64 octets (16 Ko) tiennent dans le cache
+// L1, et 256 flux d'écriture restent couverts par un TLB L1 de données
+// courant (64 entrées de 4 Ko, plus le TLB L2)
+#define SCATTER_DIRECT_MAX 256
+
+/**
+ * Alloue un tableau de size entiers aligné sur une ligne de cache (à
+ * libérer par free), condition des écritures non temporelles
+ */
+int *scatter_alloc(int size);
+
+/**
+ * Range les size éléments de data par bucket dans out: le bucket b occupe
+ * out[offsets[b]] .. out[offsets[b + 1]) (offsets: sommes préfixes des
+ * effectifs, offsets[0] = 0), dans l'ordre d'apparition. out doit provenir
+ * de scatter_alloc pour profiter des écritures non temporelles.
+ */
+void scatter_buckets(const int *data, int size, int *out, const int *offsets, int num_buckets,
+                     double range, const int *splitters);
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * Tri segmenté: répartition des segments et tri selon leur taille
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "segsort.h"
+#include "workload.h"
+#include "kernels.h"
+#include "trace.h"
+
+// Longueurs générées à la fois
+#define SEGSORT_BATCH 4096
+
+int segsort_make_offsets(int total_size, int min_length, int max_length, uint64_t seed,
+                         int **offsets) {
+    if (min_length < 1) min_length = 1;
+    if (max_length < min_length) max_length = min_length;
+    
+    // Longueurs tirées par lots (générateur à compteur: le lot b reprend la
+    // suite là où le lot b - 1 s'est arrêté)
+    int capacity = SEGSORT_BATCH;
+    int *out = (int*)malloc((capacity + 1) * sizeof(int));
+    int lengths[SEGSORT_BATCH];
+    int num_segments = 0;
+    int position = 0;
+    out[0] = 0;
+    while (position < total_size) {
+        workload_generate(lengths, num_segments, SEGSORT_BATCH, total_size,
+                          max_length - min_length + 1, DIST_UNIFORM, seed);
+        for (int j = 0; j < SEGSORT_BATCH && position < total_size; j++) {
+            int length = min_length + lengths[j];
+            if (length > total_size - position) length = total_size - position;
+            position += length;
+            if (num_segments + 1 > capacity) {
+                capacity *= 2;
+                out = (int*)realloc(out, (capacity + 1) * sizeof(int));
+            }
+            out[++num_segments] = position;
+        }
+    }
+    *offsets = out;
+    return num_segments;
+}
+
+void segsort_small(int *arr, int size) {
+    // Réseau de transposition pair-impair: size tours d'échanges entre
+    // voisins, chacun par min/max (sans branchement, vectorisable)
+    for (int round = 0; round < size; round++) {
+        for (int i = round & 1; i + 1 < size; i += 2) {
+            int a = arr[i], b = arr[i + 1];
+            arr[i] = (a < b) ? a : b;
+            arr[i + 1] = (a < b) ? b : a;
+        }
+    }
+}
+
+/**
+ * Tri d'une section d'un segment découpé: noyau de la stratégie
+ */
+static void sort_section(int *arr, int size, const void *context) {
+    strategy_sort((const strategy_t*)context, arr, size);
+}
+
+void segsort_sort(int *values, const int *offsets, int num_segments,
+                  const strategy_t *strategy, segsort_stats_t *stats) {
+    int num_threads = 1;
+    #ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    #endif
+    
+    // Un segment plus grand que la part d'un thread déséquilibrerait le
+    // partage par segments entiers
+    int total = offsets[num_segments] - offsets[0];
+    int split_min = total / num_threads;
+    if (split_min < SEGSORT_SPLIT_MIN) split_min = SEGSORT_SPLIT_MIN;
+    
+    long long small = 0, medium = 0, split = 0;
+    if (num_threads > 1) {
+        int *buffer = NULL;
+        int buffer_size = 0;
+        for (int s = 0; s < num_segments; s++) {
+            int size = offsets[s+1] - offsets[s];
+            if (size <= split_min) continue;
+            if (size > buffer_size) {
+                free(buffer);
+                buffer = (int*)malloc(size * sizeof(int));
+                buffer_size = size;
+            }
+            double trace_t0 = trace_begin();
+            kernel_sort_sections(values + offsets[s], size, num_threads, sort_section, strategy,
+                                 buffer);
+            trace_end("sort_split_segment", trace_t0);
+            split++;
+        }
+        free(buffer);
+    }
+    
+    // Petits et moyens segments: un thread par segment, par paquets
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, SEGSORT_CHUNK) reduction(+:small, medium)
+    #endif
+    for (int s = 0; s < num_segments; s++) {
+        int size = offsets[s+1] - offsets[s];
+        if (size <= SEGSORT_SMALL_MAX) {
+            segsort_small(values + offsets[s], size);
+            small++;
+        } else if (num_threads == 1 || size <= split_min) {
+            strategy_sort(strategy, values + offsets[s], size);
+            medium++;
+        }
+    }
+    
+    if (stats != NULL) {
+        stats->small += small;
+        stats->medium += medium;
+        stats->split += split;
+    }
+}
+
+int *segsort_scatter(const int *values, const int *offsets, int num_segments,
+                     segment_layout_t *layout, int root, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    memset(layout, 0, sizeof(*layout));
+    
+    // Sur root: segments de chaque processus (celui qui contient leur
+    // milieu) et longueurs à distribuer
+    int *sizes = NULL;
+    int *segment_counts = NULL;
+    int *segment_displs = NULL;
+    int *lengths = NULL;
+    if (rank == root) {
+        segment_counts = (int*)calloc(num_procs, sizeof(int));
+        segment_displs = (int*)malloc(num_procs * sizeof(int));
+        layout->counts = (int*)calloc(num_procs, sizeof(int));
+        layout->displs = (int*)malloc(num_procs * sizeof(int));
+        lengths = (int*)malloc((num_segments + 1) * sizeof(int));
+        long long total = offsets[num_segments];
+        for (int s = 0; s < num_segments; s++) {
+            lengths[s] = offsets[s+1] - offsets[s];
+            long long middle = 2LL * offsets[s] + lengths[s];
+            int r = (total > 0) ? (int)(middle * num_procs / (2 * total)) : 0;
+            if (r >= num_procs) r = num_procs - 1;
+            segment_counts[r]++;
+            layout->counts[r] += lengths[s];
+        }
+    
+        sizes = (int*)malloc(2 * num_procs * sizeof(int));
+        int first = 0;
+        for (int r = 0; r < num_procs; r++) {
+            segment_displs[r] = first;
+            layout->displs[r] = offsets[first];
+            first += segment_counts[r];
+            sizes[2 * r] = segment_counts[r];
+            sizes[2 * r + 1] = layout->counts[r];
+        }
+    }
+    
+    int local_sizes[2];
+    TRACED("MPI_Scatter",
+           MPI_Scatter(sizes, 2, MPI_INT, local_sizes, 2, MPI_INT, root, comm));
+    layout->num_segments = local_sizes[0];
+    layout->size = local_sizes[1];
+    
+    // Longueurs des segments, puis bornes locales
+    int *local_lengths = (int*)malloc((layout->num_segments + 1) * sizeof(int));
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(lengths, segment_counts, segment_displs, MPI_INT,
+                        local_lengths, layout->num_segments, MPI_INT, root, comm));
+    layout->offsets = (int*)malloc((layout->num_segments + 1) * sizeof(int));
+    layout->offsets[0] = 0;
+    for (int s = 0; s < layout->num_segments; s++) {
+        layout->offsets[s+1] = layout->offsets[s] + local_lengths[s];
+    }
+    
+    int *local_values = (int*)malloc((layout->size + 1) * sizeof(int));
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(values, layout->counts, layout->displs, MPI_INT,
+                        local_values, layout->size, MPI_INT, root, comm));
+    
+    free(sizes);
+    free(segment_counts);
+    free(segment_displs);
+    free(lengths);
+    free(local_lengths);
+    return local_values;
+}
+
+void segsort_gather(const int *local_values, const segment_layout_t *layout, int *values,
+                    int root, MPI_Comm comm) {
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv(local_values, layout->size, MPI_INT,
+                       values, layout->counts, layout->displs, MPI_INT, root, comm));
+}
+
+void segsort_layout_free(segment_layout_t *layout) {
+    free(layout->offsets);
+    free(layout->counts);
+    free(layout->displs);
+    memset(layout, 0, sizeof(*layout));
+}
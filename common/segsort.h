@@ -0,0 +1,105 @@
+/**
+ * Tri segmenté: de nombreux petits tableaux indépendants (--segments)
+ *
+ * L'entrée est un tableau de valeurs et les bornes de ses segments
+ * (offsets[s] à offsets[s+1], num_segments + 1 bornes): chaque segment est
+ * trié séparément, sans ordre entre segments. Lancer un tri par segment
+ * coûterait une distribution et une synchronisation par segment; ici:
+ * - les segments entiers sont répartis entre processus par taille cumulée
+ *   (un segment va au processus qui contient son milieu), en un
+ *   MPI_Scatterv des longueurs et un des valeurs;
+ * - les petits segments (au plus SEGSORT_SMALL_MAX éléments) sont triés par
+ *   un réseau de tri (transposition pair-impair): une suite fixe
+ *   d'échanges min/max, sans branchement ni appel de fonction, plus rapide
+ *   que l'insertion et que qsort jusqu'à quelques dizaines d'éléments;
+ * - les segments moyens sont confiés chacun à un thread (partage dynamique
+ *   par paquets de SEGSORT_CHUNK segments), avec le noyau de la stratégie;
+ * - un segment plus grand que la part d'un thread (et qu'au moins
+ *   SEGSORT_SPLIT_MIN éléments) est découpé en une section par thread,
+ *   sections triées en parallèle puis fusionnées deux à deux.
+ */
+
+#ifndef SEGSORT_H
+#define SEGSORT_H
+
+#include <stdint.h>
+#include <mpi.h>
+
+#include "tuning.h"
+
+// Taille maximale d'un petit segment (réseau de tri)
+#define SEGSORT_SMALL_MAX 64
+
+// Taille minimale d'un segment découpé entre threads
+#define SEGSORT_SPLIT_MIN 8192
+
+// Segments attribués à la fois à un thread
+#define SEGSORT_CHUNK 16
+
+// Longueurs par défaut des segments générés (--segments)
+#define SEGSORT_DEFAULT_MIN 10
+#define SEGSORT_DEFAULT_MAX 10000
+
+/**
+ * Nombre de segments traités par chaque méthode
+ */
+typedef struct {
+    long long small;    // Réseau de tri
+    long long medium;   // Un thread par segment
+    long long split;    // Découpés entre threads
+} segsort_stats_t;
+
+/**
+ * Segments d'un processus et répartition globale (counts et displs, en
+ * éléments, ne sont remplis que sur le processus racine)
+ */
+typedef struct {
+    int num_segments;   // Segments locaux
+    int size;           // Éléments locaux
+    int *offsets;       // Bornes locales (num_segments + 1, offsets[0] = 0)
+    int *counts;        // Éléments par processus (racine)
+    int *displs;        // Position de la partie de chaque processus (racine)
+} segment_layout_t;
+
+/**
+ * Bornes de segments de longueurs uniformes dans [min_length, max_length]
+ * (le dernier est tronqué) couvrant total_size éléments. Retourne le nombre
+ * de segments; *offsets (à libérer) en contient un de plus.
+ */
+int segsort_make_offsets(int total_size, int min_length, int max_length, uint64_t seed,
+                         int **offsets);
+
+/**
+ * Tri croissant par réseau de transposition pair-impair (petits tableaux,
+ * O(size^2) échanges min/max)
+ */
+void segsort_small(int *arr, int size);
+
+/**
+ * Trie chaque segment de values (bornes offsets) selon sa taille; les
+ * nombres de segments par méthode sont ajoutés à *stats si non NULL
+ */
+void segsort_sort(int *values, const int *offsets, int num_segments,
+                  const strategy_t *strategy, segsort_stats_t *stats);
+
+/**
+ * Distribue les segments entiers du processus root (values, offsets,
+ * num_segments) par taille cumulée. Retourne les valeurs locales (à
+ * libérer) et remplit *layout. Opération collective.
+ */
+int *segsort_scatter(const int *values, const int *offsets, int num_segments,
+                     segment_layout_t *layout, int root, MPI_Comm comm);
+
+/**
+ * Rassemble les parties locales dans values sur root, dans la disposition
+ * d'origine. Opération collective.
+ */
+void segsort_gather(const int *local_values, const segment_layout_t *layout, int *values,
+                    int root, MPI_Comm comm);
+
+/**
+ * Libère une répartition
+ */
+void segsort_layout_free(segment_layout_t *layout);
+
+#endif
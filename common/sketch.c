@@ -0,0 +1,161 @@
+/**
+ * Résumés approchés fusionnables: histogrammes log-linéaires
+ */
+
+#include <stdlib.h>
+#include <mpi.h>
+
+#include "sketch.h"
+#include "trace.h"
+
+void sketch_init(sketch_t *sketch, int bits) {
+    sketch->bits = bits;
+    sketch->side_bins = (33 - bits) << bits;
+    sketch->num_bins = 2 * sketch->side_bins;
+    sketch->counts = (int*)calloc(sketch->num_bins, sizeof(int));
+}
+
+void sketch_free(sketch_t *sketch) {
+    free(sketch->counts);
+    sketch->counts = NULL;
+}
+
+/**
+ * Classe d'une magnitude u (0 <= u <= 2^31): exacte sous 2^bits, puis
+ * 2^bits classes par puissance de deux
+ */
+static inline int magnitude_bin(unsigned int u, int bits) {
+    if (u < (1u << bits)) {
+        return (int)u;
+    }
+    int e = 31 - __builtin_clz(u);
+    int shift = e - bits;
+    return ((shift + 1) << bits) + (int)((u >> shift) - (1u << bits));
+}
+
+/**
+ * Bornes de magnitude de la classe j (inverse de magnitude_bin)
+ */
+static void magnitude_bounds(int j, int bits, long long *lo, long long *hi) {
+    int block = j >> bits;
+    long long m = j & ((1 << bits) - 1);
+    if (block == 0) {
+        *lo = *hi = m;
+        return;
+    }
+    int shift = block - 1;
+    *lo = ((1LL << bits) + m) << shift;
+    *hi = *lo + (1LL << shift) - 1;
+}
+
+void sketch_add(sketch_t *sketch, const int *values, int count) {
+    int *counts = sketch->counts;
+    int bits = sketch->bits;
+    int side = sketch->side_bins;
+    for (int i = 0; i < count; i++) {
+        int v = values[i];
+        if (v >= 0) {
+            counts[side + magnitude_bin((unsigned int)v, bits)]++;
+        } else {
+            // -v en non signé: correct aussi pour INT_MIN (2^31)
+            counts[side - 1 - magnitude_bin(0u - (unsigned int)v, bits)]++;
+        }
+    }
+}
+
+void sketch_allreduce(sketch_t *sketch, MPI_Comm comm) {
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(MPI_IN_PLACE, sketch->counts, sketch->num_bins, MPI_INT, MPI_SUM, comm));
+}
+
+long long sketch_bytes(const sketch_t *sketch) {
+    return (long long)sketch->num_bins * sizeof(int);
+}
+
+void sketch_bin_bounds(const sketch_t *sketch, int bin, long long *lo, long long *hi) {
+    if (bin >= sketch->side_bins) {
+        magnitude_bounds(bin - sketch->side_bins, sketch->bits, lo, hi);
+    } else {
+        long long mlo, mhi;
+        magnitude_bounds(sketch->side_bins - 1 - bin, sketch->bits, &mlo, &mhi);
+        *lo = -mhi;
+        *hi = -mlo;
+    }
+}
+
+int sketch_rank_bin(const sketch_t *sketch, long long rank, long long *below) {
+    long long cumulative = 0;
+    int bin = 0;
+    for (; bin < sketch->num_bins - 1; bin++) {
+        if (cumulative + sketch->counts[bin] > rank) break;
+        cumulative += sketch->counts[bin];
+    }
+    *below = cumulative;
+    return bin;
+}
+
+int sketch_top_bin(const sketch_t *sketch, long long k, long long *above) {
+    long long cumulative = 0;
+    int bin = sketch->num_bins - 1;
+    for (; bin > 0; bin--) {
+        if (cumulative + sketch->counts[bin] >= k) break;
+        cumulative += sketch->counts[bin];
+    }
+    *above = cumulative;
+    return bin;
+}
+
+void top_sketch_init(top_sketch_t *sketch, long long bottom, long long top, int bits) {
+    sketch->bottom = bottom;
+    sketch->top = top;
+    sketch->bits = bits;
+    sketch->num_bins = magnitude_bin((unsigned int)(top - bottom), bits) + 1;
+    sketch->counts = (int*)calloc(sketch->num_bins, sizeof(int));
+}
+
+void top_sketch_free(top_sketch_t *sketch) {
+    free(sketch->counts);
+    sketch->counts = NULL;
+}
+
+void top_sketch_add(top_sketch_t *sketch, const int *values, int count) {
+    int *counts = sketch->counts;
+    int bits = sketch->bits;
+    long long top = sketch->top;
+    long long span = top - sketch->bottom;
+    for (int i = 0; i < count; i++) {
+        long long distance = top - values[i];
+        if (distance < 0) distance = 0;
+        if (distance > span) distance = span;
+        counts[magnitude_bin((unsigned int)distance, bits)]++;
+    }
+}
+
+void top_sketch_allreduce(top_sketch_t *sketch, MPI_Comm comm) {
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(MPI_IN_PLACE, sketch->counts, sketch->num_bins, MPI_INT, MPI_SUM, comm));
+}
+
+long long top_sketch_bytes(const top_sketch_t *sketch) {
+    return (long long)sketch->num_bins * sizeof(int);
+}
+
+void top_sketch_bin_bounds(const top_sketch_t *sketch, int bin, long long *lo, long long *hi) {
+    long long dlo, dhi;
+    magnitude_bounds(bin, sketch->bits, &dlo, &dhi);
+    *hi = sketch->top - dlo;
+    *lo = sketch->top - dhi;
+    // Dernière classe: limitée au domaine
+    if (*lo < sketch->bottom) *lo = sketch->bottom;
+}
+
+int top_sketch_top_bin(const top_sketch_t *sketch, long long k, long long *above) {
+    long long cumulative = 0;
+    int bin = 0;
+    for (; bin < sketch->num_bins - 1; bin++) {
+        if (cumulative + sketch->counts[bin] >= k) break;
+        cumulative += sketch->counts[bin];
+    }
+    *above = cumulative;
+    return bin;
+}
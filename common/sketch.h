@@ -0,0 +1,130 @@
+/**
+ * Résumé approché fusionnable (--approx)
+ *
+ * Histogramme log-linéaire de taille fixe sur tout l'intervalle des entiers
+ * 32 bits (signés): les valeurs de magnitude inférieure à 2^bits ont chacune
+ * leur classe, puis chaque puissance de deux est découpée en 2^bits classes.
+ * Une classe [lo, hi] a donc une largeur relative d'au plus 2^-bits, quelle
+ * que soit l'étendue des données, sans la connaître à l'avance.
+ *
+ * Les résumés des processus se fusionnent par une somme: un seul
+ * MPI_Allreduce de (33 - bits) x 2^(bits + 1) compteurs, indépendant de n,
+ * de p et de K. bits règle le compromis précision / taille du message.
+ *
+ * Histogramme des distances au sommet (top_sketch_t, Top-K approché): le
+ * même découpage log-linéaire, appliqué à top - v pour un domaine
+ * [bottom, top] connu à l'avance. Les plus grandes valeurs, proches de top,
+ * tombent dans les classes les plus fines (largeur 1 sous 2^bits), et le
+ * résumé ne couvre que le domaine: (log2(top - bottom) - bits + 1) x 2^bits
+ * compteurs environ, 144 pour un domaine de 10^6 valeurs à 3 bits.
+ */
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <mpi.h>
+
+#define SKETCH_DEFAULT_BITS 6
+#define SKETCH_MAX_BITS 12
+#define TOP_SKETCH_DEFAULT_BITS 3
+#define TOP_SKETCH_MAX_BITS 8
+
+typedef struct {
+    int bits;
+    int side_bins;          // Classes par signe: (33 - bits) << bits
+    int num_bins;           // Classes négatives puis positives, ordre croissant
+    int *counts;
+} sketch_t;
+
+/**
+ * Prépare un résumé vide de précision 2^-bits (0 <= bits <= SKETCH_MAX_BITS)
+ */
+void sketch_init(sketch_t *sketch, int bits);
+
+/**
+ * Libère le résumé
+ */
+void sketch_free(sketch_t *sketch);
+
+/**
+ * Ajoute des valeurs au résumé local
+ */
+void sketch_add(sketch_t *sketch, const int *values, int count);
+
+/**
+ * Fusionne les résumés de tous les processus (un MPI_Allreduce en place).
+ * Opération collective.
+ */
+void sketch_allreduce(sketch_t *sketch, MPI_Comm comm);
+
+/**
+ * Taille du message de fusion en octets
+ */
+long long sketch_bytes(const sketch_t *sketch);
+
+/**
+ * Bornes [lo, hi] des valeurs de la classe bin
+ */
+void sketch_bin_bounds(const sketch_t *sketch, int bin, long long *lo, long long *hi);
+
+/**
+ * Classe contenant l'élément de rang rank (à partir de 0, ordre croissant);
+ * *below reçoit le nombre d'éléments des classes inférieures
+ */
+int sketch_rank_bin(const sketch_t *sketch, long long rank, long long *below);
+
+/**
+ * Classe contenant le k-ième plus grand élément (k >= 1); *above reçoit le
+ * nombre d'éléments des classes supérieures
+ */
+int sketch_top_bin(const sketch_t *sketch, long long k, long long *above);
+
+typedef struct {
+    long long bottom;       // Domaine des valeurs [bottom, top]
+    long long top;
+    int bits;
+    int num_bins;           // Classes des distances 0 .. top - bottom
+    int *counts;            // Classe 0: valeurs les plus proches de top
+} top_sketch_t;
+
+/**
+ * Prépare un histogramme vide des distances à top, de précision 2^-bits
+ * (0 <= bits <= TOP_SKETCH_MAX_BITS), pour des valeurs de [bottom, top]
+ * (top - bottom < 2^31)
+ */
+void top_sketch_init(top_sketch_t *sketch, long long bottom, long long top, int bits);
+
+/**
+ * Libère l'histogramme
+ */
+void top_sketch_free(top_sketch_t *sketch);
+
+/**
+ * Ajoute des valeurs à l'histogramme local; celles hors du domaine sont
+ * comptées dans la classe de la borne la plus proche
+ */
+void top_sketch_add(top_sketch_t *sketch, const int *values, int count);
+
+/**
+ * Fusionne les histogrammes de tous les processus (un MPI_Allreduce en
+ * place). Opération collective.
+ */
+void top_sketch_allreduce(top_sketch_t *sketch, MPI_Comm comm);
+
+/**
+ * Taille du message de fusion en octets
+ */
+long long top_sketch_bytes(const top_sketch_t *sketch);
+
+/**
+ * Bornes [lo, hi] des valeurs de la classe bin
+ */
+void top_sketch_bin_bounds(const top_sketch_t *sketch, int bin, long long *lo, long long *hi);
+
+/**
+ * Classe contenant le k-ième plus grand élément (k >= 1); *above reçoit le
+ * nombre d'éléments des classes supérieures (plus proches de top)
+ */
+int top_sketch_top_bin(const top_sketch_t *sketch, long long k, long long *above);
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * Noyaux de tri local (sans MPI)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sort_kernels.h"
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES 4
+
+// Longueur minimale d'une séquence du tri fusion naturel (complétée par
+// insertion)
+#define NATURAL_MIN_RUN 32
+
+static inline int int_before_asc(const int *a, const int *b) {
+    return *a < *b;
+}
+
+static inline int int_before_desc(const int *a, const int *b) {
+    return *a > *b;
+}
+
+SORT_DEFINE_KERNELS(int_asc, int, int_before_asc)
+SORT_DEFINE_KERNELS(int_desc, int, int_before_desc)
+
+static const char *kernel_names[NUM_SORT_KERNELS] = { "qsort", "radix", "counting", "natural" };
+
+int sort_kernel_parse(const char *name) {
+    for (int k = 0; k < NUM_SORT_KERNELS; k++) {
+        if (strcmp(name, kernel_names[k]) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+const char *sort_kernel_name(int kernel) {
+    return (kernel >= 0 && kernel < NUM_SORT_KERNELS) ? kernel_names[kernel] : "?";
+}
+
+void sort_int_order(int *arr, int size, int order) {
+    if (order == SORT_DESC) {
+        int_desc_sort(arr, size);
+    } else {
+        int_asc_sort(arr, size);
+    }
+}
+
+void sort_radix(int *arr, int size) {
+    if (size < 2) {
+        return;
+    }
+    
+    // Inversion du bit de signe: l'ordre des entiers non signés devient
+    // celui des entiers signés
+    unsigned int *keys = (unsigned int*)arr;
+    unsigned int *buffer = (unsigned int*)malloc(size * sizeof(unsigned int));
+    int counts[RADIX_PASSES][RADIX_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+    
+    // Histogrammes des quatre octets en une seule lecture
+    for (int i = 0; i < size; i++) {
+        unsigned int key = keys[i] ^ 0x80000000u;
+        keys[i] = key;
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+    
+    unsigned int *src = keys;
+    unsigned int *dst = buffer;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        int shift = pass * RADIX_BITS;
+        
+        // Octet identique pour toutes les clés: passe inutile
+        if (counts[pass][(src[0] >> shift) & (RADIX_BUCKETS - 1)] == size) {
+            continue;
+        }
+        
+        int offsets[RADIX_BUCKETS];
+        int sum = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            offsets[b] = sum;
+            sum += counts[pass][b];
+        }
+        for (int i = 0; i < size; i++) {
+            dst[offsets[(src[i] >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+        
+        unsigned int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    
+    if (src != keys) {
+        memcpy(keys, src, size * sizeof(unsigned int));
+    }
+    for (int i = 0; i < size; i++) {
+        keys[i] ^= 0x80000000u;
+    }
+    free(buffer);
+}
+
+void sort_counting(int *arr, int size, int min_value, int max_value) {
+    if (size < 2) {
+        return;
+    }
+    
+    long long span = (long long)max_value - min_value + 1;
+    int *counts = (int*)calloc(span, sizeof(int));
+    for (int i = 0; i < size; i++) {
+        counts[arr[i] - min_value]++;
+    }
+    
+    int pos = 0;
+    for (long long v = 0; v < span; v++) {
+        for (int c = counts[v]; c > 0; c--) {
+            arr[pos++] = (int)(v + min_value);
+        }
+    }
+    free(counts);
+}
+
+static inline void swap_int(int *a, int *b) {
+    int tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/**
+ * Fin de la séquence ordonnée commençant en start (croissante au sens
+ * large, ou strictement décroissante puis inversée), prolongée par
+ * insertion jusqu'à NATURAL_MIN_RUN éléments
+ */
+static int natural_run_end(int *arr, int start, int size) {
+    int end = start + 1;
+    if (end < size && arr[end] < arr[start]) {
+        while (end < size && arr[end] < arr[end - 1]) end++;
+        for (int i = start, j = end - 1; i < j; i++, j--) {
+            swap_int(&arr[i], &arr[j]);
+        }
+    } else {
+        while (end < size && arr[end] >= arr[end - 1]) end++;
+    }
+    
+    int limit = (size - start < NATURAL_MIN_RUN) ? size : start + NATURAL_MIN_RUN;
+    for (; end < limit; end++) {
+        int value = arr[end];
+        int j = end - 1;
+        while (j >= start && arr[j] > value) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = value;
+    }
+    return end;
+}
+
+void sort_natural(int *arr, int size) {
+    if (size < 2) {
+        return;
+    }
+    
+    // Bornes des séquences: runs[r] .. runs[r + 1]
+    int capacity = size / NATURAL_MIN_RUN + 2;
+    int *runs = (int*)malloc((capacity + 1) * sizeof(int));
+    int num_runs = 0;
+    runs[0] = 0;
+    for (int start = 0; start < size; ) {
+        start = natural_run_end(arr, start, size);
+        runs[++num_runs] = start;
+    }
+    if (num_runs == 1) {
+        free(runs);
+        return;
+    }
+    
+    // Fusions des séquences voisines deux à deux, en alternant les tampons
+    int *buffer = (int*)malloc(size * sizeof(int));
+    int *src = arr;
+    int *dst = buffer;
+    while (num_runs > 1) {
+        int merged = 0;
+        for (int r = 0; r < num_runs; r += 2) {
+            int lo = runs[r];
+            int mid = runs[r + 1];
+            int hi = (r + 2 <= num_runs) ? runs[r + 2] : mid;
+            if (r + 1 == num_runs || src[mid - 1] <= src[mid]) {
+                // Séquence isolée, ou déjà dans l'ordre: simple copie
+                memcpy(dst + lo, src + lo, (hi - lo) * sizeof(int));
+            } else {
+                int i = lo, j = mid, k = lo;
+                while (i < mid && j < hi) {
+                    dst[k++] = (src[j] < src[i]) ? src[j++] : src[i++];
+                }
+                memcpy(dst + k, src + i, (mid - i) * sizeof(int));
+                k += mid - i;
+                memcpy(dst + k, src + j, (hi - j) * sizeof(int));
+            }
+            runs[merged++] = lo;
+        }
+        runs[merged] = size;
+        num_runs = merged;
+        
+        int *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != arr) {
+        memcpy(arr, src, size * sizeof(int));
+    }
+    free(buffer);
+    free(runs);
+}
+
+int sort_select_desc(int *arr, int size, int target) {
+    int lo = 0, hi = size - 1;
+    while (lo < hi) {
+        // Pivot médian de trois
+        int a = arr[lo], b = arr[lo + (hi - lo) / 2], c = arr[hi];
+        int pivot = (a < b) ? ((b < c) ? b : (a < c ? c : a))
+                            : ((a < c) ? a : (b < c ? c : b));
+        
+        // [lo, lt) > pivot, [lt, gt] == pivot, (gt, hi] < pivot
+        int lt = lo, i = lo, gt = hi;
+        while (i <= gt) {
+            if (arr[i] > pivot) {
+                swap_int(&arr[lt++], &arr[i++]);
+            } else if (arr[i] < pivot) {
+                swap_int(&arr[i], &arr[gt--]);
+            } else {
+                i++;
+            }
+        }
+        
+        if (target < lt) {
+            hi = lt - 1;
+        } else if (target > gt) {
+            lo = gt + 1;
+        } else {
+            return pivot;
+        }
+    }
+    return arr[lo];
+}
+
+int sort_top_desc(int *arr, int size, int k) {
+    int take = (k < size) ? k : size;
+    if (take <= 0) {
+        return 0;
+    }
+    sort_select_desc(arr, size, take - 1);
+    
+    // Les take premiers sont les plus grands: tri par base puis inversion
+    sort_radix(arr, take);
+    for (int i = 0, j = take - 1; i < j; i++, j--) {
+        swap_int(&arr[i], &arr[j]);
+    }
+    return take;
+}
+
+void sort_local(int *arr, int size, int kernel) {
+    if (kernel == SORT_RADIX) {
+        sort_radix(arr, size);
+    } else if (kernel == SORT_COUNTING && size > 0) {
+        int min_value = arr[0], max_value = arr[0];
+        for (int i = 1; i < size; i++) {
+            if (arr[i] < min_value) min_value = arr[i];
+            if (arr[i] > max_value) max_value = arr[i];
+        }
+        sort_counting(arr, size, min_value, max_value);
+    } else if (kernel == SORT_NATURAL) {
+        sort_natural(arr, size);
+    } else {
+        int_asc_sort(arr, size);
+    }
+}
@@ -0,0 +1,201 @@
+/**
+ * Noyaux de tri local (sans MPI)
+ *
+ * Trois algorithmes pour l'étape de tri local du Bucket Sort, choisis selon
+ * la taille du bucket et l'étendue de ses valeurs (voir tuning.h):
+ * - qsort: tri par comparaisons, O(n log n) (introsort spécialisé, voir
+ *   SORT_DEFINE_KERNELS; le nom est celui de l'ancien appel à qsort);
+ * - tri par base LSD sur 4 octets (O(n), passes inutiles sautées);
+ * - tri par comptage sur [min, max] (O(n + étendue)).
+ * Un quatrième, le tri fusion naturel, tire parti des séquences déjà
+ * ordonnées (O(n log r) pour r séquences): il est choisi quand l'entrée est
+ * détectée presque triée (presort.h).
+ */
+
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+// Algorithmes de tri local (--local-sort=nom)
+#define SORT_QSORT     0
+#define SORT_RADIX     1
+#define SORT_COUNTING  2
+#define SORT_NATURAL   3
+#define NUM_SORT_KERNELS 4
+
+// Ordre du tri (--order=asc|desc)
+#define SORT_ASC  0
+#define SORT_DESC 1
+
+// Taille des segments triés par insertion dans l'introsort
+#define SORT_INSERTION_MAX 16
+
+/**
+ * Génère les noyaux de tri d'éléments de type type ordonnés par
+ * before(a, b) (a strictement avant b; fonction static inline sur des
+ * const type *). La comparaison est développée en ligne dans chaque noyau,
+ * sans pointeur de fonction: une instanciation par type et par ordre.
+ * - name##_sort: introsort (quicksort à médiane de trois et partition de
+ *   Hoare, tri par tas au-delà de 2 log2(n) niveaux, insertion sous
+ *   SORT_INSERTION_MAX éléments), non stable;
+ * - name##_is_sorted: aucun élément avant son prédécesseur;
+ * - name##_upper_bound: nombre d'éléments d'un tableau trié qui ne sont
+ *   pas après x (numéro de bucket pour des séparateurs).
+ */
+#define SORT_DEFINE_KERNELS(name, type, before)                                     \
+static inline void name##_insertion(type *arr, int size) {                          \
+    for (int i = 1; i < size; i++) {                                                \
+        type x = arr[i];                                                            \
+        int j = i - 1;                                                              \
+        while (j >= 0 && before(&x, &arr[j])) {                                     \
+            arr[j + 1] = arr[j];                                                    \
+            j--;                                                                    \
+        }                                                                           \
+        arr[j + 1] = x;                                                             \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static inline void name##_sift_down(type *arr, int root, int size) {                \
+    type x = arr[root];                                                             \
+    int child;                                                                      \
+    while ((child = 2 * root + 1) < size) {                                         \
+        if (child + 1 < size && before(&arr[child], &arr[child + 1])) child++;      \
+        if (!before(&x, &arr[child])) break;                                        \
+        arr[root] = arr[child];                                                     \
+        root = child;                                                               \
+    }                                                                               \
+    arr[root] = x;                                                                  \
+}                                                                                   \
+                                                                                    \
+static inline void name##_heapsort(type *arr, int size) {                           \
+    for (int i = size / 2 - 1; i >= 0; i--) {                                       \
+        name##_sift_down(arr, i, size);                                             \
+    }                                                                               \
+    for (int end = size - 1; end > 0; end--) {                                      \
+        type top = arr[0];                                                          \
+        arr[0] = arr[end];                                                          \
+        arr[end] = top;                                                             \
+        name##_sift_down(arr, 0, end);                                              \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static inline void name##_order3(type *a, type *b) {                                \
+    if (before(b, a)) {                                                             \
+        type t = *a;                                                                \
+        *a = *b;                                                                    \
+        *b = t;                                                                     \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static inline void name##_introsort(type *arr, int size, int depth) {               \
+    while (size > SORT_INSERTION_MAX) {                                             \
+        if (depth-- == 0) {                                                         \
+            name##_heapsort(arr, size);                                             \
+            return;                                                                 \
+        }                                                                           \
+        int mid = size / 2;                                                         \
+        name##_order3(&arr[0], &arr[mid]);                                          \
+        name##_order3(&arr[mid], &arr[size - 1]);                                   \
+        name##_order3(&arr[0], &arr[mid]);                                          \
+        type pivot = arr[mid];                                                      \
+        int i = -1, j = size;                                                       \
+        for (;;) {                                                                  \
+            do i++; while (before(&arr[i], &pivot));                                \
+            do j--; while (before(&pivot, &arr[j]));                                \
+            if (i >= j) break;                                                      \
+            type t = arr[i];                                                        \
+            arr[i] = arr[j];                                                        \
+            arr[j] = t;                                                             \
+        }                                                                           \
+        /* Récursion sur la plus petite partie [0, j] ou [j + 1, size) */           \
+        if (j + 1 < size - j - 1) {                                                 \
+            name##_introsort(arr, j + 1, depth);                                    \
+            arr += j + 1;                                                           \
+            size -= j + 1;                                                          \
+        } else {                                                                    \
+            name##_introsort(arr + j + 1, size - j - 1, depth);                     \
+            size = j + 1;                                                           \
+        }                                                                           \
+    }                                                                               \
+    name##_insertion(arr, size);                                                    \
+}                                                                                   \
+                                                                                    \
+static inline void name##_sort(type *arr, int size) {                               \
+    int depth = 0;                                                                  \
+    for (int n = size; n > 1; n >>= 1) depth += 2;                                  \
+    name##_introsort(arr, size, depth);                                             \
+}                                                                                   \
+                                                                                    \
+static inline int name##_is_sorted(const type *arr, int size) {                     \
+    for (int i = 1; i < size; i++) {                                                \
+        if (before(&arr[i], &arr[i - 1])) return 0;                                 \
+    }                                                                               \
+    return 1;                                                                       \
+}                                                                                   \
+                                                                                    \
+static inline int name##_upper_bound(const type *x, const type *sorted, int size) { \
+    int low = 0, high = size;                                                       \
+    while (low < high) {                                                            \
+        int mid = (low + high) / 2;                                                 \
+        if (before(x, &sorted[mid])) {                                              \
+            high = mid;                                                             \
+        } else {                                                                    \
+            low = mid + 1;                                                          \
+        }                                                                           \
+    }                                                                               \
+    return low;                                                                     \
+}
+
+/**
+ * Numéro du noyau à partir de son nom (-1 si inconnu)
+ */
+int sort_kernel_parse(const char *name);
+
+/**
+ * Nom du noyau
+ */
+const char *sort_kernel_name(int kernel);
+
+/**
+ * Tri par comparaisons dans l'ordre order (SORT_ASC ou SORT_DESC): noyau
+ * introsort instancié pour chaque ordre
+ */
+void sort_int_order(int *arr, int size, int order);
+
+/**
+ * Tri croissant par base (octet par octet, clés signées acceptées)
+ */
+void sort_radix(int *arr, int size);
+
+/**
+ * Tri croissant par comptage des valeurs de [min_value, max_value]
+ */
+void sort_counting(int *arr, int size, int min_value, int max_value);
+
+/**
+ * Tri fusion naturel: découpage en séquences croissantes (les séquences
+ * strictement décroissantes sont inversées, les séquences courtes
+ * prolongées par insertion), puis fusions deux à deux des séquences
+ * voisines. O(n) sur une entrée triée ou inversée.
+ */
+void sort_natural(int *arr, int size);
+
+/**
+ * target-ième plus grande valeur (à partir de 0) par sélection rapide avec
+ * partition en trois, efficace avec de nombreux doublons. arr est réordonné:
+ * ses target + 1 premiers éléments sont les plus grands.
+ */
+int sort_select_desc(int *arr, int size, int target);
+
+/**
+ * Place les k plus grands éléments de arr en tête, en ordre décroissant,
+ * sans trier le reste (sélection puis tri des seuls k premiers). Retourne
+ * leur nombre (min(k, size)).
+ */
+int sort_top_desc(int *arr, int size, int k);
+
+/**
+ * Trie arr en ordre croissant avec le noyau donné
+ */
+void sort_local(int *arr, int size, int kernel);
+
+#endif
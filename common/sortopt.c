@@ -0,0 +1,383 @@
+/**
+ * Options d'ordre du Bucket Sort distribué: noyaux spécialisés par
+ * combinaison et pipeline d'enregistrements
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "sortopt.h"
+#include "sort_kernels.h"
+#include "partition.h"
+#include "instrument.h"
+#include "trace.h"
+
+// Enregistrements hachés à la fois pour l'empreinte
+#define SORTOPT_HASH_BLOCK 4096
+
+typedef struct {
+    int key;
+    int index;
+} indexed_record_t;
+
+typedef struct {
+    int key;
+    int key2;
+} pair_record_t;
+
+typedef struct {
+    int key;
+    int key2;
+    int index;
+} pair_indexed_record_t;
+
+static inline int key_asc(const int *a, const int *b) {
+    return *a < *b;
+}
+
+static inline int key_desc(const int *a, const int *b) {
+    return *a > *b;
+}
+
+static inline int indexed_asc(const indexed_record_t *a, const indexed_record_t *b) {
+    return a->key < b->key || (a->key == b->key && a->index < b->index);
+}
+
+static inline int indexed_desc(const indexed_record_t *a, const indexed_record_t *b) {
+    return a->key > b->key || (a->key == b->key && a->index < b->index);
+}
+
+static inline int pair_asc(const pair_record_t *a, const pair_record_t *b) {
+    return a->key < b->key || (a->key == b->key && a->key2 < b->key2);
+}
+
+static inline int pair_desc(const pair_record_t *a, const pair_record_t *b) {
+    return a->key > b->key || (a->key == b->key && a->key2 > b->key2);
+}
+
+static inline int pair_indexed_asc(const pair_indexed_record_t *a,
+                                   const pair_indexed_record_t *b) {
+    if (a->key != b->key) return a->key < b->key;
+    if (a->key2 != b->key2) return a->key2 < b->key2;
+    return a->index < b->index;
+}
+
+static inline int pair_indexed_desc(const pair_indexed_record_t *a,
+                                    const pair_indexed_record_t *b) {
+    if (a->key != b->key) return a->key > b->key;
+    if (a->key2 != b->key2) return a->key2 > b->key2;
+    return a->index < b->index;
+}
+
+/**
+ * Noyaux d'une combinaison et leurs points d'entrée sur des enregistrements
+ * non typés (un appel indirect par tableau)
+ */
+#define SORTOPT_DEFINE(name, type, before)                                          \
+SORT_DEFINE_KERNELS(name, type, before)                                             \
+                                                                                    \
+static void name##_sort_records(void *records, int count) {                         \
+    name##_sort((type*)records, count);                                             \
+}                                                                                   \
+                                                                                    \
+static int name##_is_sorted_records(const void *records, int count) {               \
+    return name##_is_sorted((const type*)records, count);                           \
+}                                                                                   \
+                                                                                    \
+static int name##_before_records(const void *a, const void *b) {                    \
+    return before((const type*)a, (const type*)b);                                  \
+}                                                                                   \
+                                                                                    \
+static void name##_classify(const void *records, int count, const void *splitters,  \
+                            int num_splitters, int *ids) {                          \
+    const type *r = (const type*)records;                                           \
+    for (int i = 0; i < count; i++) {                                               \
+        ids[i] = name##_upper_bound(&r[i], (const type*)splitters, num_splitters);  \
+    }                                                                               \
+}
+
+SORTOPT_DEFINE(int_asc, int, key_asc)
+SORTOPT_DEFINE(int_desc, int, key_desc)
+SORTOPT_DEFINE(indexed_asc, indexed_record_t, indexed_asc)
+SORTOPT_DEFINE(indexed_desc, indexed_record_t, indexed_desc)
+SORTOPT_DEFINE(pair_asc, pair_record_t, pair_asc)
+SORTOPT_DEFINE(pair_desc, pair_record_t, pair_desc)
+SORTOPT_DEFINE(pair_indexed_asc, pair_indexed_record_t, pair_indexed_asc)
+SORTOPT_DEFINE(pair_indexed_desc, pair_indexed_record_t, pair_indexed_desc)
+
+#define SORTOPT_OPS(label, name, type, pair, stable)                                \
+    { label, (int)(sizeof(type) / sizeof(int)), pair, stable, name##_sort_records,  \
+      name##_is_sorted_records, name##_before_records, name##_classify }
+
+// Indexées par order + 2 * stable + 4 * pair
+static const sortopt_ops_t ops_table[8] = {
+    SORTOPT_OPS("int-asc", int_asc, int, 0, 0),
+    SORTOPT_OPS("int-desc", int_desc, int, 0, 0),
+    SORTOPT_OPS("int-asc-stable", indexed_asc, indexed_record_t, 0, 1),
+    SORTOPT_OPS("int-desc-stable", indexed_desc, indexed_record_t, 0, 1),
+    SORTOPT_OPS("pair-asc", pair_asc, pair_record_t, 1, 0),
+    SORTOPT_OPS("pair-desc", pair_desc, pair_record_t, 1, 0),
+    SORTOPT_OPS("pair-asc-stable", pair_indexed_asc, pair_indexed_record_t, 1, 1),
+    SORTOPT_OPS("pair-desc-stable", pair_indexed_desc, pair_indexed_record_t, 1, 1)
+};
+
+const sortopt_ops_t *sortopt_select(const sort_options_t *opts) {
+    int order = (opts->order == SORT_DESC) ? 1 : 0;
+    return &ops_table[order + 2 * (opts->stable ? 1 : 0) + 4 * (opts->pair ? 1 : 0)];
+}
+
+int *sortopt_build(const sortopt_ops_t *ops, const int *keys, const int *keys2, int count,
+                   int first_index) {
+    int f = ops->fields;
+    int *records = (int*)malloc(((size_t)count * f + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        int *r = records + (size_t)i * f;
+        r[0] = keys[i];
+        if (ops->pair) r[1] = keys2[i];
+        if (ops->stable) r[f - 1] = first_index + i;
+    }
+    return records;
+}
+
+void sortopt_scatter(const sortopt_ops_t *ops, const int *all, int count, int **local,
+                     int *local_count, int root, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    // Sur root: entiers de chaque part
+    int *counts = NULL, *displs = NULL;
+    if (rank == root) {
+        counts = (int*)malloc(num_procs * sizeof(int));
+        displs = (int*)malloc(num_procs * sizeof(int));
+        int first = 0;
+        for (int r = 0; r < num_procs; r++) {
+            int n = count / num_procs + (r < count % num_procs ? 1 : 0);
+            counts[r] = n * ops->fields;
+            displs[r] = first * ops->fields;
+            first += n;
+        }
+    }
+    
+    int local_ints;
+    TRACED("MPI_Scatter",
+           MPI_Scatter(counts, 1, MPI_INT, &local_ints, 1, MPI_INT, root, comm));
+    *local_count = local_ints / ops->fields;
+    *local = (int*)malloc((local_ints + 1) * sizeof(int));
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(all, counts, displs, MPI_INT, *local, local_ints, MPI_INT, root, comm));
+    
+    free(counts);
+    free(displs);
+}
+
+/**
+ * num_buckets - 1 séparateurs (enregistrements complets): échantillon
+ * régulier des enregistrements de chaque processus, trié, pris aux
+ * quantiles de l'échantillon global. Identiques sur tous les processus.
+ */
+static int *select_splitters(const sortopt_ops_t *ops, const int *local, int count,
+                             int num_buckets, MPI_Comm comm) {
+    int f = ops->fields;
+    int samples = PARTITION_OVERSAMPLING * num_buckets;
+    if (samples > count) samples = count;
+    
+    int *sample = (int*)malloc(((size_t)samples * f + 1) * sizeof(int));
+    for (int i = 0; i < samples; i++) {
+        int k = (int)((long long)i * count / samples);
+        memcpy(sample + (size_t)i * f, local + (size_t)k * f, f * sizeof(int));
+    }
+    
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    int *sample_counts = (int*)malloc(num_procs * sizeof(int));
+    int *sample_displs = (int*)malloc(num_procs * sizeof(int));
+    int sample_ints = samples * f;
+    TRACED("MPI_Allgather",
+           MPI_Allgather(&sample_ints, 1, MPI_INT, sample_counts, 1, MPI_INT, comm));
+    int total_ints = 0;
+    for (int r = 0; r < num_procs; r++) {
+        sample_displs[r] = total_ints;
+        total_ints += sample_counts[r];
+    }
+    int *all = (int*)malloc((total_ints + 1) * sizeof(int));
+    TRACED("MPI_Allgatherv",
+           MPI_Allgatherv(sample, sample_ints, MPI_INT,
+                          all, sample_counts, sample_displs, MPI_INT, comm));
+    int total = total_ints / f;
+    ops->sort(all, total);
+    
+    int *splitters = (int*)calloc((size_t)num_buckets * f, sizeof(int));
+    for (int b = 1; b < num_buckets && total > 0; b++) {
+        int k = (int)((long long)b * total / num_buckets);
+        memcpy(splitters + (size_t)(b - 1) * f, all + (size_t)k * f, f * sizeof(int));
+    }
+    
+    free(sample);
+    free(sample_counts);
+    free(sample_displs);
+    free(all);
+    return splitters;
+}
+
+long long sortopt_exchange(const sortopt_ops_t *ops, const int *local, int count, int **sorted,
+                           int *sorted_count, MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    int f = ops->fields;
+    
+    // Séparateurs et bucket de chaque enregistrement
+    double t0 = instr_start();
+    int *splitters = select_splitters(ops, local, count, num_procs, comm);
+    int *bucket_ids = (int*)malloc((count + 1) * sizeof(int));
+    ops->classify(local, count, splitters, num_procs - 1, bucket_ids);
+    int *send_counts = (int*)calloc(num_procs, sizeof(int));
+    for (int i = 0; i < count; i++) {
+        send_counts[bucket_ids[i]] += f;
+    }
+    instr_stop(PHASE_CLASSIFY, t0);
+    
+    // Enregistrements rangés par bucket
+    t0 = instr_start();
+    int *send_displs = (int*)malloc(num_procs * sizeof(int));
+    int *positions = (int*)malloc(num_procs * sizeof(int));
+    int total_ints = 0;
+    for (int d = 0; d < num_procs; d++) {
+        send_displs[d] = positions[d] = total_ints;
+        total_ints += send_counts[d];
+    }
+    int *send_buffer = (int*)malloc((total_ints + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        memcpy(send_buffer + positions[bucket_ids[i]], local + (size_t)i * f, f * sizeof(int));
+        positions[bucket_ids[i]] += f;
+    }
+    instr_stop(PHASE_PACK, t0);
+    
+    t0 = instr_start();
+    int *recv_counts = (int*)malloc(num_procs * sizeof(int));
+    TRACED("MPI_Alltoall",
+           MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, comm));
+    instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    
+    t0 = instr_start();
+    int *recv_displs = (int*)malloc(num_procs * sizeof(int));
+    int recv_ints = 0;
+    for (int s = 0; s < num_procs; s++) {
+        recv_displs[s] = recv_ints;
+        recv_ints += recv_counts[s];
+    }
+    *sorted = (int*)malloc((recv_ints + 1) * sizeof(int));
+    *sorted_count = recv_ints / f;
+    TRACED("MPI_Alltoallv",
+           MPI_Alltoallv(send_buffer, send_counts, send_displs, MPI_INT,
+                         *sorted, recv_counts, recv_displs, MPI_INT, comm));
+    instr_stop(PHASE_DATA_EXCHANGE, t0);
+    
+    long long bytes_sent = (long long)total_ints * sizeof(int);
+    instr_add_bytes(bytes_sent, (long long)recv_ints * sizeof(int));
+    instr_set_bucket_size(*sorted_count);
+    
+    // Tri local
+    t0 = instr_start();
+    ops->sort(*sorted, *sorted_count);
+    instr_stop(PHASE_LOCAL_SORT, t0);
+    
+    free(splitters);
+    free(bucket_ids);
+    free(send_counts);
+    free(send_displs);
+    free(positions);
+    free(send_buffer);
+    free(recv_counts);
+    free(recv_displs);
+    return bytes_sent;
+}
+
+void sortopt_gather(const sortopt_ops_t *ops, const int *local, int count, int **all,
+                    int *total, int root, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    int local_ints = count * ops->fields;
+    int *counts = NULL, *displs = NULL;
+    if (rank == root) {
+        counts = (int*)malloc(num_procs * sizeof(int));
+        displs = (int*)malloc(num_procs * sizeof(int));
+    }
+    TRACED("MPI_Gather",
+           MPI_Gather(&local_ints, 1, MPI_INT, counts, 1, MPI_INT, root, comm));
+    
+    *all = NULL;
+    *total = 0;
+    if (rank == root) {
+        int total_ints = 0;
+        for (int r = 0; r < num_procs; r++) {
+            displs[r] = total_ints;
+            total_ints += counts[r];
+        }
+        *all = (int*)malloc((total_ints + 1) * sizeof(int));
+        *total = total_ints / ops->fields;
+    }
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv(local, local_ints, MPI_INT, *all, counts, displs, MPI_INT, root, comm));
+    
+    free(counts);
+    free(displs);
+}
+
+void sortopt_checksum(checksum_t *cs, const sortopt_ops_t *ops, const int *records, int count) {
+    // Chaque enregistrement compte pour un hachage FNV-1a de ses champs
+    int hashes[SORTOPT_HASH_BLOCK];
+    int f = ops->fields;
+    for (int block = 0; block < count; block += SORTOPT_HASH_BLOCK) {
+        int n = (count - block < SORTOPT_HASH_BLOCK) ? count - block : SORTOPT_HASH_BLOCK;
+        for (int i = 0; i < n; i++) {
+            const int *r = records + (size_t)(block + i) * f;
+            unsigned int h = 2166136261u;
+            for (int j = 0; j < f; j++) {
+                h = (h ^ (unsigned int)r[j]) * 16777619u;
+            }
+            hashes[i] = (int)h;
+        }
+        checksum_add_array(cs, hashes, n);
+    }
+}
+
+int sortopt_verify_distributed(const sortopt_ops_t *ops, const int *records, int count,
+                               MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    int f = ops->fields;
+    int local_ok = ops->is_sorted(records, count);
+    
+    // Par processus: partie non vide, premier et dernier enregistrements
+    int width = 1 + 2 * f;
+    int ends[1 + 2 * SORTOPT_MAX_FIELDS] = { 0 };
+    if (count > 0) {
+        ends[0] = 1;
+        memcpy(ends + 1, records, f * sizeof(int));
+        memcpy(ends + 1 + f, records + (size_t)(count - 1) * f, f * sizeof(int));
+    }
+    int *all_ends = (int*)malloc((size_t)num_procs * width * sizeof(int));
+    TRACED("MPI_Allgather",
+           MPI_Allgather(ends, width, MPI_INT, all_ends, width, MPI_INT, comm));
+    
+    // Les parties sont dans l'ordre des rangs: le dernier enregistrement
+    // d'une partie ne suit pas le premier de la partie non vide suivante
+    const int *last = NULL;
+    for (int r = 0; r < num_procs; r++) {
+        const int *part = all_ends + (size_t)r * width;
+        if (!part[0]) continue;
+        if (last != NULL && ops->before(part + 1, last)) {
+            local_ok = 0;
+        }
+        last = part + 1 + f;
+    }
+    free(all_ends);
+    
+    int global_ok;
+    MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, comm);
+    return global_ok;
+}
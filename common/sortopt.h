@@ -0,0 +1,103 @@
+/**
+ * Options d'ordre du Bucket Sort distribué (--order, --stable, --keys=pair)
+ *
+ * Le tri d'entiers est croissant et ne distingue pas les clés égales. Ce
+ * module trie des enregistrements de quelques entiers, dans l'ordre:
+ * - clé, croissante ou décroissante (--order=asc|desc);
+ * - puis seconde clé (--keys=pair): ordre lexicographique (clé, clé2),
+ *   les deux dans le sens de --order;
+ * - puis indice d'origine croissant (--stable): les éléments de mêmes clés
+ *   gardent leur ordre initial quel que soit le sens du tri.
+ * Chaque combinaison a ses noyaux (tri, classement, vérification) générés
+ * par SORT_DEFINE_KERNELS (sort_kernels.h) pour son type d'enregistrement:
+ * la comparaison est en ligne, le choix de la combinaison ne coûte qu'un
+ * appel indirect par tableau. Le pipeline est celui des clés chaînes:
+ * séparateurs tirés d'un échantillon régulier (des enregistrements
+ * complets, donc distincts avec l'indice), échange en octets, tri local,
+ * rassemblement et vérification distribuée.
+ */
+
+#ifndef SORTOPT_H
+#define SORTOPT_H
+
+#include <mpi.h>
+
+#include "verify.h"
+
+// Champs entiers d'un enregistrement au plus (clé, clé2, indice)
+#define SORTOPT_MAX_FIELDS 3
+
+/**
+ * Options d'ordre demandées
+ */
+typedef struct {
+    int order;          // SORT_ASC ou SORT_DESC (sort_kernels.h)
+    int stable;         // Égalités départagées par l'indice d'origine
+    int pair;           // Seconde clé (ordre lexicographique)
+} sort_options_t;
+
+/**
+ * Noyaux d'une combinaison d'options. Un enregistrement est une suite de
+ * fields entiers: clé, clé2 (pair), indice (stable).
+ */
+typedef struct {
+    const char *name;   // Nom de la combinaison (par exemple "pair-desc-stable")
+    int fields;         // Entiers par enregistrement
+    int pair;           // Clé2 en deuxième champ
+    int stable;         // Indice en dernier champ
+    void (*sort)(void *records, int count);
+    int (*is_sorted)(const void *records, int count);
+    int (*before)(const void *a, const void *b);
+    // Bucket de chaque enregistrement (nombre de séparateurs qui ne le
+    // suivent pas) dans ids
+    void (*classify)(const void *records, int count, const void *splitters,
+                     int num_splitters, int *ids);
+} sortopt_ops_t;
+
+/**
+ * Noyaux de la combinaison d'options
+ */
+const sortopt_ops_t *sortopt_select(const sort_options_t *opts);
+
+/**
+ * Enregistrements de count éléments: clés keys, secondes clés keys2 (si
+ * la combinaison en a) et indices first_index, first_index + 1, ...
+ */
+int *sortopt_build(const sortopt_ops_t *ops, const int *keys, const int *keys2, int count,
+                   int first_index);
+
+/**
+ * Partage les count enregistrements du processus root en parts de même
+ * taille. Opération collective.
+ */
+void sortopt_scatter(const sortopt_ops_t *ops, const int *all, int count, int **local,
+                     int *local_count, int root, MPI_Comm comm);
+
+/**
+ * Étapes 2 à 4: séparateurs échantillonnés, répartition des enregistrements
+ * dans un bucket par processus, échange (MPI_Alltoallv) et tri local.
+ * Retourne le volume envoyé en octets.
+ */
+long long sortopt_exchange(const sortopt_ops_t *ops, const int *local, int count, int **sorted,
+                           int *sorted_count, MPI_Comm comm);
+
+/**
+ * Rassemble les parties triées sur root, dans l'ordre des rangs
+ */
+void sortopt_gather(const sortopt_ops_t *ops, const int *local, int count, int **all,
+                    int *total, int root, MPI_Comm comm);
+
+/**
+ * Ajoute les enregistrements à l'empreinte (un hachage de leurs champs
+ * par enregistrement)
+ */
+void sortopt_checksum(checksum_t *cs, const sortopt_ops_t *ops, const int *records, int count);
+
+/**
+ * Vérifie l'ordre de chaque partie et des frontières entre processus
+ * (rangs croissants). Opération collective.
+ */
+int sortopt_verify_distributed(const sortopt_ops_t *ops, const int *records, int count,
+                               MPI_Comm comm);
+
+#endif
@@ -0,0 +1,321 @@
+/**
+ * Top-K en flux: tas borné, lecture par blocs et instantanés globaux
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <mpi.h>
+
+#include "stream.h"
+#include "workload.h"
+#include "trace.h"
+#include "sort_kernels.h"
+
+void topk_heap_init(topk_heap_t *heap, int k) {
+    heap->values = (int*)malloc((k + 1) * sizeof(int));
+    heap->size = 0;
+    heap->k = k;
+}
+
+void topk_heap_free(topk_heap_t *heap) {
+    free(heap->values);
+    heap->values = NULL;
+}
+
+/**
+ * Descend l'élément placé à la racine jusqu'à sa position
+ */
+static void sift_down(int *values, int size) {
+    int i = 0;
+    int value = values[0];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size && values[child + 1] < values[child]) child++;
+        if (values[child] >= value) break;
+        values[i] = values[child];
+        i = child;
+    }
+    values[i] = value;
+}
+
+/**
+ * Remonte le dernier élément jusqu'à sa position
+ */
+static void sift_up(int *values, int i) {
+    int value = values[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (values[parent] <= value) break;
+        values[i] = values[parent];
+        i = parent;
+    }
+    values[i] = value;
+}
+
+long long topk_heap_push_chunk(topk_heap_t *heap, const int *values, int count) {
+    long long inserted = 0;
+    int i = 0;
+    
+    // Remplissage initial du tas
+    while (heap->size < heap->k && i < count) {
+        heap->values[heap->size] = values[i++];
+        sift_up(heap->values, heap->size++);
+        inserted++;
+    }
+    if (heap->k == 0) {
+        return 0;
+    }
+    
+    // Tas plein: une comparaison au seuil suffit pour la plupart des éléments
+    int threshold = heap->values[0];
+    for (; i < count; i++) {
+        if (values[i] <= threshold) continue;
+        heap->values[0] = values[i];
+        sift_down(heap->values, heap->size);
+        threshold = heap->values[0];
+        inserted++;
+    }
+    return inserted;
+}
+
+int topk_heap_sorted(const topk_heap_t *heap, int *out) {
+    memcpy(out, heap->values, heap->size * sizeof(int));
+    sort_int_order(out, heap->size, SORT_DESC);
+    return heap->size;
+}
+
+/**
+ * Lit jusqu'à max_count entiers d'un fichier texte (tout caractère autre
+ * qu'un chiffre ou un signe moins sépare les valeurs)
+ */
+static int read_text(FILE *file, int *out, int max_count) {
+    int count = 0;
+    int c = getc_unlocked(file);
+    while (count < max_count && c != EOF) {
+        if (c != '-' && (c < '0' || c > '9')) {
+            c = getc_unlocked(file);
+            continue;
+        }
+        int negative = (c == '-');
+        if (negative) c = getc_unlocked(file);
+        long long value = 0;
+        int digits = 0;
+        while (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+            digits++;
+            c = getc_unlocked(file);
+        }
+        if (digits > 0) {
+            out[count++] = (int)(negative ? -value : value);
+        }
+    }
+    if (c != EOF) {
+        ungetc(c, file);
+    }
+    return count;
+}
+
+/**
+ * Remplit un tampon avec le bloc suivant de la source
+ */
+static int fill_chunk(stream_t *stream, int *buffer) {
+    if (stream->kind == STREAM_GENERATOR) {
+        long long start = stream->next_block * stream->chunk_size;
+        if (start >= stream->total) {
+            return 0;
+        }
+        long long remaining = stream->total - start;
+        int count = (remaining < stream->chunk_size) ? (int)remaining : stream->chunk_size;
+        workload_generate(buffer, start, count, stream->total, stream->max_value,
+                          stream->dist, stream->seed);
+        stream->next_block += stream->block_step;
+        return count;
+    }
+    if (stream->kind == STREAM_TEXT) {
+        return read_text(stream->file, buffer, stream->chunk_size);
+    }
+    return 0;
+}
+
+/**
+ * Thread de lecture: remplit alternativement les deux tampons; un bloc
+ * vide signale la fin du flux
+ */
+static void *reader_main(void *arg) {
+    stream_t *stream = (stream_t*)arg;
+    int slot = 0;
+    
+    for (;;) {
+        pthread_mutex_lock(&stream->lock);
+        while (stream->full[slot] && !stream->stop) {
+            pthread_cond_wait(&stream->cond, &stream->lock);
+        }
+        int stop = stream->stop;
+        pthread_mutex_unlock(&stream->lock);
+        if (stop) break;
+    
+        int count = fill_chunk(stream, stream->buffers[slot]);
+    
+        pthread_mutex_lock(&stream->lock);
+        stream->counts[slot] = count;
+        stream->full[slot] = 1;
+        pthread_cond_broadcast(&stream->cond);
+        pthread_mutex_unlock(&stream->lock);
+        if (count == 0) break;
+        slot ^= 1;
+    }
+    return NULL;
+}
+
+int stream_rereadable(const char *source) {
+    return strcmp(source, "-") != 0;
+}
+
+int stream_open(stream_t *stream, const char *source, long long default_total, int chunk_size,
+                int rank, int num_procs, int dist, unsigned long long seed, int max_value) {
+    memset(stream, 0, sizeof(*stream));
+    stream->chunk_size = chunk_size;
+    stream->dist = dist;
+    stream->seed = seed;
+    stream->max_value = max_value;
+    stream->current = -1;
+    
+    if (strcmp(source, "gen") == 0 || strncmp(source, "gen:", 4) == 0) {
+        stream->kind = STREAM_GENERATOR;
+        stream->total = (source[3] == ':') ? atoll(source + 4) : default_total;
+        stream->next_block = rank;
+        stream->block_step = num_procs;
+    } else if (strcmp(source, "-") == 0) {
+        stream->kind = (rank == 0) ? STREAM_TEXT : STREAM_NONE;
+        stream->file = (rank == 0) ? stdin : NULL;
+        stream->is_stdin = 1;
+    } else if (strstr(source, "%d") != NULL) {
+        char path[1024];
+        snprintf(path, sizeof(path), source, rank);
+        stream->kind = STREAM_TEXT;
+        stream->file = fopen(path, "r");
+        if (stream->file == NULL) return -1;
+    } else {
+        stream->kind = (rank == 0) ? STREAM_TEXT : STREAM_NONE;
+        if (rank == 0) {
+            stream->file = fopen(source, "r");
+            if (stream->file == NULL) return -1;
+        }
+    }
+    
+    stream->buffers[0] = (int*)malloc(chunk_size * sizeof(int));
+    stream->buffers[1] = (int*)malloc(chunk_size * sizeof(int));
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    pthread_create(&stream->reader, NULL, reader_main, stream);
+    return 0;
+}
+
+int stream_next(stream_t *stream, const int **chunk) {
+    if (stream->finished) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&stream->lock);
+    // Le bloc précédent est rendu au thread de lecture
+    if (stream->current >= 0) {
+        stream->full[stream->current] = 0;
+        pthread_cond_broadcast(&stream->cond);
+    }
+    int slot = stream->next_slot;
+    while (!stream->full[slot]) {
+        pthread_cond_wait(&stream->cond, &stream->lock);
+    }
+    int count = stream->counts[slot];
+    pthread_mutex_unlock(&stream->lock);
+    
+    if (count == 0) {
+        stream->finished = 1;
+        stream->current = -1;
+        return 0;
+    }
+    stream->current = slot;
+    stream->next_slot = slot ^ 1;
+    *chunk = stream->buffers[slot];
+    return count;
+}
+
+void stream_close(stream_t *stream) {
+    pthread_mutex_lock(&stream->lock);
+    stream->stop = 1;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->lock);
+    pthread_join(stream->reader, NULL);
+    
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->cond);
+    free(stream->buffers[0]);
+    free(stream->buffers[1]);
+    if (stream->file != NULL && !stream->is_stdin) {
+        fclose(stream->file);
+    }
+}
+
+/**
+ * Opération MPI de l'instantané: chaque élément est une liste
+ * [actif, nombre, valeurs décroissantes...] de k + 2 entiers (k se déduit
+ * de la taille du type)
+ */
+static void snapshot_merge(void *in, void *inout, int *len, MPI_Datatype *type) {
+    int type_size;
+    MPI_Type_size(*type, &type_size);
+    int k = type_size / (int)sizeof(int) - 2;
+    int *merged = (int*)malloc((k + 1) * sizeof(int));
+    
+    for (int e = 0; e < *len; e++) {
+        const int *a = (const int*)in + (size_t)e * (k + 2);
+        int *b = (int*)inout + (size_t)e * (k + 2);
+        const int *values_a = a + 2;
+        const int *values_b = b + 2;
+        int i = 0, j = 0, n = 0;
+        while (n < k && (i < a[1] || j < b[1])) {
+            if (j >= b[1] || (i < a[1] && values_a[i] >= values_b[j])) {
+                merged[n++] = values_a[i++];
+            } else {
+                merged[n++] = values_b[j++];
+            }
+        }
+        b[0] = a[0] || b[0];
+        b[1] = n;
+        memcpy(b + 2, merged, n * sizeof(int));
+    }
+    free(merged);
+}
+
+int topk_snapshot(const int *local_topk, int local_count, int k, int active,
+                  int *global_topk, int *global_count, MPI_Comm comm) {
+    int *send = (int*)calloc(k + 2, sizeof(int));
+    int *recv = (int*)malloc((k + 2) * sizeof(int));
+    send[0] = active;
+    send[1] = local_count;
+    memcpy(send + 2, local_topk, local_count * sizeof(int));
+    
+    MPI_Datatype list_type;
+    MPI_Op merge_op;
+    MPI_Type_contiguous(k + 2, MPI_INT, &list_type);
+    MPI_Type_commit(&list_type);
+    MPI_Op_create(snapshot_merge, 1, &merge_op);
+    
+    TRACED("MPI_Allreduce",
+           MPI_Allreduce(send, recv, 1, list_type, merge_op, comm));
+    
+    MPI_Op_free(&merge_op);
+    MPI_Type_free(&list_type);
+    
+    int any_active = recv[0];
+    *global_count = recv[1];
+    memcpy(global_topk, recv + 2, recv[1] * sizeof(int));
+    free(send);
+    free(recv);
+    return any_active;
+}
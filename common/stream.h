@@ -0,0 +1,130 @@
+/**
+ * Top-K en flux (--stream)
+ *
+ * Les données ne sont jamais entièrement en mémoire: chaque processus lit
+ * sa source par blocs de taille fixe. Un thread de lecture remplit un bloc
+ * pendant que le bloc précédent est traité (double tampon), et les K plus
+ * grands vus jusqu'ici sont gardés dans un tas minimum de taille K: tout
+ * élément inférieur ou égal au minimum du tas est rejeté par une seule
+ * comparaison. La mémoire reste en O(K + bloc) quelle que soit la longueur
+ * du flux.
+ *
+ * Un instantané global du Top-K est obtenu par MPI_Allreduce avec une
+ * opération MPI dédiée qui fusionne les listes décroissantes.
+ *
+ * Sources:
+ * - "gen" ou "gen:N": générateur (workload.h) de N éléments, les blocs étant
+ *   répartis entre processus à tour de rôle (bloc b pour le processus b % p);
+ * - "-": entrée standard (processus 0 seulement);
+ * - chemin de fichier texte (entiers séparés par des blancs ou des
+ *   virgules); "%d" dans le chemin est remplacé par le rang, sinon seul le
+ *   processus 0 lit le fichier.
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include <mpi.h>
+
+#define STREAM_DEFAULT_CHUNK 65536
+
+#define STREAM_NONE      0
+#define STREAM_GENERATOR 1
+#define STREAM_TEXT      2
+
+/**
+ * Tas minimum des K plus grands éléments vus
+ */
+typedef struct {
+    int *values;            // values[0]: plus petit élément retenu
+    int size;
+    int k;
+} topk_heap_t;
+
+/**
+ * Source lue par blocs avec un thread de lecture (double tampon)
+ */
+typedef struct {
+    int kind;               // STREAM_NONE (aucune donnée), _GENERATOR, _TEXT
+    FILE *file;
+    int is_stdin;
+    long long total;        // Taille du flux généré
+    long long next_block;   // Prochain bloc global à générer
+    int block_step;         // Nombre de processus (répartition des blocs)
+    int dist;
+    unsigned long long seed;
+    int max_value;
+
+    int chunk_size;
+    int *buffers[2];
+    int counts[2];
+    int full[2];
+    int current;            // Tampon rendu par stream_next (-1: aucun)
+    int next_slot;
+    int finished;
+    int stop;
+    pthread_t reader;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} stream_t;
+
+/**
+ * Prépare un tas vide de capacité k
+ */
+void topk_heap_init(topk_heap_t *heap, int k);
+
+/**
+ * Libère le tas
+ */
+void topk_heap_free(topk_heap_t *heap);
+
+/**
+ * Insère les éléments d'un bloc; les éléments inférieurs ou égaux au seuil
+ * courant (minimum du tas plein) sont rejetés sans autre travail.
+ * Retourne le nombre d'éléments insérés.
+ */
+long long topk_heap_push_chunk(topk_heap_t *heap, const int *values, int count);
+
+/**
+ * Copie le contenu du tas dans out en ordre décroissant (tas inchangé) et
+ * retourne le nombre d'éléments
+ */
+int topk_heap_sorted(const topk_heap_t *heap, int *out);
+
+/**
+ * Ouvre la source (voir ci-dessus) et démarre le thread de lecture.
+ * La taille N de "gen:N" vaut default_total si elle est omise.
+ * Retourne 0, ou -1 si la source ne peut pas être ouverte.
+ */
+int stream_open(stream_t *stream, const char *source, long long default_total, int chunk_size,
+                int rank, int num_procs, int dist, unsigned long long seed, int max_value);
+
+/**
+ * Bloc suivant (valide jusqu'au prochain appel): retourne le nombre
+ * d'éléments, 0 à la fin du flux. Le bloc précédent est rendu au thread
+ * de lecture.
+ */
+int stream_next(stream_t *stream, const int **chunk);
+
+/**
+ * Arrête le thread de lecture et libère la source
+ */
+void stream_close(stream_t *stream);
+
+/**
+ * La source peut-elle être relue (tout sauf l'entrée standard)?
+ */
+int stream_rereadable(const char *source);
+
+/**
+ * Instantané global: fusionne les listes décroissantes local_topk de tous
+ * les processus (MPI_Allreduce, opération MPI dédiée) dans global_topk
+ * (capacité k) et retourne leur nombre dans *global_count. Retourne 1 si
+ * au moins un processus a indiqué active, 0 sinon. Opération collective.
+ */
+int topk_snapshot(const int *local_topk, int local_count, int k, int active,
+                  int *global_topk, int *global_count, MPI_Comm comm);
+
+#endif
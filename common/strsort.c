@@ -0,0 +1,677 @@
+/**
+ * Bucket Sort distribué de clés chaînes: génération, tri local multiclé,
+ * échange au format compact et vérification
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "strsort.h"
+#include "partition.h"
+#include "workload.h"
+#include "instrument.h"
+#include "trace.h"
+#include "sort_kernels.h"
+
+// Mots aléatoires par clé générée (chemin et paramètre)
+#define STRSORT_WORDS 4
+
+// Longueur maximale d'une clé générée
+#define STRSORT_MAX_KEY 128
+
+// Clés hachées à la fois pour l'empreinte
+#define STRSORT_HASH_BLOCK 4096
+
+/**
+ * Référence vers une clé, avec ses 8 octets à la profondeur courante
+ * (gros-boutiste, complétés par des zéros après la fin de la clé)
+ */
+typedef struct {
+    uint64_t cache;
+    const char *key;
+    int length;
+} string_ref_t;
+
+void strset_free(string_set_t *set) {
+    free(set->offsets);
+    free(set->bytes);
+    set->offsets = NULL;
+    set->bytes = NULL;
+    set->count = 0;
+}
+
+/**
+ * Alloue un ensemble de count clés et size octets (bornes non remplies)
+ */
+static void strset_alloc(string_set_t *set, int count, int size) {
+    set->count = count;
+    set->offsets = (int*)malloc((count + 1) * sizeof(int));
+    set->bytes = (char*)malloc(size + 1);
+}
+
+/**
+ * Bornes à partir des longueurs
+ */
+static void offsets_from_lengths(int *offsets, const int *lengths, int count) {
+    offsets[0] = 0;
+    for (int i = 0; i < count; i++) {
+        offsets[i + 1] = offsets[i] + lengths[i];
+    }
+}
+
+/**
+ * Lettres minuscules pseudo-aléatoires dérivées de word
+ */
+static int append_letters(char *out, unsigned int word, int count) {
+    for (int i = 0; i < count; i++) {
+        word = word * 1103515245u + 12345u;
+        out[i] = (char)('a' + (word >> 16) % 26);
+    }
+    return count;
+}
+
+/**
+ * Clé de type URL: site (4 lettres, ordre des numéros), 0 à 3 segments de
+ * chemin et un paramètre facultatif
+ */
+static int build_key(char *out, int host, const int *words) {
+    int n = sprintf(out, "https://www.");
+    for (int i = 3; i >= 0; i--) {
+        int letter = host;
+        for (int j = 0; j < i; j++) letter /= 26;
+        out[n++] = (char)('a' + letter % 26);
+    }
+    n += sprintf(out + n, ".com");
+    
+    int segments = words[0] % 4;
+    for (int s = 0; s < segments; s++) {
+        out[n++] = '/';
+        n += append_letters(out + n, (unsigned int)words[s + 1], 1 + (words[s + 1] >> 8) % 12);
+    }
+    if (words[0] & 4) {
+        n += sprintf(out + n, "?id=%d", (words[0] >> 3) % 1000000);
+    }
+    return n;
+}
+
+void strsort_generate(string_set_t *set, long long start, int count, long long total_size,
+                      int dist, uint64_t seed) {
+    // Site selon la distribution, mots du chemin uniformes: indexés par la
+    // position globale comme les tableaux d'entiers
+    int *hosts = (int*)malloc((count + 1) * sizeof(int));
+    int *words = (int*)malloc(((size_t)count * STRSORT_WORDS + 1) * sizeof(int));
+    workload_generate(hosts, start, count, total_size, STRSORT_HOSTS, dist, seed);
+    workload_generate(words, start * STRSORT_WORDS, count * STRSORT_WORDS,
+                      total_size * STRSORT_WORDS, 1 << 30, DIST_UNIFORM, seed + 1);
+    
+    int capacity = count * 32 + STRSORT_MAX_KEY;
+    set->count = count;
+    set->offsets = (int*)malloc((count + 1) * sizeof(int));
+    set->bytes = (char*)malloc(capacity);
+    set->offsets[0] = 0;
+    char key[STRSORT_MAX_KEY];
+    for (int i = 0; i < count; i++) {
+        int length = build_key(key, hosts[i], words + (size_t)i * STRSORT_WORDS);
+        if (set->offsets[i] + length > capacity) {
+            capacity *= 2;
+            set->bytes = (char*)realloc(set->bytes, capacity);
+        }
+        memcpy(set->bytes + set->offsets[i], key, length);
+        set->offsets[i + 1] = set->offsets[i] + length;
+    }
+    
+    free(hosts);
+    free(words);
+}
+
+int strsort_compare(const char *a, int length_a, const char *b, int length_b) {
+    int n = (length_a < length_b) ? length_a : length_b;
+    int c = memcmp(a, b, n);
+    if (c != 0) {
+        return c;
+    }
+    return (length_a > length_b) - (length_a < length_b);
+}
+
+/**
+ * 8 octets de la clé à partir de depth
+ */
+static inline uint64_t load_cache(const char *key, int length, int depth) {
+    uint64_t word = 0;
+    for (int b = 0; b < 8; b++) {
+        word <<= 8;
+        if (depth + b < length) word |= (unsigned char)key[depth + b];
+    }
+    return word;
+}
+
+/**
+ * Ordre de deux références de même préfixe jusqu'à depth (octets en cache,
+ * puis suite des clés, puis longueur: "ab" précède "ab\0")
+ */
+static int compare_refs(const string_ref_t *a, const string_ref_t *b, int depth) {
+    if (a->cache != b->cache) {
+        return (a->cache < b->cache) ? -1 : 1;
+    }
+    int from = depth + 8;
+    int rest_a = (a->length > from) ? a->length - from : 0;
+    int rest_b = (b->length > from) ? b->length - from : 0;
+    int c = strsort_compare(rest_a > 0 ? a->key + from : a->key, rest_a,
+                            rest_b > 0 ? b->key + from : b->key, rest_b);
+    if (c != 0) {
+        return c;
+    }
+    return (a->length > b->length) - (a->length < b->length);
+}
+
+static inline int ref_length_before(const string_ref_t *a, const string_ref_t *b) {
+    return a->length < b->length;
+}
+
+SORT_DEFINE_KERNELS(ref_length, string_ref_t, ref_length_before)
+
+static inline void swap_refs(string_ref_t *a, string_ref_t *b) {
+    string_ref_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void insertion_refs(string_ref_t *refs, int n, int depth) {
+    for (int i = 1; i < n; i++) {
+        string_ref_t current = refs[i];
+        int j = i;
+        while (j > 0 && compare_refs(&refs[j - 1], &current, depth) > 0) {
+            refs[j] = refs[j - 1];
+            j--;
+        }
+        refs[j] = current;
+    }
+}
+
+static void sort_refs(string_ref_t *refs, int n, int depth);
+
+/**
+ * Groupe de clés aux mêmes 8 octets à depth: terminé si aucune ne se
+ * prolonge au-delà (seule la longueur les distingue encore), sinon trié sur
+ * les 8 octets suivants
+ */
+static void sort_equal_group(string_ref_t *refs, int n, int depth) {
+    int longest = 0, shortest = refs[0].length;
+    for (int i = 0; i < n; i++) {
+        if (refs[i].length > longest) longest = refs[i].length;
+        if (refs[i].length < shortest) shortest = refs[i].length;
+    }
+    if (longest <= depth + 8) {
+        if (shortest != longest) {
+            ref_length_sort(refs, n);
+        }
+        return;
+    }
+    
+    depth += 8;
+    for (int i = 0; i < n; i++) {
+        refs[i].cache = load_cache(refs[i].key, refs[i].length, depth);
+    }
+    sort_refs(refs, n, depth);
+}
+
+/**
+ * Quicksort multiclé: partition en trois sur les octets en cache (pivot
+ * médiane de trois); le groupe égal passe aux octets suivants, le plus
+ * petit des deux autres est trié récursivement et le plus grand en boucle
+ */
+static void sort_refs(string_ref_t *refs, int n, int depth) {
+    while (n > STRSORT_INSERTION_MAX) {
+        uint64_t a = refs[0].cache, b = refs[n / 2].cache, c = refs[n - 1].cache;
+        uint64_t pivot = (a < b) ? ((b < c) ? b : (a < c ? c : a))
+                                 : ((a < c) ? a : (b < c ? c : b));
+        int lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            if (refs[i].cache < pivot) {
+                swap_refs(&refs[lt++], &refs[i++]);
+            } else if (refs[i].cache > pivot) {
+                swap_refs(&refs[i], &refs[--gt]);
+            } else {
+                i++;
+            }
+        }
+    
+        if (gt - lt > 1) {
+            sort_equal_group(refs + lt, gt - lt, depth);
+        }
+        if (lt < n - gt) {
+            sort_refs(refs, lt, depth);
+            refs += gt;
+            n -= gt;
+        } else {
+            sort_refs(refs + gt, n - gt, depth);
+            n = lt;
+        }
+    }
+    insertion_refs(refs, n, depth);
+}
+
+void strsort_local(string_set_t *set) {
+    int count = set->count;
+    if (count < 2) {
+        return;
+    }
+    string_ref_t *refs = (string_ref_t*)malloc(count * sizeof(string_ref_t));
+    for (int i = 0; i < count; i++) {
+        refs[i].key = set->bytes + set->offsets[i];
+        refs[i].length = set->offsets[i + 1] - set->offsets[i];
+        refs[i].cache = load_cache(refs[i].key, refs[i].length, 0);
+    }
+    sort_refs(refs, count, 0);
+    
+    // Recopie des clés dans l'ordre trié
+    string_set_t sorted;
+    strset_alloc(&sorted, count, set->offsets[count]);
+    sorted.offsets[0] = 0;
+    for (int i = 0; i < count; i++) {
+        memcpy(sorted.bytes + sorted.offsets[i], refs[i].key, refs[i].length);
+        sorted.offsets[i + 1] = sorted.offsets[i] + refs[i].length;
+    }
+    free(refs);
+    strset_free(set);
+    *set = sorted;
+}
+
+void strsort_scatter(const string_set_t *all, string_set_t *local, int root, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    // Sur root: clés et octets de chaque part
+    int *sizes = NULL;
+    int *key_counts = NULL, *key_displs = NULL;
+    int *byte_counts = NULL, *byte_displs = NULL;
+    int *lengths = NULL;
+    if (rank == root) {
+        sizes = (int*)malloc(2 * num_procs * sizeof(int));
+        key_counts = (int*)malloc(num_procs * sizeof(int));
+        key_displs = (int*)malloc(num_procs * sizeof(int));
+        byte_counts = (int*)malloc(num_procs * sizeof(int));
+        byte_displs = (int*)malloc(num_procs * sizeof(int));
+        int first = 0;
+        for (int r = 0; r < num_procs; r++) {
+            key_counts[r] = all->count / num_procs + (r < all->count % num_procs ? 1 : 0);
+            key_displs[r] = first;
+            byte_displs[r] = all->offsets[first];
+            byte_counts[r] = all->offsets[first + key_counts[r]] - all->offsets[first];
+            first += key_counts[r];
+            sizes[2 * r] = key_counts[r];
+            sizes[2 * r + 1] = byte_counts[r];
+        }
+        lengths = (int*)malloc((all->count + 1) * sizeof(int));
+        for (int i = 0; i < all->count; i++) {
+            lengths[i] = all->offsets[i + 1] - all->offsets[i];
+        }
+    }
+    
+    int local_sizes[2];
+    TRACED("MPI_Scatter",
+           MPI_Scatter(sizes, 2, MPI_INT, local_sizes, 2, MPI_INT, root, comm));
+    strset_alloc(local, local_sizes[0], local_sizes[1]);
+    
+    int *local_lengths = (int*)malloc((local->count + 1) * sizeof(int));
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(lengths, key_counts, key_displs, MPI_INT,
+                        local_lengths, local->count, MPI_INT, root, comm));
+    offsets_from_lengths(local->offsets, local_lengths, local->count);
+    TRACED("MPI_Scatterv",
+           MPI_Scatterv(rank == root ? all->bytes : NULL, byte_counts, byte_displs, MPI_CHAR,
+                        local->bytes, local_sizes[1], MPI_CHAR, root, comm));
+    
+    free(sizes);
+    free(key_counts);
+    free(key_displs);
+    free(byte_counts);
+    free(byte_displs);
+    free(lengths);
+    free(local_lengths);
+}
+
+/**
+ * Rassemble sur tous les processus les ensembles locaux (MPI_Allgatherv
+ * des longueurs puis des octets), dans l'ordre des rangs
+ */
+static void allgather_set(const string_set_t *local, string_set_t *all, MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    
+    int local_sizes[2] = { local->count, local->offsets[local->count] };
+    int *sizes = (int*)malloc(2 * num_procs * sizeof(int));
+    TRACED("MPI_Allgather",
+           MPI_Allgather(local_sizes, 2, MPI_INT, sizes, 2, MPI_INT, comm));
+    
+    int *key_counts = (int*)malloc(num_procs * sizeof(int));
+    int *key_displs = (int*)malloc(num_procs * sizeof(int));
+    int *byte_counts = (int*)malloc(num_procs * sizeof(int));
+    int *byte_displs = (int*)malloc(num_procs * sizeof(int));
+    int total_keys = 0, total_bytes = 0;
+    for (int r = 0; r < num_procs; r++) {
+        key_counts[r] = sizes[2 * r];
+        byte_counts[r] = sizes[2 * r + 1];
+        key_displs[r] = total_keys;
+        byte_displs[r] = total_bytes;
+        total_keys += key_counts[r];
+        total_bytes += byte_counts[r];
+    }
+    
+    int *local_lengths = (int*)malloc((local->count + 1) * sizeof(int));
+    for (int i = 0; i < local->count; i++) {
+        local_lengths[i] = local->offsets[i + 1] - local->offsets[i];
+    }
+    int *lengths = (int*)malloc((total_keys + 1) * sizeof(int));
+    TRACED("MPI_Allgatherv",
+           MPI_Allgatherv(local_lengths, local->count, MPI_INT,
+                          lengths, key_counts, key_displs, MPI_INT, comm));
+    strset_alloc(all, total_keys, total_bytes);
+    offsets_from_lengths(all->offsets, lengths, total_keys);
+    TRACED("MPI_Allgatherv",
+           MPI_Allgatherv(local->bytes, local_sizes[1], MPI_CHAR,
+                          all->bytes, byte_counts, byte_displs, MPI_CHAR, comm));
+    
+    free(sizes);
+    free(key_counts);
+    free(key_displs);
+    free(byte_counts);
+    free(byte_displs);
+    free(local_lengths);
+    free(lengths);
+}
+
+/**
+ * num_buckets - 1 séparateurs: préfixes (STRSORT_PREFIX octets) d'un
+ * échantillon régulier des clés de chaque processus, triés, pris aux
+ * quantiles de l'échantillon global. Identiques sur tous les processus.
+ */
+static void select_splitters(const string_set_t *local, int num_buckets, string_set_t *splitters,
+                             MPI_Comm comm) {
+    int samples = PARTITION_OVERSAMPLING * num_buckets;
+    if (samples > local->count) samples = local->count;
+    
+    string_set_t sample;
+    strset_alloc(&sample, samples, samples * STRSORT_PREFIX);
+    sample.offsets[0] = 0;
+    for (int i = 0; i < samples; i++) {
+        int k = (int)((long long)i * local->count / samples);
+        int length = local->offsets[k + 1] - local->offsets[k];
+        if (length > STRSORT_PREFIX) length = STRSORT_PREFIX;
+        memcpy(sample.bytes + sample.offsets[i], local->bytes + local->offsets[k], length);
+        sample.offsets[i + 1] = sample.offsets[i] + length;
+    }
+    
+    string_set_t all;
+    allgather_set(&sample, &all, comm);
+    strsort_local(&all);
+    
+    strset_alloc(splitters, num_buckets - 1, (num_buckets - 1) * STRSORT_PREFIX);
+    splitters->offsets[0] = 0;
+    for (int b = 1; b < num_buckets; b++) {
+        int length = 0;
+        if (all.count > 0) {
+            int k = (int)((long long)b * all.count / num_buckets);
+            length = all.offsets[k + 1] - all.offsets[k];
+            memcpy(splitters->bytes + splitters->offsets[b - 1], all.bytes + all.offsets[k],
+                   length);
+        }
+        splitters->offsets[b] = splitters->offsets[b - 1] + length;
+    }
+    
+    strset_free(&sample);
+    strset_free(&all);
+}
+
+/**
+ * Bucket d'une clé: nombre de séparateurs inférieurs ou égaux à son préfixe
+ */
+static int bucket_of(const char *key, int length, const string_set_t *splitters) {
+    if (length > STRSORT_PREFIX) length = STRSORT_PREFIX;
+    int low = 0, high = splitters->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const char *splitter = splitters->bytes + splitters->offsets[mid];
+        int splitter_length = splitters->offsets[mid + 1] - splitters->offsets[mid];
+        if (strsort_compare(splitter, splitter_length, key, length) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+long long strsort_exchange(const string_set_t *local, string_set_t *sorted, MPI_Comm comm) {
+    int num_procs;
+    MPI_Comm_size(comm, &num_procs);
+    
+    // Séparateurs et bucket de chaque clé; send_sizes[2d] clés et
+    // send_sizes[2d + 1] octets pour le processus d
+    double t0 = instr_start();
+    string_set_t splitters;
+    select_splitters(local, num_procs, &splitters, comm);
+    int *bucket_ids = (int*)malloc((local->count + 1) * sizeof(int));
+    int *send_sizes = (int*)calloc(2 * num_procs, sizeof(int));
+    for (int i = 0; i < local->count; i++) {
+        int length = local->offsets[i + 1] - local->offsets[i];
+        int b = bucket_of(local->bytes + local->offsets[i], length, &splitters);
+        bucket_ids[i] = b;
+        send_sizes[2 * b]++;
+        send_sizes[2 * b + 1] += length;
+    }
+    instr_stop(PHASE_CLASSIFY, t0);
+    
+    // Longueurs et octets rangés par bucket dans les buffers d'envoi
+    t0 = instr_start();
+    int *key_counts = (int*)malloc(num_procs * sizeof(int));
+    int *key_displs = (int*)malloc(num_procs * sizeof(int));
+    int *byte_counts = (int*)malloc(num_procs * sizeof(int));
+    int *byte_displs = (int*)malloc(num_procs * sizeof(int));
+    int *key_pos = (int*)malloc(num_procs * sizeof(int));
+    int *byte_pos = (int*)malloc(num_procs * sizeof(int));
+    int total_keys = 0, total_bytes = 0;
+    for (int d = 0; d < num_procs; d++) {
+        key_counts[d] = send_sizes[2 * d];
+        byte_counts[d] = send_sizes[2 * d + 1];
+        key_displs[d] = key_pos[d] = total_keys;
+        byte_displs[d] = byte_pos[d] = total_bytes;
+        total_keys += key_counts[d];
+        total_bytes += byte_counts[d];
+    }
+    int *send_lengths = (int*)malloc((total_keys + 1) * sizeof(int));
+    char *send_bytes = (char*)malloc(total_bytes + 1);
+    for (int i = 0; i < local->count; i++) {
+        int b = bucket_ids[i];
+        int length = local->offsets[i + 1] - local->offsets[i];
+        send_lengths[key_pos[b]++] = length;
+        memcpy(send_bytes + byte_pos[b], local->bytes + local->offsets[i], length);
+        byte_pos[b] += length;
+    }
+    instr_stop(PHASE_PACK, t0);
+    
+    // Tailles (clés et octets) de chaque paire de processus
+    t0 = instr_start();
+    int *recv_sizes = (int*)malloc(2 * num_procs * sizeof(int));
+    TRACED("MPI_Alltoall",
+           MPI_Alltoall(send_sizes, 2, MPI_INT, recv_sizes, 2, MPI_INT, comm));
+    instr_stop(PHASE_COUNT_EXCHANGE, t0);
+    
+    // Longueurs puis octets
+    t0 = instr_start();
+    int *recv_key_counts = (int*)malloc(num_procs * sizeof(int));
+    int *recv_key_displs = (int*)malloc(num_procs * sizeof(int));
+    int *recv_byte_counts = (int*)malloc(num_procs * sizeof(int));
+    int *recv_byte_displs = (int*)malloc(num_procs * sizeof(int));
+    int recv_keys = 0, recv_bytes = 0;
+    for (int s = 0; s < num_procs; s++) {
+        recv_key_counts[s] = recv_sizes[2 * s];
+        recv_byte_counts[s] = recv_sizes[2 * s + 1];
+        recv_key_displs[s] = recv_keys;
+        recv_byte_displs[s] = recv_bytes;
+        recv_keys += recv_key_counts[s];
+        recv_bytes += recv_byte_counts[s];
+    }
+    int *recv_lengths = (int*)malloc((recv_keys + 1) * sizeof(int));
+    TRACED("MPI_Alltoallv",
+           MPI_Alltoallv(send_lengths, key_counts, key_displs, MPI_INT,
+                         recv_lengths, recv_key_counts, recv_key_displs, MPI_INT, comm));
+    strset_alloc(sorted, recv_keys, recv_bytes);
+    offsets_from_lengths(sorted->offsets, recv_lengths, recv_keys);
+    TRACED("MPI_Alltoallv",
+           MPI_Alltoallv(send_bytes, byte_counts, byte_displs, MPI_CHAR,
+                         sorted->bytes, recv_byte_counts, recv_byte_displs, MPI_CHAR, comm));
+    instr_stop(PHASE_DATA_EXCHANGE, t0);
+    
+    long long bytes_sent = (long long)total_bytes + (long long)total_keys * sizeof(int);
+    instr_add_bytes(bytes_sent, (long long)recv_bytes + (long long)recv_keys * sizeof(int));
+    instr_set_bucket_size(recv_keys);
+    
+    // Tri local
+    t0 = instr_start();
+    strsort_local(sorted);
+    instr_stop(PHASE_LOCAL_SORT, t0);
+    
+    strset_free(&splitters);
+    free(bucket_ids);
+    free(send_sizes);
+    free(key_counts);
+    free(key_displs);
+    free(byte_counts);
+    free(byte_displs);
+    free(key_pos);
+    free(byte_pos);
+    free(send_lengths);
+    free(send_bytes);
+    free(recv_sizes);
+    free(recv_key_counts);
+    free(recv_key_displs);
+    free(recv_byte_counts);
+    free(recv_byte_displs);
+    free(recv_lengths);
+    return bytes_sent;
+}
+
+void strsort_gather(const string_set_t *local, string_set_t *all, int root, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    
+    int local_sizes[2] = { local->count, local->offsets[local->count] };
+    int *sizes = NULL;
+    int *key_counts = NULL, *key_displs = NULL;
+    int *byte_counts = NULL, *byte_displs = NULL;
+    int *lengths = NULL;
+    if (rank == root) {
+        sizes = (int*)malloc(2 * num_procs * sizeof(int));
+        key_counts = (int*)malloc(num_procs * sizeof(int));
+        key_displs = (int*)malloc(num_procs * sizeof(int));
+        byte_counts = (int*)malloc(num_procs * sizeof(int));
+        byte_displs = (int*)malloc(num_procs * sizeof(int));
+    }
+    TRACED("MPI_Gather",
+           MPI_Gather(local_sizes, 2, MPI_INT, sizes, 2, MPI_INT, root, comm));
+    
+    if (rank == root) {
+        int total_keys = 0, total_bytes = 0;
+        for (int r = 0; r < num_procs; r++) {
+            key_counts[r] = sizes[2 * r];
+            byte_counts[r] = sizes[2 * r + 1];
+            key_displs[r] = total_keys;
+            byte_displs[r] = total_bytes;
+            total_keys += key_counts[r];
+            total_bytes += byte_counts[r];
+        }
+        strset_alloc(all, total_keys, total_bytes);
+        lengths = (int*)malloc((total_keys + 1) * sizeof(int));
+    }
+    
+    int *local_lengths = (int*)malloc((local->count + 1) * sizeof(int));
+    for (int i = 0; i < local->count; i++) {
+        local_lengths[i] = local->offsets[i + 1] - local->offsets[i];
+    }
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv(local_lengths, local->count, MPI_INT,
+                       lengths, key_counts, key_displs, MPI_INT, root, comm));
+    TRACED("MPI_Gatherv",
+           MPI_Gatherv(local->bytes, local_sizes[1], MPI_CHAR,
+                       rank == root ? all->bytes : NULL, byte_counts, byte_displs, MPI_CHAR,
+                       root, comm));
+    if (rank == root) {
+        offsets_from_lengths(all->offsets, lengths, all->count);
+    }
+    
+    free(sizes);
+    free(key_counts);
+    free(key_displs);
+    free(byte_counts);
+    free(byte_displs);
+    free(lengths);
+    free(local_lengths);
+}
+
+void strsort_checksum(checksum_t *cs, const string_set_t *set) {
+    // Chaque clé compte pour un hachage FNV-1a de ses octets
+    int hashes[STRSORT_HASH_BLOCK];
+    for (int block = 0; block < set->count; block += STRSORT_HASH_BLOCK) {
+        int n = (set->count - block < STRSORT_HASH_BLOCK) ? set->count - block
+                                                          : STRSORT_HASH_BLOCK;
+        for (int i = 0; i < n; i++) {
+            unsigned int h = 2166136261u;
+            for (int b = set->offsets[block + i]; b < set->offsets[block + i + 1]; b++) {
+                h = (h ^ (unsigned char)set->bytes[b]) * 16777619u;
+            }
+            hashes[i] = (int)h;
+        }
+        checksum_add_array(cs, hashes, n);
+    }
+}
+
+int strsort_verify_distributed(const string_set_t *set, MPI_Comm comm) {
+    int local_ok = 1;
+    for (int i = 1; i < set->count && local_ok; i++) {
+        if (strsort_compare(set->bytes + set->offsets[i - 1],
+                            set->offsets[i] - set->offsets[i - 1],
+                            set->bytes + set->offsets[i],
+                            set->offsets[i + 1] - set->offsets[i]) > 0) {
+            local_ok = 0;
+        }
+    }
+    
+    // Première et dernière clés de chaque partie
+    string_set_t ends, all_ends;
+    int n = (set->count > 0) ? 2 : 0;
+    int size = (n > 0) ? (set->offsets[1] + set->offsets[set->count]
+                          - set->offsets[set->count - 1]) : 0;
+    strset_alloc(&ends, n, size);
+    ends.offsets[0] = 0;
+    if (n > 0) {
+        int first = set->offsets[1];
+        int last = set->offsets[set->count] - set->offsets[set->count - 1];
+        memcpy(ends.bytes, set->bytes, first);
+        memcpy(ends.bytes + first, set->bytes + set->offsets[set->count - 1], last);
+        ends.offsets[1] = first;
+        ends.offsets[2] = first + last;
+    }
+    allgather_set(&ends, &all_ends, comm);
+    
+    // Les parties sont dans l'ordre des rangs: chaque dernière clé précède
+    // la première de la partie suivante
+    for (int i = 1; i + 1 < all_ends.count; i += 2) {
+        if (strsort_compare(all_ends.bytes + all_ends.offsets[i],
+                            all_ends.offsets[i + 1] - all_ends.offsets[i],
+                            all_ends.bytes + all_ends.offsets[i + 1],
+                            all_ends.offsets[i + 2] - all_ends.offsets[i + 1]) > 0) {
+            local_ok = 0;
+        }
+    }
+    strset_free(&ends);
+    strset_free(&all_ends);
+    
+    int global_ok;
+    MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, comm);
+    return global_ok;
+}
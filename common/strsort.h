@@ -0,0 +1,105 @@
+/**
+ * Bucket Sort distribué de clés chaînes de longueur variable (--keys=string)
+ *
+ * Les noyaux entiers supposent des clés de 4 octets; ici les clés sont des
+ * suites d'octets quelconques (URL, identifiants composés), comparées dans
+ * l'ordre lexicographique des octets non signés, une clé plus courte
+ * précédant ses prolongements. Le pipeline est celui du tri d'entiers:
+ * - les clés sont rangées dans un format compact: bornes (offsets) et
+ *   octets concaténés, sans terminateur; c'est aussi le format des
+ *   messages (longueurs par MPI_INT, octets par MPI_CHAR);
+ * - les buckets sont définis par p - 1 séparateurs tirés d'un échantillon
+ *   régulier des préfixes de STRSORT_PREFIX octets des clés de tous les
+ *   processus: le bucket d'une clé ne dépend que de son préfixe, ce qui
+ *   reste compatible avec l'ordre complet;
+ * - le tri local est un quicksort multiclé (Bentley-Sedgewick) sur des
+ *   références qui gardent en cache les 8 octets de la clé à la profondeur
+ *   courante: le partitionnement compare des entiers de 64 bits sans
+ *   suivre les pointeurs, et les clés ne sont relues que pour passer aux 8
+ *   octets suivants d'un groupe de préfixe commun.
+ */
+
+#ifndef STRSORT_H
+#define STRSORT_H
+
+#include <stdint.h>
+#include <mpi.h>
+
+#include "verify.h"
+
+// Octets des préfixes échantillonnés (séparateurs)
+#define STRSORT_PREFIX 32
+
+// Taille des groupes triés par insertion
+#define STRSORT_INSERTION_MAX 16
+
+// Nombre de sites distincts des clés générées (tirés selon la distribution)
+#define STRSORT_HOSTS 65536
+
+/**
+ * Ensemble de clés au format compact: la clé i occupe les octets
+ * bytes[offsets[i]] à bytes[offsets[i+1] - 1]
+ */
+typedef struct {
+    int count;          // Nombre de clés
+    int *offsets;       // count + 1 bornes (offsets[0] = 0)
+    char *bytes;        // Octets concaténés, offsets[count] au total
+} string_set_t;
+
+/**
+ * Libère un ensemble (les pointeurs sont remis à NULL)
+ */
+void strset_free(string_set_t *set);
+
+/**
+ * Génère les clés [start, start + count) d'une suite de total_size clés de
+ * type URL: le site suit la distribution dist (workload.h), le chemin est
+ * uniforme. Comme pour les entiers, une clé ne dépend que de la graine et
+ * de sa position globale.
+ */
+void strsort_generate(string_set_t *set, long long start, int count, long long total_size,
+                      int dist, uint64_t seed);
+
+/**
+ * Comparaison lexicographique de deux clés (négatif, nul ou positif)
+ */
+int strsort_compare(const char *a, int length_a, const char *b, int length_b);
+
+/**
+ * Trie un ensemble en place (quicksort multiclé à préfixe en cache)
+ */
+void strsort_local(string_set_t *set);
+
+/**
+ * Partage les clés du processus root en parts de même nombre de clés.
+ * Opération collective.
+ */
+void strsort_scatter(const string_set_t *all, string_set_t *local, int root, MPI_Comm comm);
+
+/**
+ * Étapes 2 à 4: séparateurs échantillonnés, répartition des clés dans les
+ * buckets, échange (tailles par MPI_Alltoall, longueurs et octets par
+ * MPI_Alltoallv) et tri local. Remplit *sorted (partie triée de ce
+ * processus) et retourne le nombre d'octets envoyés. Opération collective.
+ */
+long long strsort_exchange(const string_set_t *local, string_set_t *sorted, MPI_Comm comm);
+
+/**
+ * Rassemble les parties locales, dans l'ordre des rangs, dans *all sur
+ * root. Opération collective.
+ */
+void strsort_gather(const string_set_t *local, string_set_t *all, int root, MPI_Comm comm);
+
+/**
+ * Ajoute les clés à une empreinte (un hachage de chaque clé)
+ */
+void strsort_checksum(checksum_t *cs, const string_set_t *set);
+
+/**
+ * Clés globalement croissantes: ordre de chaque partie et frontières entre
+ * parties non vides (premières et dernières clés échangées par
+ * MPI_Allgatherv). Opération collective.
+ */
+int strsort_verify_distributed(const string_set_t *set, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * Trace chronologique (format Chrome trace / Perfetto)
+ *
+ * Tampons circulaires par thread, recalage des horloges par ping-pong
+ * avec le processus 0 et export JSON fusionné sur le processus 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "trace.h"
+
+// Nombre d'allers-retours pour l'estimation du décalage d'horloge
+#define CLOCK_SYNC_ROUNDS 8
+
+/**
+ * Événement complet ("ph":"X" dans le format Chrome trace)
+ */
+typedef struct {
+    const char *name;
+    double begin;
+    double end;
+} trace_event_t;
+
+/**
+ * Tampon circulaire d'un thread (aligné sur une ligne de cache pour
+ * éviter le faux partage entre threads)
+ */
+typedef struct {
+    trace_event_t *events;
+    long count;                 // Nombre total d'événements enregistrés
+    char padding[48];
+} trace_buffer_t;
+
+int trace_enabled = 0;
+
+static trace_buffer_t *buffers = NULL;
+static int num_buffers = 0;
+static long capacity = TRACE_DEFAULT_CAPACITY;
+static double clock_offset = 0.0;   // Horloge du processus 0 - horloge locale
+static double clock_base = 0.0;     // Origine commune (horloge du processus 0)
+static char trace_path[1024] = "trace.json";
+
+/**
+ * Estime le décalage d'horloge de chaque processus par rapport au
+ * processus 0 (aller-retour de durée minimale, à la manière de NTP)
+ */
+static void sync_clocks(MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+
+    clock_offset = 0.0;
+    for (int r = 1; r < num_procs; r++) {
+        if (rank == 0) {
+            for (int i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+                double ping, now;
+                MPI_Recv(&ping, 1, MPI_DOUBLE, r, 0, comm, MPI_STATUS_IGNORE);
+                now = MPI_Wtime();
+                MPI_Send(&now, 1, MPI_DOUBLE, r, 0, comm);
+            }
+        } else if (rank == r) {
+            double best_rtt = 1e30;
+            for (int i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+                double t1 = MPI_Wtime();
+                double root_time;
+                MPI_Send(&t1, 1, MPI_DOUBLE, 0, 0, comm);
+                MPI_Recv(&root_time, 1, MPI_DOUBLE, 0, 0, comm, MPI_STATUS_IGNORE);
+                double t2 = MPI_Wtime();
+                if (t2 - t1 < best_rtt) {
+                    best_rtt = t2 - t1;
+                    clock_offset = root_time - (t1 + t2) / 2.0;
+                }
+            }
+        }
+    }
+
+    if (rank == 0) {
+        clock_base = MPI_Wtime();
+    }
+    MPI_Bcast(&clock_base, 1, MPI_DOUBLE, 0, comm);
+}
+
+void trace_init(const char *path, MPI_Comm comm) {
+    if (path != NULL) {
+        strncpy(trace_path, path, sizeof(trace_path) - 1);
+    }
+
+    #ifdef _OPENMP
+    num_buffers = omp_get_max_threads();
+    #else
+    num_buffers = 1;
+    #endif
+
+    buffers = (trace_buffer_t*)calloc(num_buffers, sizeof(trace_buffer_t));
+    for (int t = 0; t < num_buffers; t++) {
+        buffers[t].events = (trace_event_t*)malloc(capacity * sizeof(trace_event_t));
+        // Premier contact avec les pages hors de la zone mesurée
+        memset(buffers[t].events, 0, capacity * sizeof(trace_event_t));
+    }
+
+    sync_clocks(comm);
+    trace_enabled = 1;
+}
+
+void trace_record(const char *name, double t0) {
+    int tid = 0;
+    #ifdef _OPENMP
+    tid = omp_get_thread_num();
+    #endif
+    if (tid >= num_buffers) {
+        return;
+    }
+
+    trace_buffer_t *buffer = &buffers[tid];
+    trace_event_t *event = &buffer->events[buffer->count % capacity];
+    event->name = name;
+    event->begin = t0;
+    event->end = MPI_Wtime();
+    buffer->count++;
+}
+
+/**
+ * Ajoute du texte formaté à un tampon extensible
+ */
+static void append(char **text, long *length, long *size, const char *chunk) {
+    long n = (long)strlen(chunk);
+    if (*length + n + 1 > *size) {
+        *size = 2 * (*size) + n + 1;
+        *text = (char*)realloc(*text, *size);
+    }
+    memcpy(*text + *length, chunk, n + 1);
+    *length += n;
+}
+
+void trace_write(MPI_Comm comm) {
+    if (!trace_enabled) {
+        return;
+    }
+    trace_enabled = 0;
+
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+
+    // Sérialisation locale des événements (horloge du processus 0, en µs)
+    long length = 0, size = 1 << 16;
+    char *text = (char*)malloc(size);
+    char line[256];
+    text[0] = '\0';
+
+    snprintf(line, sizeof(line),
+             "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rang %d\"}},\n",
+             rank, rank);
+    append(&text, &length, &size, line);
+
+    long dropped = 0;
+    for (int t = 0; t < num_buffers; t++) {
+        long count = buffers[t].count;
+        long first = (count > capacity) ? count - capacity : 0;
+        dropped += first;
+        for (long e = first; e < count; e++) {
+            trace_event_t *event = &buffers[t].events[e % capacity];
+            double ts = (event->begin + clock_offset - clock_base) * 1e6;
+            double dur = (event->end - event->begin) * 1e6;
+            snprintf(line, sizeof(line),
+                     "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+                     event->name, rank, t, ts, dur);
+            append(&text, &length, &size, line);
+        }
+        free(buffers[t].events);
+    }
+    free(buffers);
+    buffers = NULL;
+
+    // Rassemblement des fragments JSON sur le processus 0
+    int local_length = (int)length;
+    int *lengths = NULL;
+    int *displs = NULL;
+    char *all_text = NULL;
+    long total_dropped = 0;
+
+    if (rank == 0) {
+        lengths = (int*)malloc(num_procs * sizeof(int));
+        displs = (int*)malloc(num_procs * sizeof(int));
+    }
+    MPI_Gather(&local_length, 1, MPI_INT, lengths, 1, MPI_INT, 0, comm);
+    MPI_Reduce(&dropped, &total_dropped, 1, MPI_LONG, MPI_SUM, 0, comm);
+
+    int total_length = 0;
+    if (rank == 0) {
+        for (int r = 0; r < num_procs; r++) {
+            displs[r] = total_length;
+            total_length += lengths[r];
+        }
+        all_text = (char*)malloc(total_length + 1);
+    }
+    MPI_Gatherv(text, local_length, MPI_CHAR,
+                all_text, lengths, displs, MPI_CHAR, 0, comm);
+
+    if (rank == 0) {
+        FILE *file = fopen(trace_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Erreur: impossible d'écrire la trace %s\n", trace_path);
+        } else {
+            fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+            // Suppression de la virgule finale du dernier événement
+            if (total_length >= 2) {
+                total_length -= 2;
+            }
+            fwrite(all_text, 1, total_length, file);
+            fprintf(file, "\n]}\n");
+            fclose(file);
+            printf("Trace écrite: %s", trace_path);
+            if (total_dropped > 0) {
+                printf(" (%ld événements écrasés, augmenter TRACE_DEFAULT_CAPACITY)", total_dropped);
+            }
+            printf("\n");
+        }
+        free(lengths);
+        free(displs);
+        free(all_text);
+    }
+    free(text);
+}
@@ -0,0 +1,67 @@
+/**
+ * Trace chronologique (format Chrome trace / Perfetto)
+ *
+ * Chaque thread enregistre des événements (début, fin, nom) dans un
+ * tampon circulaire préalloué, sans verrou ni allocation pendant la mesure.
+ * En fin d'exécution, les horloges des processus sont recalées sur celle du
+ * processus 0 et tous les événements sont écrits dans un unique fichier JSON
+ * lisible par chrome://tracing ou ui.perfetto.dev.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Nombre d'événements conservés par thread (les plus anciens sont écrasés)
+#define TRACE_DEFAULT_CAPACITY 65536
+
+extern int trace_enabled;
+
+/**
+ * Active la trace: préalloue un tampon par thread OpenMP et estime le
+ * décalage d'horloge de ce processus par rapport au processus 0.
+ * Opération collective.
+ */
+void trace_init(const char *path, MPI_Comm comm);
+
+/**
+ * Enregistre un événement [t0, maintenant] pour le thread courant
+ */
+void trace_record(const char *name, double t0);
+
+/**
+ * Début d'un événement: retourne l'horodatage à passer à trace_end
+ */
+static inline double trace_begin(void) {
+    return trace_enabled ? MPI_Wtime() : 0.0;
+}
+
+/**
+ * Fin d'un événement commencé à t0 (name doit rester valide: littéral)
+ */
+static inline void trace_end(const char *name, double t0) {
+    if (trace_enabled) trace_record(name, t0);
+}
+
+/**
+ * Trace un appel (typiquement MPI) sous le nom donné:
+ *     TRACED("MPI_Alltoallv", MPI_Alltoallv(...));
+ */
+#define TRACED(name, ...) do {              \
+        double trace_t0_ = trace_begin();   \
+        __VA_ARGS__;                        \
+        trace_end(name, trace_t0_);         \
+    } while (0)
+
+/**
+ * Rassemble les événements de tous les processus et écrit le fichier
+ * JSON sur le processus 0. Opération collective.
+ */
+void trace_write(MPI_Comm comm);
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * Choix automatique des stratégies et cache de calibration
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <mpi.h>
+
+#include "tuning.h"
+#include "partition.h"
+#include "exchange.h"
+#include "sort_kernels.h"
+#include "workload.h"
+
+#define LINE_LENGTH 512
+#define CALIBRATION_REPS 3
+#define CALIBRATION_MIN_SIZE 256
+#define CALIBRATION_SEED 12345
+
+// Règle par défaut du Top-K automatique
+#define TUNING_HISTOGRAM_FACTOR 64  // Histogramme si K * p * facteur <= n
+#define TUNING_GATHER_MAX_PROCS 8   // Rassemblement direct jusqu'à 8 processus
+
+static const char *topk_names[NUM_TOPK_METHODS] = { "gather", "tree", "histogram" };
+
+// Étendues relatives essayées pour le tri par comptage
+static const double counting_ratios[] = { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0 };
+#define NUM_RATIOS (int)(sizeof(counting_ratios) / sizeof(counting_ratios[0]))
+
+/**
+ * Entrée du cache (une ligne du fichier)
+ */
+typedef struct {
+    char host[64];
+    char program[64];
+    int num_procs;
+    int num_threads;
+    int size_class;
+    int k_class;
+    char partition[16];
+    char local_sort[16];
+    char topk_method[16];
+    double sample_imbalance;
+    int radix_min_size;
+    double counting_max_ratio;
+} tuning_entry_t;
+
+void strategy_init(strategy_t *strategy, int partition, int local_sort, int topk_method) {
+    strategy->partition = partition;
+    strategy->local_sort = local_sort;
+    strategy->topk_method = topk_method;
+    strategy->exchange = -1;
+    strategy->sample_imbalance = TUNING_DEFAULT_IMBALANCE;
+    strategy->radix_min_size = TUNING_DEFAULT_RADIX_MIN;
+    strategy->counting_max_ratio = TUNING_DEFAULT_COUNTING_RATIO;
+    strategy->sparse_density = TUNING_DEFAULT_SPARSE_DENSITY;
+}
+
+int topk_method_parse(const char *name) {
+    for (int m = 0; m < NUM_TOPK_METHODS; m++) {
+        if (strcmp(name, topk_names[m]) == 0) {
+            return m;
+        }
+    }
+    return -1;
+}
+
+const char *topk_method_name(int method) {
+    return (method >= 0 && method < NUM_TOPK_METHODS) ? topk_names[method] : "?";
+}
+
+int strategy_parse_choice(const char *name, int (*parse)(const char *)) {
+    return strcmp(name, "auto") == 0 ? STRATEGY_AUTO : parse(name);
+}
+
+const char *strategy_choice_name(int choice, const char *(*name_of)(int)) {
+    return choice == STRATEGY_AUTO ? "auto" : name_of(choice);
+}
+
+int strategy_choose_partition(const strategy_t *strategy, double imbalance) {
+    if (strategy->partition != STRATEGY_AUTO) {
+        return strategy->partition;
+    }
+    return imbalance > strategy->sample_imbalance ? PARTITION_SAMPLE : PARTITION_RANGE;
+}
+
+int strategy_choose_exchange(const strategy_t *strategy, double density) {
+    if (strategy->exchange != STRATEGY_AUTO) {
+        return strategy->exchange;
+    }
+    return density <= strategy->sparse_density ? EXCHANGE_SPARSE : EXCHANGE_DENSE;
+}
+
+int strategy_choose_local_sort(const strategy_t *strategy, int size, int min_value,
+                               int max_value) {
+    if (strategy->local_sort != STRATEGY_AUTO) {
+        return strategy->local_sort;
+    }
+    double span = (double)max_value - min_value + 1.0;
+    if (size > 0 && span <= strategy->counting_max_ratio * size) {
+        return SORT_COUNTING;
+    }
+    return size >= strategy->radix_min_size ? SORT_RADIX : SORT_QSORT;
+}
+
+int strategy_choose_topk(const strategy_t *strategy, long long total_size, int k,
+                         int num_procs) {
+    if (strategy->topk_method != STRATEGY_AUTO) {
+        return strategy->topk_method;
+    }
+    if ((long long)k * num_procs * TUNING_HISTOGRAM_FACTOR <= total_size) {
+        return TOPK_HISTOGRAM;
+    }
+    return num_procs <= TUNING_GATHER_MAX_PROCS ? TOPK_GATHER : TOPK_TREE;
+}
+
+int strategy_sort(const strategy_t *strategy, int *arr, int size) {
+    if (size < 2) {
+        return SORT_QSORT;
+    }
+    
+    int min_value = arr[0], max_value = arr[0];
+    if (strategy->local_sort == STRATEGY_AUTO || strategy->local_sort == SORT_COUNTING) {
+        for (int i = 1; i < size; i++) {
+            if (arr[i] < min_value) min_value = arr[i];
+            if (arr[i] > max_value) max_value = arr[i];
+        }
+    }
+    
+    int kernel = strategy_choose_local_sort(strategy, size, min_value, max_value);
+    if (kernel == SORT_COUNTING) {
+        sort_counting(arr, size, min_value, max_value);
+    } else {
+        sort_local(arr, size, kernel);
+    }
+    return kernel;
+}
+
+int tuning_size_class(long long n) {
+    int size_class = 0;
+    while (n > 1) {
+        n >>= 1;
+        size_class++;
+    }
+    return size_class;
+}
+
+/**
+ * Classe de K (0 pour les programmes de tri)
+ */
+static int k_class(int k) {
+    return k > 0 ? tuning_size_class(k) + 1 : 0;
+}
+
+/**
+ * Clé de la configuration courante
+ */
+static void make_key(tuning_entry_t *entry, const char *program, int num_procs,
+                     int num_threads, long long total_size, int k) {
+    memset(entry, 0, sizeof(*entry));
+    if (gethostname(entry->host, sizeof(entry->host) - 1) != 0 || entry->host[0] == '\0') {
+        strcpy(entry->host, "localhost");
+    }
+    // Un espace dans le nom d'hôte casserait le format du fichier
+    for (char *c = entry->host; *c; c++) {
+        if (*c == ' ') *c = '_';
+    }
+    strncpy(entry->program, program, sizeof(entry->program) - 1);
+    entry->num_procs = num_procs;
+    entry->num_threads = num_threads;
+    entry->size_class = tuning_size_class(total_size);
+    entry->k_class = k_class(k);
+}
+
+static int parse_entry(const char *line, tuning_entry_t *entry) {
+    if (line[0] == '#') {
+        return 0;
+    }
+    return sscanf(line, "%63s %63s %d %d %d %d %15s %15s %15s %lf %d %lf",
+                  entry->host, entry->program, &entry->num_procs, &entry->num_threads,
+                  &entry->size_class, &entry->k_class, entry->partition, entry->local_sort,
+                  entry->topk_method, &entry->sample_imbalance, &entry->radix_min_size,
+                  &entry->counting_max_ratio) == 12;
+}
+
+static int same_config(const tuning_entry_t *a, const tuning_entry_t *b) {
+    return strcmp(a->host, b->host) == 0 && strcmp(a->program, b->program) == 0
+        && a->num_procs == b->num_procs && a->num_threads == b->num_threads
+        && a->k_class == b->k_class;
+}
+
+/**
+ * Nom d'un choix dans le cache ("-" si le programme ne l'utilise pas)
+ */
+static const char *stored_choice(int choice, const char *(*name_of)(int)) {
+    return choice == -1 ? "-" : strategy_choice_name(choice, name_of);
+}
+
+/**
+ * Applique un choix du cache si le choix courant est automatique
+ */
+static void apply_choice(int *choice, const char *name, int (*parse)(const char *)) {
+    if (*choice != STRATEGY_AUTO) {
+        return;
+    }
+    int value = strategy_parse_choice(name, parse);
+    if (value != -1) {
+        *choice = value;
+    }
+}
+
+int tuning_load(const char *path, const char *program, int num_procs, int num_threads,
+                long long total_size, int k, strategy_t *strategy, MPI_Comm comm) {
+    int rank, found = 0;
+    MPI_Comm_rank(comm, &rank);
+    
+    if (rank == 0) {
+        FILE *file = fopen(path, "r");
+        if (file != NULL) {
+            tuning_entry_t key, entry, best;
+            make_key(&key, program, num_procs, num_threads, total_size, k);
+            int best_distance = INT_MAX;
+            char line[LINE_LENGTH];
+            
+            // Classe de taille exacte, sinon la plus proche
+            while (fgets(line, sizeof(line), file) != NULL) {
+                if (!parse_entry(line, &entry) || !same_config(&key, &entry)) {
+                    continue;
+                }
+                int distance = abs(entry.size_class - key.size_class);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = entry;
+                }
+            }
+            fclose(file);
+            
+            if (best_distance != INT_MAX) {
+                found = 1;
+                apply_choice(&strategy->partition, best.partition, partition_parse);
+                apply_choice(&strategy->local_sort, best.local_sort, sort_kernel_parse);
+                apply_choice(&strategy->topk_method, best.topk_method, topk_method_parse);
+                strategy->sample_imbalance = best.sample_imbalance;
+                strategy->radix_min_size = best.radix_min_size;
+                strategy->counting_max_ratio = best.counting_max_ratio;
+            }
+        }
+    }
+    
+    MPI_Bcast(&found, 1, MPI_INT, 0, comm);
+    MPI_Bcast(strategy, sizeof(*strategy), MPI_BYTE, 0, comm);
+    return found;
+}
+
+void tuning_store(const char *path, const char *program, int num_procs, int num_threads,
+                  long long total_size, int k, const strategy_t *strategy, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank != 0) {
+        return;
+    }
+    
+    tuning_entry_t key;
+    make_key(&key, program, num_procs, num_threads, total_size, k);
+    
+    // Relecture du cache en omettant l'ancienne entrée de cette configuration
+    char *kept = NULL;
+    size_t kept_length = 0;
+    FILE *file = fopen(path, "r");
+    if (file != NULL) {
+        char line[LINE_LENGTH];
+        tuning_entry_t entry;
+        while (fgets(line, sizeof(line), file) != NULL) {
+            if (line[0] == '#'
+                || (parse_entry(line, &entry) && same_config(&key, &entry)
+                    && entry.size_class == key.size_class)) {
+                continue;
+            }
+            size_t n = strlen(line);
+            kept = (char*)realloc(kept, kept_length + n + 1);
+            memcpy(kept + kept_length, line, n + 1);
+            kept_length += n;
+        }
+        fclose(file);
+    }
+    
+    file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Erreur: impossible d'écrire le cache %s\n", path);
+        free(kept);
+        return;
+    }
+    fprintf(file, "# hote programme procs threads classe_taille classe_k partition "
+                  "tri_local topk seuil_desequilibre radix_min ratio_comptage\n");
+    if (kept != NULL) {
+        fputs(kept, file);
+    }
+    fprintf(file, "%s %s %d %d %d %d %s %s %s %.3f %d %.2f\n",
+            key.host, key.program, key.num_procs, key.num_threads, key.size_class, key.k_class,
+            stored_choice(strategy->partition, partition_name),
+            stored_choice(strategy->local_sort, sort_kernel_name),
+            stored_choice(strategy->topk_method, topk_method_name),
+            strategy->sample_imbalance, strategy->radix_min_size, strategy->counting_max_ratio);
+    fclose(file);
+    free(kept);
+}
+
+/**
+ * Meilleur temps de tri de source (size éléments) avec un noyau
+ */
+static double time_kernel(const int *source, int *work, int size, int kernel) {
+    double best = 1e30;
+    for (int rep = 0; rep < CALIBRATION_REPS; rep++) {
+        memcpy(work, source, size * sizeof(int));
+        double t0 = MPI_Wtime();
+        sort_local(work, size, kernel);
+        double elapsed = MPI_Wtime() - t0;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+void tuning_calibrate_local_sort(strategy_t *strategy, int max_size, MPI_Comm comm) {
+    if (max_size < CALIBRATION_MIN_SIZE) {
+        max_size = CALIBRATION_MIN_SIZE;
+    }
+    int num_sizes = 0;
+    for (long long s = CALIBRATION_MIN_SIZE; s <= max_size; s *= 4) {
+        num_sizes++;
+    }
+    
+    // Temps par taille (qsort, radix) puis par étendue (comptage, meilleur
+    // des deux autres) sur la plus grande taille
+    int num_times = 2 * num_sizes + 2 * NUM_RATIOS;
+    double *local_times = (double*)malloc(num_times * sizeof(double));
+    double *times = (double*)malloc(num_times * sizeof(double));
+    int *source = (int*)malloc(max_size * sizeof(int));
+    int *work = (int*)malloc(max_size * sizeof(int));
+    
+    int size = CALIBRATION_MIN_SIZE;
+    for (int s = 0; s < num_sizes; s++, size *= 4) {
+        workload_generate(source, 0, size, size, 1 << 30, DIST_UNIFORM, CALIBRATION_SEED);
+        local_times[2*s] = time_kernel(source, work, size, SORT_QSORT);
+        local_times[2*s+1] = time_kernel(source, work, size, SORT_RADIX);
+    }
+    
+    int largest = size / 4;
+    for (int r = 0; r < NUM_RATIOS; r++) {
+        int span = (int)(counting_ratios[r] * largest);
+        if (span < 1) span = 1;
+        workload_generate(source, 0, largest, largest, span, DIST_UNIFORM, CALIBRATION_SEED);
+        double t_qsort = time_kernel(source, work, largest, SORT_QSORT);
+        double t_radix = time_kernel(source, work, largest, SORT_RADIX);
+        local_times[2*num_sizes + 2*r] = time_kernel(source, work, largest, SORT_COUNTING);
+        local_times[2*num_sizes + 2*r + 1] = t_qsort < t_radix ? t_qsort : t_radix;
+    }
+    
+    // Le processus le plus lent fixe les seuils (identiques partout)
+    MPI_Allreduce(local_times, times, num_times, MPI_DOUBLE, MPI_MAX, comm);
+    
+    // Plus petite taille à partir de laquelle le tri par base l'emporte
+    strategy->radix_min_size = INT_MAX;
+    size = CALIBRATION_MIN_SIZE << (2 * (num_sizes - 1));
+    for (int s = num_sizes - 1; s >= 0; s--, size /= 4) {
+        if (times[2*s+1] >= times[2*s]) break;
+        strategy->radix_min_size = size;
+    }
+    
+    // Plus grande étendue relative pour laquelle le comptage l'emporte
+    strategy->counting_max_ratio = 0.0;
+    for (int r = 0; r < NUM_RATIOS; r++) {
+        if (times[2*num_sizes + 2*r] >= times[2*num_sizes + 2*r + 1]) break;
+        strategy->counting_max_ratio = counting_ratios[r];
+    }
+    
+    free(local_times);
+    free(times);
+    free(source);
+    free(work);
+}
+
+double tuning_fit_imbalance(double range_time, double range_imbalance, double sample_time) {
+    if (range_time <= 0.0 || range_imbalance <= 0.0) {
+        return TUNING_DEFAULT_IMBALANCE;
+    }
+    double per_unit = range_time / range_imbalance;
+    double threshold = sample_time / per_unit;
+    if (threshold < 1.0) threshold = 1.0;
+    return threshold;
+}
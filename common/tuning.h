@@ -0,0 +1,153 @@
+/**
+ * Choix automatique des stratégies et cache de calibration
+ *
+ * Plusieurs variantes existent pour chaque étape:
+ * - partitionnement du Bucket Sort: intervalles de même largeur ou
+ *   séparateurs échantillonnés (partition.h);
+ * - tri local: qsort, tri par base ou tri par comptage (sort_kernels.h);
+ * - échange des buckets: dense ou creux selon la densité des paires non
+ *   vides (exchange.h);
+ * - Top-K: rassemblement sur le processus 0, arbre de réduction ou seuil
+ *   par histogramme global.
+ *
+ * --tune mesure ces variantes sur la machine courante (balayages courts),
+ * en déduit des seuils de coût simples et les enregistre dans un fichier
+ * texte indexé par hôte, programme, nombre de processus et de threads,
+ * classe de taille (log2 n) et classe de K. --strategy=auto relit ce
+ * fichier au démarrage; sans entrée correspondante, les seuils par défaut
+ * ci-dessous sont utilisés.
+ */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <mpi.h>
+
+// Choix laissé à la stratégie automatique (les fonctions *_parse
+// retournent -1 pour un nom inconnu)
+#define STRATEGY_AUTO -2
+
+// Méthodes du Top-K (--topk-method=nom)
+#define TOPK_GATHER    0    // Rassemblement des K locaux sur le processus 0
+#define TOPK_TREE      1    // Fusion en arbre binaire (log2 p étapes)
+#define TOPK_HISTOGRAM 2    // Seuil par histogramme global, puis candidats
+#define NUM_TOPK_METHODS 3
+
+#define TUNING_DEFAULT_FILE "tuning_cache.txt"
+
+// Seuils par défaut (sans calibration)
+#define TUNING_DEFAULT_IMBALANCE      1.5   // Déséquilibre justifiant l'échantillonnage
+#define TUNING_DEFAULT_RADIX_MIN      4096  // Taille minimale pour le tri par base
+#define TUNING_DEFAULT_COUNTING_RATIO 2.0   // Étendue / taille maximale du tri par comptage
+#define TUNING_DEFAULT_SPARSE_DENSITY 0.25  // Densité maximale pour l'échange creux
+
+/**
+ * Stratégie d'exécution: choix explicites ou STRATEGY_AUTO (-1 pour un
+ * choix que le programme n'utilise pas), et seuils utilisés pour résoudre
+ * les choix automatiques
+ */
+typedef struct {
+    int partition;              // PARTITION_* ou STRATEGY_AUTO
+    int local_sort;             // SORT_* ou STRATEGY_AUTO
+    int topk_method;            // TOPK_* ou STRATEGY_AUTO
+    int exchange;               // EXCHANGE_* ou STRATEGY_AUTO
+    double sample_imbalance;    // Échantillonnage si max/moyenne dépasse ce seuil
+    int radix_min_size;         // Tri par base à partir de cette taille
+    double counting_max_ratio;  // Tri par comptage si étendue <= ratio * taille
+    double sparse_density;      // Échange creux si la densité ne dépasse pas ce seuil
+} strategy_t;
+
+/**
+ * Stratégie avec les choix donnés et les seuils par défaut (échange non
+ * utilisé: les programmes de tri le fixent ensuite)
+ */
+void strategy_init(strategy_t *strategy, int partition, int local_sort, int topk_method);
+
+/**
+ * Numéro de la méthode de Top-K à partir de son nom (-1 si inconnu)
+ */
+int topk_method_parse(const char *name);
+
+/**
+ * Nom de la méthode de Top-K
+ */
+const char *topk_method_name(int method);
+
+/**
+ * Lit un choix: "auto" (STRATEGY_AUTO) ou un nom reconnu par parse
+ */
+int strategy_parse_choice(const char *name, int (*parse)(const char *));
+
+/**
+ * Nom d'un choix ("auto" ou nom donné par name_of)
+ */
+const char *strategy_choice_name(int choice, const char *(*name_of)(int));
+
+/**
+ * Partitionnement à utiliser compte tenu du déséquilibre des intervalles
+ */
+int strategy_choose_partition(const strategy_t *strategy, double imbalance);
+
+/**
+ * Mode d'échange compte tenu de la densité des paires non vides
+ */
+int strategy_choose_exchange(const strategy_t *strategy, double density);
+
+/**
+ * Noyau de tri local pour un bucket de taille size dont les valeurs sont
+ * comprises entre min_value et max_value
+ */
+int strategy_choose_local_sort(const strategy_t *strategy, int size, int min_value,
+                               int max_value);
+
+/**
+ * Méthode de Top-K: choix explicite, sinon règle par défaut (histogramme
+ * si K est petit devant n/p, rassemblement direct pour peu de processus,
+ * arbre au-delà)
+ */
+int strategy_choose_topk(const strategy_t *strategy, long long total_size, int k,
+                         int num_procs);
+
+/**
+ * Trie arr en ordre croissant avec le noyau choisi par la stratégie.
+ * Retourne le noyau utilisé.
+ */
+int strategy_sort(const strategy_t *strategy, int *arr, int size);
+
+/**
+ * Classe de taille d'un problème (partie entière de log2 n)
+ */
+int tuning_size_class(long long n);
+
+/**
+ * Complète les choix automatiques et les seuils de strategy avec l'entrée
+ * du cache correspondant à cette configuration (classe de taille la plus
+ * proche). Lu par le processus 0 puis diffusé. Retourne 1 si une entrée a
+ * été trouvée. Opération collective.
+ */
+int tuning_load(const char *path, const char *program, int num_procs, int num_threads,
+                long long total_size, int k, strategy_t *strategy, MPI_Comm comm);
+
+/**
+ * Enregistre (ou remplace) l'entrée de cette configuration dans le cache.
+ * Écrit par le processus 0.
+ */
+void tuning_store(const char *path, const char *program, int num_procs, int num_threads,
+                  long long total_size, int k, const strategy_t *strategy, MPI_Comm comm);
+
+/**
+ * Calibre radix_min_size et counting_max_ratio par balayage des tailles
+ * (jusqu'à max_size) et des étendues. Temps maximal sur les processus.
+ * Opération collective.
+ */
+void tuning_calibrate_local_sort(strategy_t *strategy, int max_size, MPI_Comm comm);
+
+/**
+ * Seuil de déséquilibre à partir d'une mesure de chaque partitionnement:
+ * le coût des intervalles est supposé proportionnel à la taille du plus
+ * gros bucket (t = a * I), le surcoût de l'échantillonnage est fixe.
+ * L'échantillonnage devient rentable au-delà de I* = t_sample / a.
+ */
+double tuning_fit_imbalance(double range_time, double range_imbalance, double sample_time);
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * Vérification distribuée des résultats
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "verify.h"
+
+#define NUM_SUMS 3
+
+/**
+ * Hachage d'une clé (fonction de mélange de SplitMix64)
+ */
+static inline unsigned long long hash_key(int key) {
+    unsigned long long z = (unsigned long long)(unsigned int)key + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void checksum_init(checksum_t *cs) {
+    cs->count = 0;
+    cs->sum = 0;
+    cs->hash_sum = 0;
+    cs->hash_xor = 0;
+}
+
+void checksum_add_array(checksum_t *cs, const int *arr, int size) {
+    unsigned long long sum = 0, hash_sum = 0, hash_xor = 0;
+    for (int i = 0; i < size; i++) {
+        unsigned long long h = hash_key(arr[i]);
+        sum += (unsigned long long)(long long)arr[i];
+        hash_sum += h;
+        hash_xor ^= h;
+    }
+    cs->count += size;
+    cs->sum += sum;
+    cs->hash_sum += hash_sum;
+    cs->hash_xor ^= hash_xor;
+}
+
+void checksum_add_pairs(checksum_t *cs, const key_count_t *pairs, int size) {
+    for (int i = 0; i < size; i++) {
+        unsigned long long h = hash_key(pairs[i].key);
+        unsigned long long count = (unsigned long long)pairs[i].count;
+        cs->count += count;
+        cs->sum += count * (unsigned long long)(long long)pairs[i].key;
+        cs->hash_sum += count * h;
+        // Un hachage répété un nombre pair de fois s'annule
+        if (count & 1) {
+            cs->hash_xor ^= h;
+        }
+    }
+}
+
+int checksum_equal(const checksum_t *before, const checksum_t *after, MPI_Comm comm) {
+    unsigned long long local_sums[2 * NUM_SUMS] = {
+        before->count, before->sum, before->hash_sum,
+        after->count, after->sum, after->hash_sum
+    };
+    unsigned long long local_xor[2] = { before->hash_xor, after->hash_xor };
+    unsigned long long sums[2 * NUM_SUMS];
+    unsigned long long xors[2];
+    
+    MPI_Allreduce(local_sums, sums, 2 * NUM_SUMS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    MPI_Allreduce(local_xor, xors, 2, MPI_UNSIGNED_LONG_LONG, MPI_BXOR, comm);
+    
+    for (int i = 0; i < NUM_SUMS; i++) {
+        if (sums[i] != sums[NUM_SUMS + i]) return 0;
+    }
+    return xors[0] == xors[1];
+}
+
+/**
+ * Frontières entre processus: la première clé locale doit suivre la plus
+ * grande clé des processus précédents (les processus vides sont ignorés)
+ */
+static int check_boundaries(int local_ok, int size, int first, int last, int strict,
+                            MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    int local_last = (size > 0) ? last : INT_MIN;
+    int previous_max = INT_MIN;
+    MPI_Exscan(&local_last, &previous_max, 1, MPI_INT, MPI_MAX, comm);
+    if (rank == 0) {
+        // Résultat de MPI_Exscan indéfini sur le premier processus
+        previous_max = INT_MIN;
+    }
+    
+    if (size > 0 && previous_max != INT_MIN) {
+        if (strict ? first <= previous_max : first < previous_max) {
+            local_ok = 0;
+        }
+    }
+    
+    int global_ok;
+    MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, comm);
+    return global_ok;
+}
+
+int verify_sorted_distributed(const int *local, int size, int strict, MPI_Comm comm) {
+    int local_ok = 1;
+    for (int i = 1; i < size; i++) {
+        if (strict ? local[i] <= local[i-1] : local[i] < local[i-1]) {
+            local_ok = 0;
+            break;
+        }
+    }
+    return check_boundaries(local_ok, size, size > 0 ? local[0] : 0,
+                            size > 0 ? local[size-1] : 0, strict, comm);
+}
+
+int verify_pairs_distributed(const key_count_t *local, int size, MPI_Comm comm) {
+    int local_ok = 1;
+    for (int i = 0; i < size; i++) {
+        if (local[i].count <= 0 || (i > 0 && local[i].key <= local[i-1].key)) {
+            local_ok = 0;
+            break;
+        }
+    }
+    return check_boundaries(local_ok, size, size > 0 ? local[0].key : 0,
+                            size > 0 ? local[size-1].key : 0, 1, comm);
+}
+
+int verify_segments_distributed(const int *local, const int *offsets, int num_segments,
+                                MPI_Comm comm) {
+    int local_ok = 1;
+    for (int s = 0; s < num_segments && local_ok; s++) {
+        for (int i = offsets[s] + 1; i < offsets[s+1]; i++) {
+            if (local[i] < local[i-1]) {
+                local_ok = 0;
+                break;
+            }
+        }
+    }
+    int global_ok;
+    MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, comm);
+    return global_ok;
+}
+
+void topk_tally_init(topk_tally_t *tally, const int *topk, int k, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    tally->kth = 0;
+    if (rank == root && k > 0) {
+        tally->kth = topk[k-1];
+    }
+    MPI_Bcast(&tally->kth, 1, MPI_INT, root, comm);
+    checksum_init(&tally->greater);
+    tally->at_least = 0;
+}
+
+void topk_tally_add(topk_tally_t *tally, const int *values, int count) {
+    int kth = tally->kth;
+    for (int i = 0; i < count; i++) {
+        if (values[i] > kth) {
+            checksum_add_array(&tally->greater, &values[i], 1);
+        }
+        if (values[i] >= kth) {
+            tally->at_least++;
+        }
+    }
+}
+
+int topk_tally_check(const topk_tally_t *tally, const int *topk, int k, int root,
+                     MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Ordre décroissant et empreinte des valeurs > kth du résultat (root)
+    int ok = 1;
+    checksum_t topk_greater;
+    checksum_init(&topk_greater);
+    if (rank == root && k > 0) {
+        for (int i = 0; i < k; i++) {
+            if (i > 0 && topk[i] > topk[i-1]) ok = 0;
+            if (topk[i] > tally->kth) checksum_add_array(&topk_greater, &topk[i], 1);
+        }
+    }
+    
+    long long at_least = 0;
+    MPI_Allreduce(&tally->at_least, &at_least, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (k > 0 && at_least < k) ok = 0;
+    
+    // L'empreinte du Top-K n'est comptée que sur root
+    if (!checksum_equal(&tally->greater, &topk_greater, comm)) ok = 0;
+    
+    MPI_Bcast(&ok, 1, MPI_INT, root, comm);
+    return ok;
+}
+
+int verify_topk_distributed(const int *local_data, int local_size,
+                            const int *topk, int k, int root, MPI_Comm comm) {
+    topk_tally_t tally;
+    topk_tally_init(&tally, topk, k, root, comm);
+    topk_tally_add(&tally, local_data, local_size);
+    return topk_tally_check(&tally, topk, k, root, comm);
+}
+
+int verify_argtopk_distributed(const int *local_data, const int *payload, int local_size,
+                               const topk_entry_t *entries, int k, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    
+    // Valeurs seules: mêmes contrôles que le Top-K classique
+    int *values = NULL;
+    int ok = 1;
+    if (rank == root) {
+        values = (int*)malloc((k + 1) * sizeof(int));
+        for (int i = 0; i < k; i++) {
+            values[i] = entries[i].value;
+            if (i > 0 && !topk_entry_before(&entries[i-1], &entries[i])) ok = 0;
+        }
+    }
+    if (!verify_topk_distributed(local_data, local_size, values, k, root, comm)) ok = 0;
+    free(values);
+    
+    // Les entrées sont diffusées: chacun contrôle les indices qu'il possède
+    MPI_Datatype entry_type = topk_entry_type();
+    topk_entry_t *all = (topk_entry_t*)malloc((k + 1) * sizeof(topk_entry_t));
+    if (rank == root) {
+        memcpy(all, entries, k * sizeof(topk_entry_t));
+    }
+    MPI_Bcast(all, k, entry_type, root, comm);
+    MPI_Type_free(&entry_type);
+    
+    long long local_size_ll = local_size;
+    long long first = 0;
+    MPI_Exscan(&local_size_ll, &first, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) {
+        first = 0;
+    }
+    
+    // Ex aequo de la K-ième valeur: nombre et plus grand indice retenu
+    int kth = (k > 0) ? all[k-1].value : 0;
+    long long ties = 0, last_tie = -1;
+    for (int i = 0; i < k; i++) {
+        if (all[i].value == kth) {
+            ties++;
+            last_tie = all[i].index;
+        }
+    }
+    
+    long long counts[2] = { 0, 0 };     // Indices possédés, ex aequo d'indice <= last_tie
+    for (int i = 0; i < k; i++) {
+        long long local_index = all[i].index - first;
+        if (local_index < 0 || local_index >= local_size) continue;
+        counts[0]++;
+        if (local_data[local_index] != all[i].value
+            || (payload != NULL && payload[local_index] != all[i].payload)) {
+            ok = 0;
+        }
+    }
+    for (int i = 0; i < local_size && first + i <= last_tie; i++) {
+        if (local_data[i] == kth) counts[1]++;
+    }
+    free(all);
+    
+    long long totals[2];
+    MPI_Allreduce(counts, totals, 2, MPI_LONG_LONG, MPI_SUM, comm);
+    if (totals[0] != k || totals[1] != ties) ok = 0;
+    
+    int global_ok;
+    MPI_Allreduce(&ok, &global_ok, 1, MPI_INT, MPI_LAND, comm);
+    return global_ok;
+}
+
+int verify_quantiles_distributed(const int *local_data, int local_size, const long long *ranks,
+                                 const int *values, int num_ranks, MPI_Comm comm) {
+    // Par requête: éléments < valeur, puis éléments <= valeur
+    long long *local_counts = (long long*)calloc(2 * num_ranks + 1, sizeof(long long));
+    long long *counts = (long long*)malloc((2 * num_ranks + 1) * sizeof(long long));
+    for (int i = 0; i < local_size; i++) {
+        for (int q = 0; q < num_ranks; q++) {
+            if (local_data[i] < values[q]) local_counts[2 * q]++;
+            if (local_data[i] <= values[q]) local_counts[2 * q + 1]++;
+        }
+    }
+    MPI_Allreduce(local_counts, counts, 2 * num_ranks, MPI_LONG_LONG, MPI_SUM, comm);
+    
+    int ok = 1;
+    for (int q = 0; q < num_ranks; q++) {
+        if (counts[2 * q] > ranks[q] || counts[2 * q + 1] <= ranks[q]) ok = 0;
+    }
+    free(local_counts);
+    free(counts);
+    return ok;
+}
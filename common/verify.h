@@ -0,0 +1,133 @@
+/**
+ * Vérification distribuée des résultats (O(n/p) par processus)
+ *
+ * Au lieu de rassembler et de parcourir tout le tableau sur le processus 0:
+ * - chaque processus vérifie l'ordre de sa partie, et la frontière avec les
+ *   processus précédents est contrôlée par un MPI_Exscan du maximum;
+ * - une empreinte du multi-ensemble des clés, indépendante de l'ordre
+ *   (nombre, somme, somme et xor d'un hachage), est comparée avant et après
+ *   le tri par MPI_Allreduce;
+ * - pour le Top-K, le nombre global d'éléments supérieurs à la K-ième valeur
+ *   est compté de manière distribuée;
+ * - pour les quantiles, le rang de chaque valeur est encadré par les nombres
+ *   globaux d'éléments strictement inférieurs et inférieurs ou égaux.
+ * Toutes les fonctions sont collectives et retournent le même verdict sur
+ * chaque processus.
+ */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <mpi.h>
+
+#include "dedup.h"
+#include "argtopk.h"
+
+/**
+ * Empreinte d'un multi-ensemble de clés (indépendante de l'ordre)
+ */
+typedef struct {
+    unsigned long long count;       // Nombre de clés
+    unsigned long long sum;         // Somme des clés (modulo 2^64)
+    unsigned long long hash_sum;    // Somme des hachages (modulo 2^64)
+    unsigned long long hash_xor;    // Xor des hachages
+} checksum_t;
+
+/**
+ * Empreinte vide
+ */
+void checksum_init(checksum_t *cs);
+
+/**
+ * Ajoute les clés d'un tableau
+ */
+void checksum_add_array(checksum_t *cs, const int *arr, int size);
+
+/**
+ * Ajoute des paires (clé, nombre d'occurrences): chaque clé compte
+ * autant de fois que son nombre d'occurrences
+ */
+void checksum_add_pairs(checksum_t *cs, const key_count_t *pairs, int size);
+
+/**
+ * Compare les empreintes globales (réduites sur comm) avant et après
+ */
+int checksum_equal(const checksum_t *before, const checksum_t *after, MPI_Comm comm);
+
+/**
+ * Tableau globalement croissant: parties locales triées et frontières
+ * ordonnées dans l'ordre des rangs (strict: sans doublon)
+ */
+int verify_sorted_distributed(const int *local, int size, int strict, MPI_Comm comm);
+
+/**
+ * Paires globalement triées par clé strictement croissante
+ */
+int verify_pairs_distributed(const key_count_t *local, int size, MPI_Comm comm);
+
+/**
+ * Chaque segment local [offsets[s], offsets[s+1]) est croissant (aucun
+ * ordre entre segments ni entre processus)
+ */
+int verify_segments_distributed(const int *local, const int *offsets, int num_segments,
+                                MPI_Comm comm);
+
+/**
+ * Vérifie les K plus grandes valeurs topk (décroissantes, connues du
+ * processus root) à partir des données locales de chaque processus:
+ * mêmes éléments strictement supérieurs à la K-ième valeur (nombre et
+ * empreinte) et au moins K éléments supérieurs ou égaux.
+ */
+int verify_topk_distributed(const int *local_data, int local_size,
+                            const int *topk, int k, int root, MPI_Comm comm);
+
+/**
+ * Comptage incrémental de verify_topk_distributed, pour des données lues
+ * par blocs (flux): éléments strictement supérieurs à la K-ième valeur
+ * (empreinte) et éléments supérieurs ou égaux
+ */
+typedef struct {
+    int kth;
+    checksum_t greater;
+    long long at_least;
+} topk_tally_t;
+
+/**
+ * Diffuse la K-ième valeur de topk (connue de root) et prépare le comptage.
+ * Opération collective.
+ */
+void topk_tally_init(topk_tally_t *tally, const int *topk, int k, int root, MPI_Comm comm);
+
+/**
+ * Compte un bloc de données locales
+ */
+void topk_tally_add(topk_tally_t *tally, const int *values, int count);
+
+/**
+ * Verdict de verify_topk_distributed à partir des comptages de chaque
+ * processus. Opération collective.
+ */
+int topk_tally_check(const topk_tally_t *tally, const int *topk, int k, int root,
+                     MPI_Comm comm);
+
+/**
+ * Vérifie les K entrées de l'arg-top-K (connues du processus root): mêmes
+ * contrôles que verify_topk_distributed sur les valeurs, ordre strict
+ * (valeur décroissante, indice croissant), chaque indice désigne bien sa
+ * valeur (et sa charge utile si payload est non NULL) sur le processus qui
+ * le possède, et les ex aequo de la K-ième valeur sont ceux de plus petits
+ * indices. Les parties locales sont contiguës dans l'ordre des rangs.
+ */
+int verify_argtopk_distributed(const int *local_data, const int *payload, int local_size,
+                               const topk_entry_t *entries, int k, int root, MPI_Comm comm);
+
+/**
+ * Vérifie que values[q] est l'élément de rang global ranks[q] (ordre
+ * croissant, à partir de 0): moins de ranks[q] + 1 éléments lui sont
+ * strictement inférieurs et plus de ranks[q] inférieurs ou égaux. values
+ * et ranks sont connus de tous les processus.
+ */
+int verify_quantiles_distributed(const int *local_data, int local_size, const long long *ranks,
+                                 const int *values, int num_ranks, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * Top-K sur fenêtre glissante: anneau de résumés de sous-fenêtres
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "window.h"
+#include "sort_kernels.h"
+#include "stream.h"
+
+/**
+ * Élément d'un K-skyband: valeur et position globale
+ */
+typedef struct {
+    int value;
+    long long position;
+} skyband_entry_t;
+
+static inline int skyband_before(const skyband_entry_t *a, const skyband_entry_t *b) {
+    return a->value > b->value;
+}
+
+SORT_DEFINE_KERNELS(skyband, skyband_entry_t, skyband_before)
+
+void topk_window_init(topk_window_t *window, int k, int num_panes, int exact) {
+    memset(window, 0, sizeof(*window));
+    window->k = k;
+    window->num_panes = num_panes;
+    window->exact = exact;
+    window->values = (int**)calloc(num_panes, sizeof(int*));
+    window->positions = (long long**)calloc(num_panes, sizeof(long long*));
+    window->counts = (int*)calloc(num_panes, sizeof(int));
+    window->capacities = (int*)calloc(num_panes, sizeof(int));
+    window->starts = (long long*)calloc(num_panes, sizeof(long long));
+    window->cursors = (int*)malloc((num_panes + 1) * sizeof(int));
+}
+
+void topk_window_free(topk_window_t *window) {
+    for (int p = 0; p < window->num_panes; p++) {
+        free(window->values[p]);
+        free(window->positions[p]);
+    }
+    free(window->values);
+    free(window->positions);
+    free(window->counts);
+    free(window->capacities);
+    free(window->starts);
+    free(window->cursors);
+    free(window->pending);
+    free(window->segment_starts);
+    free(window->segment_offsets);
+}
+
+/**
+ * Case de l'anneau qui reçoit la prochaine sous-fenêtre, agrandie pour
+ * count éléments
+ */
+static int next_slot(topk_window_t *window, int count, long long start) {
+    int slot = window->head;
+    if (count > window->capacities[slot]) {
+        window->values[slot] = (int*)realloc(window->values[slot], count * sizeof(int));
+        if (window->exact) {
+            window->positions[slot] = (long long*)realloc(window->positions[slot],
+                                                          count * sizeof(long long));
+        }
+        window->capacities[slot] = count;
+    }
+    window->counts[slot] = count;
+    window->starts[slot] = start;
+    window->head = (slot + 1) % window->num_panes;
+    if (window->filled < window->num_panes) {
+        window->filled++;
+    }
+    return slot;
+}
+
+void topk_window_push_pane(topk_window_t *window, const int *topk, int count, long long start) {
+    int slot = next_slot(window, count, start);
+    if (count > 0) {
+        memcpy(window->values[slot], topk, count * sizeof(int));
+    }
+}
+
+void topk_window_append(topk_window_t *window, const int *values, int count, long long position) {
+    if (count <= 0) {
+        return;
+    }
+    if (window->pending_count + count > window->pending_capacity) {
+        int capacity = 2 * window->pending_capacity;
+        if (capacity < window->pending_count + count) capacity = window->pending_count + count;
+        window->pending = (int*)realloc(window->pending, capacity * sizeof(int));
+        window->pending_capacity = capacity;
+    }
+    // Segment continu avec le précédent: pas de nouvelle entrée
+    int last = window->num_segments - 1;
+    if (last < 0 || window->segment_starts[last] + (window->pending_count -
+                                                    window->segment_offsets[last]) != position) {
+        if (window->num_segments == window->segment_capacity) {
+            int capacity = window->segment_capacity ? 2 * window->segment_capacity : 16;
+            window->segment_starts = (long long*)realloc(window->segment_starts,
+                                                         capacity * sizeof(long long));
+            window->segment_offsets = (int*)realloc(window->segment_offsets,
+                                                    capacity * sizeof(int));
+            window->segment_capacity = capacity;
+        }
+        window->segment_starts[window->num_segments] = position;
+        window->segment_offsets[window->num_segments] = window->pending_count;
+        window->num_segments++;
+    }
+    memcpy(window->pending + window->pending_count, values, count * sizeof(int));
+    window->pending_count += count;
+}
+
+void topk_window_seal_pane(topk_window_t *window, long long start) {
+    // K-skyband: parcours à rebours avec le tas des K plus grands éléments
+    // qui suivent; un élément en fait partie s'il entre dans le tas
+    topk_heap_t heap;
+    topk_heap_init(&heap, window->k);
+    skyband_entry_t *entries = NULL;
+    int count = 0, capacity = 0;
+    int segment = window->num_segments - 1;
+    for (int i = window->pending_count - 1; i >= 0; i--) {
+        while (window->segment_offsets[segment] > i) segment--;
+        if (topk_heap_push_chunk(&heap, &window->pending[i], 1) == 0) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 2 * window->k + 16;
+            entries = (skyband_entry_t*)realloc(entries, capacity * sizeof(skyband_entry_t));
+        }
+        entries[count].value = window->pending[i];
+        entries[count].position = window->segment_starts[segment] +
+                                  (i - window->segment_offsets[segment]);
+        count++;
+    }
+    topk_heap_free(&heap);
+    skyband_sort(entries, count);
+    
+    int slot = next_slot(window, count, start);
+    for (int i = 0; i < count; i++) {
+        window->values[slot][i] = entries[i].value;
+        window->positions[slot][i] = entries[i].position;
+    }
+    free(entries);
+    window->pending_count = 0;
+    window->num_segments = 0;
+}
+
+long long topk_window_start(const topk_window_t *window, long long current_start) {
+    if (window->filled == 0) {
+        return current_start;
+    }
+    // La plus ancienne sous-fenêtre précède head dans l'anneau
+    int oldest = (window->head - window->filled + window->num_panes) % window->num_panes;
+    return window->starts[oldest];
+}
+
+int topk_window_query(topk_window_t *window, const int *current, int current_count,
+                      long long window_start, int *out) {
+    int num_lists = window->filled + 1;
+    int *cursors = window->cursors;
+    memset(cursors, 0, num_lists * sizeof(int));
+    
+    // Fusion à num_panes + 1 voies: la plus grande tête de liste à chaque pas
+    int n = 0;
+    while (n < window->k) {
+        int best = -1;
+        int best_value = 0;
+        for (int l = 0; l < num_lists; l++) {
+            const int *list;
+            int count;
+            if (l < window->filled) {
+                int slot = (window->head - 1 - l + window->num_panes) % window->num_panes;
+                list = window->values[slot];
+                count = window->counts[slot];
+                // Éléments expirés de la sous-fenêtre la plus ancienne
+                if (window->exact) {
+                    const long long *positions = window->positions[slot];
+                    while (cursors[l] < count && positions[cursors[l]] < window_start) {
+                        cursors[l]++;
+                    }
+                }
+            } else {
+                list = current;
+                count = current_count;
+            }
+            if (cursors[l] < count && (best < 0 || list[cursors[l]] > best_value)) {
+                best = l;
+                best_value = list[cursors[l]];
+            }
+        }
+        if (best < 0) break;
+        out[n++] = best_value;
+        cursors[best]++;
+    }
+    return n;
+}
+
+long long topk_window_memory(const topk_window_t *window) {
+    long long bytes = 0;
+    for (int p = 0; p < window->num_panes; p++) {
+        bytes += (long long)window->capacities[p] *
+                 (sizeof(int) + (window->exact ? sizeof(long long) : 0));
+    }
+    bytes += (long long)window->pending_capacity * sizeof(int);
+    bytes += (long long)window->segment_capacity * (sizeof(long long) + sizeof(int));
+    return bytes;
+}
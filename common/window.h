@@ -0,0 +1,110 @@
+/**
+ * Top-K sur fenêtre glissante (--window)
+ *
+ * La fenêtre des W derniers éléments (ou des T dernières secondes) est
+ * découpée en sous-fenêtres de même taille (ou durée). Chaque sous-fenêtre
+ * terminée n'est conservée que par un résumé (liste décroissante), dans un
+ * anneau de num_panes résumés: l'arrivée d'un élément ne touche que la
+ * sous-fenêtre courante, et l'expiration écrase le résumé le plus ancien.
+ * Une requête fusionne les résumés, sans relire les éléments.
+ *
+ * Fenêtre de T secondes: le résumé d'une sous-fenêtre est la liste de ses K
+ * plus grands éléments, et les éléments expirent par sous-fenêtre entière.
+ *
+ * Fenêtre de W éléments (exacte): les éléments sont numérotés par leur
+ * position globale dans le flux et la fenêtre est [total - W, total). La
+ * plus ancienne sous-fenêtre n'est alors couverte qu'en partie; son résumé
+ * est son K-skyband: les éléments suivis de moins de K éléments plus
+ * grands dans la sous-fenêtre, avec leur position. Les K plus grands de
+ * tout suffixe de la sous-fenêtre en font partie; le skyband compte en
+ * moyenne O(K log(taille / K)) éléments sur un flux aléatoire (toute la
+ * sous-fenêtre au pire, sur un flux décroissant). Les éléments de la
+ * sous-fenêtre courante sont gardés jusqu'à sa fin pour le calculer.
+ */
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#define WINDOW_DEFAULT_PANES 8
+
+/**
+ * Anneau des résumés des sous-fenêtres terminées
+ */
+typedef struct {
+    int k;
+    int num_panes;
+    int exact;              // Fenêtre de W éléments (positions globales)
+    int **values;           // Résumé de la sous-fenêtre p, décroissant
+    long long **positions;  // Position globale de chaque valeur (exact)
+    int *counts;
+    int *capacities;
+    long long *starts;      // Numéro du premier élément de chaque sous-fenêtre
+    int head;               // Prochaine case à écraser (la plus ancienne)
+    int filled;
+    int *cursors;           // Curseurs de fusion (num_panes + 1)
+
+    // Sous-fenêtre courante (exact): éléments dans l'ordre d'arrivée, par
+    // segments de positions globales consécutives
+    int *pending;
+    int pending_count;
+    int pending_capacity;
+    long long *segment_starts;  // Position globale du premier élément du segment
+    int *segment_offsets;       // Indice dans pending du premier élément du segment
+    int num_segments;
+    int segment_capacity;
+} topk_window_t;
+
+/**
+ * Prépare un anneau vide de num_panes résumés de K éléments; exact: fenêtre
+ * de W éléments (résumés K-skyband, topk_window_append et
+ * topk_window_seal_pane), sinon fenêtre de T secondes (topk_window_push_pane)
+ */
+void topk_window_init(topk_window_t *window, int k, int num_panes, int exact);
+
+/**
+ * Libère l'anneau
+ */
+void topk_window_free(topk_window_t *window);
+
+/**
+ * Ajoute le résumé (liste décroissante d'au plus K éléments) d'une
+ * sous-fenêtre terminée dont le premier élément porte le numéro start;
+ * le résumé le plus ancien expire si l'anneau est plein (fenêtre de T
+ * secondes)
+ */
+void topk_window_push_pane(topk_window_t *window, const int *topk, int count, long long start);
+
+/**
+ * Garde count éléments de la sous-fenêtre courante, de positions globales
+ * consécutives à partir de position (fenêtre de W éléments)
+ */
+void topk_window_append(topk_window_t *window, const int *values, int count, long long position);
+
+/**
+ * Termine la sous-fenêtre courante, dont le premier élément global porte
+ * le numéro start: son K-skyband entre dans l'anneau, le résumé le plus
+ * ancien expirant si l'anneau est plein (fenêtre de W éléments)
+ */
+void topk_window_seal_pane(topk_window_t *window, long long start);
+
+/**
+ * Numéro du plus ancien élément couvert par la fenêtre; current_start est
+ * celui de la sous-fenêtre courante (non terminée)
+ */
+long long topk_window_start(const topk_window_t *window, long long current_start);
+
+/**
+ * K plus grands de la fenêtre: fusion des résumés, limités aux positions
+ * supérieures ou égales à window_start (fenêtre de W éléments), et de la
+ * liste décroissante de la sous-fenêtre courante. Écrit au plus K éléments
+ * décroissants dans out et retourne leur nombre.
+ */
+int topk_window_query(topk_window_t *window, const int *current, int current_count,
+                      long long window_start, int *out);
+
+/**
+ * Mémoire occupée par l'anneau et la sous-fenêtre courante, en octets
+ */
+long long topk_window_memory(const topk_window_t *window);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * Générateur de données reproductible
+ *
+ * Élément i = fonction de mélange SplitMix64 appliquée au compteur
+ * graine + (i + 1) * gamma: aucun état partagé entre threads.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "workload.h"
+
+// Incrément de SplitMix64 (partie fractionnaire du nombre d'or)
+#define SPLITMIX_GAMMA 0x9E3779B97F4A7C15ULL
+
+#define TWO_PI 6.283185307179586
+
+static const char *dist_names[NUM_DISTS] = {
+    "uniform", "zipf", "gaussian", "sorted", "reverse",
+    "nearly-sorted", "all-equal", "few-unique"
+};
+
+int workload_parse_dist(const char *name) {
+    for (int d = 0; d < NUM_DISTS; d++) {
+        if (strcmp(name, dist_names[d]) == 0) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+const char *workload_dist_name(int dist) {
+    return (dist >= 0 && dist < NUM_DISTS) ? dist_names[dist] : "?";
+}
+
+/**
+ * Fonction de mélange de SplitMix64
+ */
+static inline uint64_t splitmix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Nombre aléatoire de 64 bits associé à la position index du flux key
+ */
+static inline uint64_t counter_random(uint64_t key, long long index) {
+    return splitmix64(key + (uint64_t)(index + 1) * SPLITMIX_GAMMA);
+}
+
+/**
+ * Entier uniforme dans [0, bound) (multiplication haute, sans division)
+ */
+static inline int uniform_below(uint64_t r, int bound) {
+    return (int)(((r >> 32) * (uint64_t)bound) >> 32);
+}
+
+/**
+ * Réel uniforme dans ]0, 1[
+ */
+static inline double uniform_open(uint64_t r) {
+    return ((double)(r >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static inline int clamp_value(double x, int max_value) {
+    if (x < 0.0) return 0;
+    if (x >= max_value) return max_value - 1;
+    return (int)x;
+}
+
+void workload_generate(int *arr, long long start, int count, long long total_size,
+                       int max_value, int dist, uint64_t seed) {
+    // Deux flux indépendants (Box-Muller et perturbations en consomment deux)
+    const uint64_t key = splitmix64(seed);
+    const uint64_t key2 = splitmix64(seed ^ SPLITMIX_GAMMA);
+    
+    // Zipf par inversion de la loi de puissance continue sur [1, max_value]
+    const double zipf_exponent = 1.0 - WORKLOAD_ZIPF_EXPONENT;
+    const double zipf_scale = pow((double)max_value, zipf_exponent) - 1.0;
+    const int unique_step = max_value / WORKLOAD_FEW_UNIQUE_VALUES;
+    
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int j = 0; j < count; j++) {
+        long long i = start + j;
+        uint64_t r = counter_random(key, i);
+        int value;
+        
+        switch (dist) {
+        case DIST_ZIPF:
+            value = clamp_value(pow(zipf_scale * uniform_open(r) + 1.0,
+                                    1.0 / zipf_exponent) - 1.0, max_value);
+            break;
+        case DIST_GAUSSIAN: {
+            double u2 = uniform_open(counter_random(key2, i));
+            double z = sqrt(-2.0 * log(uniform_open(r))) * cos(TWO_PI * u2);
+            value = clamp_value(max_value * (0.5 + WORKLOAD_GAUSSIAN_SIGMA * z), max_value);
+            break;
+        }
+        case DIST_SORTED:
+            value = (int)(i * max_value / total_size);
+            break;
+        case DIST_REVERSE:
+            value = (int)((total_size - 1 - i) * max_value / total_size);
+            break;
+        case DIST_NEARLY_SORTED:
+            if (uniform_below(counter_random(key2, i), 100) < WORKLOAD_NEARLY_SORTED_PCT) {
+                value = uniform_below(r, max_value);
+            } else {
+                value = (int)(i * max_value / total_size);
+            }
+            break;
+        case DIST_ALL_EQUAL:
+            value = max_value / 2;
+            break;
+        case DIST_FEW_UNIQUE:
+            value = uniform_below(r, WORKLOAD_FEW_UNIQUE_VALUES) * unique_step + unique_step / 2;
+            break;
+        default:
+            value = uniform_below(r, max_value);
+            break;
+        }
+        arr[j] = value;
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * Générateur de données reproductible (--dist, --seed)
+ *
+ * Générateur à compteur (SplitMix64): la valeur de l'élément i ne dépend
+ * que de la graine et de sa position globale i. N'importe quel processus ou
+ * thread peut donc produire sa tranche indépendamment, et le tableau obtenu
+ * est identique bit à bit quel que soit le nombre de processus ou de
+ * threads: les versions MPI et hybride trient exactement les mêmes données.
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+
+// Distributions disponibles (--dist=nom)
+#define DIST_UNIFORM        0   // Uniforme sur [0, max_value)
+#define DIST_ZIPF           1   // Zipf: quelques petites clés très fréquentes
+#define DIST_GAUSSIAN       2   // Normale centrée sur max_value/2
+#define DIST_SORTED         3   // Croissante
+#define DIST_REVERSE        4   // Décroissante
+#define DIST_NEARLY_SORTED  5   // Croissante avec 1% de valeurs aléatoires
+#define DIST_ALL_EQUAL      6   // Une seule valeur
+#define DIST_FEW_UNIQUE     7   // 16 valeurs distinctes
+#define NUM_DISTS           8
+
+#define WORKLOAD_DEFAULT_SEED 42
+
+// Paramètres des distributions
+#define WORKLOAD_ZIPF_EXPONENT      1.1
+#define WORKLOAD_GAUSSIAN_SIGMA     0.125   // Écart-type relatif à max_value
+#define WORKLOAD_NEARLY_SORTED_PCT  1       // Pourcentage de positions perturbées
+#define WORKLOAD_FEW_UNIQUE_VALUES  16
+
+/**
+ * Numéro de la distribution à partir de son nom (-1 si inconnu)
+ */
+int workload_parse_dist(const char *name);
+
+/**
+ * Nom de la distribution
+ */
+const char *workload_dist_name(int dist);
+
+/**
+ * Remplit arr avec les éléments [start, start + count) d'un tableau de
+ * total_size valeurs dans [0, max_value). Parallélisé avec OpenMP si
+ * disponible; le résultat ne dépend ni du découpage ni des threads.
+ */
+void workload_generate(int *arr, long long start, int count, long long total_size,
+                       int max_value, int dist, uint64_t seed);
+
+#endif